@@ -202,6 +202,17 @@ def cartographer_repositories():
         ],
     )
 
+    _maybe(
+        http_archive,
+        name = "com_github_google_benchmark",
+        sha256 = "3c6a165b6ecc948967a1ead710d4a181d7b0fbcaa183ef7ea84604994966221a",
+        strip_prefix = "benchmark-1.5.0",
+        urls = [
+            "https://mirror.bazel.build/github.com/google/benchmark/archive/v1.5.0.tar.gz",
+            "https://github.com/google/benchmark/archive/v1.5.0.tar.gz",
+        ],
+    )
+
     _maybe(
         http_archive,
         name = "bazel_skylib",
@@ -105,6 +105,8 @@ class ClientServerTestBase : public T {
       MAP_BUILDER_SERVER.uplink_server_address = "localhost:50051"
       MAP_BUILDER_SERVER.server_address = "0.0.0.0:50052"
       MAP_BUILDER_SERVER.upload_batch_size = 1
+      MAP_BUILDER_SERVER.incoming_data_queue_size = 1024
+      MAP_BUILDER_SERVER.upload_queue_size = 1024
       return MAP_BUILDER_SERVER)text";
     auto uploading_map_builder_server_parameters =
         mapping::testing::ResolveLuaParameters(kUploadingMapBuilderServerLua);
@@ -31,7 +31,7 @@ namespace handlers {
 
 void AddFixedFramePoseDataHandler::OnSensorData(
     const proto::AddFixedFramePoseDataRequest& request) {
-  // The 'BlockingQueue' returned by 'sensor_data_queue()' is already
+  // The 'SensorDataQueue' returned by 'sensor_data_queue()' is already
   // thread-safe. Therefore it suffices to get an unsynchronized reference to
   // the 'MapBuilderContext'.
   GetUnsynchronizedContext<MapBuilderContextInterface>()->EnqueueSensorData(
@@ -40,7 +40,7 @@ void AddFixedFramePoseDataHandler::OnSensorData(
           request.sensor_metadata().sensor_id(),
           sensor::FromProto(request.fixed_frame_pose_data())));
 
-  // The 'BlockingQueue' in 'LocalTrajectoryUploader' is thread-safe.
+  // The send queue in 'LocalTrajectoryUploader' is thread-safe.
   // Therefore it suffices to get an unsynchronized reference to the
   // 'MapBuilderContext'.
   if (GetUnsynchronizedContext<MapBuilderContextInterface>()
@@ -30,7 +30,7 @@ namespace cloud {
 namespace handlers {
 
 void AddImuDataHandler::OnSensorData(const proto::AddImuDataRequest& request) {
-  // The 'BlockingQueue' returned by 'sensor_data_queue()' is already
+  // The 'SensorDataQueue' returned by 'sensor_data_queue()' is already
   // thread-safe. Therefore it suffices to get an unsynchronized reference to
   // the 'MapBuilderContext'.
   GetUnsynchronizedContext<MapBuilderContextInterface>()->EnqueueSensorData(
@@ -38,7 +38,7 @@ void AddImuDataHandler::OnSensorData(const proto::AddImuDataRequest& request) {
       sensor::MakeDispatchable(request.sensor_metadata().sensor_id(),
                                sensor::FromProto(request.imu_data())));
 
-  // The 'BlockingQueue' in 'LocalTrajectoryUploader' is thread-safe.
+  // The send queue in 'LocalTrajectoryUploader' is thread-safe.
   // Therefore it suffices to get an unsynchronized reference to the
   // 'MapBuilderContext'.
   if (GetUnsynchronizedContext<MapBuilderContextInterface>()
@@ -31,7 +31,7 @@ namespace handlers {
 
 void AddLandmarkDataHandler::OnSensorData(
     const proto::AddLandmarkDataRequest& request) {
-  // The 'BlockingQueue' returned by 'sensor_data_queue()' is already
+  // The 'SensorDataQueue' returned by 'sensor_data_queue()' is already
   // thread-safe. Therefore it suffices to get an unsynchronized reference to
   // the 'MapBuilderContext'.
   GetUnsynchronizedContext<MapBuilderContextInterface>()->EnqueueSensorData(
@@ -39,7 +39,7 @@ void AddLandmarkDataHandler::OnSensorData(
       sensor::MakeDispatchable(request.sensor_metadata().sensor_id(),
                                sensor::FromProto(request.landmark_data())));
 
-  // The 'BlockingQueue' in 'LocalTrajectoryUploader' is thread-safe.
+  // The send queue in 'LocalTrajectoryUploader' is thread-safe.
   // Therefore it suffices to get an unsynchronized reference to the
   // 'MapBuilderContext'.
   if (GetUnsynchronizedContext<MapBuilderContextInterface>()
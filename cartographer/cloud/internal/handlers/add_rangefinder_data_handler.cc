@@ -30,7 +30,7 @@ namespace handlers {
 
 void AddRangefinderDataHandler::OnSensorData(
     const proto::AddRangefinderDataRequest& request) {
-  // The 'BlockingQueue' returned by 'sensor_data_queue()' is already
+  // The 'SensorDataQueue' returned by 'sensor_data_queue()' is already
   // thread-safe. Therefore it suffices to get an unsynchronized reference to
   // the 'MapBuilderContext'.
   GetUnsynchronizedContext<MapBuilderContextInterface>()->EnqueueSensorData(
@@ -26,11 +26,16 @@
 #include "cartographer/cloud/internal/handlers/finish_trajectory_handler.h"
 #include "cartographer/cloud/internal/sensor/serialization.h"
 #include "cartographer/common/internal/blocking_queue.h"
+#include "cartographer/common/internal/lock_free_queue.h"
+#include "cartographer/metrics/counter.h"
 #include "glog/logging.h"
 #include "grpc++/grpc++.h"
 
 namespace cartographer {
 namespace cloud {
+
+static auto* kDroppedSensorDataMetric = metrics::Counter::Null();
+
 namespace {
 
 using absl::make_unique;
@@ -54,6 +59,24 @@ bool IsNewSubmap(const mapping::proto::Submap& submap) {
          (submap.has_submap_3d() && submap.submap_3d().num_range_data() == 1);
 }
 
+using SensorDataPtr = std::unique_ptr<proto::SensorData>;
+
+// Pushes 'sensor_data' onto the unbounded 'queue'. Never fails.
+bool TryPush(SensorDataPtr sensor_data,
+             common::BlockingQueue<SensorDataPtr>* const queue) {
+  queue->Push(std::move(sensor_data));
+  return true;
+}
+
+// Returns false instead of blocking if the bounded 'queue' is full.
+bool TryPush(SensorDataPtr sensor_data,
+             common::LockFreeQueue<SensorDataPtr>* const queue) {
+  return queue->TryPush(std::move(sensor_data));
+}
+
+// 'SendQueue' is either an unbounded 'BlockingQueue' or a bounded
+// 'LockFreeQueue', see 'CreateLocalTrajectoryUploader'.
+template <typename SendQueue>
 class LocalTrajectoryUploader : public LocalTrajectoryUploaderInterface {
  public:
   struct TrajectoryInfo {
@@ -66,8 +89,8 @@ class LocalTrajectoryUploader : public LocalTrajectoryUploaderInterface {
 
  public:
   LocalTrajectoryUploader(const std::string& uplink_server_address,
-                          int batch_size, bool enable_ssl_encryption,
-                          bool enable_google_auth);
+                          int batch_size, int queue_size,
+                          bool enable_ssl_encryption, bool enable_google_auth);
   ~LocalTrajectoryUploader();
 
   // Starts the upload thread.
@@ -100,15 +123,17 @@ class LocalTrajectoryUploader : public LocalTrajectoryUploaderInterface {
   std::shared_ptr<::grpc::Channel> client_channel_;
   int batch_size_;
   std::map<int, TrajectoryInfo> local_trajectory_id_to_trajectory_info_;
-  common::BlockingQueue<std::unique_ptr<proto::SensorData>> send_queue_;
+  // Filled by any thread, drained by 'upload_thread_'.
+  SendQueue send_queue_;
   bool shutting_down_ = false;
   std::unique_ptr<std::thread> upload_thread_;
 };
 
-LocalTrajectoryUploader::LocalTrajectoryUploader(
-    const std::string& uplink_server_address, int batch_size,
+template <typename SendQueue>
+LocalTrajectoryUploader<SendQueue>::LocalTrajectoryUploader(
+    const std::string& uplink_server_address, int batch_size, int queue_size,
     bool enable_ssl_encryption, bool enable_google_auth)
-    : batch_size_(batch_size) {
+    : batch_size_(batch_size), send_queue_(queue_size) {
   auto channel_creds =
       enable_google_auth
           ? grpc::GoogleDefaultCredentials()
@@ -126,23 +151,27 @@ LocalTrajectoryUploader::LocalTrajectoryUploader(
   }
 }
 
-LocalTrajectoryUploader::~LocalTrajectoryUploader() {}
+template <typename SendQueue>
+LocalTrajectoryUploader<SendQueue>::~LocalTrajectoryUploader() {}
 
-void LocalTrajectoryUploader::Start() {
+template <typename SendQueue>
+void LocalTrajectoryUploader<SendQueue>::Start() {
   CHECK(!shutting_down_);
   CHECK(!upload_thread_);
   upload_thread_ =
       make_unique<std::thread>([this]() { this->ProcessSendQueue(); });
 }
 
-void LocalTrajectoryUploader::Shutdown() {
+template <typename SendQueue>
+void LocalTrajectoryUploader<SendQueue>::Shutdown() {
   CHECK(!shutting_down_);
   CHECK(upload_thread_);
   shutting_down_ = true;
   upload_thread_->join();
 }
 
-void LocalTrajectoryUploader::TryRecovery() {
+template <typename SendQueue>
+void LocalTrajectoryUploader<SendQueue>::TryRecovery() {
   if (client_channel_->GetState(false /* try_to_connect */) !=
       grpc_connectivity_state::GRPC_CHANNEL_READY) {
     LOG(INFO) << "Trying to re-connect to uplink...";
@@ -163,7 +192,7 @@ void LocalTrajectoryUploader::TryRecovery() {
       return;
     }
     proto::SensorData* sensor_data =
-        send_queue_.PeekWithTimeout<proto::SensorData>(kPopTimeout);
+        send_queue_.template PeekWithTimeout<proto::SensorData>(kPopTimeout);
     if (sensor_data) {
       CHECK_GE(sensor_data->local_slam_result_data().submaps_size(), 0);
       if (sensor_data->sensor_data_case() ==
@@ -198,7 +227,8 @@ void LocalTrajectoryUploader::TryRecovery() {
   LOG(INFO) << "LocalTrajectoryUploader recovered.";
 }
 
-void LocalTrajectoryUploader::ProcessSendQueue() {
+template <typename SendQueue>
+void LocalTrajectoryUploader<SendQueue>::ProcessSendQueue() {
   LOG(INFO) << "Starting uploader thread.";
   proto::AddSensorDataBatchRequest batch_request;
   while (!shutting_down_) {
@@ -242,7 +272,8 @@ void LocalTrajectoryUploader::ProcessSendQueue() {
   }
 }
 
-bool LocalTrajectoryUploader::TranslateTrajectoryId(
+template <typename SendQueue>
+bool LocalTrajectoryUploader<SendQueue>::TranslateTrajectoryId(
     proto::SensorMetadata* sensor_metadata) {
   auto it = local_trajectory_id_to_trajectory_info_.find(
       sensor_metadata->trajectory_id());
@@ -258,7 +289,8 @@ bool LocalTrajectoryUploader::TranslateTrajectoryId(
   return true;
 }
 
-grpc::Status LocalTrajectoryUploader::AddTrajectory(
+template <typename SendQueue>
+grpc::Status LocalTrajectoryUploader<SendQueue>::AddTrajectory(
     const std::string& client_id, int local_trajectory_id,
     const std::set<SensorId>& expected_sensor_ids,
     const mapping::proto::TrajectoryBuilderOptions& trajectory_options) {
@@ -270,7 +302,8 @@ grpc::Status LocalTrajectoryUploader::AddTrajectory(
   return RegisterTrajectory(local_trajectory_id);
 }
 
-grpc::Status LocalTrajectoryUploader::RegisterTrajectory(
+template <typename SendQueue>
+grpc::Status LocalTrajectoryUploader<SendQueue>::RegisterTrajectory(
     int local_trajectory_id) {
   TrajectoryInfo& trajectory_info =
       local_trajectory_id_to_trajectory_info_.at(local_trajectory_id);
@@ -302,7 +335,8 @@ grpc::Status LocalTrajectoryUploader::RegisterTrajectory(
   return status;
 }
 
-grpc::Status LocalTrajectoryUploader::FinishTrajectory(
+template <typename SendQueue>
+grpc::Status LocalTrajectoryUploader<SendQueue>::FinishTrajectory(
     const std::string& client_id, int local_trajectory_id) {
   auto it = local_trajectory_id_to_trajectory_info_.find(local_trajectory_id);
   if (it == local_trajectory_id_to_trajectory_info_.end()) {
@@ -326,19 +360,44 @@ grpc::Status LocalTrajectoryUploader::FinishTrajectory(
   return status;
 }
 
-void LocalTrajectoryUploader::EnqueueSensorData(
+template <typename SendQueue>
+void LocalTrajectoryUploader<SendQueue>::EnqueueSensorData(
     std::unique_ptr<proto::SensorData> sensor_data) {
-  send_queue_.Push(std::move(sensor_data));
+  // Never blocks the caller, which is typically a local SLAM result callback,
+  // also not while the uplink is unavailable for a long time.
+  if (!TryPush(std::move(sensor_data), &send_queue_)) {
+    kDroppedSensorDataMetric->Increment();
+    LOG_EVERY_N(WARNING, 1000)
+        << "Upload queue is full, dropped " << google::COUNTER
+        << " sensor data messages.";
+  }
 }
 
 }  // namespace
 
+void RegisterLocalTrajectoryUploaderMetrics(
+    metrics::FamilyFactory* family_factory) {
+  auto* dropped_sensor_data = family_factory->NewCounterFamily(
+      "cloud_internal_local_trajectory_uploader_dropped_sensor_data",
+      "Sensor data messages dropped because the upload queue was full");
+  kDroppedSensorDataMetric = dropped_sensor_data->Add({});
+}
+
 std::unique_ptr<LocalTrajectoryUploaderInterface> CreateLocalTrajectoryUploader(
-    const std::string& uplink_server_address, int batch_size,
+    const std::string& uplink_server_address, int batch_size, int queue_size,
     bool enable_ssl_encryption, bool enable_google_auth) {
-  return make_unique<LocalTrajectoryUploader>(uplink_server_address, batch_size,
-                                              enable_ssl_encryption,
-                                              enable_google_auth);
+  CHECK_GE(queue_size, 0);
+  if (queue_size == 0) {
+    // A 'BlockingQueue' of size 0 is unbounded.
+    return make_unique<
+        LocalTrajectoryUploader<common::BlockingQueue<SensorDataPtr>>>(
+        uplink_server_address, batch_size, queue_size, enable_ssl_encryption,
+        enable_google_auth);
+  }
+  return make_unique<
+      LocalTrajectoryUploader<common::LockFreeQueue<SensorDataPtr>>>(
+      uplink_server_address, batch_size, queue_size, enable_ssl_encryption,
+      enable_google_auth);
 }
 
 }  // namespace cloud
@@ -24,6 +24,7 @@
 #include "cartographer/cloud/proto/map_builder_service.pb.h"
 #include "cartographer/mapping/proto/trajectory_builder_options.pb.h"
 #include "cartographer/mapping/trajectory_builder_interface.h"
+#include "cartographer/metrics/family_factory.h"
 #include "grpc++/support/status.h"
 
 namespace cartographer {
@@ -44,7 +45,9 @@ class LocalTrajectoryUploaderInterface {
   // complete.
   virtual void Shutdown() = 0;
 
-  // Enqueue an Add*DataRequest message to be uploaded.
+  // Enqueue an Add*DataRequest message to be uploaded. Does not block: while
+  // a bounded send queue is full, e.g. during an outage of the uplink, further
+  // messages are dropped and counted.
   virtual void EnqueueSensorData(
       std::unique_ptr<proto::SensorData> sensor_data) = 0;
 
@@ -61,9 +64,17 @@ class LocalTrajectoryUploaderInterface {
       int local_trajectory_id) const = 0;
 };
 
-// Returns LocalTrajectoryUploader with the actual implementation.
+// Registers a counter of the sensor data messages dropped by
+// 'EnqueueSensorData'.
+void RegisterLocalTrajectoryUploaderMetrics(
+    metrics::FamilyFactory* family_factory);
+
+// Returns LocalTrajectoryUploader with the actual implementation. With a
+// 'queue_size' of 0 its send queue is an unbounded 'BlockingQueue', otherwise a
+// 'LockFreeQueue' holding 'queue_size' messages, beyond which
+// 'EnqueueSensorData' drops messages.
 std::unique_ptr<LocalTrajectoryUploaderInterface> CreateLocalTrajectoryUploader(
-    const std::string& uplink_server_address, int batch_size,
+    const std::string& uplink_server_address, int batch_size, int queue_size,
     bool enable_ssl_encryption, bool enable_google_auth);
 
 }  // namespace cloud
@@ -16,6 +16,8 @@
 
 #include "cartographer/cloud/internal/local_trajectory_uploader.h"
 
+#include "absl/memory/memory.h"
+#include "cartographer/metrics/internal/recording_family_factory.h"
 #include "glog/logging.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -31,25 +33,54 @@ const SensorId kImuSensorId{SensorId::SensorType::IMU, "imu"};
 const SensorId kRangeSensorId{SensorId::SensorType::RANGE, "range"};
 const int kLocalTrajectoryId = 3;
 
-TEST(LocalTrajectoryUploaderTest, HandlesInvalidUplink) {
-  auto uploader = CreateLocalTrajectoryUploader("invalid-uplink-address:50051",
-                                                /*batch_size=*/1, false, false);
-  uploader->Start();
-  mapping::proto::TrajectoryBuilderOptions options;
-  auto status = uploader->AddTrajectory(
-      kClientId, kLocalTrajectoryId, {kRangeSensorId, kImuSensorId}, options);
-  EXPECT_FALSE(status.ok());
+std::unique_ptr<proto::SensorData> CreateImuData() {
   auto sensor_data = absl::make_unique<proto::SensorData>();
   sensor_data->mutable_sensor_metadata()->set_client_id(kClientId);
   sensor_data->mutable_sensor_metadata()->set_sensor_id(kImuSensorId.id);
   sensor_data->mutable_sensor_metadata()->set_trajectory_id(kLocalTrajectoryId);
   sensor_data->mutable_imu_data()->set_timestamp(1);
-  uploader->EnqueueSensorData(std::move(sensor_data));
-  auto sensor_id = uploader->GetLocalSlamResultSensorId(kLocalTrajectoryId);
-  EXPECT_THAT(sensor_id.id, ::testing::Not(::testing::IsEmpty()));
-  status = uploader->FinishTrajectory(kClientId, kLocalTrajectoryId);
-  EXPECT_FALSE(status.ok());
-  uploader->Shutdown();
+  return sensor_data;
+}
+
+TEST(LocalTrajectoryUploaderTest, HandlesInvalidUplink) {
+  // Both the unbounded and the bounded send queue.
+  for (const int queue_size : {0, 16}) {
+    SCOPED_TRACE(queue_size);
+    auto uploader = CreateLocalTrajectoryUploader(
+        "invalid-uplink-address:50051", /*batch_size=*/1, queue_size, false,
+        false);
+    uploader->Start();
+    mapping::proto::TrajectoryBuilderOptions options;
+    auto status = uploader->AddTrajectory(
+        kClientId, kLocalTrajectoryId, {kRangeSensorId, kImuSensorId}, options);
+    EXPECT_FALSE(status.ok());
+    uploader->EnqueueSensorData(CreateImuData());
+    auto sensor_id = uploader->GetLocalSlamResultSensorId(kLocalTrajectoryId);
+    EXPECT_THAT(sensor_id.id, ::testing::Not(::testing::IsEmpty()));
+    status = uploader->FinishTrajectory(kClientId, kLocalTrajectoryId);
+    EXPECT_FALSE(status.ok());
+    uploader->Shutdown();
+  }
+}
+
+TEST(LocalTrajectoryUploaderTest, DropsSensorDataWhenQueueIsFull) {
+  // Never destroyed, since the registered metrics outlive this test.
+  auto* const family_factory = new metrics::RecordingFamilyFactory();
+  RegisterLocalTrajectoryUploaderMetrics(family_factory);
+  constexpr int kQueueSize = 16;
+  auto uploader = CreateLocalTrajectoryUploader("invalid-uplink-address:50051",
+                                                /*batch_size=*/1, kQueueSize,
+                                                false, false);
+  // Without the upload thread nothing is sent, as during an outage of the
+  // uplink. Enqueueing must neither block nor grow the queue without bound.
+  constexpr int kNumDropped = 10;
+  for (int i = 0; i != kQueueSize + kNumDropped; ++i) {
+    uploader->EnqueueSensorData(CreateImuData());
+  }
+  const auto* dropped_sensor_data = family_factory->GetCounter(
+      "cloud_internal_local_trajectory_uploader_dropped_sensor_data", {});
+  ASSERT_NE(dropped_sensor_data, nullptr);
+  EXPECT_EQ(dropped_sensor_data->Value(), kNumDropped);
 }
 
 }  // namespace
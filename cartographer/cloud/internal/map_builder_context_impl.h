@@ -31,9 +31,9 @@ mapping::MapBuilderInterface& MapBuilderContext<SubmapType>::map_builder() {
 }
 
 template <class SubmapType>
-common::BlockingQueue<std::unique_ptr<MapBuilderContextInterface::Data>>&
+MapBuilderContextInterface::SensorDataQueue&
 MapBuilderContext<SubmapType>::sensor_data_queue() {
-  return map_builder_server_->incoming_data_queue_;
+  return *map_builder_server_->incoming_data_queue_;
 }
 
 template <class SubmapType>
@@ -103,7 +103,7 @@ MapBuilderContext<SubmapType>::local_trajectory_uploader() {
 template <class SubmapType>
 void MapBuilderContext<SubmapType>::EnqueueSensorData(
     int trajectory_id, std::unique_ptr<sensor::Data> data) {
-  map_builder_server_->incoming_data_queue_.Push(
+  map_builder_server_->incoming_data_queue_->Push(
       absl::make_unique<Data>(Data{trajectory_id, std::move(data)}));
 }
 
@@ -19,7 +19,7 @@
 
 #include "async_grpc/execution_context.h"
 #include "cartographer/cloud/internal/local_trajectory_uploader.h"
-#include "cartographer/common/internal/blocking_queue.h"
+#include "cartographer/common/time.h"
 #include "cartographer/mapping/map_builder_interface.h"
 #include "cartographer/mapping/pose_graph_interface.h"
 #include "cartographer/mapping/proto/serialization.pb.h"
@@ -61,6 +61,17 @@ class MapBuilderContextInterface : public async_grpc::ExecutionContext {
     int trajectory_id;
     std::unique_ptr<sensor::Data> data;
   };
+  // Incoming sensor data is pushed by the gRPC handlers and consumed by a
+  // single SLAM thread. The implementation is chosen by
+  // 'MapBuilderServerOptions.incoming_data_queue_size'.
+  class SensorDataQueue {
+   public:
+    virtual ~SensorDataQueue() = default;
+    virtual void Push(std::unique_ptr<Data> data) = 0;
+    virtual std::unique_ptr<Data> PopWithTimeout(common::Duration timeout) = 0;
+    virtual size_t Size() = 0;
+    virtual void WaitUntilEmpty() = 0;
+  };
   struct LocalSlamSubscriptionId {
     const int trajectory_id;
     const int subscription_index;
@@ -74,7 +85,7 @@ class MapBuilderContextInterface : public async_grpc::ExecutionContext {
       delete;
 
   virtual mapping::MapBuilderInterface& map_builder() = 0;
-  virtual common::BlockingQueue<std::unique_ptr<Data>>& sensor_data_queue() = 0;
+  virtual SensorDataQueue& sensor_data_queue() = 0;
   virtual mapping::TrajectoryBuilderInterface::LocalSlamResultCallback
   GetLocalSlamResultCallbackForSubscriptions() = 0;
   virtual void AddSensorDataToTrajectory(const Data& sensor_data) = 0;
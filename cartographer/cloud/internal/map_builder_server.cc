@@ -43,6 +43,8 @@
 #include "cartographer/cloud/internal/handlers/write_state_handler.h"
 #include "cartographer/cloud/internal/handlers/write_state_to_file_handler.h"
 #include "cartographer/cloud/internal/sensor/serialization.h"
+#include "cartographer/common/internal/blocking_queue.h"
+#include "cartographer/common/internal/lock_free_queue.h"
 #include "glog/logging.h"
 
 namespace cartographer {
@@ -53,12 +55,46 @@ static auto* kIncomingDataQueueMetric = metrics::Gauge::Null();
 constexpr int kMaxMessageSize = 100 * 1024 * 1024;  // 100 MB
 const common::Duration kPopTimeout = common::FromMilliseconds(100);
 
+using SensorDataPtr = std::unique_ptr<MapBuilderContextInterface::Data>;
+
+template <typename QueueType>
+class SensorDataQueue : public MapBuilderContextInterface::SensorDataQueue {
+ public:
+  explicit SensorDataQueue(const size_t queue_size) : queue_(queue_size) {}
+
+  void Push(SensorDataPtr data) override { queue_.Push(std::move(data)); }
+  SensorDataPtr PopWithTimeout(const common::Duration timeout) override {
+    return queue_.PopWithTimeout(timeout);
+  }
+  size_t Size() override { return queue_.Size(); }
+  void WaitUntilEmpty() override { queue_.WaitUntilEmpty(); }
+
+ private:
+  QueueType queue_;
+};
+
+// Returns an unbounded 'BlockingQueue' for a 'queue_size' of 0, otherwise a
+// 'LockFreeQueue' holding 'queue_size' messages.
+std::unique_ptr<MapBuilderContextInterface::SensorDataQueue>
+CreateSensorDataQueue(const int queue_size) {
+  CHECK_GE(queue_size, 0);
+  if (queue_size == 0) {
+    // A 'BlockingQueue' of size 0 is unbounded.
+    return absl::make_unique<
+        SensorDataQueue<common::BlockingQueue<SensorDataPtr>>>(queue_size);
+  }
+  return absl::make_unique<
+      SensorDataQueue<common::LockFreeQueue<SensorDataPtr>>>(queue_size);
+}
+
 }  // namespace
 
 MapBuilderServer::MapBuilderServer(
     const proto::MapBuilderServerOptions& map_builder_server_options,
     std::unique_ptr<mapping::MapBuilderInterface> map_builder)
-    : map_builder_(std::move(map_builder)) {
+    : map_builder_(std::move(map_builder)),
+      incoming_data_queue_(CreateSensorDataQueue(
+          map_builder_server_options.incoming_data_queue_size())) {
   async_grpc::Server::Builder server_builder;
   server_builder.SetServerAddress(map_builder_server_options.server_address());
   server_builder.SetNumGrpcThreads(
@@ -71,6 +107,7 @@ MapBuilderServer::MapBuilderServer(
     local_trajectory_uploader_ = CreateLocalTrajectoryUploader(
         map_builder_server_options.uplink_server_address(),
         map_builder_server_options.upload_batch_size(),
+        map_builder_server_options.upload_queue_size(),
         map_builder_server_options.enable_ssl_encryption(),
         map_builder_server_options.enable_google_auth());
   }
@@ -142,8 +179,10 @@ void MapBuilderServer::WaitForShutdown() {
 }
 
 void MapBuilderServer::Shutdown() {
-  shutting_down_ = true;
+  // Shuts down the gRPC server while the SLAM thread still drains the incoming
+  // data queue, so that handlers blocked on a full bounded queue can return.
   grpc_server_->Shutdown();
+  shutting_down_ = true;
   if (slam_thread_) {
     slam_thread_->join();
     slam_thread_.reset();
@@ -157,9 +196,9 @@ void MapBuilderServer::Shutdown() {
 void MapBuilderServer::ProcessSensorDataQueue() {
   LOG(INFO) << "Starting SLAM thread.";
   while (!shutting_down_) {
-    kIncomingDataQueueMetric->Set(incoming_data_queue_.Size());
+    kIncomingDataQueueMetric->Set(incoming_data_queue_->Size());
     std::unique_ptr<MapBuilderContextInterface::Data> sensor_data =
-        incoming_data_queue_.PopWithTimeout(kPopTimeout);
+        incoming_data_queue_->PopWithTimeout(kPopTimeout);
     if (sensor_data) {
       grpc_server_->GetContext<MapBuilderContextInterface>()
           ->AddSensorDataToTrajectory(*sensor_data);
@@ -282,7 +321,7 @@ void MapBuilderServer::NotifyFinishTrajectory(int trajectory_id) {
 }
 
 void MapBuilderServer::WaitUntilIdle() {
-  incoming_data_queue_.WaitUntilEmpty();
+  incoming_data_queue_->WaitUntilEmpty();
   map_builder_->pose_graph()->RunFinalOptimization();
 }
 
@@ -291,6 +330,7 @@ void MapBuilderServer::RegisterMetrics(metrics::FamilyFactory* factory) {
       "cloud_internal_map_builder_server_incoming_data_queue_length",
       "Incoming SLAM Data Queue length");
   kIncomingDataQueueMetric = queue_length->Add({});
+  RegisterLocalTrajectoryUploaderMetrics(factory);
 }
 
 }  // namespace cloud
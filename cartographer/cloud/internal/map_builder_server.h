@@ -23,7 +23,6 @@
 #include "cartographer/cloud/internal/map_builder_context_interface.h"
 #include "cartographer/cloud/map_builder_server_interface.h"
 #include "cartographer/cloud/proto/map_builder_server_options.pb.h"
-#include "cartographer/common/internal/blocking_queue.h"
 #include "cartographer/common/time.h"
 #include "cartographer/mapping/2d/submap_2d.h"
 #include "cartographer/mapping/3d/submap_3d.h"
@@ -43,8 +42,7 @@ class MapBuilderContext : public MapBuilderContextInterface {
  public:
   MapBuilderContext(MapBuilderServer* map_builder_server);
   mapping::MapBuilderInterface& map_builder() override;
-  common::BlockingQueue<std::unique_ptr<MapBuilderContextInterface::Data>>&
-  sensor_data_queue() override;
+  MapBuilderContextInterface::SensorDataQueue& sensor_data_queue() override;
   mapping::TrajectoryBuilderInterface::LocalSlamResultCallback
   GetLocalSlamResultCallbackForSubscriptions() override;
   void AddSensorDataToTrajectory(const Data& sensor_data) override;
@@ -132,7 +130,7 @@ class MapBuilderServer : public MapBuilderServerInterface {
   std::unique_ptr<std::thread> slam_thread_;
   std::unique_ptr<async_grpc::Server> grpc_server_;
   std::unique_ptr<mapping::MapBuilderInterface> map_builder_;
-  common::BlockingQueue<std::unique_ptr<MapBuilderContextInterface::Data>>
+  std::unique_ptr<MapBuilderContextInterface::SensorDataQueue>
       incoming_data_queue_;
   absl::Mutex subscriptions_lock_;
   int current_subscription_index_ = 0;
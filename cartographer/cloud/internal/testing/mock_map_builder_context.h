@@ -30,10 +30,8 @@ namespace testing {
 class MockMapBuilderContext : public MapBuilderContextInterface {
  public:
   MOCK_METHOD0(map_builder, mapping::MapBuilderInterface &());
-  MOCK_METHOD0(
-      sensor_data_queue,
-      common::BlockingQueue<std::unique_ptr<MapBuilderContextInterface::Data>>
-          &());
+  MOCK_METHOD0(sensor_data_queue,
+               MapBuilderContextInterface::SensorDataQueue &());
   MOCK_METHOD0(GetLocalSlamResultCallbackForSubscriptions,
                mapping::TrajectoryBuilderInterface::LocalSlamResultCallback());
   MOCK_METHOD1(AddSensorDataToTrajectory,
@@ -0,0 +1,279 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "cartographer/cloud/proto/map_builder_service.pb.h"
+#include "cartographer/common/configuration_file_resolver.h"
+#include "cartographer/common/lua_parameter_dictionary.h"
+#include "cartographer/common/time.h"
+#include "cartographer/io/proto_stream.h"
+#include "cartographer/mapping/map_builder.h"
+#include "cartographer/mapping/pose_graph.h"
+#include "cartographer/mapping/trajectory_builder_interface.h"
+#include "cartographer/metrics/internal/recording_family_factory.h"
+#include "cartographer/metrics/register.h"
+#include "cartographer/sensor/fixed_frame_pose_data.h"
+#include "cartographer/sensor/imu_data.h"
+#include "cartographer/sensor/landmark_data.h"
+#include "cartographer/sensor/odometry_data.h"
+#include "cartographer/sensor/timed_point_cloud_data.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+DEFINE_string(configuration_directory, "",
+              "First directory in which configuration files are searched, "
+              "second is always the Cartographer installation to allow "
+              "including files from there.");
+DEFINE_string(configuration_basename, "",
+              "Basename, i.e. not containing any directory prefix, of the "
+              "configuration file. It must return a table with 'map_builder' "
+              "and 'trajectory_builder' entries, see map_builder_replay.lua.");
+DEFINE_string(sensor_data_filename, "",
+              "Proto stream of cartographer.cloud.proto.SensorData messages "
+              "in the order in which they were recorded.");
+DEFINE_double(backlog_sample_period, 1.,
+              "Wall clock period in seconds at which the size of the pose "
+              "graph work queue is sampled during the replay.");
+
+namespace cartographer {
+namespace cloud {
+namespace {
+
+using SensorId = mapping::TrajectoryBuilderInterface::SensorId;
+using SensorType = SensorId::SensorType;
+
+constexpr char kAddRangeDataLatencyMetricName[] =
+    "mapping_global_trajectory_builder_add_range_data_latency";
+
+struct ReplayOptions {
+  mapping::proto::MapBuilderOptions map_builder_options;
+  mapping::proto::TrajectoryBuilderOptions trajectory_builder_options;
+};
+
+ReplayOptions LoadReplayOptions(const std::string& configuration_directory,
+                                const std::string& configuration_basename) {
+  auto file_resolver = absl::make_unique<common::ConfigurationFileResolver>(
+      std::vector<std::string>{configuration_directory});
+  const std::string code =
+      file_resolver->GetFileContentOrDie(configuration_basename);
+  common::LuaParameterDictionary lua_parameter_dictionary(
+      code, std::move(file_resolver));
+  return ReplayOptions{
+      mapping::CreateMapBuilderOptions(
+          lua_parameter_dictionary.GetDictionary("map_builder").get()),
+      mapping::CreateTrajectoryBuilderOptions(
+          lua_parameter_dictionary.GetDictionary("trajectory_builder").get())};
+}
+
+SensorType GetSensorType(const proto::SensorData& sensor_data) {
+  switch (sensor_data.sensor_data_case()) {
+    case proto::SensorData::kOdometryData:
+      return SensorType::ODOMETRY;
+    case proto::SensorData::kImuData:
+      return SensorType::IMU;
+    case proto::SensorData::kTimedPointCloudData:
+      return SensorType::RANGE;
+    case proto::SensorData::kFixedFramePoseData:
+      return SensorType::FIXED_FRAME_POSE;
+    case proto::SensorData::kLandmarkData:
+      return SensorType::LANDMARK;
+    case proto::SensorData::kLocalSlamResultData:
+      return SensorType::LOCAL_SLAM_RESULT;
+    case proto::SensorData::SENSOR_DATA_NOT_SET:
+      break;
+  }
+  LOG(FATAL) << "Sensor data without payload: "
+             << sensor_data.sensor_metadata().DebugString();
+}
+
+// Returns the expected sensor ids of each recorded trajectory. Local SLAM
+// results cannot be replayed and are not expected.
+std::map<int, std::set<SensorId>> CollectSensorIds(
+    const std::string& sensor_data_filename) {
+  io::ProtoStreamReader reader(sensor_data_filename);
+  proto::SensorData sensor_data;
+  std::map<int, std::set<SensorId>> sensor_ids;
+  while (reader.ReadProto(&sensor_data)) {
+    const SensorType sensor_type = GetSensorType(sensor_data);
+    if (sensor_type == SensorType::LOCAL_SLAM_RESULT) {
+      continue;
+    }
+    sensor_ids[sensor_data.sensor_metadata().trajectory_id()].insert(
+        SensorId{sensor_type, sensor_data.sensor_metadata().sensor_id()});
+  }
+  return sensor_ids;
+}
+
+void AddSensorData(const proto::SensorData& sensor_data,
+                   mapping::TrajectoryBuilderInterface* trajectory_builder) {
+  const std::string& sensor_id = sensor_data.sensor_metadata().sensor_id();
+  switch (sensor_data.sensor_data_case()) {
+    case proto::SensorData::kOdometryData:
+      trajectory_builder->AddSensorData(
+          sensor_id, sensor::FromProto(sensor_data.odometry_data()));
+      return;
+    case proto::SensorData::kImuData:
+      trajectory_builder->AddSensorData(
+          sensor_id, sensor::FromProto(sensor_data.imu_data()));
+      return;
+    case proto::SensorData::kTimedPointCloudData:
+      trajectory_builder->AddSensorData(
+          sensor_id, sensor::FromProto(sensor_data.timed_point_cloud_data()));
+      return;
+    case proto::SensorData::kFixedFramePoseData:
+      trajectory_builder->AddSensorData(
+          sensor_id, sensor::FromProto(sensor_data.fixed_frame_pose_data()));
+      return;
+    case proto::SensorData::kLandmarkData:
+      trajectory_builder->AddSensorData(
+          sensor_id, sensor::FromProto(sensor_data.landmark_data()));
+      return;
+    case proto::SensorData::kLocalSlamResultData:
+    case proto::SensorData::SENSOR_DATA_NOT_SET:
+      break;
+  }
+  LOG(FATAL) << "Cannot replay sensor data: "
+             << sensor_data.sensor_metadata().DebugString();
+}
+
+void Run(const std::string& configuration_directory,
+         const std::string& configuration_basename,
+         const std::string& sensor_data_filename) {
+  ::cartographer::metrics::RecordingFamilyFactory registry;
+  ::cartographer::metrics::RegisterAllMetrics(&registry);
+  const ReplayOptions options =
+      LoadReplayOptions(configuration_directory, configuration_basename);
+  auto map_builder = mapping::CreateMapBuilder(options.map_builder_options);
+  mapping::PoseGraph* const pose_graph = CHECK_NOTNULL(
+      dynamic_cast<mapping::PoseGraph*>(map_builder->pose_graph()));
+
+  std::map<int /* recorded trajectory id */, int /* trajectory id */>
+      trajectory_ids;
+  for (const auto& entry : CollectSensorIds(sensor_data_filename)) {
+    trajectory_ids[entry.first] = map_builder->AddTrajectoryBuilder(
+        entry.second, options.trajectory_builder_options,
+        nullptr /* local_slam_result_callback */);
+  }
+  const ::cartographer::metrics::RecordingGauge* const work_queue_size =
+      CHECK_NOTNULL(registry.GetGauge(
+          options.map_builder_options.use_trajectory_builder_2d()
+              ? "mapping_2d_pose_graph_work_queue_size"
+              : "mapping_3d_pose_graph_work_queue_size",
+          {}));
+
+  LOG(INFO) << "Replaying sensor data from '" << sensor_data_filename
+            << "' into " << trajectory_ids.size() << " trajectories...";
+  io::ProtoStreamReader reader(sensor_data_filename);
+  proto::SensorData sensor_data;
+  int num_messages = 0;
+  int num_range_data = 0;
+  int num_skipped_local_slam_results = 0;
+  std::vector<std::pair<double /* wall time */, double /* size */>>
+      work_queue_sizes;
+  const auto start_time = std::chrono::steady_clock::now();
+  auto next_sample_time = start_time;
+  while (reader.ReadProto(&sensor_data)) {
+    if (GetSensorType(sensor_data) == SensorType::LOCAL_SLAM_RESULT) {
+      ++num_skipped_local_slam_results;
+      continue;
+    }
+    AddSensorData(sensor_data,
+                  map_builder->GetTrajectoryBuilder(trajectory_ids.at(
+                      sensor_data.sensor_metadata().trajectory_id())));
+    ++num_messages;
+    if (sensor_data.has_timed_point_cloud_data()) {
+      ++num_range_data;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= next_sample_time) {
+      work_queue_sizes.emplace_back(common::ToSeconds(now - start_time),
+                                    work_queue_size->Value());
+      next_sample_time += std::chrono::duration_cast<
+          std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(FLAGS_backlog_sample_period));
+    }
+  }
+  for (const auto& entry : trajectory_ids) {
+    map_builder->FinishTrajectory(entry.second);
+  }
+  const auto replay_end_time = std::chrono::steady_clock::now();
+  const double backlog_at_replay_end = work_queue_size->Value();
+  pose_graph->WaitForAllComputations();
+  const auto drain_end_time = std::chrono::steady_clock::now();
+  pose_graph->RunFinalOptimization();
+  const auto final_optimization_end_time = std::chrono::steady_clock::now();
+
+  const double replay_duration =
+      common::ToSeconds(replay_end_time - start_time);
+  LOG(INFO) << "Replayed " << num_messages << " messages, " << num_range_data
+            << " of them range data, in " << replay_duration << " s.";
+  if (num_skipped_local_slam_results > 0) {
+    LOG(WARNING) << "Skipped " << num_skipped_local_slam_results
+                 << " local SLAM results which cannot be replayed.";
+  }
+  LOG(INFO) << "Throughput: " << num_messages / replay_duration
+            << " messages/s, " << num_range_data / replay_duration
+            << " scans/s.";
+  const ::cartographer::metrics::RecordingHistogram* const latency =
+      CHECK_NOTNULL(registry.GetHistogram(kAddRangeDataLatencyMetricName, {}));
+  LOG(INFO) << "Local SLAM AddRangeData latency: p50 "
+            << 1e3 * latency->Percentile(0.5) << " ms, p99 "
+            << 1e3 * latency->Percentile(0.99) << " ms, max "
+            << 1e3 * latency->Percentile(1.) << " ms over "
+            << latency->Count() << " calls.";
+  for (const auto& sample : work_queue_sizes) {
+    LOG(INFO) << "Pose graph work queue size at " << sample.first
+              << " s: " << sample.second;
+  }
+  LOG(INFO) << "Pose graph work queue size at end of replay: "
+            << backlog_at_replay_end;
+  LOG(INFO) << "Draining the work queue took "
+            << common::ToSeconds(drain_end_time - replay_end_time) << " s.";
+  LOG(INFO) << "The final optimization took "
+            << common::ToSeconds(final_optimization_end_time - drain_end_time)
+            << " s.";
+}
+
+}  // namespace
+}  // namespace cloud
+}  // namespace cartographer
+
+int main(int argc, char** argv) {
+  google::InitGoogleLogging(argv[0]);
+  FLAGS_logtostderr = true;
+  google::SetUsageMessage(
+      "\n\n"
+      "This program replays recorded sensor data into a MapBuilder as fast as "
+      "possible and reports throughput, local SLAM latency and the pose graph "
+      "work queue backlog.\n");
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  if (FLAGS_configuration_directory.empty() ||
+      FLAGS_configuration_basename.empty() ||
+      FLAGS_sensor_data_filename.empty()) {
+    google::ShowUsageWithFlagsRestrict(argv[0], "map_builder_replay_main");
+    return EXIT_FAILURE;
+  }
+  cartographer::cloud::Run(FLAGS_configuration_directory,
+                           FLAGS_configuration_basename,
+                           FLAGS_sensor_data_filename);
+}
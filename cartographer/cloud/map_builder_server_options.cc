@@ -43,6 +43,10 @@ proto::MapBuilderServerOptions CreateMapBuilderServerOptions(
       lua_parameter_dictionary->GetBool("enable_ssl_encryption"));
   map_builder_server_options.set_enable_google_auth(
       lua_parameter_dictionary->GetBool("enable_google_auth"));
+  map_builder_server_options.set_incoming_data_queue_size(
+      lua_parameter_dictionary->GetNonNegativeInt("incoming_data_queue_size"));
+  map_builder_server_options.set_upload_queue_size(
+      lua_parameter_dictionary->GetNonNegativeInt("upload_queue_size"));
   return map_builder_server_options;
 }
 
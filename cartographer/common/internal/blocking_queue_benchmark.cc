@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+#include "cartographer/common/internal/blocking_queue.h"
+#include "cartographer/common/internal/lock_free_queue.h"
+
+namespace cartographer {
+namespace common {
+namespace {
+
+constexpr int kQueueSize = 1024;
+constexpr int kNumValues = 100000;
+
+// Measures the cost of an uncontended push and pop.
+template <typename Queue>
+void BM_PushPopUncontended(benchmark::State& state) {
+  Queue queue(kQueueSize);
+  auto value = absl::make_unique<int>(42);
+  for (auto _ : state) {
+    queue.Push(std::move(value));
+    value = queue.Pop();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_PushPopUncontended, BlockingQueue<std::unique_ptr<int>>);
+BENCHMARK_TEMPLATE(BM_PushPopUncontended, LockFreeQueue<std::unique_ptr<int>>);
+
+// Pushes 'kNumValues' values from 'state.range(0)' producer threads and pops
+// them on the benchmark thread, like the sensor data queues of the cloud
+// server and uploader.
+template <typename Queue>
+void BM_PushPop(benchmark::State& state) {
+  const int num_producers = state.range(0);
+  Queue queue(kQueueSize);
+  for (auto _ : state) {
+    std::vector<std::thread> producers;
+    for (int i = 0; i != num_producers; ++i) {
+      producers.emplace_back([&queue, num_producers]() {
+        for (int j = 0; j < kNumValues / num_producers; ++j) {
+          queue.Push(absl::make_unique<int>(j));
+        }
+      });
+    }
+    int64_t sum = 0;
+    for (int i = 0; i < kNumValues / num_producers * num_producers; ++i) {
+      sum += *queue.Pop();
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          (kNumValues / num_producers * num_producers));
+}
+BENCHMARK_TEMPLATE(BM_PushPop, BlockingQueue<std::unique_ptr<int>>)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_PushPop, LockFreeQueue<std::unique_ptr<int>>)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace common
+}  // namespace cartographer
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_COMMON_INTERNAL_LOCK_FREE_QUEUE_H_
+#define CARTOGRAPHER_COMMON_INTERNAL_LOCK_FREE_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "cartographer/common/time.h"
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace common {
+
+// A bounded queue with the interface of 'BlockingQueue' for any number of
+// producers and a single consumer. Values are kept in a ring buffer in which
+// each slot carries a sequence number, so 'Push' and 'Pop' only need atomic
+// operations as long as the queue is neither full nor empty. Threads which
+// have to block park on a mutex, which is only touched by the other side if
+// somebody is waiting.
+//
+// Only one thread may call 'Pop', 'PopWithTimeout', 'Peek' and
+// 'PeekWithTimeout'. 'T' must be movable and default constructible.
+template <typename T>
+class LockFreeQueue {
+ public:
+  // Constructs a queue which holds at least 'queue_size' values. The capacity
+  // is rounded up to the next power of two, and is at least two so that the
+  // sequence numbers of a full and an empty slot differ.
+  explicit LockFreeQueue(const size_t queue_size)
+      : capacity_(RoundUpToPowerOfTwo(queue_size)),
+        slots_(absl::make_unique<Slot[]>(capacity_)) {
+    CHECK_GT(queue_size, 0);
+    for (size_t i = 0; i != capacity_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  LockFreeQueue(const LockFreeQueue&) = delete;
+  LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+  // Pushes a value onto the queue. Blocks if the queue is full.
+  void Push(T t) {
+    const auto predicate = [this]() { return NotFull(); };
+    while (!PushIfNotFull(&t)) {
+      WaitUntil(predicate, absl::InfiniteFuture());
+    }
+    NotifyWaiters();
+  }
+
+  // Like push, but returns false if 'timeout' is reached.
+  bool PushWithTimeout(T t, const common::Duration timeout) {
+    const auto predicate = [this]() { return NotFull(); };
+    const absl::Time deadline = absl::Now() + absl::FromChrono(timeout);
+    while (!PushIfNotFull(&t)) {
+      if (!WaitUntil(predicate, deadline)) {
+        return false;
+      }
+    }
+    NotifyWaiters();
+    return true;
+  }
+
+  // Like push, but returns false instead of blocking if the queue is full.
+  bool TryPush(T t) {
+    if (!PushIfNotFull(&t)) {
+      return false;
+    }
+    NotifyWaiters();
+    return true;
+  }
+
+  // Pops the next value from the queue. Blocks until a value is available.
+  T Pop() {
+    const auto predicate = [this]() { return Front() != nullptr; };
+    T t;
+    while (!TryPop(&t)) {
+      WaitUntil(predicate, absl::InfiniteFuture());
+    }
+    NotifyWaiters();
+    return t;
+  }
+
+  // Like Pop, but can timeout. Returns nullptr in this case.
+  T PopWithTimeout(const common::Duration timeout) {
+    const auto predicate = [this]() { return Front() != nullptr; };
+    T t;
+    if (!TryPop(&t)) {
+      if (!WaitUntil(predicate, absl::Now() + absl::FromChrono(timeout))) {
+        return nullptr;
+      }
+      // There is a single consumer, so the value is still there.
+      CHECK(TryPop(&t));
+    }
+    NotifyWaiters();
+    return t;
+  }
+
+  // Like Peek, but can timeout. Returns nullptr in this case.
+  template <typename R>
+  R* PeekWithTimeout(const common::Duration timeout) {
+    const auto predicate = [this]() { return Front() != nullptr; };
+    if (Front() == nullptr &&
+        !WaitUntil(predicate, absl::Now() + absl::FromChrono(timeout))) {
+      return nullptr;
+    }
+    return Front()->get();
+  }
+
+  // Returns the next value in the queue or nullptr if the queue is empty.
+  // Maintains ownership. This assumes a member function get() that returns
+  // a pointer to the given type R.
+  template <typename R>
+  const R* Peek() {
+    const T* const front = Front();
+    if (front == nullptr) {
+      return nullptr;
+    }
+    return front->get();
+  }
+
+  // Returns the number of items currently in the queue. Values which are
+  // being pushed concurrently may already be counted.
+  size_t Size() {
+    const size_t pop_position = pop_position_.load(std::memory_order_acquire);
+    const size_t push_position = push_position_.load(std::memory_order_acquire);
+    return push_position - pop_position;
+  }
+
+  // Blocks until the queue is empty.
+  void WaitUntilEmpty() {
+    const auto predicate = [this]() { return Size() == 0; };
+    if (!predicate()) {
+      WaitUntil(predicate, absl::InfiniteFuture());
+    }
+  }
+
+ private:
+  struct Slot {
+    // Equal to the push position this slot is ready for, or that position
+    // plus one once the value has been written.
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t RoundUpToPowerOfTwo(const size_t n) {
+    size_t capacity = 2;
+    while (capacity < n) {
+      capacity *= 2;
+    }
+    return capacity;
+  }
+
+  // Moves '*t' into the queue and returns true, or returns false if the
+  // queue is full.
+  bool PushIfNotFull(T* const t) {
+    size_t position = push_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+      slot = &slots_[position & (capacity_ - 1)];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const intptr_t difference = static_cast<intptr_t>(sequence) -
+                                  static_cast<intptr_t>(position);
+      if (difference == 0) {
+        if (push_position_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = push_position_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value = std::move(*t);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Moves the next value into '*t' and returns true, or returns false if no
+  // value is available.
+  bool TryPop(T* const t) {
+    const size_t position = pop_position_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[position & (capacity_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+      return false;
+    }
+    *t = std::move(slot.value);
+    slot.value = T();
+    slot.sequence.store(position + capacity_, std::memory_order_release);
+    pop_position_.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool NotFull() { return Size() < capacity_; }
+
+  // Returns the next value without removing it, or nullptr.
+  T* Front() {
+    const size_t position = pop_position_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[position & (capacity_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+      return nullptr;
+    }
+    return &slot.value;
+  }
+
+  // Blocks until 'predicate' returns true or 'deadline' is reached, and
+  // returns the last value of 'predicate'. The waiter count is published
+  // before 'predicate' is evaluated under 'mutex_', so a concurrent change
+  // is either seen by 'predicate' or wakes this thread in 'NotifyWaiters'.
+  template <typename Predicate>
+  bool WaitUntil(const Predicate& predicate, const absl::Time deadline) {
+    absl::MutexLock lock(&mutex_);
+    num_waiters_.fetch_add(1, std::memory_order_seq_cst);
+    const bool result =
+        mutex_.AwaitWithDeadline(absl::Condition(&predicate), deadline);
+    num_waiters_.fetch_sub(1, std::memory_order_relaxed);
+    return result;
+  }
+
+  // Lets blocked threads re-evaluate their conditions after a value has been
+  // pushed or popped.
+  void NotifyWaiters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_waiters_.load(std::memory_order_relaxed) > 0) {
+      // Releasing the mutex makes waiters re-evaluate their conditions.
+      absl::MutexLock lock(&mutex_);
+    }
+  }
+
+  const size_t capacity_;
+  const std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<size_t> push_position_{0};
+  alignas(64) std::atomic<size_t> pop_position_{0};
+  alignas(64) std::atomic<int> num_waiters_{0};
+  absl::Mutex mutex_;
+};
+
+}  // namespace common
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_COMMON_INTERNAL_LOCK_FREE_QUEUE_H_
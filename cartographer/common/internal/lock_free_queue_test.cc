@@ -0,0 +1,186 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/common/internal/lock_free_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "cartographer/common/time.h"
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace common {
+namespace {
+
+TEST(LockFreeQueueTest, testPushPeekPop) {
+  LockFreeQueue<std::unique_ptr<int>> queue(4);
+  queue.Push(absl::make_unique<int>(42));
+  ASSERT_EQ(1, queue.Size());
+  queue.Push(absl::make_unique<int>(24));
+  ASSERT_EQ(2, queue.Size());
+  EXPECT_EQ(42, *queue.Peek<int>());
+  ASSERT_EQ(2, queue.Size());
+  EXPECT_EQ(42, *queue.Pop());
+  ASSERT_EQ(1, queue.Size());
+  EXPECT_EQ(24, *queue.Pop());
+  ASSERT_EQ(0, queue.Size());
+  EXPECT_EQ(nullptr, queue.Peek<int>());
+  ASSERT_EQ(0, queue.Size());
+}
+
+TEST(LockFreeQueueTest, testPushPopSharedPtr) {
+  LockFreeQueue<std::shared_ptr<int>> queue(2);
+  queue.Push(std::make_shared<int>(42));
+  queue.Push(std::make_shared<int>(24));
+  EXPECT_EQ(42, *queue.Pop());
+  EXPECT_EQ(24, *queue.Pop());
+}
+
+TEST(LockFreeQueueTest, testPopWithTimeout) {
+  LockFreeQueue<std::unique_ptr<int>> queue(1);
+  EXPECT_EQ(nullptr, queue.PopWithTimeout(common::FromMilliseconds(150)));
+  EXPECT_EQ(nullptr,
+            queue.PeekWithTimeout<int>(common::FromMilliseconds(150)));
+}
+
+TEST(LockFreeQueueTest, testPushWithTimeout) {
+  LockFreeQueue<std::unique_ptr<int>> queue(2);
+  EXPECT_EQ(true, queue.PushWithTimeout(absl::make_unique<int>(42),
+                                        common::FromMilliseconds(150)));
+  EXPECT_EQ(true, queue.PushWithTimeout(absl::make_unique<int>(24),
+                                        common::FromMilliseconds(150)));
+  EXPECT_EQ(false, queue.PushWithTimeout(absl::make_unique<int>(15),
+                                         common::FromMilliseconds(150)));
+  EXPECT_EQ(42, *queue.Pop());
+  EXPECT_EQ(24, *queue.Pop());
+  EXPECT_EQ(0, queue.Size());
+}
+
+TEST(LockFreeQueueTest, testTryPush) {
+  LockFreeQueue<std::unique_ptr<int>> queue(2);
+  EXPECT_EQ(true, queue.TryPush(absl::make_unique<int>(42)));
+  EXPECT_EQ(true, queue.TryPush(absl::make_unique<int>(24)));
+  EXPECT_EQ(false, queue.TryPush(absl::make_unique<int>(15)));
+  EXPECT_EQ(42, *queue.Pop());
+  EXPECT_EQ(true, queue.TryPush(absl::make_unique<int>(15)));
+  EXPECT_EQ(24, *queue.Pop());
+  EXPECT_EQ(15, *queue.Pop());
+  EXPECT_EQ(0, queue.Size());
+}
+
+TEST(LockFreeQueueTest, testWrapsAround) {
+  LockFreeQueue<std::unique_ptr<int>> queue(3);
+  for (int i = 0; i != 10; ++i) {
+    queue.Push(absl::make_unique<int>(i));
+    queue.Push(absl::make_unique<int>(i + 100));
+    EXPECT_EQ(i, *queue.Pop());
+    EXPECT_EQ(i + 100, *queue.Pop());
+  }
+  EXPECT_EQ(0, queue.Size());
+}
+
+TEST(LockFreeQueueTest, testBlockingPop) {
+  LockFreeQueue<std::unique_ptr<int>> queue(1);
+  ASSERT_EQ(0, queue.Size());
+
+  int pop = 0;
+
+  std::thread thread([&queue, &pop] { pop = *queue.Pop(); });
+
+  std::this_thread::sleep_for(common::FromMilliseconds(100));
+  queue.Push(absl::make_unique<int>(42));
+  thread.join();
+  ASSERT_EQ(0, queue.Size());
+  EXPECT_EQ(42, pop);
+}
+
+TEST(LockFreeQueueTest, testBlockingPeekWithTimeout) {
+  LockFreeQueue<std::unique_ptr<int>> queue(1);
+  int peek = 0;
+
+  std::thread thread([&queue, &peek] {
+    peek = *queue.PeekWithTimeout<int>(common::FromMilliseconds(2500));
+  });
+
+  std::this_thread::sleep_for(common::FromMilliseconds(100));
+  queue.Push(absl::make_unique<int>(42));
+  thread.join();
+  ASSERT_EQ(1, queue.Size());
+  EXPECT_EQ(42, peek);
+}
+
+TEST(LockFreeQueueTest, testBlockingPush) {
+  LockFreeQueue<std::unique_ptr<int>> queue(2);
+  queue.Push(absl::make_unique<int>(42));
+  queue.Push(absl::make_unique<int>(43));
+
+  std::thread thread([&queue] { queue.Push(absl::make_unique<int>(24)); });
+
+  std::this_thread::sleep_for(common::FromMilliseconds(100));
+  EXPECT_EQ(42, *queue.Pop());
+  EXPECT_EQ(43, *queue.Pop());
+  EXPECT_EQ(24, *queue.PopWithTimeout(common::FromMilliseconds(2500)));
+  thread.join();
+}
+
+TEST(LockFreeQueueTest, testWaitUntilEmpty) {
+  LockFreeQueue<std::unique_ptr<int>> queue(4);
+  queue.Push(absl::make_unique<int>(42));
+  queue.Push(absl::make_unique<int>(24));
+
+  std::thread thread([&queue] {
+    std::this_thread::sleep_for(common::FromMilliseconds(100));
+    queue.Pop();
+    queue.Pop();
+  });
+
+  queue.WaitUntilEmpty();
+  EXPECT_EQ(0, queue.Size());
+  thread.join();
+}
+
+TEST(LockFreeQueueTest, testMultipleProducers) {
+  constexpr int kNumProducers = 4;
+  constexpr int kNumValuesPerProducer = 10000;
+  LockFreeQueue<std::unique_ptr<int>> queue(16);
+  std::vector<std::thread> producers;
+  for (int i = 0; i != kNumProducers; ++i) {
+    producers.emplace_back([&queue, i] {
+      for (int j = 0; j != kNumValuesPerProducer; ++j) {
+        queue.Push(absl::make_unique<int>(i * kNumValuesPerProducer + j));
+      }
+    });
+  }
+
+  // Values of each producer arrive in the order in which they were pushed.
+  std::vector<int> next_value(kNumProducers, 0);
+  for (int i = 0; i != kNumProducers * kNumValuesPerProducer; ++i) {
+    const int value = *queue.Pop();
+    const int producer = value / kNumValuesPerProducer;
+    EXPECT_EQ(next_value[producer]++, value % kNumValuesPerProducer);
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(0, queue.Size());
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace cartographer
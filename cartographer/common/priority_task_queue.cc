@@ -0,0 +1,101 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/common/priority_task_queue.h"
+
+#include <iterator>
+
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace common {
+
+PriorityTaskQueue::PriorityTaskQueue(const int max_times_passed_over)
+    : max_times_passed_over_(max_times_passed_over) {
+  CHECK_GT(max_times_passed_over_, 0);
+}
+
+void PriorityTaskQueue::Push(std::shared_ptr<Task> task) {
+  const int priority = task->GetPriority();
+  CHECK_GE(priority, 0);
+  CHECK_LT(priority, Task::kNumPriorities);
+  const Task* const key = task.get();
+  std::list<std::shared_ptr<Task>>& tasks = buckets_[priority].tasks;
+  tasks.push_back(std::move(task));
+  CHECK(queued_tasks_.emplace(key, QueuedTask{priority, std::prev(tasks.end())})
+            .second);
+}
+
+bool PriorityTaskQueue::UpdatePriority(const Task* const task) {
+  const auto queued = queued_tasks_.find(task);
+  if (queued == queued_tasks_.end()) {
+    return false;
+  }
+  const int priority = task->GetPriority();
+  QueuedTask& queued_task = queued->second;
+  if (priority < queued_task.priority) {
+    std::list<std::shared_ptr<Task>>& tasks = buckets_[priority].tasks;
+    tasks.splice(tasks.end(), buckets_[queued_task.priority].tasks,
+                 queued_task.it);
+    queued_task.priority = priority;
+  }
+  return true;
+}
+
+std::shared_ptr<Task> PriorityTaskQueue::PopOldest() {
+  Bucket* const bucket = SelectBucket();
+  return Pop(bucket, bucket->tasks.begin());
+}
+
+std::shared_ptr<Task> PriorityTaskQueue::PopNewest() {
+  Bucket* const bucket = SelectBucket();
+  return Pop(bucket, std::prev(bucket->tasks.end()));
+}
+
+std::shared_ptr<Task> PriorityTaskQueue::Pop(
+    Bucket* const bucket, const std::list<std::shared_ptr<Task>>::iterator it) {
+  std::shared_ptr<Task> task = std::move(*it);
+  bucket->tasks.erase(it);
+  CHECK_EQ(queued_tasks_.erase(task.get()), 1);
+  return task;
+}
+
+PriorityTaskQueue::Bucket* PriorityTaskQueue::SelectBucket() {
+  CHECK(!empty());
+  // The most urgent non-empty bucket, unless a less urgent one is starving.
+  int selected = -1;
+  for (int i = 0; i != Task::kNumPriorities; ++i) {
+    if (buckets_[i].tasks.empty()) {
+      continue;
+    }
+    if (selected == -1) {
+      selected = i;
+    } else if (buckets_[i].times_passed_over >= max_times_passed_over_) {
+      selected = i;
+      break;
+    }
+  }
+  for (int i = selected + 1; i != Task::kNumPriorities; ++i) {
+    if (!buckets_[i].tasks.empty()) {
+      ++buckets_[i].times_passed_over;
+    }
+  }
+  buckets_[selected].times_passed_over = 0;
+  return &buckets_[selected];
+}
+
+}  // namespace common
+}  // namespace cartographer
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_COMMON_PRIORITY_TASK_QUEUE_H_
+#define CARTOGRAPHER_COMMON_PRIORITY_TASK_QUEUE_H_
+
+#include <array>
+#include <list>
+#include <memory>
+
+#include "absl/container/flat_hash_map.h"
+#include "cartographer/common/task.h"
+
+namespace cartographer {
+namespace common {
+
+// Queue of ready tasks used by the thread pools, bucketed by
+// 'Task::Priority'. Tasks are taken from the most urgent non-empty bucket,
+// except that a bucket which has been passed over 'max_times_passed_over'
+// times is served next, so that less urgent tasks are delayed by a bounded
+// number of tasks. Not thread-safe.
+class PriorityTaskQueue {
+ public:
+  // Used by the thread pools.
+  static constexpr int kDefaultMaxTimesPassedOver = 8;
+
+  explicit PriorityTaskQueue(int max_times_passed_over);
+
+  bool empty() const { return queued_tasks_.empty(); }
+  size_t size() const { return queued_tasks_.size(); }
+
+  void Push(std::shared_ptr<Task> task);
+
+  // Moves 'task' to the bucket of its 'GetPriority()' if it is queued in a
+  // less urgent one, after it inherited a more urgent priority. Returns false
+  // if 'task' is not queued here. Takes constant time.
+  bool UpdatePriority(const Task* task);
+
+  // Removes and returns the oldest task of the selected bucket. Must not be
+  // empty.
+  std::shared_ptr<Task> PopOldest();
+
+  // Removes and returns the newest task of the selected bucket. Must not be
+  // empty.
+  std::shared_ptr<Task> PopNewest();
+
+ private:
+  struct Bucket {
+    std::list<std::shared_ptr<Task>> tasks;
+    int times_passed_over = 0;
+  };
+
+  struct QueuedTask {
+    int priority;
+    std::list<std::shared_ptr<Task>>::iterator it;
+  };
+
+  // Returns the bucket to take the next task from and updates the starvation
+  // counters of the other buckets.
+  Bucket* SelectBucket();
+
+  // Removes and returns the task at 'it' of 'bucket'.
+  std::shared_ptr<Task> Pop(Bucket* bucket,
+                            std::list<std::shared_ptr<Task>>::iterator it);
+
+  const int max_times_passed_over_;
+  std::array<Bucket, Task::kNumPriorities> buckets_;
+  // Where each queued task is, so that 'UpdatePriority' does not search.
+  absl::flat_hash_map<const Task*, QueuedTask> queued_tasks_;
+};
+
+}  // namespace common
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_COMMON_PRIORITY_TASK_QUEUE_H_
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/common/priority_task_queue.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace common {
+namespace {
+
+std::shared_ptr<Task> CreateTask(const Task::Priority priority) {
+  auto task = std::make_shared<Task>();
+  task->SetPriority(priority);
+  return task;
+}
+
+TEST(PriorityTaskQueueTest, PopsMostUrgentFirst) {
+  PriorityTaskQueue queue(100 /* max_times_passed_over */);
+  const auto background = CreateTask(Task::BACKGROUND);
+  const auto constraint_search = CreateTask(Task::CONSTRAINT_SEARCH);
+  const auto optimization = CreateTask(Task::OPTIMIZATION);
+  const auto realtime = CreateTask(Task::REALTIME);
+  queue.Push(background);
+  queue.Push(constraint_search);
+  queue.Push(optimization);
+  queue.Push(realtime);
+  EXPECT_EQ(queue.size(), 4);
+  EXPECT_EQ(queue.PopOldest(), realtime);
+  EXPECT_EQ(queue.PopOldest(), optimization);
+  EXPECT_EQ(queue.PopOldest(), constraint_search);
+  EXPECT_EQ(queue.PopOldest(), background);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(PriorityTaskQueueTest, OldestAndNewestWithinPriority) {
+  PriorityTaskQueue queue(100 /* max_times_passed_over */);
+  const auto first = CreateTask(Task::CONSTRAINT_SEARCH);
+  const auto second = CreateTask(Task::CONSTRAINT_SEARCH);
+  const auto third = CreateTask(Task::CONSTRAINT_SEARCH);
+  queue.Push(first);
+  queue.Push(second);
+  queue.Push(third);
+  EXPECT_EQ(queue.PopNewest(), third);
+  EXPECT_EQ(queue.PopOldest(), first);
+  EXPECT_EQ(queue.PopOldest(), second);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(PriorityTaskQueueTest, UpdatePriorityMovesTaskToMoreUrgentBucket) {
+  PriorityTaskQueue queue(100 /* max_times_passed_over */);
+  const auto first = CreateTask(Task::BACKGROUND);
+  const auto second = CreateTask(Task::BACKGROUND);
+  const auto optimization = CreateTask(Task::OPTIMIZATION);
+  queue.Push(first);
+  queue.Push(second);
+  queue.Push(optimization);
+  second->SetPriority(Task::REALTIME);
+  EXPECT_TRUE(queue.UpdatePriority(second.get()));
+  EXPECT_TRUE(queue.UpdatePriority(first.get()));
+  const auto not_queued = CreateTask(Task::REALTIME);
+  EXPECT_FALSE(queue.UpdatePriority(not_queued.get()));
+  EXPECT_EQ(queue.size(), 3);
+  EXPECT_EQ(queue.PopOldest(), second);
+  EXPECT_EQ(queue.PopOldest(), optimization);
+  EXPECT_EQ(queue.PopNewest(), first);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_FALSE(queue.UpdatePriority(second.get()));
+}
+
+TEST(PriorityTaskQueueTest, LessUrgentTasksDoNotStarve) {
+  constexpr int kMaxTimesPassedOver = 3;
+  PriorityTaskQueue queue(kMaxTimesPassedOver);
+  const auto background = CreateTask(Task::BACKGROUND);
+  queue.Push(background);
+  std::vector<std::shared_ptr<Task>> popped;
+  for (int i = 0; i < 10; ++i) {
+    queue.Push(CreateTask(Task::REALTIME));
+    popped.push_back(queue.PopOldest());
+  }
+  int background_index = -1;
+  for (int i = 0; i < static_cast<int>(popped.size()); ++i) {
+    if (popped[i] == background) background_index = i;
+  }
+  EXPECT_EQ(background_index, kMaxTimesPassedOver);
+  EXPECT_EQ(queue.size(), 1);
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace cartographer
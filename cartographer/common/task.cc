@@ -16,90 +16,156 @@
 
 #include "cartographer/common/task.h"
 
+#include "cartographer/common/thread_pool.h"
+
 namespace cartographer {
 namespace common {
 
 Task::~Task() {
   // TODO(gaschler): Relax some checks after testing.
-  if (state_ != NEW && state_ != COMPLETED) {
+  const State state = GetState();
+  if (state != NEW && state != COMPLETED) {
     LOG(WARNING) << "Delete Task between dispatch and completion.";
   }
 }
 
-Task::State Task::GetState() {
-  absl::MutexLock locker(&mutex_);
-  return state_;
+Task::DependentLink* Task::CompletedMarker() {
+  static DependentLink completed_marker{nullptr, nullptr, {}};
+  return &completed_marker;
 }
 
 void Task::SetWorkItem(const WorkItem& work_item) {
-  absl::MutexLock locker(&mutex_);
-  CHECK_EQ(state_, NEW);
+  CHECK_EQ(GetState(), NEW);
   work_item_ = work_item;
 }
 
+void Task::SetPriority(const Priority priority) {
+  CHECK_EQ(GetState(), NEW);
+  priority_ = priority;
+}
+
+void Task::SetLabel(const std::string& label) {
+  CHECK_EQ(GetState(), NEW);
+  label_ = label;
+}
+
 void Task::AddDependency(std::weak_ptr<Task> dependency) {
-  std::shared_ptr<Task> shared_dependency;
-  {
-    absl::MutexLock locker(&mutex_);
-    CHECK_EQ(state_, NEW);
-    if ((shared_dependency = dependency.lock())) {
-      ++uncompleted_dependencies_;
-    }
-  }
+  CHECK_EQ(GetState(), NEW);
+  std::shared_ptr<Task> shared_dependency = dependency.lock();
   if (shared_dependency) {
-    shared_dependency->AddDependentTask(this);
+    uncompleted_dependencies_.fetch_add(1, std::memory_order_relaxed);
+    DependentLink* const link = AddDependencyLink();
+    *link = DependentLink{this, nullptr, dependency};
+    shared_dependency->AddDependentTask(link);
   }
 }
 
+Task::DependentLink* Task::AddDependencyLink() {
+  if (num_dependency_links_ < kNumInlineDependencies) {
+    return &dependency_links_[num_dependency_links_++];
+  }
+  overflow_dependency_links_.emplace_front();
+  return &overflow_dependency_links_.front();
+}
+
 void Task::SetThreadPool(ThreadPoolInterface* thread_pool) {
-  absl::MutexLock locker(&mutex_);
-  CHECK_EQ(state_, NEW);
-  state_ = DISPATCHED;
+  CHECK_EQ(GetState(), NEW);
+  CHECK(thread_pool);
   thread_pool_to_notify_ = thread_pool;
-  if (uncompleted_dependencies_ == 0) {
-    state_ = DEPENDENCIES_COMPLETED;
-    CHECK(thread_pool_to_notify_);
+  // Sequentially consistent, so that a concurrent 'InheritPriority()' either
+  // sees this state or its priority is seen below.
+  state_.store(DISPATCHED);
+  RaiseDependencyPriorities();
+  ReleaseDependency();
+}
+
+void Task::AddDependentTask(DependentLink* const link) {
+  DependentLink* head = dependents_.load(std::memory_order_acquire);
+  do {
+    if (head == CompletedMarker()) {
+      link->dependent_task->OnDependenyCompleted();
+      return;
+    }
+    link->next = head;
+  } while (!dependents_.compare_exchange_weak(head, link,
+                                              std::memory_order_acq_rel,
+                                              std::memory_order_acquire));
+}
+
+void Task::OnDependenyCompleted() {
+  const State state = GetState();
+  CHECK(state == NEW || state == DISPATCHED);
+  ReleaseDependency();
+}
+
+void Task::ReleaseDependency() {
+  if (uncompleted_dependencies_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    dependencies_completed_time_ = std::chrono::steady_clock::now();
+    state_.store(DEPENDENCIES_COMPLETED, std::memory_order_release);
     thread_pool_to_notify_->NotifyDependenciesCompleted(this);
   }
 }
 
-void Task::AddDependentTask(Task* dependent_task) {
-  absl::MutexLock locker(&mutex_);
-  if (state_ == COMPLETED) {
-    dependent_task->OnDependenyCompleted();
-    return;
+void Task::InheritPriority(const Priority priority) {
+  Priority inherited_priority = inherited_priority_.load();
+  do {
+    if (inherited_priority <= priority) {
+      return;
+    }
+  } while (
+      !inherited_priority_.compare_exchange_weak(inherited_priority, priority));
+  switch (state_.load()) {
+    case NEW:
+      // Its dependencies are raised when it is dispatched.
+      break;
+    case DISPATCHED:
+      RaiseDependencyPriorities();
+      break;
+    case DEPENDENCIES_COMPLETED:
+      thread_pool_to_notify_->NotifyPriorityRaised(this);
+      break;
+    case RUNNING:
+    case COMPLETED:
+      break;
   }
-  bool inserted = dependent_tasks_.insert(dependent_task).second;
-  CHECK(inserted) << "Given dependency is already a dependency.";
 }
 
-void Task::OnDependenyCompleted() {
-  absl::MutexLock locker(&mutex_);
-  CHECK(state_ == NEW || state_ == DISPATCHED);
-  --uncompleted_dependencies_;
-  if (uncompleted_dependencies_ == 0 && state_ == DISPATCHED) {
-    state_ = DEPENDENCIES_COMPLETED;
-    CHECK(thread_pool_to_notify_);
-    thread_pool_to_notify_->NotifyDependenciesCompleted(this);
+void Task::RaiseDependencyPriorities() {
+  const Priority priority = GetPriority();
+  if (priority == BACKGROUND) {
+    return;
+  }
+  const auto raise = [priority](const DependentLink& link) {
+    if (std::shared_ptr<Task> dependency = link.dependency.lock()) {
+      dependency->InheritPriority(priority);
+    }
+  };
+  for (int i = 0; i != num_dependency_links_; ++i) {
+    raise(dependency_links_[i]);
+  }
+  for (const DependentLink& link : overflow_dependency_links_) {
+    raise(link);
   }
 }
 
 void Task::Execute() {
-  {
-    absl::MutexLock locker(&mutex_);
-    CHECK_EQ(state_, DEPENDENCIES_COMPLETED);
-    state_ = RUNNING;
-  }
+  CHECK_EQ(GetState(), DEPENDENCIES_COMPLETED);
+  state_.store(RUNNING, std::memory_order_release);
 
   // Execute the work item.
   if (work_item_) {
     work_item_();
   }
 
-  absl::MutexLock locker(&mutex_);
-  state_ = COMPLETED;
-  for (Task* dependent_task : dependent_tasks_) {
-    dependent_task->OnDependenyCompleted();
+  state_.store(COMPLETED, std::memory_order_release);
+  DependentLink* link =
+      dependents_.exchange(CompletedMarker(), std::memory_order_acq_rel);
+  while (link != nullptr) {
+    // Read 'next' first, the dependent task may be destroyed as soon as it is
+    // notified.
+    DependentLink* const next = link->next;
+    link->dependent_task->OnDependenyCompleted();
+    link = next;
   }
 }
 
@@ -17,57 +17,140 @@
 #ifndef CARTOGRAPHER_COMMON_TASK_H_
 #define CARTOGRAPHER_COMMON_TASK_H_
 
-#include <set>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <forward_list>
+#include <functional>
+#include <memory>
+#include <string>
 
-#include "absl/synchronization/mutex.h"
 #include "glog/logging.h"
-#include "thread_pool.h"
 
 namespace cartographer {
 namespace common {
 
 class ThreadPoolInterface;
 
+// A unit of work with dependencies on other tasks. Dependency tracking is
+// lock-free: each task counts its uncompleted dependencies atomically and
+// keeps the tasks depending on it in an intrusive list of links which are
+// owned by the dependent tasks.
 class Task {
  public:
   friend class ThreadPoolInterface;
 
   using WorkItem = std::function<void()>;
   enum State { NEW, DISPATCHED, DEPENDENCIES_COMPLETED, RUNNING, COMPLETED };
+  // Scheduling classes, from most to least urgent. Thread pools run ready
+  // tasks of a more urgent class first, but do not starve the other classes.
+  // A task inherits the priority of the most urgent dispatched task depending
+  // on it, directly or indirectly, so that urgent work never waits for a
+  // dependency queued behind less urgent work.
+  enum Priority { REALTIME, OPTIMIZATION, CONSTRAINT_SEARCH, BACKGROUND };
+  static constexpr int kNumPriorities = BACKGROUND + 1;
+  // Most tasks have at most this many dependencies.
+  static constexpr int kNumInlineDependencies = 2;
 
   Task() = default;
   ~Task();
 
-  State GetState() LOCKS_EXCLUDED(mutex_);
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
 
-  // State must be 'NEW'.
-  void SetWorkItem(const WorkItem& work_item) LOCKS_EXCLUDED(mutex_);
+  State GetState() const { return state_.load(std::memory_order_acquire); }
+
+  // State must be 'NEW'. Must not be called concurrently with other calls
+  // that require the 'NEW' state.
+  void SetWorkItem(const WorkItem& work_item);
 
   // State must be 'NEW'. 'dependency' may be nullptr, in which case it is
-  // assumed completed.
-  void AddDependency(std::weak_ptr<Task> dependency) LOCKS_EXCLUDED(mutex_);
+  // assumed completed. The same dependency may be added more than once, the
+  // task then waits for it only once. Does not allocate for the first
+  // 'kNumInlineDependencies' dependencies. Must not be called concurrently
+  // with other calls that require the 'NEW' state.
+  void AddDependency(std::weak_ptr<Task> dependency);
+
+  // State must be 'NEW'. Defaults to 'BACKGROUND'.
+  void SetPriority(Priority priority);
+
+  // Returns the more urgent of the priority set by 'SetPriority()' and the
+  // one inherited from dependent tasks. Once the task is scheduled, it can
+  // only become more urgent.
+  Priority GetPriority() const {
+    return std::min(priority_, inherited_priority_.load());
+  }
+
+  // State must be 'NEW'. Names the kind of work, e.g. "constraint_2d", for
+  // the thread pool metrics. Tasks without a label are reported as
+  // "unlabeled".
+  void SetLabel(const std::string& label);
+
+  const std::string& GetLabel() const { return label_; }
 
  private:
-  // Allowed in all states.
-  void AddDependentTask(Task* dependent_task);
+  // Entry in the list of dependents of a task, owned by the dependent task.
+  struct DependentLink {
+    Task* dependent_task;
+    DependentLink* next;
+    // The task this link was added to, for passing on priorities.
+    std::weak_ptr<Task> dependency;
+  };
+
+  // Sentinel for 'dependents_' of a 'COMPLETED' task.
+  static DependentLink* CompletedMarker();
+
+  // Allowed in all states. Notifies 'link->dependent_task' immediately if
+  // this task is already 'COMPLETED'.
+  void AddDependentTask(DependentLink* link);
 
   // State must be 'DEPENDENCIES_COMPLETED' and becomes 'COMPLETED'.
-  void Execute() LOCKS_EXCLUDED(mutex_);
+  void Execute();
 
   // State must be 'NEW' and becomes 'DISPATCHED' or 'DEPENDENCIES_COMPLETED'.
-  void SetThreadPool(ThreadPoolInterface* thread_pool) LOCKS_EXCLUDED(mutex_);
+  void SetThreadPool(ThreadPoolInterface* thread_pool);
 
   // State must be 'NEW' or 'DISPATCHED'. If 'DISPATCHED', may become
   // 'DEPENDENCIES_COMPLETED'.
   void OnDependenyCompleted();
 
-  WorkItem work_item_ GUARDED_BY(mutex_);
-  ThreadPoolInterface* thread_pool_to_notify_ GUARDED_BY(mutex_) = nullptr;
-  State state_ GUARDED_BY(mutex_) = NEW;
-  unsigned int uncompleted_dependencies_ GUARDED_BY(mutex_) = 0;
-  std::set<Task*> dependent_tasks_ GUARDED_BY(mutex_);
-
-  absl::Mutex mutex_;
+  // Drops one reference from 'uncompleted_dependencies_' and hands the task
+  // to 'thread_pool_to_notify_' when it was the last.
+  void ReleaseDependency();
+
+  // Makes the task at least as urgent as 'priority'. A dispatched task passes
+  // this on to its dependencies, a queued one is moved by its thread pool.
+  void InheritPriority(Priority priority);
+
+  // State must not be 'NEW'. Passes 'GetPriority()' on to all dependencies.
+  void RaiseDependencyPriorities();
+
+  // Returns storage for a new link in 'dependency_links_' or
+  // 'overflow_dependency_links_'.
+  DependentLink* AddDependencyLink();
+
+  WorkItem work_item_;
+  ThreadPoolInterface* thread_pool_to_notify_ = nullptr;
+  std::atomic<State> state_{NEW};
+  Priority priority_ = BACKGROUND;
+  std::atomic<Priority> inherited_priority_{BACKGROUND};
+  std::string label_ = "unlabeled";
+  // When the state became 'DEPENDENCIES_COMPLETED'.
+  std::chrono::steady_clock::time_point dependencies_completed_time_;
+  // Starts at one for the reference held until 'SetThreadPool()', so that
+  // dependencies completing before dispatch cannot make the task ready.
+  std::atomic<int> uncompleted_dependencies_{1};
+  // Head of the list of dependents, or 'CompletedMarker()' once this task is
+  // 'COMPLETED'.
+  std::atomic<DependentLink*> dependents_{nullptr};
+  // Links of this task into the dependent lists of its dependencies, which
+  // must keep their addresses. The first ones are stored inline, so that
+  // creating a task with few dependencies does not allocate, the others in a
+  // list which does not allocate while empty.
+  std::array<DependentLink, kNumInlineDependencies> dependency_links_;
+  int num_dependency_links_ = 0;
+  std::forward_list<DependentLink> overflow_dependency_links_;
 };
 
 }  // namespace common
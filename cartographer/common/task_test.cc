@@ -16,14 +16,55 @@
 
 #include "cartographer/common/task.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <map>
 #include <memory>
+#include <new>
 #include <queue>
+#include <random>
+#include <thread>
+#include <vector>
 
+#include "absl/base/attributes.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "cartographer/common/thread_pool.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+namespace {
+
+// Number of heap allocations made by the current thread while
+// 'count_allocations' is set.
+thread_local bool count_allocations = false;
+thread_local int num_allocations = 0;
+
+}  // namespace
+
+// Not inlined, so that the compiler does not mistake freeing the memory for
+// freeing memory that was not allocated with malloc().
+ABSL_ATTRIBUTE_NOINLINE void* operator new(std::size_t size) {
+  if (count_allocations) {
+    ++num_allocations;
+  }
+  void* const ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+ABSL_ATTRIBUTE_NOINLINE void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+ABSL_ATTRIBUTE_NOINLINE void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
 namespace cartographer {
 namespace common {
 namespace {
@@ -182,6 +223,134 @@ TEST_F(TaskTest, RunWithCompletedDependency) {
   EXPECT_EQ(shared_b->GetState(), Task::COMPLETED);
 }
 
+TEST_F(TaskTest, RunWithSameDependencyTwice) {
+  auto a = absl::make_unique<Task>();
+  MockCallback callback_a;
+  a->SetWorkItem([&callback_a]() { callback_a.Run(); });
+  auto shared_a = thread_pool()->Schedule(std::move(a)).lock();
+  auto b = absl::make_unique<Task>();
+  MockCallback callback_b;
+  b->SetWorkItem([&callback_b]() { callback_b.Run(); });
+  b->AddDependency(shared_a);
+  b->AddDependency(shared_a);
+  auto shared_b = thread_pool()->Schedule(std::move(b)).lock();
+  EXPECT_EQ(shared_b->GetState(), Task::DISPATCHED);
+  EXPECT_CALL(callback_a, Run()).Times(1);
+  thread_pool()->RunNext();
+  EXPECT_EQ(shared_b->GetState(), Task::DEPENDENCIES_COMPLETED);
+  EXPECT_CALL(callback_b, Run()).Times(1);
+  thread_pool()->RunNext();
+  EXPECT_TRUE(thread_pool()->IsEmpty());
+}
+
+TEST_F(TaskTest, RunWithManyDependencies) {
+  constexpr int kNumDependencies = 2 * Task::kNumInlineDependencies + 1;
+  std::vector<std::shared_ptr<Task>> dependencies;
+  MockCallback callback_dependency;
+  for (int i = 0; i != kNumDependencies; ++i) {
+    auto dependency = absl::make_unique<Task>();
+    dependency->SetWorkItem(
+        [&callback_dependency]() { callback_dependency.Run(); });
+    dependencies.push_back(
+        thread_pool()->Schedule(std::move(dependency)).lock());
+  }
+  auto task = absl::make_unique<Task>();
+  MockCallback callback;
+  task->SetWorkItem([&callback]() { callback.Run(); });
+  for (const auto& dependency : dependencies) {
+    task->AddDependency(dependency);
+  }
+  auto shared_task = thread_pool()->Schedule(std::move(task)).lock();
+  EXPECT_CALL(callback_dependency, Run()).Times(kNumDependencies);
+  for (int i = 0; i != kNumDependencies; ++i) {
+    EXPECT_EQ(shared_task->GetState(), Task::DISPATCHED);
+    thread_pool()->RunNext();
+  }
+  EXPECT_EQ(shared_task->GetState(), Task::DEPENDENCIES_COMPLETED);
+  EXPECT_CALL(callback, Run()).Times(1);
+  thread_pool()->RunNext();
+  EXPECT_TRUE(thread_pool()->IsEmpty());
+}
+
+TEST(TaskAllocationTest, FewDependenciesDoNotAllocate) {
+  auto dependency_a = std::make_shared<Task>();
+  auto dependency_b = std::make_shared<Task>();
+  count_allocations = true;
+  num_allocations = 0;
+  {
+    Task task;
+    task.AddDependency(dependency_a);
+    task.AddDependency(dependency_b);
+  }
+  count_allocations = false;
+  EXPECT_EQ(num_allocations, 0);
+}
+
+// Producers concurrently schedule tasks depending on random earlier tasks,
+// many of which are running or completing at the same time.
+TEST(TaskStressTest, ConcurrentDependencies) {
+  constexpr int kNumProducers = 4;
+  constexpr int kNumTasksPerProducer = 2000;
+  constexpr int kNumTasks = kNumProducers * kNumTasksPerProducer;
+  constexpr int kMaxNumDependencies = 5;
+  std::vector<std::atomic<bool>> completed(kNumTasks);
+  for (auto& task_completed : completed) task_completed = false;
+  std::atomic<int> num_ordering_violations(0);
+  absl::Mutex mutex;
+  int num_completed = 0;
+  std::vector<std::pair<int, std::weak_ptr<Task>>> scheduled_tasks;
+  {
+    ThreadPool thread_pool(8);
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer != kNumProducers; ++producer) {
+      producers.emplace_back([&, producer]() {
+        std::mt19937 prng(42 + producer);
+        for (int i = 0; i != kNumTasksPerProducer; ++i) {
+          const int id = producer * kNumTasksPerProducer + i;
+          auto task = absl::make_unique<Task>();
+          std::vector<int> dependency_ids;
+          {
+            absl::MutexLock locker(&mutex);
+            if (!scheduled_tasks.empty()) {
+              std::uniform_int_distribution<int> distribution(
+                  0, scheduled_tasks.size() - 1);
+              for (int j = 0; j != kMaxNumDependencies; ++j) {
+                const auto& dependency = scheduled_tasks[distribution(prng)];
+                if (std::find(dependency_ids.begin(), dependency_ids.end(),
+                              dependency.first) != dependency_ids.end()) {
+                  continue;
+                }
+                dependency_ids.push_back(dependency.first);
+                task->AddDependency(dependency.second);
+              }
+            }
+          }
+          task->SetWorkItem([&, id, dependency_ids]() {
+            for (const int dependency_id : dependency_ids) {
+              if (!completed[dependency_id]) ++num_ordering_violations;
+            }
+            completed[id] = true;
+            absl::MutexLock locker(&mutex);
+            ++num_completed;
+          });
+          auto handle = thread_pool.Schedule(std::move(task));
+          absl::MutexLock locker(&mutex);
+          scheduled_tasks.emplace_back(id, handle);
+        }
+      });
+    }
+    for (std::thread& producer : producers) {
+      producer.join();
+    }
+    const auto all_completed = [&num_completed]() {
+      return num_completed == kNumTasks;
+    };
+    absl::MutexLock locker(&mutex);
+    mutex.Await(absl::Condition(&all_completed));
+  }
+  EXPECT_EQ(num_ordering_violations, 0);
+}
+
 }  // namespace
 }  // namespace common
 }  // namespace cartographer
@@ -20,23 +20,110 @@
 #include <unistd.h>
 #endif
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <numeric>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "cartographer/common/task.h"
+#include "cartographer/common/time.h"
 #include "glog/logging.h"
 
 namespace cartographer {
 namespace common {
 
-void ThreadPoolInterface::Execute(Task* task) { task->Execute(); }
+static auto* kQueueLengthFamily = metrics::Family<metrics::Gauge>::Null();
+static auto* kTaskWaitTimeFamily = metrics::Family<metrics::Histogram>::Null();
+static auto* kTaskRunTimeFamily = metrics::Family<metrics::Histogram>::Null();
+
+namespace {
+
+struct TaskMetrics {
+  metrics::Histogram* wait_time;
+  metrics::Histogram* run_time;
+};
+
+// Serializes registering the families and adding metrics to them.
+absl::Mutex task_metrics_mutex;
+// Incremented by RegisterMetrics() to invalidate the cached metrics.
+std::atomic<int> task_metrics_generation{0};
+
+// Looks up the metrics of each label once per thread, so that running a task
+// does not contend on a lock shared by all threads of all pools.
+TaskMetrics GetOrCreateTaskMetrics(const std::string& label) {
+  thread_local int cached_generation = -1;
+  thread_local absl::flat_hash_map<std::string, TaskMetrics> cached_metrics;
+  const int generation = task_metrics_generation.load();
+  if (cached_generation != generation) {
+    cached_metrics.clear();
+    cached_generation = generation;
+  }
+  auto it = cached_metrics.find(label);
+  if (it == cached_metrics.end()) {
+    absl::MutexLock locker(&task_metrics_mutex);
+    it = cached_metrics
+             .emplace(label,
+                      TaskMetrics{kTaskWaitTimeFamily->Add({{"task", label}}),
+                                  kTaskRunTimeFamily->Add({{"task", label}})})
+             .first;
+  }
+  return it->second;
+}
+
+}  // namespace
+
+void ThreadPoolInterface::RegisterMetrics(
+    metrics::FamilyFactory* family_factory) {
+  const auto boundaries = metrics::Histogram::ScaledPowersOf(2, 1e-5, 100.);
+  absl::MutexLock locker(&task_metrics_mutex);
+  kQueueLengthFamily = family_factory->NewGaugeFamily(
+      "common_thread_pool_queue_length",
+      "Number of tasks waiting for a thread");
+  kTaskWaitTimeFamily = family_factory->NewHistogramFamily(
+      "common_thread_pool_task_wait_time",
+      "Time in seconds from completed dependencies to task start",
+      boundaries);
+  kTaskRunTimeFamily = family_factory->NewHistogramFamily(
+      "common_thread_pool_task_run_time", "Task run time in seconds",
+      boundaries);
+  task_metrics_generation.fetch_add(1);
+}
+
+ThreadPoolInterface::ThreadPoolInterface(const std::string& name)
+    : queue_length_metric_([&name]() {
+        absl::MutexLock locker(&task_metrics_mutex);
+        return kQueueLengthFamily->Add({{"pool", name}});
+      }()) {}
+
+void ThreadPoolInterface::Execute(Task* task) {
+  const auto start_time = std::chrono::steady_clock::now();
+  const TaskMetrics task_metrics = GetOrCreateTaskMetrics(task->GetLabel());
+  task_metrics.wait_time->Observe(
+      ToSeconds(start_time - task->dependencies_completed_time_));
+  task->Execute();
+  task_metrics.run_time->Observe(
+      ToSeconds(std::chrono::steady_clock::now() - start_time));
+}
+
+void ThreadPoolInterface::IncrementQueueLengthMetric() {
+  queue_length_metric_->Increment();
+}
+
+void ThreadPoolInterface::DecrementQueueLengthMetric() {
+  queue_length_metric_->Decrement();
+}
 
 void ThreadPoolInterface::SetThreadPool(Task* task) {
   task->SetThreadPool(this);
 }
 
-ThreadPool::ThreadPool(int num_threads) {
+ThreadPool::ThreadPool(int num_threads, const std::string& name,
+                       const bool lower_thread_priority)
+    : ThreadPoolInterface(name),
+      lower_thread_priority_(lower_thread_priority),
+      task_queue_(PriorityTaskQueue::kDefaultMaxTimesPassedOver) {
   CHECK_GT(num_threads, 0) << "ThreadPool requires a positive num_threads!";
   absl::MutexLock locker(&mutex_);
   for (int i = 0; i != num_threads; ++i) {
@@ -59,10 +146,16 @@ void ThreadPool::NotifyDependenciesCompleted(Task* task) {
   absl::MutexLock locker(&mutex_);
   auto it = tasks_not_ready_.find(task);
   CHECK(it != tasks_not_ready_.end());
-  task_queue_.push_back(it->second);
+  task_queue_.Push(it->second);
+  IncrementQueueLengthMetric();
   tasks_not_ready_.erase(it);
 }
 
+void ThreadPool::NotifyPriorityRaised(Task* task) {
+  absl::MutexLock locker(&mutex_);
+  task_queue_.UpdatePriority(task);
+}
+
 std::weak_ptr<Task> ThreadPool::Schedule(std::unique_ptr<Task> task) {
   std::shared_ptr<Task> shared_task;
   {
@@ -81,7 +174,9 @@ void ThreadPool::DoWork() {
   // This changes the per-thread nice level of the current thread on Linux. We
   // do this so that the background work done by the thread pool is not taking
   // away CPU resources from more important foreground threads.
-  CHECK_NE(nice(10), -1);
+  if (lower_thread_priority_) {
+    CHECK_NE(nice(10), -1);
+  }
 #endif
   const auto predicate = [this]() EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
     return !task_queue_.empty() || !running_;
@@ -92,8 +187,8 @@ void ThreadPool::DoWork() {
       absl::MutexLock locker(&mutex_);
       mutex_.Await(absl::Condition(&predicate));
       if (!task_queue_.empty()) {
-        task = std::move(task_queue_.front());
-        task_queue_.pop_front();
+        task = task_queue_.PopOldest();
+        DecrementQueueLengthMetric();
       } else if (!running_) {
         return;
       }
@@ -104,5 +199,27 @@ void ThreadPool::DoWork() {
   }
 }
 
+void RunInParallel(const std::vector<Task::WorkItem>& work_items,
+                   const Task::Priority priority, const std::string& label,
+                   ThreadPoolInterface* const thread_pool) {
+  if (work_items.empty()) {
+    return;
+  }
+  absl::BlockingCounter pending_tasks(work_items.size() - 1);
+  for (size_t i = 0; i + 1 < work_items.size(); ++i) {
+    auto task = absl::make_unique<Task>();
+    task->SetPriority(priority);
+    task->SetLabel(label);
+    const Task::WorkItem* const work_item = &work_items[i];
+    task->SetWorkItem([work_item, &pending_tasks]() {
+      (*work_item)();
+      pending_tasks.DecrementCount();
+    });
+    thread_pool->Schedule(std::move(task));
+  }
+  work_items.back()();
+  pending_tasks.Wait();
+}
+
 }  // namespace common
 }  // namespace cartographer
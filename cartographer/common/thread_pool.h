@@ -17,15 +17,17 @@
 #ifndef CARTOGRAPHER_COMMON_THREAD_POOL_H_
 #define CARTOGRAPHER_COMMON_THREAD_POOL_H_
 
-#include <deque>
 #include <functional>
 #include <memory>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "cartographer/common/priority_task_queue.h"
 #include "cartographer/common/task.h"
+#include "cartographer/metrics/family_factory.h"
 
 namespace cartographer {
 namespace common {
@@ -34,29 +36,54 @@ class Task;
 
 class ThreadPoolInterface {
  public:
-  ThreadPoolInterface() {}
+  ThreadPoolInterface() : ThreadPoolInterface("unnamed") {}
+  // 'name' labels the metrics of this pool. Pools with the same name share
+  // their queue length gauge, which then counts the tasks of all of them.
+  explicit ThreadPoolInterface(const std::string& name);
   virtual ~ThreadPoolInterface() {}
   virtual std::weak_ptr<Task> Schedule(std::unique_ptr<Task> task) = 0;
 
+  // Registers a per pool name gauge of the number of queued tasks, and per
+  // 'Task::GetLabel()' histograms of the time tasks wait for a thread once
+  // their dependencies completed, and of their run time. Pools created before
+  // do not record their queue length.
+  static void RegisterMetrics(metrics::FamilyFactory* family_factory);
+
  protected:
+  // Executes 'task' and records its wait and run time.
   void Execute(Task* task);
   void SetThreadPool(Task* task);
+  // To be called whenever a task was added to or removed from the queue.
+  void IncrementQueueLengthMetric();
+  void DecrementQueueLengthMetric();
 
  private:
   friend class Task;
 
   virtual void NotifyDependenciesCompleted(Task* task) = 0;
+
+  // Called when 'task' inherited a more urgent priority after its
+  // dependencies completed, so that it can be moved up in the queue.
+  virtual void NotifyPriorityRaised(Task* task) {}
+
+  metrics::Gauge* const queue_length_metric_;
 };
 
 // A fixed number of threads working on tasks. Adding a task does not block.
 // Tasks may be added whether or not their dependencies are completed.
 // When all dependencies of a task are completed, it is queued up for execution
-// in a background thread. The queue must be empty before calling the
-// destructor. The thread pool will then wait for the currently executing work
-// items to finish and then destroy the threads.
+// in a background thread. Queued tasks run by 'Task::Priority', see
+// 'PriorityTaskQueue', and in FIFO order within a priority. The queue must be
+// empty before calling the destructor. The thread pool will then wait for the
+// currently executing work items to finish and then destroy the threads.
+//
+// On Linux, the threads run with a raised nice level unless
+// 'lower_thread_priority' is false, which is meant for pools doing work that
+// a foreground thread waits for.
 class ThreadPool : public ThreadPoolInterface {
  public:
-  explicit ThreadPool(int num_threads);
+  explicit ThreadPool(int num_threads, const std::string& name = "unnamed",
+                      bool lower_thread_priority = true);
   ~ThreadPool();
 
   ThreadPool(const ThreadPool&) = delete;
@@ -71,15 +98,25 @@ class ThreadPool : public ThreadPoolInterface {
   void DoWork();
 
   void NotifyDependenciesCompleted(Task* task) LOCKS_EXCLUDED(mutex_) override;
+  void NotifyPriorityRaised(Task* task) LOCKS_EXCLUDED(mutex_) override;
 
+  const bool lower_thread_priority_;
   absl::Mutex mutex_;
   bool running_ GUARDED_BY(mutex_) = true;
   std::vector<std::thread> pool_ GUARDED_BY(mutex_);
-  std::deque<std::shared_ptr<Task>> task_queue_ GUARDED_BY(mutex_);
+  PriorityTaskQueue task_queue_ GUARDED_BY(mutex_);
   absl::flat_hash_map<Task*, std::shared_ptr<Task>> tasks_not_ready_
       GUARDED_BY(mutex_);
 };
 
+// Runs 'work_items' concurrently and returns once all of them completed. All
+// but the last work item are scheduled on 'thread_pool' as tasks with
+// 'priority' and 'label', the last one runs on the calling thread, which must
+// not be a thread of 'thread_pool'.
+void RunInParallel(const std::vector<Task::WorkItem>& work_items,
+                   Task::Priority priority, const std::string& label,
+                   ThreadPoolInterface* thread_pool);
+
 }  // namespace common
 }  // namespace cartographer
 
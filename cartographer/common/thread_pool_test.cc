@@ -16,9 +16,14 @@
 
 #include "cartographer/common/thread_pool.h"
 
+#ifdef __linux__
+#include <unistd.h>
+#endif
+#include <algorithm>
 #include <vector>
 
 #include "absl/memory/memory.h"
+#include "cartographer/metrics/internal/recording_family_factory.h"
 #include "gtest/gtest.h"
 
 namespace cartographer {
@@ -172,6 +177,189 @@ TEST(ThreadPoolTest, RunWithFinishedDependency) {
   receiver.WaitForNumberSequence({1, 2});
 }
 
+TEST(ThreadPoolTest, RunsMoreUrgentTasksFirst) {
+  ThreadPool pool(1);
+  Receiver receiver;
+  absl::Mutex mutex;
+  bool release = false;
+  // Occupies the only thread until all other tasks are queued.
+  auto blocking_task = absl::make_unique<Task>();
+  blocking_task->SetWorkItem([&mutex, &release]() {
+    absl::MutexLock locker(&mutex);
+    mutex.Await(absl::Condition(&release));
+  });
+  blocking_task->SetPriority(Task::REALTIME);
+  pool.Schedule(std::move(blocking_task));
+  const std::vector<std::pair<Task::Priority, int>> priorities_and_numbers = {
+      {Task::BACKGROUND, 4},
+      {Task::CONSTRAINT_SEARCH, 3},
+      {Task::OPTIMIZATION, 2},
+      {Task::REALTIME, 1}};
+  for (const auto& priority_and_number : priorities_and_numbers) {
+    auto task = absl::make_unique<Task>();
+    const int number = priority_and_number.second;
+    task->SetWorkItem([&receiver, number]() { receiver.Receive(number); });
+    task->SetPriority(priority_and_number.first);
+    pool.Schedule(std::move(task));
+  }
+  {
+    absl::MutexLock locker(&mutex);
+    release = true;
+  }
+  receiver.WaitForNumberSequence({1, 2, 3, 4});
+}
+
+TEST(ThreadPoolTest, UrgentTasksRaiseThePriorityOfTheirDependencies) {
+  ThreadPool pool(1);
+  Receiver receiver;
+  absl::Mutex mutex;
+  bool release = false;
+  // Occupies the only thread until all other tasks are queued.
+  auto blocking_task = absl::make_unique<Task>();
+  blocking_task->SetWorkItem([&mutex, &release]() {
+    absl::MutexLock locker(&mutex);
+    mutex.Await(absl::Condition(&release));
+  });
+  blocking_task->SetPriority(Task::REALTIME);
+  pool.Schedule(std::move(blocking_task));
+  // Saturates the pool with background work, like a burst of global
+  // constraint searches.
+  constexpr int kNumBackgroundTasks = 100;
+  for (int i = 0; i < kNumBackgroundTasks; ++i) {
+    auto task = absl::make_unique<Task>();
+    task->SetWorkItem([&receiver]() { receiver.Receive(0); });
+    pool.Schedule(std::move(task));
+  }
+  // The chain of the constraint builder: an optimization waiting for a
+  // finished node waiting for a background search queued last.
+  auto search_task = absl::make_unique<Task>();
+  search_task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+  auto finish_node_task = absl::make_unique<Task>();
+  finish_node_task->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  finish_node_task->SetPriority(Task::CONSTRAINT_SEARCH);
+  finish_node_task->AddDependency(pool.Schedule(std::move(search_task)));
+  auto when_done_task = absl::make_unique<Task>();
+  when_done_task->SetWorkItem([&receiver]() { receiver.Receive(3); });
+  when_done_task->SetPriority(Task::OPTIMIZATION);
+  when_done_task->AddDependency(pool.Schedule(std::move(finish_node_task)));
+  pool.Schedule(std::move(when_done_task));
+  {
+    absl::MutexLock locker(&mutex);
+    release = true;
+  }
+  std::vector<int> expected_numbers(kNumBackgroundTasks, 0);
+  expected_numbers.insert(expected_numbers.begin(), {1, 2, 3});
+  receiver.WaitForNumberSequence(expected_numbers);
+}
+
+TEST(ThreadPoolTest, RecordsMetricsPerTaskLabel) {
+  // Never destroyed, since the registered metrics outlive this test.
+  auto* const family_factory = new metrics::RecordingFamilyFactory();
+  ThreadPoolInterface::RegisterMetrics(family_factory);
+  Receiver receiver;
+  {
+    ThreadPool pool(1, "labeled_pool");
+    for (int i = 0; i < 3; ++i) {
+      auto task = absl::make_unique<Task>();
+      task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+      task->SetLabel("labeled");
+      pool.Schedule(std::move(task));
+    }
+    auto task = absl::make_unique<Task>();
+    task->SetWorkItem([&receiver]() { receiver.Receive(2); });
+    pool.Schedule(std::move(task));
+    receiver.WaitForNumberSequence({1, 1, 1, 2});
+  }
+  const auto* labeled_wait_time = family_factory->GetHistogram(
+      "common_thread_pool_task_wait_time", {{"task", "labeled"}});
+  const auto* labeled_run_time = family_factory->GetHistogram(
+      "common_thread_pool_task_run_time", {{"task", "labeled"}});
+  const auto* unlabeled_run_time = family_factory->GetHistogram(
+      "common_thread_pool_task_run_time", {{"task", "unlabeled"}});
+  ASSERT_NE(labeled_wait_time, nullptr);
+  ASSERT_NE(labeled_run_time, nullptr);
+  ASSERT_NE(unlabeled_run_time, nullptr);
+  EXPECT_EQ(labeled_wait_time->Count(), 3);
+  EXPECT_EQ(labeled_run_time->Count(), 3);
+  EXPECT_EQ(unlabeled_run_time->Count(), 1);
+  EXPECT_GE(labeled_wait_time->Sum(), 0.);
+  const auto* queue_length = family_factory->GetGauge(
+      "common_thread_pool_queue_length", {{"pool", "labeled_pool"}});
+  ASSERT_NE(queue_length, nullptr);
+  EXPECT_EQ(queue_length->Value(), 0.);
+}
+
+TEST(ThreadPoolTest, RecordsQueueLengthPerPool) {
+  // Never destroyed, since the registered metrics outlive this test.
+  auto* const family_factory = new metrics::RecordingFamilyFactory();
+  ThreadPoolInterface::RegisterMetrics(family_factory);
+  absl::Mutex mutex;
+  bool release = false;
+  {
+    ThreadPool busy_pool(1, "busy_pool");
+    ThreadPool idle_pool(1, "idle_pool");
+    auto blocking_task = absl::make_unique<Task>();
+    blocking_task->SetWorkItem([&mutex, &release]() {
+      absl::MutexLock locker(&mutex);
+      mutex.Await(absl::Condition(&release));
+    });
+    busy_pool.Schedule(std::move(blocking_task));
+    for (int i = 0; i < 3; ++i) {
+      auto task = absl::make_unique<Task>();
+      task->SetWorkItem([]() {});
+      busy_pool.Schedule(std::move(task));
+    }
+    const auto* busy_queue_length = family_factory->GetGauge(
+        "common_thread_pool_queue_length", {{"pool", "busy_pool"}});
+    const auto* idle_queue_length = family_factory->GetGauge(
+        "common_thread_pool_queue_length", {{"pool", "idle_pool"}});
+    ASSERT_NE(busy_queue_length, nullptr);
+    ASSERT_NE(idle_queue_length, nullptr);
+    // The blocking task may or may not have been taken off the queue yet.
+    EXPECT_GE(busy_queue_length->Value(), 3.);
+    EXPECT_LE(busy_queue_length->Value(), 4.);
+    EXPECT_EQ(idle_queue_length->Value(), 0.);
+    absl::MutexLock locker(&mutex);
+    release = true;
+  }
+  EXPECT_EQ(family_factory
+                ->GetGauge("common_thread_pool_queue_length",
+                           {{"pool", "busy_pool"}})
+                ->Value(),
+            0.);
+}
+
+TEST(ThreadPoolTest, RunInParallelWaitsForAllWorkItems) {
+  ThreadPool pool(2);
+  for (int num_work_items = 0; num_work_items < 5; ++num_work_items) {
+    std::vector<int> results(num_work_items, 0);
+    std::vector<Task::WorkItem> work_items;
+    for (int i = 0; i < num_work_items; ++i) {
+      work_items.push_back([&results, i]() { results[i] = i + 1; });
+    }
+    RunInParallel(work_items, Task::REALTIME, "parallel", &pool);
+    for (int i = 0; i < num_work_items; ++i) {
+      EXPECT_EQ(i + 1, results[i]);
+    }
+  }
+}
+
+#ifdef __linux__
+TEST(ThreadPoolTest, LowersThreadPriorityUnlessDisabled) {
+  const int caller_nice_level = nice(0);
+  for (const bool lower_thread_priority : {true, false}) {
+    ThreadPool pool(1, "unnamed", lower_thread_priority);
+    Receiver receiver;
+    auto task = absl::make_unique<Task>();
+    task->SetWorkItem([&receiver]() { receiver.Receive(nice(0)); });
+    pool.Schedule(std::move(task));
+    receiver.WaitForNumberSequence({lower_thread_priority
+                                        ? std::min(caller_nice_level + 10, 19)
+                                        : caller_nice_level});
+  }
+}
+#endif
+
 }  // namespace
 }  // namespace common
 }  // namespace cartographer
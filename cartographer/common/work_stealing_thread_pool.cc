@@ -0,0 +1,182 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/common/work_stealing_thread_pool.h"
+
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
+#include "absl/memory/memory.h"
+#include "cartographer/common/task.h"
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace common {
+namespace {
+
+// Identifies the pool and deque owned by the current thread, if any.
+thread_local const WorkStealingThreadPool* current_thread_pool = nullptr;
+thread_local int current_worker_index = -1;
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(int num_threads,
+                                               const std::string& name)
+    : ThreadPoolInterface(name) {
+  CHECK_GT(num_threads, 0)
+      << "WorkStealingThreadPool requires a positive num_threads!";
+  for (int i = 0; i != num_threads; ++i) {
+    worker_queues_.push_back(absl::make_unique<WorkerQueue>());
+  }
+  for (int i = 0; i != num_threads; ++i) {
+    pool_.emplace_back([this, i]() { WorkStealingThreadPool::DoWork(i); });
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    absl::MutexLock locker(&wake_mutex_);
+    CHECK(running_);
+    running_ = false;
+  }
+  for (std::thread& thread : pool_) {
+    thread.join();
+  }
+}
+
+void WorkStealingThreadPool::NotifyDependenciesCompleted(Task* task) {
+  std::shared_ptr<Task> shared_task;
+  {
+    absl::MutexLock locker(&tasks_not_ready_mutex_);
+    auto it = tasks_not_ready_.find(task);
+    CHECK(it != tasks_not_ready_.end());
+    shared_task = std::move(it->second);
+    tasks_not_ready_.erase(it);
+  }
+  PushTask(std::move(shared_task));
+}
+
+void WorkStealingThreadPool::NotifyPriorityRaised(Task* task) {
+  // All deques are locked at once, so that 'task' cannot be pushed onto a
+  // deque which has already been searched. Since other threads hold at most
+  // one of these locks, taking them in order cannot deadlock.
+  for (const auto& queue : worker_queues_) {
+    queue->mutex.Lock();
+  }
+  for (const auto& queue : worker_queues_) {
+    if (queue->tasks.UpdatePriority(task)) {
+      break;
+    }
+  }
+  for (const auto& queue : worker_queues_) {
+    queue->mutex.Unlock();
+  }
+}
+
+std::weak_ptr<Task> WorkStealingThreadPool::Schedule(
+    std::unique_ptr<Task> task) {
+  std::shared_ptr<Task> shared_task;
+  {
+    absl::MutexLock locker(&tasks_not_ready_mutex_);
+    auto insert_result =
+        tasks_not_ready_.insert(std::make_pair(task.get(), std::move(task)));
+    CHECK(insert_result.second) << "Schedule called twice";
+    shared_task = insert_result.first->second;
+  }
+  SetThreadPool(shared_task.get());
+  return shared_task;
+}
+
+void WorkStealingThreadPool::PushTask(std::shared_ptr<Task> task) {
+  WorkerQueue* queue;
+  if (current_thread_pool == this) {
+    queue = worker_queues_[current_worker_index].get();
+  } else {
+    queue = worker_queues_[next_worker_queue_.fetch_add(1) %
+                           worker_queues_.size()]
+                .get();
+  }
+  {
+    absl::MutexLock locker(&queue->mutex);
+    queue->tasks.Push(std::move(task));
+  }
+  num_queued_tasks_.fetch_add(1);
+  IncrementQueueLengthMetric();
+  if (num_idle_threads_.load() > 0) {
+    // Releasing 'wake_mutex_' makes idle threads re-evaluate their wait
+    // condition.
+    absl::MutexLock locker(&wake_mutex_);
+  }
+}
+
+std::shared_ptr<Task> WorkStealingThreadPool::TryPopTask(
+    const int worker_index) {
+  std::shared_ptr<Task> task;
+  {
+    WorkerQueue& own_queue = *worker_queues_[worker_index];
+    absl::MutexLock locker(&own_queue.mutex);
+    if (!own_queue.tasks.empty()) {
+      task = own_queue.tasks.PopNewest();
+    }
+  }
+  const int num_queues = worker_queues_.size();
+  for (int i = 1; !task && i != num_queues; ++i) {
+    WorkerQueue& victim_queue =
+        *worker_queues_[(worker_index + i) % num_queues];
+    absl::MutexLock locker(&victim_queue.mutex);
+    if (!victim_queue.tasks.empty()) {
+      task = victim_queue.tasks.PopOldest();
+    }
+  }
+  if (task) {
+    num_queued_tasks_.fetch_sub(1);
+    DecrementQueueLengthMetric();
+  }
+  return task;
+}
+
+void WorkStealingThreadPool::DoWork(const int worker_index) {
+#ifdef __linux__
+  // This changes the per-thread nice level of the current thread on Linux. We
+  // do this so that the background work done by the thread pool is not taking
+  // away CPU resources from more important foreground threads.
+  CHECK_NE(nice(10), -1);
+#endif
+  current_thread_pool = this;
+  current_worker_index = worker_index;
+  const auto predicate = [this]() EXCLUSIVE_LOCKS_REQUIRED(wake_mutex_) {
+    return num_queued_tasks_.load() > 0 || !running_;
+  };
+  for (;;) {
+    std::shared_ptr<Task> task = TryPopTask(worker_index);
+    if (task) {
+      CHECK_EQ(task->GetState(), common::Task::DEPENDENCIES_COMPLETED);
+      Execute(task.get());
+      continue;
+    }
+    absl::MutexLock locker(&wake_mutex_);
+    num_idle_threads_.fetch_add(1);
+    wake_mutex_.Await(absl::Condition(&predicate));
+    num_idle_threads_.fetch_sub(1);
+    if (num_queued_tasks_.load() == 0 && !running_) {
+      return;
+    }
+  }
+}
+
+}  // namespace common
+}  // namespace cartographer
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_COMMON_WORK_STEALING_THREAD_POOL_H_
+#define CARTOGRAPHER_COMMON_WORK_STEALING_THREAD_POOL_H_
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "cartographer/common/priority_task_queue.h"
+#include "cartographer/common/task.h"
+#include "cartographer/common/thread_pool.h"
+
+namespace cartographer {
+namespace common {
+
+// A fixed number of threads working on tasks, with the same task and
+// dependency semantics as 'ThreadPool'. Instead of a single shared queue, each
+// thread owns a deque of ready tasks: a task whose dependencies complete on a
+// pool thread is pushed onto that thread's deque and popped again in LIFO
+// order, while tasks becoming ready on other threads are distributed round
+// robin. Threads that run out of local work steal the oldest task from the
+// deques of other threads. Each deque is a 'PriorityTaskQueue', so more urgent
+// tasks are popped and stolen first. All queued tasks are run before the
+// destructor returns.
+class WorkStealingThreadPool : public ThreadPoolInterface {
+ public:
+  explicit WorkStealingThreadPool(int num_threads,
+                                  const std::string& name = "unnamed");
+  ~WorkStealingThreadPool();
+
+  WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+  WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+  // When the returned weak pointer is expired, 'task' has certainly completed,
+  // so dependants no longer need to add it as a dependency.
+  std::weak_ptr<Task> Schedule(std::unique_ptr<Task> task)
+      LOCKS_EXCLUDED(tasks_not_ready_mutex_) override;
+
+ private:
+  struct WorkerQueue {
+    absl::Mutex mutex;
+    PriorityTaskQueue tasks GUARDED_BY(mutex){
+        PriorityTaskQueue::kDefaultMaxTimesPassedOver};
+  };
+
+  void DoWork(int worker_index);
+
+  // Pops from the back of the own deque, then steals from the front of the
+  // deques of the other threads. Returns nullptr if no task was found.
+  std::shared_ptr<Task> TryPopTask(int worker_index);
+
+  void PushTask(std::shared_ptr<Task> task) LOCKS_EXCLUDED(wake_mutex_);
+
+  void NotifyDependenciesCompleted(Task* task)
+      LOCKS_EXCLUDED(tasks_not_ready_mutex_) override;
+  // Moves 'task' within its deque while no deque is modified. A task that is
+  // not queued yet gets its raised priority when it is pushed.
+  void NotifyPriorityRaised(Task* task) NO_THREAD_SAFETY_ANALYSIS override;
+
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  std::vector<std::thread> pool_;
+  std::atomic<size_t> next_worker_queue_{0};
+
+  // Number of tasks in all 'worker_queues_'. Idle threads wait on
+  // 'wake_mutex_' for this to become positive.
+  std::atomic<int> num_queued_tasks_{0};
+  std::atomic<int> num_idle_threads_{0};
+  absl::Mutex wake_mutex_;
+  bool running_ GUARDED_BY(wake_mutex_) = true;
+
+  absl::Mutex tasks_not_ready_mutex_;
+  absl::flat_hash_map<Task*, std::shared_ptr<Task>> tasks_not_ready_
+      GUARDED_BY(tasks_not_ready_mutex_);
+};
+
+}  // namespace common
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_COMMON_WORK_STEALING_THREAD_POOL_H_
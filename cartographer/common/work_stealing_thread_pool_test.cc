@@ -0,0 +1,311 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/common/work_stealing_thread_pool.h"
+
+#include <thread>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace common {
+namespace {
+
+class Receiver {
+ public:
+  void Receive(int number) {
+    absl::MutexLock locker(&mutex_);
+    received_numbers_.push_back(number);
+  }
+
+  void WaitForNumberSequence(const std::vector<int>& expected_numbers) {
+    const auto predicate =
+        [this, &expected_numbers]() EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+          return (received_numbers_.size() >= expected_numbers.size());
+        };
+    absl::MutexLock locker(&mutex_);
+    mutex_.Await(absl::Condition(&predicate));
+    EXPECT_EQ(expected_numbers, received_numbers_);
+  }
+
+  absl::Mutex mutex_;
+  std::vector<int> received_numbers_ GUARDED_BY(mutex_);
+};
+
+TEST(WorkStealingThreadPoolTest, RunTask) {
+  WorkStealingThreadPool pool(1);
+  Receiver receiver;
+  auto task = absl::make_unique<Task>();
+  task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+  pool.Schedule(std::move(task));
+  receiver.WaitForNumberSequence({1});
+}
+
+TEST(WorkStealingThreadPoolTest, ManyTasks) {
+  for (int a = 0; a < 5; ++a) {
+    WorkStealingThreadPool pool(3);
+    Receiver receiver;
+    int kNumTasks = 10;
+    for (int i = 0; i < kNumTasks; ++i) {
+      auto task = absl::make_unique<Task>();
+      task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+      pool.Schedule(std::move(task));
+    }
+    receiver.WaitForNumberSequence(std::vector<int>(kNumTasks, 1));
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, RunWithDependency) {
+  WorkStealingThreadPool pool(2);
+  Receiver receiver;
+  auto task_2 = absl::make_unique<Task>();
+  task_2->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  auto task_1 = absl::make_unique<Task>();
+  task_1->SetWorkItem([&receiver]() { receiver.Receive(1); });
+  auto weak_task_1 = pool.Schedule(std::move(task_1));
+  task_2->AddDependency(weak_task_1);
+  pool.Schedule(std::move(task_2));
+  receiver.WaitForNumberSequence({1, 2});
+}
+
+TEST(WorkStealingThreadPoolTest, RunWithOutOfScopeDependency) {
+  WorkStealingThreadPool pool(2);
+  Receiver receiver;
+  auto task_2 = absl::make_unique<Task>();
+  task_2->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  {
+    auto task_1 = absl::make_unique<Task>();
+    task_1->SetWorkItem([&receiver]() { receiver.Receive(1); });
+    auto weak_task_1 = pool.Schedule(std::move(task_1));
+    task_2->AddDependency(weak_task_1);
+  }
+  pool.Schedule(std::move(task_2));
+  receiver.WaitForNumberSequence({1, 2});
+}
+
+TEST(WorkStealingThreadPoolTest, ManyDependencies) {
+  for (int a = 0; a < 5; ++a) {
+    WorkStealingThreadPool pool(5);
+    Receiver receiver;
+    int kNumDependencies = 10;
+    auto task = absl::make_unique<Task>();
+    task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+    for (int i = 0; i < kNumDependencies; ++i) {
+      auto dependency_task = absl::make_unique<Task>();
+      dependency_task->SetWorkItem([]() {});
+      task->AddDependency(pool.Schedule(std::move(dependency_task)));
+    }
+    pool.Schedule(std::move(task));
+    receiver.WaitForNumberSequence({1});
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, ManyDependants) {
+  for (int a = 0; a < 5; ++a) {
+    WorkStealingThreadPool pool(5);
+    Receiver receiver;
+    int kNumDependants = 10;
+    auto dependency_task = absl::make_unique<Task>();
+    dependency_task->SetWorkItem([]() {});
+    auto dependency_handle = pool.Schedule(std::move(dependency_task));
+    for (int i = 0; i < kNumDependants; ++i) {
+      auto task = absl::make_unique<Task>();
+      task->AddDependency(dependency_handle);
+      task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+      pool.Schedule(std::move(task));
+    }
+    receiver.WaitForNumberSequence(std::vector<int>(kNumDependants, 1));
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, RunWithMultipleDependencies) {
+  WorkStealingThreadPool pool(2);
+  Receiver receiver;
+  auto task_1 = absl::make_unique<Task>();
+  task_1->SetWorkItem([&receiver]() { receiver.Receive(1); });
+  auto task_2a = absl::make_unique<Task>();
+  task_2a->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  auto task_2b = absl::make_unique<Task>();
+  task_2b->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  auto task_3 = absl::make_unique<Task>();
+  task_3->SetWorkItem([&receiver]() { receiver.Receive(3); });
+  /*          -> task_2a \
+   *  task_1 /-> task_2b --> task_3
+   */
+  auto weak_task_1 = pool.Schedule(std::move(task_1));
+  task_2a->AddDependency(weak_task_1);
+  auto weak_task_2a = pool.Schedule(std::move(task_2a));
+  task_3->AddDependency(weak_task_1);
+  task_3->AddDependency(weak_task_2a);
+  task_2b->AddDependency(weak_task_1);
+  auto weak_task_2b = pool.Schedule(std::move(task_2b));
+  task_3->AddDependency(weak_task_2b);
+  pool.Schedule(std::move(task_3));
+  receiver.WaitForNumberSequence({1, 2, 2, 3});
+}
+
+TEST(WorkStealingThreadPoolTest, RunWithFinishedDependency) {
+  WorkStealingThreadPool pool(2);
+  Receiver receiver;
+  auto task_1 = absl::make_unique<Task>();
+  task_1->SetWorkItem([&receiver]() { receiver.Receive(1); });
+  auto task_2 = absl::make_unique<Task>();
+  task_2->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  auto weak_task_1 = pool.Schedule(std::move(task_1));
+  task_2->AddDependency(weak_task_1);
+  receiver.WaitForNumberSequence({1});
+  pool.Schedule(std::move(task_2));
+  receiver.WaitForNumberSequence({1, 2});
+}
+
+TEST(WorkStealingThreadPoolTest, IdleThreadsStealFromBlockedThread) {
+  WorkStealingThreadPool pool(2);
+  Receiver receiver;
+  absl::Mutex mutex;
+  bool release = false;
+  // The first task occupies one thread and schedules more work from within
+  // the pool, which lands on its own deque. It can only complete once the
+  // other thread has stolen and run that work.
+  auto task = absl::make_unique<Task>();
+  task->SetWorkItem([&pool, &receiver, &mutex, &release]() {
+    auto dependency = absl::make_unique<Task>();
+    dependency->SetWorkItem([&receiver]() { receiver.Receive(1); });
+    auto weak_dependency = pool.Schedule(std::move(dependency));
+    auto releasing_task = absl::make_unique<Task>();
+    releasing_task->SetWorkItem([&mutex, &release]() {
+      absl::MutexLock locker(&mutex);
+      release = true;
+    });
+    releasing_task->AddDependency(weak_dependency);
+    pool.Schedule(std::move(releasing_task));
+    absl::MutexLock locker(&mutex);
+    mutex.Await(absl::Condition(&release));
+    receiver.Receive(2);
+  });
+  pool.Schedule(std::move(task));
+  receiver.WaitForNumberSequence({1, 2});
+}
+
+TEST(WorkStealingThreadPoolTest,
+     UrgentTasksRaiseThePriorityOfTheirDependencies) {
+  WorkStealingThreadPool pool(1);
+  Receiver receiver;
+  absl::Mutex mutex;
+  bool release = false;
+  // Occupies the only thread until all other tasks are queued.
+  auto blocking_task = absl::make_unique<Task>();
+  blocking_task->SetWorkItem([&mutex, &release]() {
+    absl::MutexLock locker(&mutex);
+    mutex.Await(absl::Condition(&release));
+  });
+  blocking_task->SetPriority(Task::REALTIME);
+  pool.Schedule(std::move(blocking_task));
+  // Saturates the pool with background work, like a burst of global
+  // constraint searches.
+  constexpr int kNumBackgroundTasks = 100;
+  for (int i = 0; i < kNumBackgroundTasks; ++i) {
+    auto task = absl::make_unique<Task>();
+    task->SetWorkItem([&receiver]() { receiver.Receive(0); });
+    pool.Schedule(std::move(task));
+  }
+  // The chain of the constraint builder: an optimization waiting for a
+  // finished node waiting for a background search queued last.
+  auto search_task = absl::make_unique<Task>();
+  search_task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+  auto finish_node_task = absl::make_unique<Task>();
+  finish_node_task->SetWorkItem([&receiver]() { receiver.Receive(2); });
+  finish_node_task->SetPriority(Task::CONSTRAINT_SEARCH);
+  finish_node_task->AddDependency(pool.Schedule(std::move(search_task)));
+  auto when_done_task = absl::make_unique<Task>();
+  when_done_task->SetWorkItem([&receiver]() { receiver.Receive(3); });
+  when_done_task->SetPriority(Task::OPTIMIZATION);
+  when_done_task->AddDependency(pool.Schedule(std::move(finish_node_task)));
+  pool.Schedule(std::move(when_done_task));
+  {
+    absl::MutexLock locker(&mutex);
+    release = true;
+  }
+  std::vector<int> expected_numbers(kNumBackgroundTasks, 0);
+  expected_numbers.insert(expected_numbers.begin(), {1, 2, 3});
+  receiver.WaitForNumberSequence(expected_numbers);
+}
+
+TEST(WorkStealingThreadPoolTest, RaisesPriorityWhileOtherThreadSchedules) {
+  for (int a = 0; a < 5; ++a) {
+    WorkStealingThreadPool pool(1);
+    Receiver receiver;
+    absl::Mutex mutex;
+    bool release = false;
+    // Occupies the only thread until all other tasks are queued.
+    auto blocking_task = absl::make_unique<Task>();
+    blocking_task->SetWorkItem([&mutex, &release]() {
+      absl::MutexLock locker(&mutex);
+      mutex.Await(absl::Condition(&release));
+    });
+    blocking_task->SetPriority(Task::REALTIME);
+    pool.Schedule(std::move(blocking_task));
+    // Pushes background work while the priority below is raised.
+    constexpr int kNumBackgroundTasks = 1000;
+    std::thread scheduling_thread([&pool, &receiver]() {
+      for (int i = 0; i < kNumBackgroundTasks; ++i) {
+        auto task = absl::make_unique<Task>();
+        task->SetWorkItem([&receiver]() { receiver.Receive(0); });
+        pool.Schedule(std::move(task));
+      }
+    });
+    auto search_task = absl::make_unique<Task>();
+    search_task->SetWorkItem([&receiver]() { receiver.Receive(1); });
+    auto when_done_task = absl::make_unique<Task>();
+    when_done_task->SetWorkItem([&receiver]() { receiver.Receive(2); });
+    when_done_task->SetPriority(Task::OPTIMIZATION);
+    when_done_task->AddDependency(pool.Schedule(std::move(search_task)));
+    pool.Schedule(std::move(when_done_task));
+    scheduling_thread.join();
+    {
+      absl::MutexLock locker(&mutex);
+      release = true;
+    }
+    std::vector<int> expected_numbers(kNumBackgroundTasks, 0);
+    expected_numbers.insert(expected_numbers.begin(), {1, 2});
+    receiver.WaitForNumberSequence(expected_numbers);
+  }
+}
+
+TEST(WorkStealingThreadPoolTest, RunsAllQueuedTasksBeforeDestruction) {
+  Receiver receiver;
+  constexpr int kNumTasks = 1000;
+  {
+    WorkStealingThreadPool pool(4);
+    std::weak_ptr<Task> previous_task;
+    for (int i = 0; i < kNumTasks; ++i) {
+      auto task = absl::make_unique<Task>();
+      task->SetWorkItem([&receiver, i]() { receiver.Receive(i); });
+      task->AddDependency(previous_task);
+      previous_task = pool.Schedule(std::move(task));
+    }
+  }
+  std::vector<int> expected_numbers(kNumTasks);
+  for (int i = 0; i < kNumTasks; ++i) {
+    expected_numbers[i] = i;
+  }
+  receiver.WaitForNumberSequence(expected_numbers);
+}
+
+}  // namespace
+}  // namespace common
+}  // namespace cartographer
@@ -15,6 +15,8 @@
  */
 #include "cartographer/mapping/2d/grid_2d.h"
 
+#include <algorithm>
+
 namespace cartographer {
 namespace mapping {
 namespace {
@@ -44,6 +46,32 @@ float MaxCorrespondenceCostFromProto(const proto::Grid2D& proto) {
 }
 }  // namespace
 
+void CellsToProto(const TiledCells& cells,
+                  google::protobuf::RepeatedField<int32>* proto) {
+  const CellLimits& cell_limits = cells.cell_limits();
+  proto->Resize(cell_limits.num_x_cells * cell_limits.num_y_cells, 0);
+  int32* flat_cells = proto->mutable_data();
+  std::vector<uint16> row(cell_limits.num_x_cells);
+  for (int y = 0; y < cell_limits.num_y_cells; ++y) {
+    cells.GetRow(Eigen::Array2i(0, y), cell_limits.num_x_cells, row.data());
+    flat_cells = std::copy(row.begin(), row.end(), flat_cells);
+  }
+}
+
+void CellsFromProto(const google::protobuf::RepeatedField<int32>& proto,
+                    TiledCells* const cells) {
+  const int num_x_cells = cells->cell_limits().num_x_cells;
+  CHECK_LE(proto.size(), num_x_cells * cells->cell_limits().num_y_cells);
+  for (int i = 0; i < proto.size(); ++i) {
+    CHECK_LE(proto.Get(i), std::numeric_limits<uint16>::max());
+    // Leave cells which are unknown untouched to not allocate their tiles.
+    if (proto.Get(i) != cells->unknown_value()) {
+      *cells->mutable_value(Eigen::Array2i(i % num_x_cells, i / num_x_cells)) =
+          proto.Get(i);
+    }
+  }
+}
+
 proto::GridOptions2D CreateGridOptions2D(
     common::LuaParameterDictionary* const parameter_dictionary) {
   proto::GridOptions2D options;
@@ -61,26 +89,32 @@ Grid2D::Grid2D(const MapLimits& limits, float min_correspondence_cost,
                float max_correspondence_cost,
                ValueConversionTables* conversion_tables)
     : limits_(limits),
-      correspondence_cost_cells_(
-          limits_.cell_limits().num_x_cells * limits_.cell_limits().num_y_cells,
-          kUnknownCorrespondenceValue),
+      correspondence_cost_cells_(limits_.cell_limits(),
+                                 kUnknownCorrespondenceValue),
       min_correspondence_cost_(min_correspondence_cost),
       max_correspondence_cost_(max_correspondence_cost),
-      value_to_correspondence_cost_table_(conversion_tables->GetConversionTable(
-          max_correspondence_cost, min_correspondence_cost,
-          max_correspondence_cost)) {
+      value_to_correspondence_cost_table_(
+          conversion_tables
+              ->GetConversionTable(max_correspondence_cost,
+                                   min_correspondence_cost,
+                                   max_correspondence_cost)
+              ->data()) {
   CHECK_LT(min_correspondence_cost_, max_correspondence_cost_);
 }
 
 Grid2D::Grid2D(const proto::Grid2D& proto,
                ValueConversionTables* conversion_tables)
     : limits_(proto.limits()),
-      correspondence_cost_cells_(),
+      correspondence_cost_cells_(limits_.cell_limits(),
+                                 kUnknownCorrespondenceValue),
       min_correspondence_cost_(MinCorrespondenceCostFromProto(proto)),
       max_correspondence_cost_(MaxCorrespondenceCostFromProto(proto)),
-      value_to_correspondence_cost_table_(conversion_tables->GetConversionTable(
-          max_correspondence_cost_, min_correspondence_cost_,
-          max_correspondence_cost_)) {
+      value_to_correspondence_cost_table_(
+          conversion_tables
+              ->GetConversionTable(max_correspondence_cost_,
+                                   min_correspondence_cost_,
+                                   max_correspondence_cost_)
+              ->data()) {
   CHECK_LT(min_correspondence_cost_, max_correspondence_cost_);
   if (proto.has_known_cells_box()) {
     const auto& box = proto.known_cells_box();
@@ -88,23 +122,39 @@ Grid2D::Grid2D(const proto::Grid2D& proto,
         Eigen::AlignedBox2i(Eigen::Vector2i(box.min_x(), box.min_y()),
                             Eigen::Vector2i(box.max_x(), box.max_y()));
   }
-  correspondence_cost_cells_.reserve(proto.cells_size());
-  for (const auto& cell : proto.cells()) {
-    CHECK_LE(cell, std::numeric_limits<uint16>::max());
-    correspondence_cost_cells_.push_back(cell);
-  }
+  CellsFromProto(proto.cells(), &correspondence_cost_cells_);
 }
 
 // Finishes the update sequence.
 void Grid2D::FinishUpdate() {
   while (!update_indices_.empty()) {
-    DCHECK_GE(correspondence_cost_cells_[update_indices_.back()],
-              kUpdateMarker);
-    correspondence_cost_cells_[update_indices_.back()] -= kUpdateMarker;
+    DCHECK_GE(*update_indices_.back(), kUpdateMarker);
+    *update_indices_.back() -= kUpdateMarker;
     update_indices_.pop_back();
   }
 }
 
+void Grid2D::GetCorrespondenceCostValues(const Eigen::Array2i& begin,
+                                         const int num_cells,
+                                         uint16* const values) const {
+  const CellLimits& cell_limits = limits_.cell_limits();
+  const int known_begin = std::max(begin.x(), 0);
+  const int known_end =
+      std::min(begin.x() + num_cells, cell_limits.num_x_cells);
+  if (begin.y() < 0 || begin.y() >= cell_limits.num_y_cells ||
+      known_begin >= known_end) {
+    std::fill(values, values + num_cells, kUnknownCorrespondenceValue);
+    return;
+  }
+  std::fill(values, values + (known_begin - begin.x()),
+            kUnknownCorrespondenceValue);
+  correspondence_cost_cells_.GetRow(Eigen::Array2i(known_begin, begin.y()),
+                                    known_end - known_begin,
+                                    values + (known_begin - begin.x()));
+  std::fill(values + (known_end - begin.x()), values + num_cells,
+            kUnknownCorrespondenceValue);
+}
+
 // Fills in 'offset' and 'limits' to define a subregion of that contains all
 // known cells.
 void Grid2D::ComputeCroppedLimits(Eigen::Array2i* const offset,
@@ -123,13 +173,11 @@ void Grid2D::ComputeCroppedLimits(Eigen::Array2i* const offset,
 // these coordinates going forward. This method must be called immediately
 // after 'FinishUpdate', before any calls to 'ApplyLookupTable'.
 void Grid2D::GrowLimits(const Eigen::Vector2f& point) {
-  GrowLimits(point, {mutable_correspondence_cost_cells()},
-             {kUnknownCorrespondenceValue});
+  GrowLimits(point, {mutable_correspondence_cost_cells()});
 }
 
 void Grid2D::GrowLimits(const Eigen::Vector2f& point,
-                        const std::vector<std::vector<uint16>*>& grids,
-                        const std::vector<uint16>& grids_unknown_cell_values) {
+                        const std::vector<TiledCells*>& grids) {
   CHECK(update_indices_.empty());
   while (!limits_.Contains(limits_.GetCellIndex(point))) {
     const int x_offset = limits_.cell_limits().num_x_cells / 2;
@@ -140,21 +188,8 @@ void Grid2D::GrowLimits(const Eigen::Vector2f& point,
             limits_.resolution() * Eigen::Vector2d(y_offset, x_offset),
         CellLimits(2 * limits_.cell_limits().num_x_cells,
                    2 * limits_.cell_limits().num_y_cells));
-    const int stride = new_limits.cell_limits().num_x_cells;
-    const int offset = x_offset + stride * y_offset;
-    const int new_size = new_limits.cell_limits().num_x_cells *
-                         new_limits.cell_limits().num_y_cells;
-
-    for (size_t grid_index = 0; grid_index < grids.size(); ++grid_index) {
-      std::vector<uint16> new_cells(new_size,
-                                    grids_unknown_cell_values[grid_index]);
-      for (int i = 0; i < limits_.cell_limits().num_y_cells; ++i) {
-        for (int j = 0; j < limits_.cell_limits().num_x_cells; ++j) {
-          new_cells[offset + j + i * stride] =
-              (*grids[grid_index])[j + i * limits_.cell_limits().num_x_cells];
-        }
-      }
-      *grids[grid_index] = new_cells;
+    for (TiledCells* const grid : grids) {
+      grid->Grow(Eigen::Array2i(x_offset, y_offset), new_limits.cell_limits());
     }
     limits_ = new_limits;
     if (!known_cells_box_.isEmpty()) {
@@ -166,8 +201,7 @@ void Grid2D::GrowLimits(const Eigen::Vector2f& point,
 proto::Grid2D Grid2D::ToProto() const {
   proto::Grid2D result;
   *result.mutable_limits() = mapping::ToProto(limits_);
-  *result.mutable_cells() = {correspondence_cost_cells_.begin(),
-                             correspondence_cost_cells_.end()};
+  CellsToProto(correspondence_cost_cells_, result.mutable_cells());
   CHECK(update_indices().empty()) << "Serializing a grid during an update is "
                                      "not supported. Finish the update first.";
   if (!known_cells_box().isEmpty()) {
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "cartographer/mapping/2d/map_limits.h"
+#include "cartographer/mapping/2d/tiled_cells.h"
 #include "cartographer/mapping/grid_interface.h"
 #include "cartographer/mapping/probability_values.h"
 #include "cartographer/mapping/proto/grid_2d.pb.h"
@@ -33,6 +34,14 @@ namespace mapping {
 proto::GridOptions2D CreateGridOptions2D(
     common::LuaParameterDictionary* const parameter_dictionary);
 
+// Serializes 'cells' into the flat row-major layout of proto::Grid2D.
+void CellsToProto(const TiledCells& cells,
+                  google::protobuf::RepeatedField<int32>* proto);
+
+// Fills 'cells' from the flat row-major layout of proto::Grid2D.
+void CellsFromProto(const google::protobuf::RepeatedField<int32>& proto,
+                    TiledCells* cells);
+
 enum class GridType { PROBABILITY_GRID, TSDF };
 
 class Grid2D : public GridInterface {
@@ -51,9 +60,26 @@ class Grid2D : public GridInterface {
 
   // Returns the correspondence cost of the cell with 'cell_index'.
   float GetCorrespondenceCost(const Eigen::Array2i& cell_index) const {
-    if (!limits().Contains(cell_index)) return max_correspondence_cost_;
-    return (*value_to_correspondence_cost_table_)
-        [correspondence_cost_cells()[ToFlatIndex(cell_index)]];
+    return CorrespondenceCostFromValue(GetCorrespondenceCostValue(cell_index));
+  }
+
+  // Returns the raw uint16 value of the cell with 'cell_index', which
+  // GetCorrespondenceCost() converts to a float. Cells outside the limits are
+  // unknown.
+  uint16 GetCorrespondenceCostValue(const Eigen::Array2i& cell_index) const {
+    if (!limits().Contains(cell_index)) return kUnknownCorrespondenceValue;
+    return correspondence_cost_cells_.value(cell_index);
+  }
+
+  // Copies the raw values of the 'num_cells' cells from 'begin' in the x
+  // direction into 'values', as GetCorrespondenceCostValue() returns them.
+  // This is much faster than reading the cells one by one.
+  void GetCorrespondenceCostValues(const Eigen::Array2i& begin, int num_cells,
+                                   uint16* values) const;
+
+  // Converts a raw uint16 value into its correspondence cost.
+  float CorrespondenceCostFromValue(const uint16 value) const {
+    return value_to_correspondence_cost_table_[value];
   }
 
   virtual GridType GetGridType() const = 0;
@@ -67,7 +93,7 @@ class Grid2D : public GridInterface {
   // Returns true if the probability at the specified index is known.
   bool IsKnown(const Eigen::Array2i& cell_index) const {
     return limits_.Contains(cell_index) &&
-           correspondence_cost_cells_[ToFlatIndex(cell_index)] !=
+           correspondence_cost_cells_.value(cell_index) !=
                kUnknownCorrespondenceValue;
   }
 
@@ -91,40 +117,37 @@ class Grid2D : public GridInterface {
 
  protected:
   void GrowLimits(const Eigen::Vector2f& point,
-                  const std::vector<std::vector<uint16>*>& grids,
-                  const std::vector<uint16>& grids_unknown_cell_values);
+                  const std::vector<TiledCells*>& grids);
 
-  const std::vector<uint16>& correspondence_cost_cells() const {
+  const TiledCells& correspondence_cost_cells() const {
     return correspondence_cost_cells_;
   }
-  const std::vector<int>& update_indices() const { return update_indices_; }
+  const std::vector<uint16*>& update_indices() const {
+    return update_indices_;
+  }
   const Eigen::AlignedBox2i& known_cells_box() const {
     return known_cells_box_;
   }
 
-  std::vector<uint16>* mutable_correspondence_cost_cells() {
+  TiledCells* mutable_correspondence_cost_cells() {
     return &correspondence_cost_cells_;
   }
 
-  std::vector<int>* mutable_update_indices() { return &update_indices_; }
+  std::vector<uint16*>* mutable_update_indices() { return &update_indices_; }
   Eigen::AlignedBox2i* mutable_known_cells_box() { return &known_cells_box_; }
 
-  // Converts a 'cell_index' into an index into 'cells_'.
-  int ToFlatIndex(const Eigen::Array2i& cell_index) const {
-    CHECK(limits_.Contains(cell_index)) << cell_index;
-    return limits_.cell_limits().num_x_cells * cell_index.y() + cell_index.x();
-  }
-
  private:
   MapLimits limits_;
-  std::vector<uint16> correspondence_cost_cells_;
+  TiledCells correspondence_cost_cells_;
   float min_correspondence_cost_;
   float max_correspondence_cost_;
-  std::vector<int> update_indices_;
+  // Pointers to the cells updated in the current update sequence.
+  std::vector<uint16*> update_indices_;
 
   // Bounding box of known cells to efficiently compute cropping limits.
   Eigen::AlignedBox2i known_cells_box_;
-  const std::vector<float>* value_to_correspondence_cost_table_;
+  // Data of the shared table from ValueConversionTables.
+  const float* value_to_correspondence_cost_table_;
 };
 
 }  // namespace mapping
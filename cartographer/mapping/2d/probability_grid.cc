@@ -40,8 +40,9 @@ ProbabilityGrid::ProbabilityGrid(const proto::Grid2D& proto,
 // 'probability'. Only allowed if the cell was unknown before.
 void ProbabilityGrid::SetProbability(const Eigen::Array2i& cell_index,
                                      const float probability) {
+  CHECK(limits().Contains(cell_index)) << cell_index;
   uint16& cell =
-      (*mutable_correspondence_cost_cells())[ToFlatIndex(cell_index)];
+      *mutable_correspondence_cost_cells()->mutable_value(cell_index);
   CHECK_EQ(cell, kUnknownProbabilityValue);
   cell =
       CorrespondenceCostToValue(ProbabilityToCorrespondenceCost(probability));
@@ -58,12 +59,12 @@ void ProbabilityGrid::SetProbability(const Eigen::Array2i& cell_index,
 bool ProbabilityGrid::ApplyLookupTable(const Eigen::Array2i& cell_index,
                                        const std::vector<uint16>& table) {
   DCHECK_EQ(table.size(), kUpdateMarker);
-  const int flat_index = ToFlatIndex(cell_index);
-  uint16* cell = &(*mutable_correspondence_cost_cells())[flat_index];
+  CHECK(limits().Contains(cell_index)) << cell_index;
+  uint16* cell = mutable_correspondence_cost_cells()->mutable_value(cell_index);
   if (*cell >= kUpdateMarker) {
     return false;
   }
-  mutable_update_indices()->push_back(flat_index);
+  mutable_update_indices()->push_back(cell);
   *cell = table[*cell];
   DCHECK_GE(*cell, kUpdateMarker);
   mutable_known_cells_box()->extend(cell_index.matrix());
@@ -74,13 +75,6 @@ GridType ProbabilityGrid::GetGridType() const {
   return GridType::PROBABILITY_GRID;
 }
 
-// Returns the probability of the cell with 'cell_index'.
-float ProbabilityGrid::GetProbability(const Eigen::Array2i& cell_index) const {
-  if (!limits().Contains(cell_index)) return kMinProbability;
-  return CorrespondenceCostToProbability(ValueToCorrespondenceCost(
-      correspondence_cost_cells()[ToFlatIndex(cell_index)]));
-}
-
 proto::Grid2D ProbabilityGrid::ToProto() const {
   proto::Grid2D result;
   result = Grid2D::ToProto();
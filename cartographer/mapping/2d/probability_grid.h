@@ -23,6 +23,8 @@
 #include "cartographer/mapping/2d/grid_2d.h"
 #include "cartographer/mapping/2d/map_limits.h"
 #include "cartographer/mapping/2d/xy_index.h"
+#include "cartographer/mapping/probability_values.h"
+#include "glog/logging.h"
 
 namespace cartographer {
 namespace mapping {
@@ -50,10 +52,36 @@ class ProbabilityGrid : public Grid2D {
   bool ApplyLookupTable(const Eigen::Array2i& cell_index,
                         const std::vector<uint16>& table);
 
+  // Like ApplyLookupTable(), but meant for updating many cells at once, e.g.
+  // all cells along the rays of a scan: 'cell_index' is only DCHECKed to be
+  // within the limits, and the known cells box is not extended. The caller
+  // must extend it with ExtendKnownCellsBox() to cover all updated cells.
+  void ApplyLookupTableUnchecked(const Eigen::Array2i& cell_index,
+                                 const std::vector<uint16>& table) {
+    DCHECK_EQ(table.size(), kUpdateMarker);
+    DCHECK(limits().Contains(cell_index)) << cell_index;
+    uint16* const cell =
+        mutable_correspondence_cost_cells()->mutable_value(cell_index);
+    if (*cell >= kUpdateMarker) {
+      return;
+    }
+    mutable_update_indices()->push_back(cell);
+    *cell = table[*cell];
+  }
+
+  // Extends the bounding box of known cells to include 'cell_index'.
+  void ExtendKnownCellsBox(const Eigen::Array2i& cell_index) {
+    mutable_known_cells_box()->extend(cell_index.matrix());
+  }
+
   GridType GetGridType() const override;
 
   // Returns the probability of the cell with 'cell_index'.
-  float GetProbability(const Eigen::Array2i& cell_index) const;
+  float GetProbability(const Eigen::Array2i& cell_index) const {
+    if (!limits().Contains(cell_index)) return kMinProbability;
+    return CorrespondenceCostToProbability(ValueToCorrespondenceCost(
+        correspondence_cost_cells().value(cell_index)));
+  }
 
   proto::Grid2D ToProto() const override;
   std::unique_ptr<Grid2D> ComputeCroppedGrid() const override;
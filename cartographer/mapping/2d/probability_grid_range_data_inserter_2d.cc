@@ -32,16 +32,28 @@ namespace {
 // Factor for subpixel accuracy of start and end point for ray casts.
 constexpr int kSubpixelScale = 1000;
 
-void GrowAsNeeded(const sensor::RangeData& range_data,
+Eigen::Vector2f Position2D(const sensor::PointCloud& point_cloud,
+                           const size_t index) {
+  return point_cloud[index].position.head<2>();
+}
+
+Eigen::Vector2f Position2D(const sensor::SoaPointCloudView& point_cloud,
+                           const size_t index) {
+  return Eigen::Vector2f(point_cloud.x()[index], point_cloud.y()[index]);
+}
+
+template <class PointCloudType>
+void GrowAsNeeded(const Eigen::Vector3f& origin, const PointCloudType& returns,
+                  const PointCloudType& misses,
                   ProbabilityGrid* const probability_grid) {
-  Eigen::AlignedBox2f bounding_box(range_data.origin.head<2>());
+  Eigen::AlignedBox2f bounding_box(origin.head<2>());
   // Padding around bounding box to avoid numerical issues at cell boundaries.
   constexpr float kPadding = 1e-6f;
-  for (const sensor::RangefinderPoint& hit : range_data.returns) {
-    bounding_box.extend(hit.position.head<2>());
+  for (size_t i = 0; i < returns.size(); ++i) {
+    bounding_box.extend(Position2D(returns, i));
   }
-  for (const sensor::RangefinderPoint& miss : range_data.misses) {
-    bounding_box.extend(miss.position.head<2>());
+  for (size_t i = 0; i < misses.size(); ++i) {
+    bounding_box.extend(Position2D(misses, i));
   }
   probability_grid->GrowLimits(bounding_box.min() -
                                kPadding * Eigen::Vector2f::Ones());
@@ -49,11 +61,13 @@ void GrowAsNeeded(const sensor::RangeData& range_data,
                                kPadding * Eigen::Vector2f::Ones());
 }
 
-void CastRays(const sensor::RangeData& range_data,
+template <class PointCloudType>
+void CastRays(const Eigen::Vector3f& origin, const PointCloudType& returns,
+              const PointCloudType& misses,
               const std::vector<uint16>& hit_table,
               const std::vector<uint16>& miss_table,
               const bool insert_free_space, ProbabilityGrid* probability_grid) {
-  GrowAsNeeded(range_data, probability_grid);
+  GrowAsNeeded(origin, returns, misses, probability_grid);
 
   const MapLimits& limits = probability_grid->limits();
   const double superscaled_resolution = limits.resolution() / kSubpixelScale;
@@ -62,12 +76,12 @@ void CastRays(const sensor::RangeData& range_data,
       CellLimits(limits.cell_limits().num_x_cells * kSubpixelScale,
                  limits.cell_limits().num_y_cells * kSubpixelScale));
   const Eigen::Array2i begin =
-      superscaled_limits.GetCellIndex(range_data.origin.head<2>());
+      superscaled_limits.GetCellIndex(origin.head<2>());
   // Compute and add the end points.
   std::vector<Eigen::Array2i> ends;
-  ends.reserve(range_data.returns.size());
-  for (const sensor::RangefinderPoint& hit : range_data.returns) {
-    ends.push_back(superscaled_limits.GetCellIndex(hit.position.head<2>()));
+  ends.reserve(returns.size());
+  for (size_t i = 0; i < returns.size(); ++i) {
+    ends.push_back(superscaled_limits.GetCellIndex(Position2D(returns, i)));
     probability_grid->ApplyLookupTable(ends.back() / kSubpixelScale, hit_table);
   }
 
@@ -75,25 +89,29 @@ void CastRays(const sensor::RangeData& range_data,
     return;
   }
 
-  // Now add the misses.
+  // Now add the misses. The cells along each ray lie within the bounding box
+  // of its first and last cell, so extending the known cells box by those is
+  // enough.
+  const auto apply_miss = [probability_grid,
+                           &miss_table](const Eigen::Array2i& cell_index) {
+    probability_grid->ApplyLookupTableUnchecked(cell_index, miss_table);
+  };
+  if (!ends.empty() || misses.size() != 0) {
+    probability_grid->ExtendKnownCellsBox(begin / kSubpixelScale);
+  }
   for (const Eigen::Array2i& end : ends) {
-    std::vector<Eigen::Array2i> ray =
-        RayToPixelMask(begin, end, kSubpixelScale);
-    for (const Eigen::Array2i& cell_index : ray) {
-      probability_grid->ApplyLookupTable(cell_index, miss_table);
-    }
+    ForEachPixelOnRay(begin, end, kSubpixelScale, apply_miss);
   }
 
   // Finally, compute and add empty rays based on misses in the range data.
-  for (const sensor::RangefinderPoint& missing_echo : range_data.misses) {
-    std::vector<Eigen::Array2i> ray = RayToPixelMask(
-        begin, superscaled_limits.GetCellIndex(missing_echo.position.head<2>()),
-        kSubpixelScale);
-    for (const Eigen::Array2i& cell_index : ray) {
-      probability_grid->ApplyLookupTable(cell_index, miss_table);
-    }
+  for (size_t i = 0; i < misses.size(); ++i) {
+    const Eigen::Array2i end =
+        superscaled_limits.GetCellIndex(Position2D(misses, i));
+    probability_grid->ExtendKnownCellsBox(end / kSubpixelScale);
+    ForEachPixelOnRay(begin, end, kSubpixelScale, apply_miss);
   }
 }
+
 }  // namespace
 
 proto::ProbabilityGridRangeDataInserterOptions2D
@@ -127,10 +145,21 @@ void ProbabilityGridRangeDataInserter2D::Insert(
   CHECK(probability_grid != nullptr);
   // By not finishing the update after hits are inserted, we give hits priority
   // (i.e. no hits will be ignored because of a miss in the same cell).
-  CastRays(range_data, hit_table_, miss_table_, options_.insert_free_space(),
+  CastRays(range_data.origin, range_data.returns, range_data.misses,
+           hit_table_, miss_table_, options_.insert_free_space(),
            probability_grid);
   probability_grid->FinishUpdate();
 }
 
+void ProbabilityGridRangeDataInserter2D::Insert(
+    const sensor::SoaRangeData& range_data, GridInterface* const grid) const {
+  ProbabilityGrid* const probability_grid = static_cast<ProbabilityGrid*>(grid);
+  CHECK(probability_grid != nullptr);
+  CastRays(range_data.origin, sensor::SoaPointCloudView(range_data.returns),
+           sensor::SoaPointCloudView(range_data.misses), hit_table_,
+           miss_table_, options_.insert_free_space(), probability_grid);
+  probability_grid->FinishUpdate();
+}
+
 }  // namespace mapping
 }  // namespace cartographer
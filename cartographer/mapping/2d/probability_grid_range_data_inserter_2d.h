@@ -28,6 +28,7 @@
 #include "cartographer/mapping/range_data_inserter_interface.h"
 #include "cartographer/sensor/point_cloud.h"
 #include "cartographer/sensor/range_data.h"
+#include "cartographer/sensor/soa_point_cloud.h"
 
 namespace cartographer {
 namespace mapping {
@@ -50,6 +51,10 @@ class ProbabilityGridRangeDataInserter2D : public RangeDataInserterInterface {
   virtual void Insert(const sensor::RangeData& range_data,
                       GridInterface* grid) const override;
 
+  // Same as above for range data stored as structure-of-arrays.
+  void Insert(const sensor::SoaRangeData& range_data,
+              GridInterface* grid) const;
+
  private:
   const proto::ProbabilityGridRangeDataInserterOptions2D options_;
   const std::vector<uint16> hit_table_;
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "cartographer/mapping/2d/probability_grid.h"
+#include "cartographer/mapping/2d/probability_grid_range_data_inserter_2d.h"
+#include "cartographer/mapping/probability_values.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+#include "cartographer/sensor/range_data.h"
+
+namespace cartographer {
+namespace mapping {
+namespace {
+
+// Inserts a scan with 'state.range(0)' beams of a 20 m x 12 m room. The grid is
+// preallocated, so that only CastRays() and FinishUpdate() are measured.
+void BM_ProbabilityGridRangeDataInserter2D_Insert(benchmark::State& state) {
+  proto::ProbabilityGridRangeDataInserterOptions2D options;
+  options.set_hit_probability(0.55);
+  options.set_miss_probability(0.49);
+  options.set_insert_free_space(true);
+  const ProbabilityGridRangeDataInserter2D range_data_inserter(options);
+  const sensor::RangeData range_data{
+      Eigen::Vector3f::Zero(),
+      sensor::testing::ToPointCloud(
+          sensor::testing::GenerateSyntheticScan2D(state.range(0), 10.f, 6.f)),
+      {}};
+  ValueConversionTables conversion_tables;
+  ProbabilityGrid probability_grid(
+      MapLimits(0.05, Eigen::Vector2d(12., 12.), CellLimits(480, 480)),
+      &conversion_tables);
+  for (auto _ : state) {
+    range_data_inserter.Insert(range_data, &probability_grid);
+    probability_grid.FinishUpdate();
+  }
+  state.SetItemsProcessed(state.iterations() * range_data.returns.size());
+}
+BENCHMARK(BM_ProbabilityGridRangeDataInserter2D_Insert)->Arg(360)->Arg(1440);
+
+}  // namespace
+}  // namespace mapping
+}  // namespace cartographer
@@ -17,6 +17,7 @@
 #include "cartographer/mapping/2d/probability_grid.h"
 
 #include <random>
+#include <vector>
 
 #include "cartographer/mapping/probability_values.h"
 #include "gtest/gtest.h"
@@ -148,6 +149,45 @@ TEST(ProbabilityGridTest, GetProbability) {
   }
 }
 
+TEST(ProbabilityGridTest, GetCorrespondenceCostValue) {
+  ValueConversionTables conversion_tables;
+  ProbabilityGrid probability_grid(
+      MapLimits(1., Eigen::Vector2d(1., 2.), CellLimits(2, 2)),
+      &conversion_tables);
+  const Array2i cell_index(1, 0);
+  probability_grid.SetProbability(cell_index, 0.7f);
+  EXPECT_EQ(CorrespondenceCostToValue(ProbabilityToCorrespondenceCost(0.7f)),
+            probability_grid.GetCorrespondenceCostValue(cell_index));
+  EXPECT_EQ(kUnknownCorrespondenceValue,
+            probability_grid.GetCorrespondenceCostValue(Array2i(0, 0)));
+  EXPECT_EQ(kUnknownCorrespondenceValue,
+            probability_grid.GetCorrespondenceCostValue(Array2i(-1, 2)));
+  EXPECT_EQ(kMinProbability, probability_grid.GetProbability(Array2i(-1, 2)));
+}
+
+TEST(ProbabilityGridTest, GetCorrespondenceCostValues) {
+  ValueConversionTables conversion_tables;
+  ProbabilityGrid probability_grid(
+      MapLimits(1., Eigen::Vector2d(1., 2.), CellLimits(100, 3)),
+      &conversion_tables);
+  probability_grid.SetProbability(Array2i(0, 1), 0.7f);
+  probability_grid.SetProbability(Array2i(70, 1), 0.6f);
+  probability_grid.SetProbability(Array2i(99, 1), 0.8f);
+  for (const Array2i& begin :
+       {Array2i(-5, 1), Array2i(0, 1), Array2i(60, 1), Array2i(-3, -1),
+        Array2i(95, 3), Array2i(-120, 1), Array2i(100, 1)}) {
+    constexpr int kNumCells = 110;
+    std::vector<uint16> values(kNumCells, 1);
+    probability_grid.GetCorrespondenceCostValues(begin, kNumCells,
+                                                 values.data());
+    for (int x = 0; x != kNumCells; ++x) {
+      EXPECT_EQ(probability_grid.GetCorrespondenceCostValue(
+                    begin + Array2i(x, 0)),
+                values[x]);
+    }
+  }
+}
+
 TEST(ProbabilityGridTest, GetCellIndex) {
   ValueConversionTables conversion_tables;
   ProbabilityGrid probability_grid(
@@ -46,7 +46,7 @@ class RangeDataInserterTest2D : public ::testing::Test {
         absl::make_unique<ProbabilityGridRangeDataInserter2D>(options_);
   }
 
-  void InsertPointCloud() {
+  static sensor::RangeData CreateRangeData() {
     sensor::RangeData range_data;
     range_data.returns.push_back({Eigen::Vector3f{-3.5f, 0.5f, 0.f}});
     range_data.returns.push_back({Eigen::Vector3f{-2.5f, 1.5f, 0.f}});
@@ -54,7 +54,11 @@ class RangeDataInserterTest2D : public ::testing::Test {
     range_data.returns.push_back({Eigen::Vector3f{-0.5f, 3.5f, 0.f}});
     range_data.origin.x() = -0.5f;
     range_data.origin.y() = 0.5f;
-    range_data_inserter_->Insert(range_data, &probability_grid_);
+    return range_data;
+  }
+
+  void InsertPointCloud() {
+    range_data_inserter_->Insert(CreateRangeData(), &probability_grid_);
     probability_grid_.FinishUpdate();
   }
 
@@ -104,6 +108,34 @@ TEST_F(RangeDataInserterTest2D, InsertPointCloud) {
   }
 }
 
+TEST_F(RangeDataInserterTest2D, InsertSoaPointCloud) {
+  sensor::RangeData range_data = CreateRangeData();
+  range_data.misses.push_back({Eigen::Vector3f{-3.5f, 3.5f, 0.f}});
+  range_data_inserter_->Insert(range_data, &probability_grid_);
+  ProbabilityGrid soa_probability_grid(probability_grid_.limits(),
+                                       &conversion_tables_);
+  range_data_inserter_->Insert(
+      sensor::SoaRangeData{
+          range_data.origin,
+          sensor::SoaPointCloud::FromPointCloud(range_data.returns),
+          sensor::SoaPointCloud::FromPointCloud(range_data.misses)},
+      &soa_probability_grid);
+
+  const CellLimits& cell_limits = probability_grid_.limits().cell_limits();
+  for (int x = 0; x != cell_limits.num_x_cells; ++x) {
+    for (int y = 0; y != cell_limits.num_y_cells; ++y) {
+      const Eigen::Array2i cell_index(x, y);
+      EXPECT_EQ(probability_grid_.IsKnown(cell_index),
+                soa_probability_grid.IsKnown(cell_index));
+      EXPECT_EQ(probability_grid_.GetProbability(cell_index),
+                soa_probability_grid.GetProbability(cell_index));
+    }
+  }
+  const Eigen::Array2i miss_cell_index =
+      soa_probability_grid.limits().GetCellIndex(Eigen::Vector2f(-3.5f, 3.5f));
+  EXPECT_TRUE(soa_probability_grid.IsKnown(miss_cell_index));
+}
+
 TEST_F(RangeDataInserterTest2D, ProbabilityProgression) {
   InsertPointCloud();
   EXPECT_NEAR(
@@ -38,6 +38,8 @@ proto::SubmapsOptions2D CreateSubmapsOptions2D(
   proto::SubmapsOptions2D options;
   options.set_num_range_data(
       parameter_dictionary->GetNonNegativeInt("num_range_data"));
+  options.set_num_insertion_threads(
+      parameter_dictionary->GetNonNegativeInt("num_insertion_threads"));
   *options.mutable_grid_options_2d() = CreateGridOptions2D(
       parameter_dictionary->GetDictionary("grid_options_2d").get());
   *options.mutable_range_data_inserter_options() =
@@ -151,7 +153,14 @@ void Submap2D::Finish() {
 }
 
 ActiveSubmaps2D::ActiveSubmaps2D(const proto::SubmapsOptions2D& options)
-    : options_(options), range_data_inserter_(CreateRangeDataInserter()) {}
+    : options_(options), range_data_inserter_(CreateRangeDataInserter()) {
+  if (options_.num_insertion_threads() > 0) {
+    // Local SLAM waits for the insertion, so the threads keep their priority.
+    thread_pool_ = absl::make_unique<common::ThreadPool>(
+        options_.num_insertion_threads(), "submap_insertion",
+        false /* lower_thread_priority */);
+  }
+}
 
 std::vector<std::shared_ptr<const Submap2D>> ActiveSubmaps2D::submaps() const {
   return std::vector<std::shared_ptr<const Submap2D>>(submaps_.begin(),
@@ -164,8 +173,21 @@ std::vector<std::shared_ptr<const Submap2D>> ActiveSubmaps2D::InsertRangeData(
       submaps_.back()->num_range_data() == options_.num_range_data()) {
     AddSubmap(range_data.origin.head<2>());
   }
-  for (auto& submap : submaps_) {
-    submap->InsertRangeData(range_data, range_data_inserter_.get());
+  if (thread_pool_ != nullptr) {
+    // The submaps have separate grids and the inserter is stateless, so the
+    // result does not depend on the order of insertion.
+    std::vector<common::Task::WorkItem> work_items;
+    for (auto& submap : submaps_) {
+      work_items.push_back([this, &submap, &range_data]() {
+        submap->InsertRangeData(range_data, range_data_inserter_.get());
+      });
+    }
+    common::RunInParallel(work_items, common::Task::REALTIME,
+                          "submap_insertion_2d", thread_pool_.get());
+  } else {
+    for (auto& submap : submaps_) {
+      submap->InsertRangeData(range_data, range_data_inserter_.get());
+    }
   }
   if (submaps_.front()->num_range_data() == 2 * options_.num_range_data()) {
     submaps_.front()->Finish();
@@ -22,6 +22,7 @@
 
 #include "Eigen/Core"
 #include "cartographer/common/lua_parameter_dictionary.h"
+#include "cartographer/common/thread_pool.h"
 #include "cartographer/mapping/2d/grid_2d.h"
 #include "cartographer/mapping/2d/map_limits.h"
 #include "cartographer/mapping/proto/serialization.pb.h"
@@ -99,6 +100,8 @@ class ActiveSubmaps2D {
   std::vector<std::shared_ptr<Submap2D>> submaps_;
   std::unique_ptr<RangeDataInserterInterface> range_data_inserter_;
   ValueConversionTables conversion_tables_;
+  // Inserts into the active submaps concurrently if not null.
+  std::unique_ptr<common::ThreadPool> thread_pool_;
 };
 
 }  // namespace mapping
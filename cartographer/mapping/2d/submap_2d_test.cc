@@ -25,6 +25,7 @@
 #include "cartographer/common/lua_parameter_dictionary.h"
 #include "cartographer/common/port.h"
 #include "cartographer/mapping/2d/probability_grid.h"
+#include "cartographer/sensor/internal/test_helpers.h"
 #include "cartographer/transform/transform.h"
 #include "gmock/gmock.h"
 
@@ -39,6 +40,7 @@ TEST(Submap2DTest, TheRightNumberOfRangeDataAreInserted) {
       "num_range_data = " +
       std::to_string(kNumRangeData) +
       ", "
+      "num_insertion_threads = 0, "
       "grid_options_2d = {"
       "grid_type = \"PROBABILITY_GRID\","
       "resolution = 0.05, "
@@ -95,6 +97,42 @@ TEST(Submap2DTest, TheRightNumberOfRangeDataAreInserted) {
   EXPECT_EQ(1, num_unfinished_submaps);
 }
 
+TEST(Submap2DTest, ParallelInsertionMatchesSequentialInsertion) {
+  proto::SubmapsOptions2D options;
+  options.set_num_range_data(3);
+  options.mutable_grid_options_2d()->set_grid_type(
+      proto::GridOptions2D::PROBABILITY_GRID);
+  options.mutable_grid_options_2d()->set_resolution(0.05);
+  auto* const range_data_inserter_options =
+      options.mutable_range_data_inserter_options();
+  range_data_inserter_options->set_range_data_inserter_type(
+      proto::RangeDataInserterOptions::PROBABILITY_GRID_INSERTER_2D);
+  auto* const probability_grid_options =
+      range_data_inserter_options
+          ->mutable_probability_grid_range_data_inserter_options_2d();
+  probability_grid_options->set_insert_free_space(true);
+  probability_grid_options->set_hit_probability(0.53);
+  probability_grid_options->set_miss_probability(0.495);
+  ActiveSubmaps2D sequential_submaps(options);
+  options.set_num_insertion_threads(2);
+  ActiveSubmaps2D parallel_submaps(options);
+
+  const sensor::PointCloud scan = sensor::testing::ToPointCloud(
+      sensor::testing::GenerateSyntheticScan2D(360, 4.f, 3.f));
+  for (int i = 0; i != 10; ++i) {
+    const sensor::RangeData range_data = sensor::TransformRangeData(
+        {Eigen::Vector3f::Zero(), scan, {}},
+        transform::Rigid3f::Translation(Eigen::Vector3f(0.3f * i, 0.f, 0.f)));
+    const auto expected = sequential_submaps.InsertRangeData(range_data);
+    const auto actual = parallel_submaps.InsertRangeData(range_data);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t j = 0; j != expected.size(); ++j) {
+      EXPECT_EQ(expected[j]->ToProto(true).SerializeAsString(),
+                actual[j]->ToProto(true).SerializeAsString());
+    }
+  }
+}
+
 TEST(Submap2DTest, ToFromProto) {
   MapLimits expected_map_limits(1., Eigen::Vector2d(2., 3.),
                                 CellLimits(100, 110));
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/2d/tiled_cells.h"
+
+#include <algorithm>
+
+#include "absl/memory/memory.h"
+
+namespace cartographer {
+namespace mapping {
+namespace {
+
+// Returns the index of the tile containing the lattice position 'value',
+// rounding towards negative infinity.
+int ToTileCoordinate(const int value) {
+  return value >= 0 ? value / TiledCells::kTileSize
+                    : -((-value + TiledCells::kTileSize - 1) /
+                        TiledCells::kTileSize);
+}
+
+}  // namespace
+
+TiledCells::TiledCells(const CellLimits& cell_limits,
+                       const uint16 unknown_value)
+    : cell_limits_(cell_limits),
+      unknown_value_(unknown_value),
+      cell_to_lattice_(Eigen::Array2i::Zero()),
+      tile_begin_(Eigen::Array2i::Zero()),
+      first_tile_offset_(Eigen::Array2i::Zero()),
+      num_x_tiles_((cell_limits.num_x_cells + kTileSize - 1) / kTileSize),
+      num_y_tiles_((cell_limits.num_y_cells + kTileSize - 1) / kTileSize),
+      tiles_(num_x_tiles_ * num_y_tiles_) {
+  CHECK_GT(cell_limits.num_x_cells, 0);
+  CHECK_GT(cell_limits.num_y_cells, 0);
+}
+
+void TiledCells::Grow(const Eigen::Array2i& offset,
+                      const CellLimits& cell_limits) {
+  const Eigen::Array2i new_cell_to_lattice = cell_to_lattice_ - offset;
+  const Eigen::Array2i new_tile_begin(
+      ToTileCoordinate(new_cell_to_lattice.x()),
+      ToTileCoordinate(new_cell_to_lattice.y()));
+  const Eigen::Array2i new_tile_end(
+      ToTileCoordinate(new_cell_to_lattice.x() + cell_limits.num_x_cells -
+                       1) +
+          1,
+      ToTileCoordinate(new_cell_to_lattice.y() + cell_limits.num_y_cells -
+                       1) +
+          1);
+  const int new_num_x_tiles = new_tile_end.x() - new_tile_begin.x();
+  const int new_num_y_tiles = new_tile_end.y() - new_tile_begin.y();
+  std::vector<std::unique_ptr<Tile>> new_tiles(new_num_x_tiles *
+                                               new_num_y_tiles);
+  for (int y = 0; y < num_y_tiles_; ++y) {
+    for (int x = 0; x < num_x_tiles_; ++x) {
+      std::unique_ptr<Tile>& tile = tiles_[y * num_x_tiles_ + x];
+      if (tile == nullptr) {
+        continue;
+      }
+      const Eigen::Array2i new_index =
+          tile_begin_ + Eigen::Array2i(x, y) - new_tile_begin;
+      CHECK((new_index >= 0).all() && new_index.x() < new_num_x_tiles &&
+            new_index.y() < new_num_y_tiles)
+          << "Growing must keep all cells.";
+      new_tiles[new_index.y() * new_num_x_tiles + new_index.x()] =
+          std::move(tile);
+    }
+  }
+  cell_limits_ = cell_limits;
+  cell_to_lattice_ = new_cell_to_lattice;
+  tile_begin_ = new_tile_begin;
+  first_tile_offset_ = cell_to_lattice_ - kTileSize * tile_begin_;
+  num_x_tiles_ = new_num_x_tiles;
+  num_y_tiles_ = new_num_y_tiles;
+  tiles_ = std::move(new_tiles);
+}
+
+void TiledCells::GetRow(const Eigen::Array2i& begin, const int num_cells,
+                        uint16* values) const {
+  if (num_cells == 0) {
+    return;
+  }
+  CHECK_GT(num_cells, 0);
+  const Eigen::Array2i first = ToTiledIndex(begin);
+  const Eigen::Array2i last =
+      ToTiledIndex(begin + Eigen::Array2i(num_cells - 1, 0));
+  const int row_in_tile = ToIndexInTile(Eigen::Array2i(0, first.y()));
+  for (int x = first.x(); x <= last.x();) {
+    const int end_x = std::min(last.x() + 1, (x | (kTileSize - 1)) + 1);
+    const Tile* const tile =
+        tiles_[ToTileIndex(Eigen::Array2i(x, first.y()))].get();
+    if (tile == nullptr) {
+      std::fill(values, values + (end_x - x), unknown_value_);
+    } else {
+      const uint16* const cells =
+          &tile->cells[row_in_tile + (x & (kTileSize - 1))];
+      std::copy(cells, cells + (end_x - x), values);
+    }
+    values += end_x - x;
+    x = end_x;
+  }
+}
+
+int TiledCells::num_allocated_tiles() const {
+  return std::count_if(
+      tiles_.begin(), tiles_.end(),
+      [](const std::unique_ptr<Tile>& tile) { return tile != nullptr; });
+}
+
+std::unique_ptr<TiledCells::Tile> TiledCells::NewTile() const {
+  auto tile = absl::make_unique<Tile>();
+  tile->cells.fill(unknown_value_);
+  return tile;
+}
+
+}  // namespace mapping
+}  // namespace cartographer
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_MAPPING_2D_TILED_CELLS_H_
+#define CARTOGRAPHER_MAPPING_2D_TILED_CELLS_H_
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Eigen/Core"
+#include "cartographer/common/port.h"
+#include "cartographer/mapping/2d/map_limits.h"
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace mapping {
+
+// Stores the uint16 cells of a 2D grid with 'cell_limits' in square tiles of
+// 'kTileSize' x 'kTileSize' cells. Tiles are only allocated when a cell in them
+// is first written, cells in other tiles have the 'unknown_value'. Growing
+// keeps all allocated tiles and only rebuilds the table of tiles.
+class TiledCells {
+ public:
+  static constexpr int kTileBits = 6;
+  static constexpr int kTileSize = 1 << kTileBits;
+
+  TiledCells(const CellLimits& cell_limits, uint16 unknown_value);
+
+  TiledCells(const TiledCells&) = delete;
+  TiledCells& operator=(const TiledCells&) = delete;
+  TiledCells(TiledCells&&) = default;
+  TiledCells& operator=(TiledCells&&) = default;
+
+  const CellLimits& cell_limits() const { return cell_limits_; }
+  uint16 unknown_value() const { return unknown_value_; }
+
+  // Returns the value of the cell with 'cell_index' which must be within
+  // 'cell_limits'.
+  uint16 value(const Eigen::Array2i& cell_index) const {
+    const Eigen::Array2i index = ToTiledIndex(cell_index);
+    const Tile* const tile = tiles_[ToTileIndex(index)].get();
+    if (tile == nullptr) {
+      return unknown_value_;
+    }
+    return tile->cells[ToIndexInTile(index)];
+  }
+
+  // Returns a pointer to the cell with 'cell_index' which must be within
+  // 'cell_limits', allocating its tile if necessary. The pointer stays valid
+  // until this object is destroyed, even when growing.
+  uint16* mutable_value(const Eigen::Array2i& cell_index) {
+    const Eigen::Array2i index = ToTiledIndex(cell_index);
+    std::unique_ptr<Tile>& tile = tiles_[ToTileIndex(index)];
+    if (tile == nullptr) {
+      tile = NewTile();
+    }
+    return &tile->cells[ToIndexInTile(index)];
+  }
+
+  // Copies the values of the 'num_cells' cells from 'begin' in the x direction
+  // into 'values'. All of them must be within 'cell_limits'. This copies the
+  // part of the row in each tile at once, which is much faster than calling
+  // value() for each cell.
+  void GetRow(const Eigen::Array2i& begin, int num_cells,
+              uint16* values) const;
+
+  // Moves all cells by 'offset' and changes the limits to 'cell_limits' which
+  // must contain all moved cells.
+  void Grow(const Eigen::Array2i& offset, const CellLimits& cell_limits);
+
+  // Returns the number of allocated tiles.
+  int num_allocated_tiles() const;
+
+ private:
+  struct alignas(64) Tile {
+    std::array<uint16, kTileSize * kTileSize> cells;
+  };
+
+  // Converts a 'cell_index' into an index relative to the first cell of the
+  // first tile.
+  Eigen::Array2i ToTiledIndex(const Eigen::Array2i& cell_index) const {
+    DCHECK((cell_index >= 0).all() &&
+           cell_index.x() < cell_limits_.num_x_cells &&
+           cell_index.y() < cell_limits_.num_y_cells)
+        << cell_index;
+    return cell_index + first_tile_offset_;
+  }
+
+  int ToTileIndex(const Eigen::Array2i& tiled_index) const {
+    return (tiled_index.y() >> kTileBits) * num_x_tiles_ +
+           (tiled_index.x() >> kTileBits);
+  }
+
+  static int ToIndexInTile(const Eigen::Array2i& tiled_index) {
+    return ((tiled_index.y() & (kTileSize - 1)) << kTileBits) +
+           (tiled_index.x() & (kTileSize - 1));
+  }
+
+  std::unique_ptr<Tile> NewTile() const;
+
+  CellLimits cell_limits_;
+  uint16 unknown_value_;
+
+  // Tiles are aligned to a lattice which is fixed to the cells, so that they
+  // stay valid when growing. 'cell_to_lattice_' is added to a cell index to
+  // get its lattice position, 'tile_begin_' is the lattice position of the
+  // first tile in units of tiles, and 'first_tile_offset_' is added to a cell
+  // index to get its position relative to the first cell of the first tile.
+  Eigen::Array2i cell_to_lattice_;
+  Eigen::Array2i tile_begin_;
+  Eigen::Array2i first_tile_offset_;
+  int num_x_tiles_;
+  int num_y_tiles_;
+  std::vector<std::unique_ptr<Tile>> tiles_;
+};
+
+}  // namespace mapping
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_MAPPING_2D_TILED_CELLS_H_
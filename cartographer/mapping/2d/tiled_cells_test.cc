@@ -0,0 +1,199 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/2d/tiled_cells.h"
+
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "cartographer/mapping/2d/probability_grid.h"
+#include "cartographer/mapping/probability_values.h"
+#include "cartographer/mapping/value_conversion_tables.h"
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace mapping {
+namespace {
+
+TEST(TiledCellsTest, UnknownUntilWritten) {
+  TiledCells cells(CellLimits(100, 70), 7);
+  EXPECT_EQ(0, cells.num_allocated_tiles());
+  EXPECT_EQ(7, cells.value(Eigen::Array2i(0, 0)));
+  EXPECT_EQ(7, cells.value(Eigen::Array2i(99, 69)));
+  *cells.mutable_value(Eigen::Array2i(99, 69)) = 42;
+  EXPECT_EQ(1, cells.num_allocated_tiles());
+  EXPECT_EQ(42, cells.value(Eigen::Array2i(99, 69)));
+  EXPECT_EQ(7, cells.value(Eigen::Array2i(98, 69)));
+  EXPECT_EQ(7, cells.value(Eigen::Array2i(0, 0)));
+}
+
+TEST(TiledCellsTest, TileBoundaries) {
+  constexpr int kTileSize = TiledCells::kTileSize;
+  TiledCells cells(CellLimits(2 * kTileSize + 1, kTileSize + 1), 0);
+  const std::vector<Eigen::Array2i> boundary_indices = {
+      {kTileSize - 1, 0},         {kTileSize, 0},
+      {0, kTileSize - 1},         {0, kTileSize},
+      {kTileSize - 1, kTileSize}, {kTileSize, kTileSize - 1},
+      {2 * kTileSize, kTileSize}};
+  for (size_t i = 0; i != boundary_indices.size(); ++i) {
+    *cells.mutable_value(boundary_indices[i]) = i + 1;
+  }
+  EXPECT_EQ(4, cells.num_allocated_tiles());
+  for (size_t i = 0; i != boundary_indices.size(); ++i) {
+    EXPECT_EQ(static_cast<uint16>(i + 1), cells.value(boundary_indices[i]));
+  }
+  EXPECT_EQ(0, cells.value(Eigen::Array2i(kTileSize - 2, 0)));
+  EXPECT_EQ(0, cells.value(Eigen::Array2i(kTileSize + 1, 0)));
+  EXPECT_EQ(0, cells.value(Eigen::Array2i(kTileSize, kTileSize)));
+}
+
+TEST(TiledCellsTest, GetRowAcrossTiles) {
+  constexpr int kTileSize = TiledCells::kTileSize;
+  const CellLimits cell_limits(3 * kTileSize + 5, 2);
+  TiledCells cells(cell_limits, 7);
+  // Leaves the middle tile of the first row unallocated.
+  for (int x = 0; x != cell_limits.num_x_cells; ++x) {
+    if (x / kTileSize != 1) {
+      *cells.mutable_value(Eigen::Array2i(x, 0)) = x;
+    }
+  }
+  EXPECT_EQ(3, cells.num_allocated_tiles());
+  for (const int begin_x : {0, 1, kTileSize - 1, kTileSize, 2 * kTileSize}) {
+    for (const int num_cells :
+         {0, 1, 2, kTileSize, cell_limits.num_x_cells - begin_x}) {
+      if (begin_x + num_cells > cell_limits.num_x_cells) continue;
+      std::vector<uint16> row(num_cells, 0);
+      cells.GetRow(Eigen::Array2i(begin_x, 0), num_cells, row.data());
+      for (int i = 0; i != num_cells; ++i) {
+        EXPECT_EQ(cells.value(Eigen::Array2i(begin_x + i, 0)), row[i])
+            << begin_x << " " << i;
+      }
+    }
+  }
+}
+
+TEST(TiledCellsTest, GrowKeepsCellsAndPointers) {
+  std::mt19937 prng(42);
+  CellLimits cell_limits(37, 53);
+  TiledCells cells(cell_limits, 0);
+  std::map<std::pair<int, int>, uint16*> written;
+  for (int i = 0; i != 300; ++i) {
+    const Eigen::Array2i cell_index(
+        std::uniform_int_distribution<int>(0, cell_limits.num_x_cells - 1)(
+            prng),
+        std::uniform_int_distribution<int>(0, cell_limits.num_y_cells - 1)(
+            prng));
+    uint16* const cell = cells.mutable_value(cell_index);
+    *cell = std::uniform_int_distribution<int>(1, 1000)(prng);
+    written[{cell_index.x(), cell_index.y()}] = cell;
+  }
+  const int num_allocated_tiles = cells.num_allocated_tiles();
+
+  // Grow like Grid2D::GrowLimits() does.
+  Eigen::Array2i total_offset = Eigen::Array2i::Zero();
+  for (int i = 0; i != 5; ++i) {
+    const Eigen::Array2i offset(cell_limits.num_x_cells / 2,
+                                cell_limits.num_y_cells / 2);
+    cell_limits = CellLimits(2 * cell_limits.num_x_cells,
+                             2 * cell_limits.num_y_cells);
+    cells.Grow(offset, cell_limits);
+    total_offset += offset;
+  }
+  EXPECT_EQ(cell_limits.num_x_cells, cells.cell_limits().num_x_cells);
+  EXPECT_EQ(cell_limits.num_y_cells, cells.cell_limits().num_y_cells);
+  EXPECT_EQ(num_allocated_tiles, cells.num_allocated_tiles());
+
+  for (int y = 0; y != cell_limits.num_y_cells; ++y) {
+    for (int x = 0; x != cell_limits.num_x_cells; ++x) {
+      const Eigen::Array2i original_index =
+          Eigen::Array2i(x, y) - total_offset;
+      const auto it = written.find({original_index.x(), original_index.y()});
+      if (it == written.end()) {
+        EXPECT_EQ(0, cells.value(Eigen::Array2i(x, y)));
+      } else {
+        // Pointers returned before growing still refer to the same cells.
+        EXPECT_EQ(*it->second, cells.value(Eigen::Array2i(x, y)));
+        EXPECT_EQ(it->second, cells.mutable_value(Eigen::Array2i(x, y)));
+      }
+    }
+  }
+}
+
+TEST(TiledCellsTest, GrowByOneCell) {
+  constexpr int kTileSize = TiledCells::kTileSize;
+  TiledCells cells(CellLimits(kTileSize, kTileSize), 0);
+  *cells.mutable_value(Eigen::Array2i(0, 0)) = 1;
+  *cells.mutable_value(Eigen::Array2i(kTileSize - 1, kTileSize - 1)) = 2;
+  // Moving the cells by one cell makes the tile lattice no longer start at
+  // the first cell, so the cells span two tiles in each direction.
+  cells.Grow(Eigen::Array2i(1, 1), CellLimits(kTileSize + 1, kTileSize + 1));
+  EXPECT_EQ(1, cells.num_allocated_tiles());
+  EXPECT_EQ(1, cells.value(Eigen::Array2i(1, 1)));
+  EXPECT_EQ(2, cells.value(Eigen::Array2i(kTileSize, kTileSize)));
+  EXPECT_EQ(0, cells.value(Eigen::Array2i(0, 0)));
+  *cells.mutable_value(Eigen::Array2i(0, 0)) = 3;
+  EXPECT_EQ(2, cells.num_allocated_tiles());
+  std::vector<uint16> row(kTileSize + 1);
+  cells.GetRow(Eigen::Array2i(0, 0), kTileSize + 1, row.data());
+  EXPECT_EQ(3, row[0]);
+  for (int x = 1; x != kTileSize + 1; ++x) {
+    EXPECT_EQ(0, row[x]);
+  }
+}
+
+TEST(TiledCellsTest, ComputeCroppedLimitsWithSparseTiles) {
+  constexpr int kTileSize = TiledCells::kTileSize;
+  ValueConversionTables conversion_tables;
+  ProbabilityGrid probability_grid(
+      MapLimits(0.05, Eigen::Vector2d(10., 10.), CellLimits(400, 400)),
+      &conversion_tables);
+  // Two known cells several tiles apart, so that only their tiles are
+  // allocated.
+  const Eigen::Array2i first(kTileSize - 1, 2 * kTileSize + 3);
+  const Eigen::Array2i second(4 * kTileSize + 1, kTileSize);
+  probability_grid.SetProbability(first, 0.3f);
+  probability_grid.SetProbability(second, 0.8f);
+
+  Eigen::Array2i offset;
+  CellLimits limits;
+  probability_grid.ComputeCroppedLimits(&offset, &limits);
+  EXPECT_TRUE((offset == Eigen::Array2i(kTileSize - 1, kTileSize)).all());
+  EXPECT_EQ(3 * kTileSize + 3, limits.num_x_cells);
+  EXPECT_EQ(kTileSize + 4, limits.num_y_cells);
+
+  const std::unique_ptr<Grid2D> cropped_grid =
+      probability_grid.ComputeCroppedGrid();
+  const auto& cropped_probability_grid =
+      static_cast<const ProbabilityGrid&>(*cropped_grid);
+  EXPECT_NEAR(0.3f, cropped_probability_grid.GetProbability(first - offset),
+              1e-3f);
+  EXPECT_NEAR(0.8f, cropped_probability_grid.GetProbability(second - offset),
+              1e-3f);
+  int num_known_cells = 0;
+  for (int y = 0; y != limits.num_y_cells; ++y) {
+    for (int x = 0; x != limits.num_x_cells; ++x) {
+      num_known_cells += cropped_probability_grid.IsKnown(Eigen::Array2i(x, y));
+    }
+  }
+  EXPECT_EQ(2, num_known_cells);
+}
+
+}  // namespace
+}  // namespace mapping
+}  // namespace cartographer
@@ -24,14 +24,46 @@ namespace cartographer {
 namespace mapping {
 namespace {
 
+Eigen::Vector3f Position3D(const sensor::PointCloud& point_cloud,
+                           const size_t index) {
+  return point_cloud[index].position;
+}
+
+Eigen::Vector3f Position3D(const sensor::SoaPointCloudView& point_cloud,
+                           const size_t index) {
+  return point_cloud.position(index);
+}
+
+const float* Intensities(const sensor::PointCloud& point_cloud) {
+  return point_cloud.intensities().empty() ? nullptr
+                                           : point_cloud.intensities().data();
+}
+
+const float* Intensities(const sensor::SoaPointCloudView& point_cloud) {
+  return point_cloud.intensity();
+}
+
+template <class PointCloudType>
+void InsertHitsIntoGrid(const std::vector<uint16>& hit_table,
+                        const PointCloudType& returns,
+                        HybridGrid* hybrid_grid) {
+  for (size_t i = 0; i < returns.size(); ++i) {
+    const Eigen::Array3i hit_cell =
+        hybrid_grid->GetCellIndex(Position3D(returns, i));
+    hybrid_grid->ApplyLookupTable(hit_cell, hit_table);
+  }
+}
+
+template <class PointCloudType>
 void InsertMissesIntoGrid(const std::vector<uint16>& miss_table,
                           const Eigen::Vector3f& origin,
-                          const sensor::PointCloud& returns,
+                          const PointCloudType& returns,
                           HybridGrid* hybrid_grid,
                           const int num_free_space_voxels) {
   const Eigen::Array3i origin_cell = hybrid_grid->GetCellIndex(origin);
-  for (const sensor::RangefinderPoint& hit : returns) {
-    const Eigen::Array3i hit_cell = hybrid_grid->GetCellIndex(hit.position);
+  for (size_t i = 0; i < returns.size(); ++i) {
+    const Eigen::Array3i hit_cell =
+        hybrid_grid->GetCellIndex(Position3D(returns, i));
 
     const Eigen::Array3i delta = hit_cell - origin_cell;
     const int num_samples = delta.cwiseAbs().maxCoeff();
@@ -51,18 +83,21 @@ void InsertMissesIntoGrid(const std::vector<uint16>& miss_table,
   }
 }
 
-void InsertIntensitiesIntoGrid(const sensor::PointCloud& returns,
+template <class PointCloudType>
+void InsertIntensitiesIntoGrid(const PointCloudType& returns,
                                IntensityHybridGrid* intensity_hybrid_grid,
                                const float intensity_threshold) {
-  if (returns.intensities().size() > 0) {
-    for (size_t i = 0; i < returns.size(); ++i) {
-      if (returns.intensities()[i] > intensity_threshold) {
-        continue;
-      }
-      const Eigen::Array3i hit_cell =
-          intensity_hybrid_grid->GetCellIndex(returns[i].position);
-      intensity_hybrid_grid->AddIntensity(hit_cell, returns.intensities()[i]);
+  const float* const intensities = Intensities(returns);
+  if (intensities == nullptr) {
+    return;
+  }
+  for (size_t i = 0; i < returns.size(); ++i) {
+    if (intensities[i] > intensity_threshold) {
+      continue;
     }
+    const Eigen::Array3i hit_cell =
+        intensity_hybrid_grid->GetCellIndex(Position3D(returns, i));
+    intensity_hybrid_grid->AddIntensity(hit_cell, intensities[i]);
   }
 }
 
@@ -96,18 +131,31 @@ void RangeDataInserter3D::Insert(
     const sensor::RangeData& range_data, HybridGrid* hybrid_grid,
     IntensityHybridGrid* intensity_hybrid_grid) const {
   CHECK_NOTNULL(hybrid_grid);
+  InsertReturns(range_data.origin, range_data.returns, hybrid_grid,
+                intensity_hybrid_grid);
+}
 
-  for (const sensor::RangefinderPoint& hit : range_data.returns) {
-    const Eigen::Array3i hit_cell = hybrid_grid->GetCellIndex(hit.position);
-    hybrid_grid->ApplyLookupTable(hit_cell, hit_table_);
-  }
+void RangeDataInserter3D::Insert(
+    const sensor::SoaRangeData& range_data, HybridGrid* hybrid_grid,
+    IntensityHybridGrid* intensity_hybrid_grid) const {
+  CHECK_NOTNULL(hybrid_grid);
+  InsertReturns(range_data.origin,
+                sensor::SoaPointCloudView(range_data.returns), hybrid_grid,
+                intensity_hybrid_grid);
+}
+
+template <class PointCloudType>
+void RangeDataInserter3D::InsertReturns(
+    const Eigen::Vector3f& origin, const PointCloudType& returns,
+    HybridGrid* hybrid_grid, IntensityHybridGrid* intensity_hybrid_grid) const {
+  InsertHitsIntoGrid(hit_table_, returns, hybrid_grid);
 
   // By not starting a new update after hits are inserted, we give hits priority
   // (i.e. no hits will be ignored because of a miss in the same cell).
-  InsertMissesIntoGrid(miss_table_, range_data.origin, range_data.returns,
-                       hybrid_grid, options_.num_free_space_voxels());
+  InsertMissesIntoGrid(miss_table_, origin, returns, hybrid_grid,
+                       options_.num_free_space_voxels());
   if (intensity_hybrid_grid != nullptr) {
-    InsertIntensitiesIntoGrid(range_data.returns, intensity_hybrid_grid,
+    InsertIntensitiesIntoGrid(returns, intensity_hybrid_grid,
                               options_.intensity_threshold());
   }
   hybrid_grid->FinishUpdate();
@@ -21,6 +21,7 @@
 #include "cartographer/mapping/proto/range_data_inserter_options_3d.pb.h"
 #include "cartographer/sensor/point_cloud.h"
 #include "cartographer/sensor/range_data.h"
+#include "cartographer/sensor/soa_point_cloud.h"
 
 namespace cartographer {
 namespace mapping {
@@ -41,7 +42,16 @@ class RangeDataInserter3D {
   void Insert(const sensor::RangeData& range_data, HybridGrid* hybrid_grid,
               IntensityHybridGrid* intensity_hybrid_grid) const;
 
+  // Same as above for range data stored as structure-of-arrays.
+  void Insert(const sensor::SoaRangeData& range_data, HybridGrid* hybrid_grid,
+              IntensityHybridGrid* intensity_hybrid_grid) const;
+
  private:
+  template <class PointCloudType>
+  void InsertReturns(const Eigen::Vector3f& origin,
+                     const PointCloudType& returns, HybridGrid* hybrid_grid,
+                     IntensityHybridGrid* intensity_hybrid_grid) const;
+
   const proto::RangeDataInserterOptions3D options_;
   const std::vector<uint16> hit_table_;
   const std::vector<uint16> miss_table_;
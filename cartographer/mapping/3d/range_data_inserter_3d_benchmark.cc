@@ -0,0 +1,53 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "cartographer/mapping/3d/hybrid_grid.h"
+#include "cartographer/mapping/3d/range_data_inserter_3d.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+#include "cartographer/sensor/range_data.h"
+
+namespace cartographer {
+namespace mapping {
+namespace {
+
+// Inserts a scan of a 16-ring lidar with 'state.range(0)' points per ring into
+// a high resolution hybrid grid, as done for each scan in ActiveSubmaps3D.
+void BM_RangeDataInserter3D_Insert(benchmark::State& state) {
+  proto::RangeDataInserterOptions3D options;
+  options.set_hit_probability(0.55);
+  options.set_miss_probability(0.49);
+  options.set_num_free_space_voxels(2);
+  options.set_intensity_threshold(40.f);
+  const RangeDataInserter3D range_data_inserter(options);
+  const sensor::RangeData range_data{
+      Eigen::Vector3f::Zero(),
+      sensor::testing::ToPointCloud(sensor::testing::GenerateSyntheticScan3D(
+          16, state.range(0), Eigen::Vector3f(12.f, 8.f, 3.f))),
+      {}};
+  HybridGrid hybrid_grid(0.10f);
+  for (auto _ : state) {
+    range_data_inserter.Insert(range_data, &hybrid_grid,
+                               /*intensity_hybrid_grid=*/nullptr);
+    hybrid_grid.FinishUpdate();
+  }
+  state.SetItemsProcessed(state.iterations() * range_data.returns.size());
+}
+BENCHMARK(BM_RangeDataInserter3D_Insert)->Arg(256)->Arg(1024);
+
+}  // namespace
+}  // namespace mapping
+}  // namespace cartographer
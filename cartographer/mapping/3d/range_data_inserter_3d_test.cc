@@ -66,6 +66,19 @@ class RangeDataInserter3DTest : public ::testing::Test {
         &hybrid_grid_, &intensity_hybrid_grid_);
   }
 
+  void InsertSoaPointCloudWithIntensities() {
+    sensor::SoaRangeData range_data{
+        Eigen::Vector3f(0.f, 0.f, -4.f),
+        sensor::SoaPointCloud(/*has_time=*/false, /*has_intensity=*/true),
+        sensor::SoaPointCloud()};
+    range_data.returns.push_back({-3.f, -1.f, 4.f}, 0.f, 7.f);
+    range_data.returns.push_back({-2.f, 0.f, 4.f}, 0.f, 8.f);
+    range_data.returns.push_back({-1.f, 1.f, 4.f}, 0.f, 9.f);
+    range_data.returns.push_back({0.f, 2.f, 4.f}, 0.f, 10.f);
+    range_data_inserter_->Insert(range_data, &hybrid_grid_,
+                                 &intensity_hybrid_grid_);
+  }
+
   float GetProbability(float x, float y, float z) const {
     return hybrid_grid_.GetProbability(
         hybrid_grid_.GetCellIndex(Eigen::Vector3f(x, y, z)));
@@ -132,6 +145,26 @@ TEST_F(RangeDataInserter3DTest, InsertPointCloudWithIntensities) {
   }
 }
 
+TEST_F(RangeDataInserter3DTest, InsertSoaPointCloudWithIntensities) {
+  InsertSoaPointCloudWithIntensities();
+  EXPECT_NEAR(options().miss_probability(), GetProbability(0.f, 0.f, -4.f),
+              1e-4);
+  EXPECT_NEAR(options().miss_probability(), GetProbability(0.f, 0.f, -2.f),
+              1e-4);
+  for (int x = -4; x <= 4; ++x) {
+    for (int y = -4; y <= 4; ++y) {
+      if (x < -3 || x > 0 || y != x + 2) {
+        EXPECT_FALSE(IsKnown(x, y, 4.f));
+        EXPECT_NEAR(0.f, GetIntensity(x, y, 4.f), 1e-6);
+      } else {
+        EXPECT_NEAR(options().hit_probability(), GetProbability(x, y, 4.f),
+                    1e-4);
+        EXPECT_NEAR(10 + x, GetIntensity(x, y, 4.f), 1e-6);
+      }
+    }
+  }
+}
+
 TEST_F(RangeDataInserter3DTest, ProbabilityProgression) {
   InsertPointCloud();
   EXPECT_NEAR(options().hit_probability(), GetProbability(-2.f, 0.f, 4.f),
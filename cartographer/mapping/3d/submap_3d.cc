@@ -187,6 +187,8 @@ proto::SubmapsOptions3D CreateSubmapsOptions3D(
   options.set_low_resolution(parameter_dictionary->GetDouble("low_resolution"));
   options.set_num_range_data(
       parameter_dictionary->GetNonNegativeInt("num_range_data"));
+  options.set_num_insertion_threads(
+      parameter_dictionary->GetNonNegativeInt("num_insertion_threads"));
   *options.mutable_range_data_inserter_options() =
       CreateRangeDataInserterOptions3D(
           parameter_dictionary->GetDictionary("range_data_inserter").get());
@@ -273,24 +275,45 @@ void Submap3D::InsertData(const sensor::RangeData& range_data_in_local,
                           const float high_resolution_max_range,
                           const Eigen::Quaterniond& local_from_gravity_aligned,
                           const Eigen::VectorXf& scan_histogram_in_gravity) {
+  for (const auto& work_item : CreateInsertDataWorkItems(
+           range_data_in_local, range_data_inserter, high_resolution_max_range,
+           local_from_gravity_aligned, scan_histogram_in_gravity)) {
+    work_item();
+  }
+}
+
+std::vector<common::Task::WorkItem> Submap3D::CreateInsertDataWorkItems(
+    const sensor::RangeData& range_data_in_local,
+    const RangeDataInserter3D& range_data_inserter,
+    const float high_resolution_max_range,
+    const Eigen::Quaterniond& local_from_gravity_aligned,
+    const Eigen::VectorXf& scan_histogram_in_gravity) {
   CHECK(!insertion_finished());
   // Transform range data into submap frame.
-  const sensor::RangeData transformed_range_data = sensor::TransformRangeData(
-      range_data_in_local, local_pose().inverse().cast<float>());
-  range_data_inserter.Insert(
-      FilterRangeDataByMaxRange(transformed_range_data,
-                                high_resolution_max_range),
-      high_resolution_hybrid_grid_.get(),
-      high_resolution_intensity_hybrid_grid_.get());
-  range_data_inserter.Insert(transformed_range_data,
-                             low_resolution_hybrid_grid_.get(),
-                             /*intensity_hybrid_grid=*/nullptr);
+  const auto transformed_range_data =
+      std::make_shared<const sensor::RangeData>(sensor::TransformRangeData(
+          range_data_in_local, local_pose().inverse().cast<float>()));
+  std::vector<common::Task::WorkItem> work_items;
+  work_items.push_back([this, transformed_range_data, &range_data_inserter,
+                        high_resolution_max_range]() {
+    range_data_inserter.Insert(
+        FilterRangeDataByMaxRange(*transformed_range_data,
+                                  high_resolution_max_range),
+        high_resolution_hybrid_grid_.get(),
+        high_resolution_intensity_hybrid_grid_.get());
+  });
+  work_items.push_back([this, transformed_range_data, &range_data_inserter]() {
+    range_data_inserter.Insert(*transformed_range_data,
+                               low_resolution_hybrid_grid_.get(),
+                               /*intensity_hybrid_grid=*/nullptr);
+  });
   set_num_range_data(num_range_data() + 1);
   const float yaw_in_submap_from_gravity = transform::GetYaw(
       local_pose().inverse().rotation() * local_from_gravity_aligned);
   rotational_scan_matcher_histogram_ +=
       scan_matching::RotationalScanMatcher::RotateHistogram(
           scan_histogram_in_gravity, yaw_in_submap_from_gravity);
+  return work_items;
 }
 
 void Submap3D::Finish() {
@@ -300,7 +323,14 @@ void Submap3D::Finish() {
 
 ActiveSubmaps3D::ActiveSubmaps3D(const proto::SubmapsOptions3D& options)
     : options_(options),
-      range_data_inserter_(options.range_data_inserter_options()) {}
+      range_data_inserter_(options.range_data_inserter_options()) {
+  if (options_.num_insertion_threads() > 0) {
+    // Local SLAM waits for the insertion, so the threads keep their priority.
+    thread_pool_ = absl::make_unique<common::ThreadPool>(
+        options_.num_insertion_threads(), "submap_insertion",
+        false /* lower_thread_priority */);
+  }
+}
 
 std::vector<std::shared_ptr<const Submap3D>> ActiveSubmaps3D::submaps() const {
   return std::vector<std::shared_ptr<const Submap3D>>(submaps_.begin(),
@@ -317,11 +347,28 @@ std::vector<std::shared_ptr<const Submap3D>> ActiveSubmaps3D::InsertData(
                                  local_from_gravity_aligned),
               rotational_scan_matcher_histogram_in_gravity.size());
   }
-  for (auto& submap : submaps_) {
-    submap->InsertData(range_data, range_data_inserter_,
-                       options_.high_resolution_max_range(),
-                       local_from_gravity_aligned,
-                       rotational_scan_matcher_histogram_in_gravity);
+  if (thread_pool_ != nullptr) {
+    // Each work item updates a separate grid and the inserter is stateless, so
+    // the result does not depend on the order of insertion.
+    std::vector<common::Task::WorkItem> work_items;
+    for (auto& submap : submaps_) {
+      for (auto& work_item : submap->CreateInsertDataWorkItems(
+               range_data, range_data_inserter_,
+               options_.high_resolution_max_range(),
+               local_from_gravity_aligned,
+               rotational_scan_matcher_histogram_in_gravity)) {
+        work_items.push_back(std::move(work_item));
+      }
+    }
+    common::RunInParallel(work_items, common::Task::REALTIME,
+                          "submap_insertion_3d", thread_pool_.get());
+  } else {
+    for (auto& submap : submaps_) {
+      submap->InsertData(range_data, range_data_inserter_,
+                         options_.high_resolution_max_range(),
+                         local_from_gravity_aligned,
+                         rotational_scan_matcher_histogram_in_gravity);
+    }
   }
   if (submaps_.front()->num_range_data() == 2 * options_.num_range_data()) {
     submaps_.front()->Finish();
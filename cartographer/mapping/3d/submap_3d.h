@@ -23,6 +23,7 @@
 
 #include "Eigen/Geometry"
 #include "cartographer/common/port.h"
+#include "cartographer/common/thread_pool.h"
 #include "cartographer/mapping/3d/hybrid_grid.h"
 #include "cartographer/mapping/3d/range_data_inserter_3d.h"
 #include "cartographer/mapping/id.h"
@@ -80,6 +81,17 @@ class Submap3D : public Submap {
                   const Eigen::Quaterniond& local_from_gravity_aligned,
                   const Eigen::VectorXf& scan_histogram_in_gravity);
 
+  // Like InsertData(), but returns the insertion into the high and the low
+  // resolution grid as separate work items instead of running them. They may
+  // run concurrently with each other and with those of other submaps, and
+  // must complete before this submap is used again.
+  std::vector<common::Task::WorkItem> CreateInsertDataWorkItems(
+      const sensor::RangeData& range_data,
+      const RangeDataInserter3D& range_data_inserter,
+      float high_resolution_max_range,
+      const Eigen::Quaterniond& local_from_gravity_aligned,
+      const Eigen::VectorXf& scan_histogram_in_gravity);
+
   void Finish();
 
  private:
@@ -127,6 +139,8 @@ class ActiveSubmaps3D {
   const proto::SubmapsOptions3D options_;
   std::vector<std::shared_ptr<Submap3D>> submaps_;
   RangeDataInserter3D range_data_inserter_;
+  // Inserts into the grids of the active submaps concurrently if not null.
+  std::unique_ptr<common::ThreadPool> thread_pool_;
 };
 
 }  // namespace mapping
@@ -16,6 +16,7 @@
 
 #include "cartographer/mapping/3d/submap_3d.h"
 
+#include "cartographer/sensor/internal/test_helpers.h"
 #include "cartographer/transform/transform.h"
 #include "gmock/gmock.h"
 
@@ -48,6 +49,43 @@ TEST(SubmapsTest, ToFromProto) {
       actual.rotational_scan_matcher_histogram(), 1e-6));
 }
 
+TEST(SubmapsTest, ParallelInsertionMatchesSequentialInsertion) {
+  proto::SubmapsOptions3D options;
+  options.set_high_resolution(0.1);
+  options.set_high_resolution_max_range(3.);
+  options.set_low_resolution(0.4);
+  options.set_num_range_data(3);
+  auto* const range_data_inserter_options =
+      options.mutable_range_data_inserter_options();
+  range_data_inserter_options->set_hit_probability(0.7);
+  range_data_inserter_options->set_miss_probability(0.4);
+  range_data_inserter_options->set_num_free_space_voxels(2);
+  range_data_inserter_options->set_intensity_threshold(100.f);
+  ActiveSubmaps3D sequential_submaps(options);
+  options.set_num_insertion_threads(3);
+  ActiveSubmaps3D parallel_submaps(options);
+
+  const sensor::PointCloud scan =
+      sensor::testing::ToPointCloud(sensor::testing::GenerateSyntheticScan3D(
+          8, 180, Eigen::Vector3f(4.f, 3.f, 2.f)));
+  Eigen::VectorXf histogram(4);
+  histogram << 1.f, 2.f, 3.f, 4.f;
+  for (int i = 0; i != 10; ++i) {
+    const sensor::RangeData range_data = sensor::TransformRangeData(
+        {Eigen::Vector3f::Zero(), scan, {}},
+        transform::Rigid3f::Translation(Eigen::Vector3f(0.3f * i, 0.f, 0.f)));
+    const auto expected = sequential_submaps.InsertData(
+        range_data, Eigen::Quaterniond::Identity(), histogram);
+    const auto actual = parallel_submaps.InsertData(
+        range_data, Eigen::Quaterniond::Identity(), histogram);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t j = 0; j != expected.size(); ++j) {
+      EXPECT_EQ(expected[j]->ToProto(true).SerializeAsString(),
+                actual[j]->ToProto(true).SerializeAsString());
+    }
+  }
+}
+
 }  // namespace
 }  // namespace mapping
 }  // namespace cartographer
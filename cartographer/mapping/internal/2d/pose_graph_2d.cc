@@ -52,7 +52,7 @@ static auto* kDeletedSubmapsMetric = metrics::Gauge::Null();
 PoseGraph2D::PoseGraph2D(
     const proto::PoseGraphOptions& options,
     std::unique_ptr<optimization::OptimizationProblem2D> optimization_problem,
-    common::ThreadPool* thread_pool)
+    common::ThreadPoolInterface* thread_pool)
     : options_(options),
       optimization_problem_(std::move(optimization_problem)),
       constraint_builder_(options_.constraint_builder_options(), thread_pool),
@@ -155,6 +155,10 @@ NodeId PoseGraph2D::AddNode(
     std::shared_ptr<const TrajectoryNode::Data> constant_data,
     const int trajectory_id,
     const std::vector<std::shared_ptr<const Submap2D>>& insertion_submaps) {
+  if (options_.compress_node_point_clouds()) {
+    constant_data = std::make_shared<const TrajectoryNode::Data>(
+        CompressPointClouds(*constant_data));
+  }
   const transform::Rigid3d optimized_pose(
       GetLocalToGlobalTransform(trajectory_id) * constant_data->local_pose);
 
@@ -178,6 +182,8 @@ void PoseGraph2D::AddWorkItem(
     work_queue_ = absl::make_unique<WorkQueue>();
     auto task = absl::make_unique<common::Task>();
     task->SetWorkItem([this]() { DrainWorkQueue(); });
+    task->SetPriority(common::Task::REALTIME);
+    task->SetLabel("pose_graph_work_queue_2d");
     thread_pool_->Schedule(std::move(task));
   }
   const auto now = std::chrono::steady_clock::now();
@@ -733,7 +739,10 @@ void PoseGraph2D::AddNodeFromProto(const transform::Rigid3d& global_pose,
   const NodeId node_id = {node.node_id().trajectory_id(),
                           node.node_id().node_index()};
   std::shared_ptr<const TrajectoryNode::Data> constant_data =
-      std::make_shared<const TrajectoryNode::Data>(FromProto(node.node_data()));
+      std::make_shared<const TrajectoryNode::Data>(
+          options_.compress_node_point_clouds()
+              ? FromProtoWithCompressedPointClouds(node.node_data())
+              : FromProto(node.node_data()));
 
   {
     absl::MutexLock locker(&mutex_);
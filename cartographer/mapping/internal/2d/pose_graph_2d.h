@@ -66,7 +66,7 @@ class PoseGraph2D : public PoseGraph {
   PoseGraph2D(
       const proto::PoseGraphOptions& options,
       std::unique_ptr<optimization::OptimizationProblem2D> optimization_problem,
-      common::ThreadPool* thread_pool);
+      common::ThreadPoolInterface* thread_pool);
   ~PoseGraph2D() override;
 
   PoseGraph2D(const PoseGraph2D&) = delete;
@@ -114,6 +114,8 @@ class PoseGraph2D : public PoseGraph {
       const std::vector<Constraint>& constraints) override;
   void AddTrimmer(std::unique_ptr<PoseGraphTrimmer> trimmer) override;
   void RunFinalOptimization() override;
+  void WaitForAllComputations() LOCKS_EXCLUDED(mutex_)
+      LOCKS_EXCLUDED(work_queue_mutex_) override;
   std::vector<std::vector<int>> GetConnectedTrajectories() const override
       LOCKS_EXCLUDED(mutex_);
   PoseGraphInterface::SubmapData GetSubmapData(const SubmapId& submap_id) const
@@ -209,11 +211,6 @@ class PoseGraph2D : public PoseGraph {
   void DrainWorkQueue() LOCKS_EXCLUDED(mutex_)
       LOCKS_EXCLUDED(work_queue_mutex_);
 
-  // Waits until we caught up (i.e. nothing is waiting to be scheduled), and
-  // all computations have finished.
-  void WaitForAllComputations() LOCKS_EXCLUDED(mutex_)
-      LOCKS_EXCLUDED(work_queue_mutex_);
-
   // Runs the optimization. Callers have to make sure, that there is only one
   // optimization being run at a time.
   void RunOptimization() LOCKS_EXCLUDED(mutex_);
@@ -259,7 +256,7 @@ class PoseGraph2D : public PoseGraph {
   constraints::ConstraintBuilder2D constraint_builder_;
 
   // Thread pool used for handling the work queue.
-  common::ThreadPool* const thread_pool_;
+  common::ThreadPoolInterface* const thread_pool_;
 
   // List of all trimmers to consult when optimizations finish.
   std::vector<std::unique_ptr<PoseGraphTrimmer>> trimmers_ GUARDED_BY(mutex_);
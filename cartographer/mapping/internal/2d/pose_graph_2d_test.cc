@@ -52,6 +52,7 @@ class PoseGraph2DTest : public ::testing::Test {
       auto parameter_dictionary = common::MakeDictionary(R"text(
           return {
             num_range_data = 1,
+            num_insertion_threads = 0,
             grid_options_2d = {
               grid_type = "PROBABILITY_GRID",
               resolution = 0.05,
@@ -94,6 +95,9 @@ class PoseGraph2DTest : public ::testing::Test {
               loop_closure_translation_weight = 1.,
               loop_closure_rotation_weight = 1.,
               log_matches = true,
+              decompressed_node_cache_size = 100,
+              rotated_scan_cache_max_bytes = 64 * 1024 * 1024,
+              num_scan_matcher_threads = 2,
               fast_correlative_scan_matcher = {
                 linear_search_window = 3.,
                 angular_search_window = 0.1,
@@ -158,6 +162,7 @@ class PoseGraph2DTest : public ::testing::Test {
             global_sampling_ratio = 0.01,
             log_residual_histograms = true,
             global_constraint_search_after_n_seconds = 10.0,
+            compress_node_point_clouds = false,
           })text");
       auto options = CreatePoseGraphOptions(parameter_dictionary.get());
       pose_graph_ = absl::make_unique<PoseGraph2D>(
@@ -17,13 +17,144 @@
 #ifndef CARTOGRAPHER_MAPPING_INTERNAL_2D_RAY_TO_PIXEL_MASK_H_
 #define CARTOGRAPHER_MAPPING_INTERNAL_2D_RAY_TO_PIXEL_MASK_H_
 
+#include <algorithm>
 #include <vector>
 
+#include "cartographer/common/port.h"
 #include "cartographer/transform/transform.h"
+#include "glog/logging.h"
 
 namespace cartographer {
 namespace mapping {
 
+// Calls 'visitor' with all pixels that contain some part of the line segment
+// connecting 'scaled_begin' and 'scaled_end', in the same order as
+// RayToPixelMask() returns them. This walks the pixels with an integer DDA and
+// does not allocate.
+template <typename Visitor>
+void ForEachPixelOnRay(const Eigen::Array2i& scaled_begin,
+                       const Eigen::Array2i& scaled_end,
+                       const int subpixel_scale, Visitor&& visitor) {
+  // For simplicity, we order 'scaled_begin' and 'scaled_end' by their x
+  // coordinate.
+  if (scaled_begin.x() > scaled_end.x()) {
+    ForEachPixelOnRay(scaled_end, scaled_begin, subpixel_scale, visitor);
+    return;
+  }
+
+  DCHECK_GE(scaled_begin.x(), 0);
+  DCHECK_GE(scaled_begin.y(), 0);
+  DCHECK_GE(scaled_end.y(), 0);
+  // Special case: We have to draw a vertical line in full pixels, as
+  // 'scaled_begin' and 'scaled_end' have the same full pixel x coordinate.
+  if (scaled_begin.x() / subpixel_scale == scaled_end.x() / subpixel_scale) {
+    Eigen::Array2i current(
+        scaled_begin.x() / subpixel_scale,
+        std::min(scaled_begin.y(), scaled_end.y()) / subpixel_scale);
+    const int end_y =
+        std::max(scaled_begin.y(), scaled_end.y()) / subpixel_scale;
+    for (; current.y() <= end_y; ++current.y()) {
+      visitor(current);
+    }
+    return;
+  }
+
+  const int64 dx = scaled_end.x() - scaled_begin.x();
+  const int64 dy = scaled_end.y() - scaled_begin.y();
+  const int64 denominator = 2 * subpixel_scale * dx;
+
+  // The current full pixel coordinates. We start at 'scaled_begin'. Every
+  // step below moves to a new pixel, so each pixel is visited exactly once.
+  Eigen::Array2i current = scaled_begin / subpixel_scale;
+  visitor(current);
+
+  // To represent subpixel centers, we use a factor of 2 * 'subpixel_scale' in
+  // the denominator.
+  // +-+-+-+ -- 1 = (2 * subpixel_scale) / (2 * subpixel_scale)
+  // | | | |
+  // +-+-+-+
+  // | | | |
+  // +-+-+-+ -- top edge of first subpixel = 2 / (2 * subpixel_scale)
+  // | | | | -- center of first subpixel = 1 / (2 * subpixel_scale)
+  // +-+-+-+ -- 0 = 0 / (2 * subpixel_scale)
+
+  // The center of the subpixel part of 'scaled_begin.y()' assuming the
+  // 'denominator', i.e., sub_y / denominator is in (0, 1).
+  int64 sub_y = (2 * (scaled_begin.y() % subpixel_scale) + 1) * dx;
+
+  // The distance from the from 'scaled_begin' to the right pixel border, to be
+  // divided by 2 * 'subpixel_scale'.
+  const int first_pixel =
+      2 * subpixel_scale - 2 * (scaled_begin.x() % subpixel_scale) - 1;
+  // The same from the left pixel border to 'scaled_end'.
+  const int last_pixel = 2 * (scaled_end.x() % subpixel_scale) + 1;
+
+  // The full pixel x coordinate of 'scaled_end'.
+  const int end_x = std::max(scaled_begin.x(), scaled_end.x()) / subpixel_scale;
+
+  // Move from 'scaled_begin' to the next pixel border to the right.
+  sub_y += dy * first_pixel;
+  if (dy > 0) {
+    while (true) {
+      while (sub_y > denominator) {
+        sub_y -= denominator;
+        ++current.y();
+        visitor(current);
+      }
+      ++current.x();
+      if (sub_y == denominator) {
+        sub_y -= denominator;
+        ++current.y();
+      }
+      if (current.x() == end_x) {
+        break;
+      }
+      visitor(current);
+      // Move from one pixel border to the next.
+      sub_y += dy * 2 * subpixel_scale;
+    }
+    // Move from the pixel border on the right to 'scaled_end'.
+    sub_y += dy * last_pixel;
+    visitor(current);
+    while (sub_y > denominator) {
+      sub_y -= denominator;
+      ++current.y();
+      visitor(current);
+    }
+    CHECK_NE(sub_y, denominator);
+    CHECK_EQ(current.y(), scaled_end.y() / subpixel_scale);
+    return;
+  }
+
+  // Same for lines non-ascending in y coordinates.
+  while (true) {
+    while (sub_y < 0) {
+      sub_y += denominator;
+      --current.y();
+      visitor(current);
+    }
+    ++current.x();
+    if (sub_y == 0) {
+      sub_y += denominator;
+      --current.y();
+    }
+    if (current.x() == end_x) {
+      break;
+    }
+    visitor(current);
+    sub_y += dy * 2 * subpixel_scale;
+  }
+  sub_y += dy * last_pixel;
+  visitor(current);
+  while (sub_y < 0) {
+    sub_y += denominator;
+    --current.y();
+    visitor(current);
+  }
+  CHECK_NE(sub_y, 0);
+  CHECK_EQ(current.y(), scaled_end.y() / subpixel_scale);
+}
+
 // Compute all pixels that contain some part of the line segment connecting
 // 'scaled_begin' and 'scaled_end'. 'scaled_begin' and 'scaled_end' are scaled
 // by 'subpixel_scale'. 'scaled_begin' and 'scaled_end' are expected to be
@@ -202,6 +202,27 @@ TEST(RayToPixelMaskTest, MultiScaleSkewedLine) {
                                PixelMaskEqual(Eigen::Array2i({9, 9}))));
 }
 
+TEST(RayToPixelMaskTest, ForEachPixelOnRayMatchesRayToPixelMask) {
+  const int subpixel_scale = 10;
+  const Eigen::Array2i begin = {153, 271};
+  for (int x = 0; x < 400; x += 7) {
+    for (int y = 0; y < 400; y += 11) {
+      const Eigen::Array2i end = {x, y};
+      std::vector<Eigen::Array2i> visited;
+      ForEachPixelOnRay(begin, end, subpixel_scale,
+                        [&visited](const Eigen::Array2i& pixel) {
+                          visited.push_back(pixel);
+                        });
+      const std::vector<Eigen::Array2i> ray =
+          RayToPixelMask(begin, end, subpixel_scale);
+      ASSERT_EQ(visited.size(), ray.size());
+      for (size_t i = 0; i < ray.size(); ++i) {
+        EXPECT_THAT(visited[i], PixelMaskEqual(ray[i]));
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace mapping
 }  // namespace cartographer
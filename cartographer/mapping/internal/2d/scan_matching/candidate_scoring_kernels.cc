@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/internal/2d/scan_matching/candidate_scoring_kernels.h"
+
+#include <cstddef>
+#include <limits>
+
+#include "glog/logging.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CARTOGRAPHER_SCAN_MATCHING_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+namespace {
+
+template <typename SumType, typename ValueType>
+SumType SumCellValuesScalar(const ScoringGrid2D<ValueType>& grid,
+                            const SoaDiscreteScan2D& discrete_scan,
+                            const size_t begin, const int x_index_offset,
+                            const int y_index_offset) {
+  const int x_shift = x_index_offset - grid.offset.x();
+  const int y_shift = y_index_offset - grid.offset.y();
+  SumType sum = 0;
+  for (size_t i = begin; i < discrete_scan.x_indices.size(); ++i) {
+    const int x = discrete_scan.x_indices[i] + x_shift;
+    const int y = discrete_scan.y_indices[i] + y_shift;
+    // The static_cast<unsigned> checks 0 <= x < num_x_cells with a single
+    // comparison, and the same for y.
+    if (static_cast<unsigned>(x) < static_cast<unsigned>(grid.num_x_cells) &&
+        static_cast<unsigned>(y) < static_cast<unsigned>(grid.num_y_cells)) {
+      sum += grid.data[x + y * grid.num_x_cells];
+    } else {
+      sum += grid.outside_value;
+    }
+  }
+  return sum;
+}
+
+#ifdef CARTOGRAPHER_SCAN_MATCHING_X86_KERNELS
+
+// Computes the indices into the grid data of 8 cells at a time, and which of
+// them are inside the grid.
+struct CellIndices {
+  template <typename ValueType>
+  __attribute__((target("avx2"))) CellIndices(
+      const ScoringGrid2D<ValueType>& grid, const int x_index_offset,
+      const int y_index_offset)
+      : x_shift(_mm256_set1_epi32(x_index_offset - grid.offset.x())),
+        y_shift(_mm256_set1_epi32(y_index_offset - grid.offset.y())),
+        sign_bit(_mm256_set1_epi32(std::numeric_limits<int>::min())),
+        biased_num_x_cells(_mm256_xor_si256(
+            _mm256_set1_epi32(grid.num_x_cells), sign_bit)),
+        biased_num_y_cells(_mm256_xor_si256(
+            _mm256_set1_epi32(grid.num_y_cells), sign_bit)),
+        stride(_mm256_set1_epi32(grid.num_x_cells)) {}
+
+  // Returns the indices of the cells 'i' to 'i' + 7 of 'discrete_scan' and
+  // sets 'inside' to all ones for those inside the grid.
+  __attribute__((target("avx2"))) __m256i Load(
+      const SoaDiscreteScan2D& discrete_scan, const size_t i,
+      __m256i* const inside) const {
+    const __m256i x = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            discrete_scan.x_indices.data() + i)),
+        x_shift);
+    const __m256i y = _mm256_add_epi32(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+            discrete_scan.y_indices.data() + i)),
+        y_shift);
+    // Flipping the sign bits turns the signed comparison into an unsigned one
+    // which also rejects negative indices.
+    *inside = _mm256_and_si256(
+        _mm256_cmpgt_epi32(biased_num_x_cells, _mm256_xor_si256(x, sign_bit)),
+        _mm256_cmpgt_epi32(biased_num_y_cells, _mm256_xor_si256(y, sign_bit)));
+    return _mm256_add_epi32(x, _mm256_mullo_epi32(y, stride));
+  }
+
+  const __m256i x_shift;
+  const __m256i y_shift;
+  const __m256i sign_bit;
+  const __m256i biased_num_x_cells;
+  const __m256i biased_num_y_cells;
+  const __m256i stride;
+};
+
+__attribute__((target("avx2"))) int SumCellValuesAvx2(
+    const ScoringGrid2D<uint8>& grid, const SoaDiscreteScan2D& discrete_scan,
+    const int x_index_offset, const int y_index_offset) {
+  const CellIndices cell_indices(grid, x_index_offset, y_index_offset);
+  const __m256i outside_value = _mm256_set1_epi32(grid.outside_value);
+  const __m256i low_byte = _mm256_set1_epi32(0xff);
+  const size_t num_cells = discrete_scan.x_indices.size();
+  const size_t num_batched = num_cells - num_cells % 8;
+  __m256i sum = _mm256_setzero_si256();
+  for (size_t i = 0; i < num_batched; i += 8) {
+    __m256i inside;
+    const __m256i index = cell_indices.Load(discrete_scan, i, &inside);
+    // Gathers the 32-bit words starting at the cells, of which we keep the
+    // first byte. This is why the grid data needs 3 bytes of padding.
+    const __m256i words = _mm256_mask_i32gather_epi32(
+        outside_value, reinterpret_cast<const int*>(grid.data), index, inside,
+        1);
+    sum = _mm256_add_epi32(sum, _mm256_and_si256(words, low_byte));
+  }
+  __m128i sum_128 = _mm_add_epi32(_mm256_castsi256_si128(sum),
+                                  _mm256_extracti128_si256(sum, 1));
+  sum_128 = _mm_add_epi32(sum_128,
+                          _mm_shuffle_epi32(sum_128, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum_128 = _mm_add_epi32(sum_128,
+                          _mm_shuffle_epi32(sum_128, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum_128) +
+         SumCellValuesScalar<int>(grid, discrete_scan, num_batched,
+                                  x_index_offset, y_index_offset);
+}
+
+__attribute__((target("avx2"))) float SumCellValuesAvx2(
+    const ScoringGrid2D<float>& grid, const SoaDiscreteScan2D& discrete_scan,
+    const int x_index_offset, const int y_index_offset) {
+  const CellIndices cell_indices(grid, x_index_offset, y_index_offset);
+  const __m256 outside_value = _mm256_set1_ps(grid.outside_value);
+  const size_t num_cells = discrete_scan.x_indices.size();
+  const size_t num_batched = num_cells - num_cells % 8;
+  __m256 sum = _mm256_setzero_ps();
+  for (size_t i = 0; i < num_batched; i += 8) {
+    __m256i inside;
+    const __m256i index = cell_indices.Load(discrete_scan, i, &inside);
+    sum = _mm256_add_ps(
+        sum, _mm256_mask_i32gather_ps(outside_value, grid.data, index,
+                                      _mm256_castsi256_ps(inside), 4));
+  }
+  __m128 sum_128 = _mm_add_ps(_mm256_castps256_ps128(sum),
+                              _mm256_extractf128_ps(sum, 1));
+  sum_128 = _mm_add_ps(sum_128, _mm_movehl_ps(sum_128, sum_128));
+  sum_128 = _mm_add_ss(sum_128, _mm_movehdup_ps(sum_128));
+  return _mm_cvtss_f32(sum_128) +
+         SumCellValuesScalar<float>(grid, discrete_scan, num_batched,
+                                    x_index_offset, y_index_offset);
+}
+
+#endif  // CARTOGRAPHER_SCAN_MATCHING_X86_KERNELS
+
+template <typename SumType, typename ValueType>
+SumType SumCellValuesWithKernel(const ScoringGrid2D<ValueType>& grid,
+                                const SoaDiscreteScan2D& discrete_scan,
+                                const int x_index_offset,
+                                const int y_index_offset,
+                                const ScoringKernel kernel) {
+  CHECK(IsScoringKernelSupported(kernel));
+  DCHECK_EQ(discrete_scan.x_indices.size(), discrete_scan.y_indices.size());
+  switch (kernel) {
+#ifdef CARTOGRAPHER_SCAN_MATCHING_X86_KERNELS
+    case ScoringKernel::kAvx2:
+      return SumCellValuesAvx2(grid, discrete_scan, x_index_offset,
+                               y_index_offset);
+#endif
+    default:
+      return SumCellValuesScalar<SumType>(grid, discrete_scan, 0,
+                                          x_index_offset, y_index_offset);
+  }
+}
+
+}  // namespace
+
+std::vector<SoaDiscreteScan2D> ToSoaDiscreteScans(
+    const std::vector<DiscreteScan2D>& discrete_scans) {
+  std::vector<SoaDiscreteScan2D> soa_discrete_scans(discrete_scans.size());
+  for (size_t i = 0; i != discrete_scans.size(); ++i) {
+    SoaDiscreteScan2D& soa_discrete_scan = soa_discrete_scans[i];
+    soa_discrete_scan.x_indices.reserve(discrete_scans[i].size());
+    soa_discrete_scan.y_indices.reserve(discrete_scans[i].size());
+    for (const Eigen::Array2i& xy_index : discrete_scans[i]) {
+      soa_discrete_scan.x_indices.push_back(xy_index.x());
+      soa_discrete_scan.y_indices.push_back(xy_index.y());
+    }
+  }
+  return soa_discrete_scans;
+}
+
+bool IsScoringKernelSupported(const ScoringKernel kernel) {
+  switch (kernel) {
+    case ScoringKernel::kScalar:
+      return true;
+#ifdef CARTOGRAPHER_SCAN_MATCHING_X86_KERNELS
+    case ScoringKernel::kAvx2:
+      return __builtin_cpu_supports("avx2");
+#endif
+    default:
+      return false;
+  }
+}
+
+ScoringKernel GetFastestScoringKernel() {
+  static const ScoringKernel kFastestKernel =
+      IsScoringKernelSupported(ScoringKernel::kAvx2) ? ScoringKernel::kAvx2
+                                                     : ScoringKernel::kScalar;
+  return kFastestKernel;
+}
+
+int SumCellValues(const ScoringGrid2D<uint8>& grid,
+                  const SoaDiscreteScan2D& discrete_scan,
+                  const int x_index_offset, const int y_index_offset,
+                  const ScoringKernel kernel) {
+  return SumCellValuesWithKernel<int>(grid, discrete_scan, x_index_offset,
+                                      y_index_offset, kernel);
+}
+
+float SumCellValues(const ScoringGrid2D<float>& grid,
+                    const SoaDiscreteScan2D& discrete_scan,
+                    const int x_index_offset, const int y_index_offset,
+                    const ScoringKernel kernel) {
+  return SumCellValuesWithKernel<float>(grid, discrete_scan, x_index_offset,
+                                        y_index_offset, kernel);
+}
+
+int SumCellValues(const ScoringGrid2D<uint8>& grid,
+                  const SoaDiscreteScan2D& discrete_scan,
+                  const int x_index_offset, const int y_index_offset) {
+  return SumCellValues(grid, discrete_scan, x_index_offset, y_index_offset,
+                       GetFastestScoringKernel());
+}
+
+float SumCellValues(const ScoringGrid2D<float>& grid,
+                    const SoaDiscreteScan2D& discrete_scan,
+                    const int x_index_offset, const int y_index_offset) {
+  return SumCellValues(grid, discrete_scan, x_index_offset, y_index_offset,
+                       GetFastestScoringKernel());
+}
+
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
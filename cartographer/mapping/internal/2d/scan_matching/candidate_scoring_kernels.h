@@ -0,0 +1,87 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_CANDIDATE_SCORING_KERNELS_H_
+#define CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_CANDIDATE_SCORING_KERNELS_H_
+
+#include <vector>
+
+#include "Eigen/Core"
+#include "cartographer/common/port.h"
+#include "cartographer/mapping/internal/2d/scan_matching/correlative_scan_matcher_2d.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+
+// A 'DiscreteScan2D' with the x and y indices of the cells in separate arrays,
+// so that the kernels can load the indices of consecutive cells at once.
+struct SoaDiscreteScan2D {
+  std::vector<int> x_indices;
+  std::vector<int> y_indices;
+};
+
+std::vector<SoaDiscreteScan2D> ToSoaDiscreteScans(
+    const std::vector<DiscreteScan2D>& discrete_scans);
+
+// Dense values of the 'num_x_cells' x 'num_y_cells' cells starting at cell
+// index 'offset', stored row by row. All other cells have 'outside_value'.
+// For uint8 values, 3 more bytes must be readable after the last cell, since
+// the AVX2 kernel gathers 32-bit words.
+template <typename ValueType>
+struct ScoringGrid2D {
+  const ValueType* data;
+  Eigen::Array2i offset;
+  int num_x_cells;
+  int num_y_cells;
+  ValueType outside_value;
+};
+
+// Implementations of summing up the values of the cells of a scan. 'kAvx2'
+// gathers the values of 8 cells per iteration and selects 'outside_value' for
+// cells outside the grid with a mask instead of branches. Integer sums of all
+// kernels are equal, float sums agree within float rounding.
+enum class ScoringKernel { kScalar, kAvx2 };
+
+// Returns true if 'kernel' can be used on the CPU we are running on.
+bool IsScoringKernelSupported(ScoringKernel kernel);
+
+// Returns the fastest kernel supported by the CPU we are running on.
+ScoringKernel GetFastestScoringKernel();
+
+// Returns the sum of the values in 'grid' of the cells of 'discrete_scan'
+// shifted by 'x_index_offset' and 'y_index_offset', using 'kernel' which must
+// be supported.
+int SumCellValues(const ScoringGrid2D<uint8>& grid,
+                  const SoaDiscreteScan2D& discrete_scan, int x_index_offset,
+                  int y_index_offset, ScoringKernel kernel);
+float SumCellValues(const ScoringGrid2D<float>& grid,
+                    const SoaDiscreteScan2D& discrete_scan, int x_index_offset,
+                    int y_index_offset, ScoringKernel kernel);
+
+// Same as above, using the fastest supported kernel.
+int SumCellValues(const ScoringGrid2D<uint8>& grid,
+                  const SoaDiscreteScan2D& discrete_scan, int x_index_offset,
+                  int y_index_offset);
+float SumCellValues(const ScoringGrid2D<float>& grid,
+                    const SoaDiscreteScan2D& discrete_scan, int x_index_offset,
+                    int y_index_offset);
+
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_CANDIDATE_SCORING_KERNELS_H_
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/internal/2d/scan_matching/candidate_scoring_kernels.h"
+
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+namespace {
+
+using ::testing::Values;
+
+constexpr int kNumXCells = 37;
+constexpr int kNumYCells = 23;
+
+// A scan with cells around and partially outside of a grid at (-5, 7).
+DiscreteScan2D CreateDiscreteScan(const int num_cells) {
+  std::mt19937 prng(42);
+  std::uniform_int_distribution<int> x_distribution(-20, 40);
+  std::uniform_int_distribution<int> y_distribution(-10, 40);
+  DiscreteScan2D discrete_scan;
+  for (int i = 0; i != num_cells; ++i) {
+    discrete_scan.emplace_back(x_distribution(prng), y_distribution(prng));
+  }
+  return discrete_scan;
+}
+
+template <typename ValueType>
+ValueType GetExpectedValue(const ScoringGrid2D<ValueType>& grid,
+                           const Eigen::Array2i& xy_index) {
+  const Eigen::Array2i local_xy_index = xy_index - grid.offset;
+  if (local_xy_index.x() < 0 || local_xy_index.x() >= grid.num_x_cells ||
+      local_xy_index.y() < 0 || local_xy_index.y() >= grid.num_y_cells) {
+    return grid.outside_value;
+  }
+  return grid.data[local_xy_index.x() + local_xy_index.y() * grid.num_x_cells];
+}
+
+class ScoringKernelTest : public ::testing::TestWithParam<ScoringKernel> {};
+
+TEST_P(ScoringKernelTest, SumsUint8Values) {
+  if (!IsScoringKernelSupported(GetParam())) {
+    return;
+  }
+  std::mt19937 prng(42);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  // Padding for the AVX2 kernel, filled with values which must be ignored.
+  std::vector<uint8> cells(kNumXCells * kNumYCells + 3);
+  for (uint8& cell : cells) {
+    cell = distribution(prng);
+  }
+  const ScoringGrid2D<uint8> grid{cells.data(), Eigen::Array2i(-5, 7),
+                                  kNumXCells, kNumYCells, 17};
+  // Sizes that exercise full batches as well as the scalar remainder.
+  for (const int num_cells : {0, 1, 7, 8, 9, 17, 1000}) {
+    const DiscreteScan2D discrete_scan = CreateDiscreteScan(num_cells);
+    const SoaDiscreteScan2D soa_discrete_scan =
+        ToSoaDiscreteScans({discrete_scan}).front();
+    for (const Eigen::Array2i& offset :
+         {Eigen::Array2i(0, 0), Eigen::Array2i(-3, 2), Eigen::Array2i(30, 0),
+          Eigen::Array2i(0, -1000)}) {
+      int expected = 0;
+      for (const Eigen::Array2i& xy_index : discrete_scan) {
+        expected += GetExpectedValue(grid, xy_index + offset);
+      }
+      EXPECT_EQ(expected, SumCellValues(grid, soa_discrete_scan, offset.x(),
+                                        offset.y(), GetParam()))
+          << num_cells << " cells, offset " << offset.transpose();
+    }
+  }
+}
+
+TEST_P(ScoringKernelTest, SumsFloatValues) {
+  if (!IsScoringKernelSupported(GetParam())) {
+    return;
+  }
+  std::mt19937 prng(42);
+  std::uniform_real_distribution<float> distribution(0.1f, 0.9f);
+  std::vector<float> cells(kNumXCells * kNumYCells);
+  for (float& cell : cells) {
+    cell = distribution(prng);
+  }
+  const ScoringGrid2D<float> grid{cells.data(), Eigen::Array2i(-5, 7),
+                                  kNumXCells, kNumYCells, 0.1f};
+  for (const int num_cells : {0, 1, 7, 8, 9, 17, 1000}) {
+    const DiscreteScan2D discrete_scan = CreateDiscreteScan(num_cells);
+    const SoaDiscreteScan2D soa_discrete_scan =
+        ToSoaDiscreteScans({discrete_scan}).front();
+    for (const Eigen::Array2i& offset :
+         {Eigen::Array2i(0, 0), Eigen::Array2i(-3, 2), Eigen::Array2i(30, 0),
+          Eigen::Array2i(0, -1000)}) {
+      float expected = 0.f;
+      for (const Eigen::Array2i& xy_index : discrete_scan) {
+        expected += GetExpectedValue(grid, xy_index + offset);
+      }
+      EXPECT_NEAR(expected,
+                  SumCellValues(grid, soa_discrete_scan, offset.x(),
+                                offset.y(), GetParam()),
+                  1e-5f * num_cells)
+          << num_cells << " cells, offset " << offset.transpose();
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(AllKernels, ScoringKernelTest,
+                        Values(ScoringKernel::kScalar, ScoringKernel::kAvx2));
+
+TEST(ScoringKernelsTest, FastestKernelIsSupported) {
+  EXPECT_TRUE(IsScoringKernelSupported(GetFastestScoringKernel()));
+}
+
+}  // namespace
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
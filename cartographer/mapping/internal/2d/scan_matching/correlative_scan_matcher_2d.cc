@@ -126,6 +126,25 @@ std::vector<DiscreteScan2D> DiscretizeScans(
   return discrete_scans;
 }
 
+std::vector<DiscreteScan2D> DiscretizeScans(
+    const MapLimits& map_limits, const std::vector<sensor::PointCloud>& scans,
+    const transform::Rigid2f& initial_pose) {
+  const Eigen::Affine2f transform =
+      Eigen::Translation2f(initial_pose.translation()) *
+      initial_pose.rotation();
+  std::vector<DiscreteScan2D> discrete_scans;
+  discrete_scans.reserve(scans.size());
+  for (const sensor::PointCloud& scan : scans) {
+    discrete_scans.emplace_back();
+    discrete_scans.back().reserve(scan.size());
+    for (const sensor::RangefinderPoint& point : scan) {
+      discrete_scans.back().push_back(
+          map_limits.GetCellIndex(transform * point.position.head<2>()));
+    }
+  }
+  return discrete_scans;
+}
+
 }  // namespace scan_matching
 }  // namespace mapping
 }  // namespace cartographer
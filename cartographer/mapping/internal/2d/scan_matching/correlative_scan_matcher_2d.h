@@ -24,6 +24,7 @@
 #include "cartographer/mapping/2d/map_limits.h"
 #include "cartographer/mapping/2d/xy_index.h"
 #include "cartographer/sensor/point_cloud.h"
+#include "cartographer/transform/rigid_transform.h"
 
 namespace cartographer {
 namespace mapping {
@@ -70,6 +71,12 @@ std::vector<DiscreteScan2D> DiscretizeScans(
     const MapLimits& map_limits, const std::vector<sensor::PointCloud>& scans,
     const Eigen::Translation2f& initial_translation);
 
+// Same as above, but transforms the rotated scans by 'initial_pose', so that
+// its rotation does not have to be applied to the scans beforehand.
+std::vector<DiscreteScan2D> DiscretizeScans(
+    const MapLimits& map_limits, const std::vector<sensor::PointCloud>& scans,
+    const transform::Rigid2f& initial_pose);
+
 // A possible solution.
 struct Candidate2D {
   Candidate2D(const int init_scan_index, const int init_x_index_offset,
@@ -18,13 +18,17 @@
 
 #include <algorithm>
 #include <cmath>
-#include <deque>
 #include <functional>
 #include <limits>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Eigen/Geometry"
 #include "absl/memory/memory.h"
 #include "cartographer/common/math.h"
+#include "cartographer/common/task.h"
 #include "cartographer/mapping/2d/grid_2d.h"
 #include "cartographer/sensor/point_cloud.h"
 #include "cartographer/transform/transform.h"
@@ -35,43 +39,73 @@ namespace mapping {
 namespace scan_matching {
 namespace {
 
-// A collection of values which can be added and later removed, and the maximum
-// of the current values in the collection can be retrieved.
-// All of it in (amortized) O(1).
-class SlidingWindowMaximum {
- public:
-  void AddValue(const float value) {
-    while (!non_ascending_maxima_.empty() &&
-           value > non_ascending_maxima_.back()) {
-      non_ascending_maxima_.pop_back();
-    }
-    non_ascending_maxima_.push_back(value);
-  }
+// Number of bytes after the cells of a precomputation grid, which the scoring
+// kernels may read.
+constexpr int kNumPaddingCells = 3;
 
-  void RemoveValue(const float value) {
-    // DCHECK for performance, since this is done for every value in the
-    // precomputation grid.
-    DCHECK(!non_ascending_maxima_.empty());
-    DCHECK_LE(value, non_ascending_maxima_.front());
-    if (value == non_ascending_maxima_.front()) {
-      non_ascending_maxima_.pop_front();
-    }
+// Number of rows of the precomputation grids computed by one work item.
+constexpr int kNumRowsPerWorkItem = 64;
+
+// Calls 'function' with consecutive ranges [begin_row, end_row) covering all
+// 'num_rows' rows. The ranges are processed concurrently on 'thread_pool' and
+// the calling thread if 'thread_pool' is not nullptr.
+void ForEachRowRange(
+    const int num_rows, common::ThreadPoolInterface* const thread_pool,
+    const std::function<void(int begin_row, int end_row)>& function) {
+  if (thread_pool == nullptr || num_rows <= kNumRowsPerWorkItem) {
+    function(0, num_rows);
+    return;
+  }
+  std::vector<common::Task::WorkItem> work_items;
+  for (int begin_row = 0; begin_row < num_rows;
+       begin_row += kNumRowsPerWorkItem) {
+    const int end_row = std::min(begin_row + kNumRowsPerWorkItem, num_rows);
+    work_items.push_back(
+        [&function, begin_row, end_row]() { function(begin_row, end_row); });
   }
+  common::RunInParallel(work_items, common::Task::CONSTRAINT_SEARCH,
+                        "precomputation_grid_2d", thread_pool);
+}
 
-  float GetMaximum() const {
-    // DCHECK for performance, since this is done for every value in the
-    // precomputation grid.
-    DCHECK_GT(non_ascending_maxima_.size(), 0);
-    return non_ascending_maxima_.front();
+// Sets 'result[i]' to the maximum of 'a[i]' and 'b[i]' for i < 'size'.
+void ComputeMaximum(const uint8* a, const uint8* b, const int size,
+                    uint8* const result) {
+  int i = 0;
+#ifdef __SSE2__
+  for (; i + 16 <= size; i += 16) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(result + i),
+        _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+  }
+#endif
+  for (; i != size; ++i) {
+    result[i] = std::max(a[i], b[i]);
   }
+}
+
+// Number of work items a full submap is matched with. They take the lowest
+// resolution candidates one after the other, so this only limits how many
+// threads can work on it.
+constexpr int kNumBranchAndBoundWorkItems = 16;
 
-  void CheckIsEmpty() const { CHECK_EQ(non_ascending_maxima_.size(), 0); }
+// Sets 'value' to 'new_value' if it is greater.
+void UpdateMaximum(const float new_value, std::atomic<float>* const value) {
+  float current_value = value->load();
+  while (new_value > current_value &&
+         !value->compare_exchange_weak(current_value, new_value)) {
+  }
+}
 
- private:
-  // Maximum of the current sliding window at the front. Then the maximum of the
-  // remaining window that came after this values first occurrence, and so on.
-  std::deque<float> non_ascending_maxima_;
-};
+// Sets the 'size' + 'shift' values of 'result' to the maximum of the values of
+// 'a' at the same index and at the index 'shift' lower. Values outside of 'a'
+// do not contribute. 'shift' must not be greater than 'size'.
+void ComputeShiftedMaximum(const uint8* a, const int size, const int shift,
+                           uint8* const result) {
+  std::copy(a, a + shift, result);
+  ComputeMaximum(a, a + shift, size - shift, result + shift);
+  std::copy(a + size - shift, a + size, result + size);
+}
 
 }  // namespace
 
@@ -90,74 +124,124 @@ CreateFastCorrelativeScanMatcherOptions2D(
 
 PrecomputationGrid2D::PrecomputationGrid2D(
     const Grid2D& grid, const CellLimits& limits, const int width,
-    std::vector<float>* reusable_intermediate_grid)
+    std::vector<uint8>* reusable_intermediate_grid,
+    common::ThreadPoolInterface* const thread_pool)
     : offset_(-width + 1, -width + 1),
       wide_limits_(limits.num_x_cells + width - 1,
                    limits.num_y_cells + width - 1),
       min_score_(1.f - grid.GetMaxCorrespondenceCost()),
       max_score_(1.f - grid.GetMinCorrespondenceCost()),
-      cells_(wide_limits_.num_x_cells * wide_limits_.num_y_cells) {
+      cells_(wide_limits_.num_x_cells * wide_limits_.num_y_cells +
+             kNumPaddingCells) {
   CHECK_GE(width, 1);
   CHECK_GE(limits.num_x_cells, 1);
   CHECK_GE(limits.num_y_cells, 1);
-  const int stride = wide_limits_.num_x_cells;
-  // First we compute the maximum probability for each (x0, y) achieved in the
-  // span defined by x0 <= x < x0 + width.
-  std::vector<float>& intermediate = *reusable_intermediate_grid;
-  intermediate.resize(wide_limits_.num_x_cells * limits.num_y_cells);
-  for (int y = 0; y != limits.num_y_cells; ++y) {
-    SlidingWindowMaximum current_values;
-    current_values.AddValue(
-        1.f - std::abs(grid.GetCorrespondenceCost(Eigen::Array2i(0, y))));
-    for (int x = -width + 1; x != 0; ++x) {
-      intermediate[x + width - 1 + y * stride] = current_values.GetMaximum();
-      if (x + width < limits.num_x_cells) {
-        current_values.AddValue(1.f - std::abs(grid.GetCorrespondenceCost(
-                                          Eigen::Array2i(x + width, y))));
-      }
-    }
-    for (int x = 0; x < limits.num_x_cells - width; ++x) {
-      intermediate[x + width - 1 + y * stride] = current_values.GetMaximum();
-      current_values.RemoveValue(
-          1.f - std::abs(grid.GetCorrespondenceCost(Eigen::Array2i(x, y))));
-      current_values.AddValue(1.f - std::abs(grid.GetCorrespondenceCost(
-                                        Eigen::Array2i(x + width, y))));
-    }
-    for (int x = std::max(limits.num_x_cells - width, 0);
-         x != limits.num_x_cells; ++x) {
-      intermediate[x + width - 1 + y * stride] = current_values.GetMaximum();
-      current_values.RemoveValue(
-          1.f - std::abs(grid.GetCorrespondenceCost(Eigen::Array2i(x, y))));
-    }
-    current_values.CheckIsEmpty();
-  }
-  // For each (x, y), we compute the maximum probability in the width x width
-  // region starting at each (x, y) and precompute the resulting bound on the
-  // score.
-  for (int x = 0; x != wide_limits_.num_x_cells; ++x) {
-    SlidingWindowMaximum current_values;
-    current_values.AddValue(intermediate[x]);
-    for (int y = -width + 1; y != 0; ++y) {
-      cells_[x + (y + width - 1) * stride] =
-          ComputeCellValue(current_values.GetMaximum());
-      if (y + width < limits.num_y_cells) {
-        current_values.AddValue(intermediate[x + (y + width) * stride]);
-      }
-    }
-    for (int y = 0; y < limits.num_y_cells - width; ++y) {
-      cells_[x + (y + width - 1) * stride] =
-          ComputeCellValue(current_values.GetMaximum());
-      current_values.RemoveValue(intermediate[x + y * stride]);
-      current_values.AddValue(intermediate[x + (y + width) * stride]);
-    }
-    for (int y = std::max(limits.num_y_cells - width, 0);
-         y != limits.num_y_cells; ++y) {
-      cells_[x + (y + width - 1) * stride] =
-          ComputeCellValue(current_values.GetMaximum());
-      current_values.RemoveValue(intermediate[x + y * stride]);
-    }
-    current_values.CheckIsEmpty();
+  if (width == 1) {
+    ComputeCellValues(grid, thread_pool);
+    return;
   }
+  const PrecomputationGrid2D narrower_grid(
+      grid, limits, (width + 1) / 2, reusable_intermediate_grid, thread_pool);
+  ComputeCellValuesFromNarrowerCells(narrower_grid.width(),
+                                     narrower_grid.cells_,
+                                     reusable_intermediate_grid, thread_pool);
+}
+
+PrecomputationGrid2D::PrecomputationGrid2D(
+    const PrecomputationGrid2D& narrower_grid, const int width,
+    std::vector<uint8>* reusable_intermediate_grid,
+    common::ThreadPoolInterface* const thread_pool)
+    : offset_(-width + 1, -width + 1),
+      wide_limits_(narrower_grid.wide_limits_.num_x_cells + width -
+                       narrower_grid.width(),
+                   narrower_grid.wide_limits_.num_y_cells + width -
+                       narrower_grid.width()),
+      min_score_(narrower_grid.min_score_),
+      max_score_(narrower_grid.max_score_),
+      cells_(wide_limits_.num_x_cells * wide_limits_.num_y_cells +
+             kNumPaddingCells) {
+  CHECK_GE(width, narrower_grid.width());
+  CHECK_LE(width, 2 * narrower_grid.width());
+  ComputeCellValuesFromNarrowerCells(narrower_grid.width(),
+                                     narrower_grid.cells_,
+                                     reusable_intermediate_grid, thread_pool);
+}
+
+void PrecomputationGrid2D::ComputeCellValues(
+    const Grid2D& grid, common::ThreadPoolInterface* const thread_pool) {
+  CHECK_EQ(width(), 1);
+  const int stride = wide_limits_.num_x_cells;
+  // Most cells of a submap are unknown, so their value is computed only once.
+  const uint8 unknown_cell_value = ComputeCellValue(
+      1.f - std::abs(grid.CorrespondenceCostFromValue(
+                kUnknownCorrespondenceValue)));
+  ForEachRowRange(
+      wide_limits_.num_y_cells, thread_pool,
+      [this, &grid, stride, unknown_cell_value](const int begin_row,
+                                                const int end_row) {
+        // Reads whole rows of raw values, which is much faster than looking up
+        // the tile of each cell.
+        std::vector<uint16> row(stride);
+        for (int y = begin_row; y != end_row; ++y) {
+          grid.GetCorrespondenceCostValues(Eigen::Array2i(0, y), stride,
+                                           row.data());
+          for (int x = 0; x != stride; ++x) {
+            cells_[x + y * stride] =
+                row[x] == kUnknownCorrespondenceValue
+                    ? unknown_cell_value
+                    : ComputeCellValue(1.f - std::abs(
+                          grid.CorrespondenceCostFromValue(row[x])));
+          }
+        }
+      });
+}
+
+void PrecomputationGrid2D::ComputeCellValuesFromNarrowerCells(
+    const int narrower_width, const std::vector<uint8>& narrower_cells,
+    std::vector<uint8>* const reusable_intermediate_grid,
+    common::ThreadPoolInterface* const thread_pool) {
+  // The maximum in the width x width area at (x0, y0) is the maximum of the
+  // areas of the narrower grid at (x0, y0), (x0 + shift, y0), (x0, y0 + shift)
+  // and (x0 + shift, y0 + shift), which together cover it. Each cell of the
+  // narrower grid is at the index of the same cell in this grid minus 'shift'.
+  const int shift = width() - narrower_width;
+  const int stride = wide_limits_.num_x_cells;
+  const int narrower_stride = stride - shift;
+  const int narrower_num_rows = wide_limits_.num_y_cells - shift;
+  CHECK_EQ(narrower_cells.size(),
+           static_cast<size_t>(narrower_stride * narrower_num_rows +
+                               kNumPaddingCells));
+  // First we compute the maximum in the x direction for each row of the
+  // narrower grid.
+  std::vector<uint8>& intermediate = *reusable_intermediate_grid;
+  intermediate.resize(stride * narrower_num_rows);
+  ForEachRowRange(
+      narrower_num_rows, thread_pool,
+      [&narrower_cells, &intermediate, shift, stride, narrower_stride](
+          const int begin_row, const int end_row) {
+        for (int y = begin_row; y != end_row; ++y) {
+          ComputeShiftedMaximum(&narrower_cells[y * narrower_stride],
+                                narrower_stride, shift,
+                                &intermediate[y * stride]);
+        }
+      });
+  // Then in the y direction, for whole rows at once.
+  ForEachRowRange(
+      wide_limits_.num_y_cells, thread_pool,
+      [this, &intermediate, shift, stride, narrower_num_rows](
+          const int begin_row, const int end_row) {
+        for (int y = begin_row; y != end_row; ++y) {
+          uint8* const row = &cells_[y * stride];
+          if (y < shift) {
+            std::copy_n(&intermediate[y * stride], stride, row);
+          } else if (y < narrower_num_rows) {
+            ComputeMaximum(&intermediate[(y - shift) * stride],
+                           &intermediate[y * stride], stride, row);
+          } else {
+            std::copy_n(&intermediate[(y - shift) * stride], stride, row);
+          }
+        }
+      });
 }
 
 uint8 PrecomputationGrid2D::ComputeCellValue(const float probability) const {
@@ -170,28 +254,41 @@ uint8 PrecomputationGrid2D::ComputeCellValue(const float probability) const {
 
 PrecomputationGridStack2D::PrecomputationGridStack2D(
     const Grid2D& grid,
-    const proto::FastCorrelativeScanMatcherOptions2D& options) {
+    const proto::FastCorrelativeScanMatcherOptions2D& options,
+    common::ThreadPoolInterface* const thread_pool) {
   CHECK_GE(options.branch_and_bound_depth(), 1);
   const int max_width = 1 << (options.branch_and_bound_depth() - 1);
   precomputation_grids_.reserve(options.branch_and_bound_depth());
-  std::vector<float> reusable_intermediate_grid;
+  std::vector<uint8> reusable_intermediate_grid;
   const CellLimits limits = grid.limits().cell_limits();
   reusable_intermediate_grid.reserve((limits.num_x_cells + max_width - 1) *
-                                     limits.num_y_cells);
-  for (int i = 0; i != options.branch_and_bound_depth(); ++i) {
+                                     (limits.num_y_cells + max_width / 2 - 1));
+  precomputation_grids_.emplace_back(grid, limits, 1 /* width */,
+                                     &reusable_intermediate_grid, thread_pool);
+  for (int i = 1; i != options.branch_and_bound_depth(); ++i) {
     const int width = 1 << i;
-    precomputation_grids_.emplace_back(grid, limits, width,
-                                       &reusable_intermediate_grid);
+    // No reallocation happens, so the reference to the previous grid stays
+    // valid.
+    precomputation_grids_.emplace_back(precomputation_grids_.back(), width,
+                                       &reusable_intermediate_grid,
+                                       thread_pool);
   }
 }
 
 FastCorrelativeScanMatcher2D::FastCorrelativeScanMatcher2D(
     const Grid2D& grid,
     const proto::FastCorrelativeScanMatcherOptions2D& options)
+    : FastCorrelativeScanMatcher2D(grid, options, nullptr /* thread_pool */) {}
+
+FastCorrelativeScanMatcher2D::FastCorrelativeScanMatcher2D(
+    const Grid2D& grid,
+    const proto::FastCorrelativeScanMatcherOptions2D& options,
+    common::ThreadPoolInterface* const thread_pool)
     : options_(options),
       limits_(grid.limits()),
-      precomputation_grid_stack_(
-          absl::make_unique<PrecomputationGridStack2D>(grid, options)) {}
+      thread_pool_(thread_pool),
+      precomputation_grid_stack_(absl::make_unique<PrecomputationGridStack2D>(
+          grid, options, thread_pool)) {}
 
 FastCorrelativeScanMatcher2D::~FastCorrelativeScanMatcher2D() {}
 
@@ -199,17 +296,36 @@ bool FastCorrelativeScanMatcher2D::Match(
     const transform::Rigid2d& initial_pose_estimate,
     const sensor::PointCloud& point_cloud, const float min_score, float* score,
     transform::Rigid2d* pose_estimate) const {
+  return Match(initial_pose_estimate, point_cloud, min_score,
+               nullptr /* rotated_scan_cache */, score, pose_estimate);
+}
+
+bool FastCorrelativeScanMatcher2D::Match(
+    const transform::Rigid2d& initial_pose_estimate,
+    const sensor::PointCloud& point_cloud, const float min_score,
+    RotatedScanCache2D* const rotated_scan_cache, float* score,
+    transform::Rigid2d* pose_estimate) const {
   const SearchParameters search_parameters(options_.linear_search_window(),
                                            options_.angular_search_window(),
                                            point_cloud, limits_.resolution());
   return MatchWithSearchParameters(search_parameters, initial_pose_estimate,
-                                   point_cloud, min_score, score,
-                                   pose_estimate);
+                                   point_cloud, min_score,
+                                   nullptr /* thread_pool */,
+                                   rotated_scan_cache, score, pose_estimate);
 }
 
 bool FastCorrelativeScanMatcher2D::MatchFullSubmap(
     const sensor::PointCloud& point_cloud, float min_score, float* score,
     transform::Rigid2d* pose_estimate) const {
+  return MatchFullSubmap(point_cloud, min_score,
+                         nullptr /* rotated_scan_cache */, score,
+                         pose_estimate);
+}
+
+bool FastCorrelativeScanMatcher2D::MatchFullSubmap(
+    const sensor::PointCloud& point_cloud, float min_score,
+    RotatedScanCache2D* const rotated_scan_cache, float* score,
+    transform::Rigid2d* pose_estimate) const {
   // Compute a search window around the center of the submap that includes it
   // fully.
   const SearchParameters search_parameters(
@@ -221,35 +337,50 @@ bool FastCorrelativeScanMatcher2D::MatchFullSubmap(
                           Eigen::Vector2d(limits_.cell_limits().num_y_cells,
                                           limits_.cell_limits().num_x_cells));
   return MatchWithSearchParameters(search_parameters, center, point_cloud,
-                                   min_score, score, pose_estimate);
+                                   min_score, thread_pool_, rotated_scan_cache,
+                                   score, pose_estimate);
 }
 
 bool FastCorrelativeScanMatcher2D::MatchWithSearchParameters(
     SearchParameters search_parameters,
     const transform::Rigid2d& initial_pose_estimate,
-    const sensor::PointCloud& point_cloud, float min_score, float* score,
+    const sensor::PointCloud& point_cloud, float min_score,
+    common::ThreadPoolInterface* const thread_pool,
+    RotatedScanCache2D* const rotated_scan_cache, float* score,
     transform::Rigid2d* pose_estimate) const {
   CHECK(score != nullptr);
   CHECK(pose_estimate != nullptr);
 
   const Eigen::Rotation2Dd initial_rotation = initial_pose_estimate.rotation();
-  const sensor::PointCloud rotated_point_cloud = sensor::TransformPointCloud(
-      point_cloud,
-      transform::Rigid3f::Rotation(Eigen::AngleAxisf(
-          initial_rotation.cast<float>().angle(), Eigen::Vector3f::UnitZ())));
-  const std::vector<sensor::PointCloud> rotated_scans =
-      GenerateRotatedScans(rotated_point_cloud, search_parameters);
-  const std::vector<DiscreteScan2D> discrete_scans = DiscretizeScans(
-      limits_, rotated_scans,
-      Eigen::Translation2f(initial_pose_estimate.translation().x(),
-                           initial_pose_estimate.translation().y()));
-  search_parameters.ShrinkToFit(discrete_scans, limits_.cell_limits());
+  std::shared_ptr<const std::vector<sensor::PointCloud>> rotated_scans;
+  if (rotated_scan_cache != nullptr) {
+    rotated_scans = rotated_scan_cache->Get(point_cloud, search_parameters);
+  } else {
+    rotated_scans = std::make_shared<const std::vector<sensor::PointCloud>>(
+        GenerateRotatedScans(point_cloud, search_parameters));
+  }
+  // The scans are only rotated by the angular perturbations, which do not
+  // depend on the grid. The initial rotation is applied together with the
+  // translation when discretizing.
+  const std::vector<DiscreteScan2D> aos_discrete_scans = DiscretizeScans(
+      limits_, *rotated_scans, initial_pose_estimate.cast<float>());
+  search_parameters.ShrinkToFit(aos_discrete_scans, limits_.cell_limits());
+  const std::vector<SoaDiscreteScan2D> discrete_scans =
+      ToSoaDiscreteScans(aos_discrete_scans);
 
   const std::vector<Candidate2D> lowest_resolution_candidates =
       ComputeLowestResolutionCandidates(discrete_scans, search_parameters);
-  const Candidate2D best_candidate = BranchAndBound(
-      discrete_scans, search_parameters, lowest_resolution_candidates,
-      precomputation_grid_stack_->max_depth(), min_score);
+  Candidate2D best_candidate(0, 0, 0, search_parameters);
+  if (thread_pool == nullptr) {
+    std::atomic<float> best_score(min_score);
+    best_candidate = BranchAndBound(
+        discrete_scans, search_parameters, lowest_resolution_candidates,
+        precomputation_grid_stack_->max_depth(), min_score, &best_score);
+  } else {
+    best_candidate = ConcurrentBranchAndBound(discrete_scans, search_parameters,
+                                              lowest_resolution_candidates,
+                                              min_score, thread_pool);
+  }
   if (best_candidate.score > min_score) {
     *score = best_candidate.score;
     *pose_estimate = transform::Rigid2d(
@@ -263,7 +394,7 @@ bool FastCorrelativeScanMatcher2D::MatchWithSearchParameters(
 
 std::vector<Candidate2D>
 FastCorrelativeScanMatcher2D::ComputeLowestResolutionCandidates(
-    const std::vector<DiscreteScan2D>& discrete_scans,
+    const std::vector<SoaDiscreteScan2D>& discrete_scans,
     const SearchParameters& search_parameters) const {
   std::vector<Candidate2D> lowest_resolution_candidates =
       GenerateLowestResolutionCandidates(search_parameters);
@@ -313,30 +444,28 @@ FastCorrelativeScanMatcher2D::GenerateLowestResolutionCandidates(
 
 void FastCorrelativeScanMatcher2D::ScoreCandidates(
     const PrecomputationGrid2D& precomputation_grid,
-    const std::vector<DiscreteScan2D>& discrete_scans,
+    const std::vector<SoaDiscreteScan2D>& discrete_scans,
     const SearchParameters& search_parameters,
     std::vector<Candidate2D>* const candidates) const {
+  const ScoringGrid2D<uint8> scoring_grid = precomputation_grid.scoring_grid();
   for (Candidate2D& candidate : *candidates) {
-    int sum = 0;
-    for (const Eigen::Array2i& xy_index :
-         discrete_scans[candidate.scan_index]) {
-      const Eigen::Array2i proposed_xy_index(
-          xy_index.x() + candidate.x_index_offset,
-          xy_index.y() + candidate.y_index_offset);
-      sum += precomputation_grid.GetValue(proposed_xy_index);
-    }
+    const SoaDiscreteScan2D& discrete_scan =
+        discrete_scans[candidate.scan_index];
+    const int sum =
+        SumCellValues(scoring_grid, discrete_scan, candidate.x_index_offset,
+                      candidate.y_index_offset);
     candidate.score = precomputation_grid.ToScore(
-        sum / static_cast<float>(discrete_scans[candidate.scan_index].size()));
+        sum / static_cast<float>(discrete_scan.x_indices.size()));
   }
   std::sort(candidates->begin(), candidates->end(),
             std::greater<Candidate2D>());
 }
 
 Candidate2D FastCorrelativeScanMatcher2D::BranchAndBound(
-    const std::vector<DiscreteScan2D>& discrete_scans,
+    const std::vector<SoaDiscreteScan2D>& discrete_scans,
     const SearchParameters& search_parameters,
     const std::vector<Candidate2D>& candidates, const int candidate_depth,
-    float min_score) const {
+    float min_score, std::atomic<float>* const best_score) const {
   if (candidate_depth == 0) {
     // Return the best candidate.
     return *candidates.begin();
@@ -345,7 +474,10 @@ Candidate2D FastCorrelativeScanMatcher2D::BranchAndBound(
   Candidate2D best_high_resolution_candidate(0, 0, 0, search_parameters);
   best_high_resolution_candidate.score = min_score;
   for (const Candidate2D& candidate : candidates) {
-    if (candidate.score <= min_score) {
+    // Candidates scoring equal to the 'best_score' of a concurrent search are
+    // not pruned, so that the result does not depend on the timing.
+    if (candidate.score <= min_score ||
+        candidate.score < best_score->load(std::memory_order_relaxed)) {
       break;
     }
     std::vector<Candidate2D> higher_resolution_candidates;
@@ -372,11 +504,70 @@ Candidate2D FastCorrelativeScanMatcher2D::BranchAndBound(
         best_high_resolution_candidate,
         BranchAndBound(discrete_scans, search_parameters,
                        higher_resolution_candidates, candidate_depth - 1,
-                       best_high_resolution_candidate.score));
+                       best_high_resolution_candidate.score, best_score));
+    UpdateMaximum(best_high_resolution_candidate.score, best_score);
   }
   return best_high_resolution_candidate;
 }
 
+Candidate2D FastCorrelativeScanMatcher2D::ConcurrentBranchAndBound(
+    const std::vector<SoaDiscreteScan2D>& discrete_scans,
+    const SearchParameters& search_parameters,
+    const std::vector<Candidate2D>& candidates, const float min_score,
+    common::ThreadPoolInterface* const thread_pool) const {
+  // Each work item searches the candidates it takes one at a time, so it finds
+  // the first best candidate of these. The first best candidate overall is
+  // the one with the lowest index among the work items' results.
+  struct Result {
+    int candidate_index;
+    Candidate2D candidate;
+  };
+  Result no_result{static_cast<int>(candidates.size()),
+                   Candidate2D(0, 0, 0, search_parameters)};
+  no_result.candidate.score = min_score;
+  std::vector<Result> results(kNumBranchAndBoundWorkItems, no_result);
+  std::atomic<int> next_candidate_index(0);
+  std::atomic<float> best_score(min_score);
+  std::vector<common::Task::WorkItem> work_items;
+  for (Result& result : results) {
+    Result* const work_item_result = &result;
+    work_items.push_back([this, &discrete_scans, &search_parameters,
+                          &candidates, min_score, &next_candidate_index,
+                          &best_score, work_item_result]() {
+      for (;;) {
+        const int candidate_index = next_candidate_index.fetch_add(1);
+        if (candidate_index >= static_cast<int>(candidates.size())) {
+          return;
+        }
+        const Candidate2D& candidate = candidates[candidate_index];
+        // The candidates are sorted by score, so no later candidate is better.
+        if (candidate.score <= min_score ||
+            candidate.score < best_score.load(std::memory_order_relaxed)) {
+          return;
+        }
+        const Candidate2D best_candidate = BranchAndBound(
+            discrete_scans, search_parameters, {candidate},
+            precomputation_grid_stack_->max_depth(), min_score, &best_score);
+        UpdateMaximum(best_candidate.score, &best_score);
+        if (best_candidate.score > work_item_result->candidate.score) {
+          *work_item_result = Result{candidate_index, best_candidate};
+        }
+      }
+    });
+  }
+  common::RunInParallel(work_items, common::Task::CONSTRAINT_SEARCH,
+                        "branch_and_bound_2d", thread_pool);
+  Result best_result = no_result;
+  for (const Result& result : results) {
+    if (result.candidate.score > best_result.candidate.score ||
+        (result.candidate.score == best_result.candidate.score &&
+         result.candidate_index < best_result.candidate_index)) {
+      best_result = result;
+    }
+  }
+  return best_result.candidate;
+}
+
 }  // namespace scan_matching
 }  // namespace mapping
 }  // namespace cartographer
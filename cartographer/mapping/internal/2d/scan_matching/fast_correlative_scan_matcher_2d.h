@@ -25,13 +25,17 @@
 #ifndef CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_FAST_CORRELATIVE_SCAN_MATCHER_2D_H_
 #define CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_FAST_CORRELATIVE_SCAN_MATCHER_2D_H_
 
+#include <atomic>
 #include <memory>
 #include <vector>
 
 #include "Eigen/Core"
 #include "cartographer/common/port.h"
+#include "cartographer/common/thread_pool.h"
 #include "cartographer/mapping/2d/grid_2d.h"
+#include "cartographer/mapping/internal/2d/scan_matching/candidate_scoring_kernels.h"
 #include "cartographer/mapping/internal/2d/scan_matching/correlative_scan_matcher_2d.h"
+#include "cartographer/mapping/internal/2d/scan_matching/rotated_scan_cache_2d.h"
 #include "cartographer/mapping/proto/scan_matching/fast_correlative_scan_matcher_options_2d.pb.h"
 #include "cartographer/sensor/point_cloud.h"
 
@@ -46,10 +50,22 @@ CreateFastCorrelativeScanMatcherOptions2D(
 // A precomputed grid that contains in each cell (x0, y0) the maximum
 // probability in the width x width area defined by x0 <= x < x0 + width and
 // y0 <= y < y0.
+//
+// The constructors split their work into bands of rows which run concurrently
+// on 'thread_pool' if it is not nullptr. The calling thread works on one of the
+// bands and must not be a thread of 'thread_pool'.
 class PrecomputationGrid2D {
  public:
   PrecomputationGrid2D(const Grid2D& grid, const CellLimits& limits, int width,
-                       std::vector<float>* reusable_intermediate_grid);
+                       std::vector<uint8>* reusable_intermediate_grid,
+                       common::ThreadPoolInterface* thread_pool);
+
+  // Computes the grid for 'width' from 'narrower_grid' computed for the same
+  // grid and a width in [width / 2, width]. This is much faster than computing
+  // it from the grid.
+  PrecomputationGrid2D(const PrecomputationGrid2D& narrower_grid, int width,
+                       std::vector<uint8>* reusable_intermediate_grid,
+                       common::ThreadPoolInterface* thread_pool);
 
   // Returns a value between 0 and 255 to represent probabilities between
   // min_score and max_score.
@@ -70,6 +86,13 @@ class PrecomputationGrid2D {
     return cells_[local_xy_index.x() + local_xy_index.y() * stride];
   }
 
+  // Returns the cells for 'SumCellValues', which then sums up the values
+  // 'GetValue' returns.
+  ScoringGrid2D<uint8> scoring_grid() const {
+    return {cells_.data(), offset_, wide_limits_.num_x_cells,
+            wide_limits_.num_y_cells, 0};
+  }
+
   // Maps values from [0, 255] to [min_score, max_score].
   float ToScore(float value) const {
     return min_score_ + value * ((max_score_ - min_score_) / 255.f);
@@ -78,6 +101,21 @@ class PrecomputationGrid2D {
  private:
   uint8 ComputeCellValue(float probability) const;
 
+  // Width of the area over which the maximum is taken.
+  int width() const { return 1 - offset_.x(); }
+
+  // Sets 'cells_' to the values of the cells of 'grid' which is the
+  // precomputation grid of width 1.
+  void ComputeCellValues(const Grid2D& grid,
+                         common::ThreadPoolInterface* thread_pool);
+
+  // Sets 'cells_' to the maximum of 'narrower_cells', the cells of the
+  // precomputation grid for 'narrower_width', in width x width areas.
+  void ComputeCellValuesFromNarrowerCells(
+      int narrower_width, const std::vector<uint8>& narrower_cells,
+      std::vector<uint8>* reusable_intermediate_grid,
+      common::ThreadPoolInterface* thread_pool);
+
   // Offset of the precomputation grid in relation to the 'grid'
   // including the additional 'width' - 1 cells.
   const Eigen::Array2i offset_;
@@ -88,15 +126,19 @@ class PrecomputationGrid2D {
   const float min_score_;
   const float max_score_;
 
-  // Probabilites mapped to 0 to 255.
+  // Probabilites mapped to 0 to 255, followed by the padding the scoring
+  // kernels need.
   std::vector<uint8> cells_;
 };
 
+// The precomputation grids for widths 1, 2, 4, ..., each computed from the
+// previous one. See 'PrecomputationGrid2D' for 'thread_pool'.
 class PrecomputationGridStack2D {
  public:
   PrecomputationGridStack2D(
       const Grid2D& grid,
-      const proto::FastCorrelativeScanMatcherOptions2D& options);
+      const proto::FastCorrelativeScanMatcherOptions2D& options,
+      common::ThreadPoolInterface* thread_pool);
 
   const PrecomputationGrid2D& Get(int index) {
     return precomputation_grids_[index];
@@ -114,6 +156,14 @@ class FastCorrelativeScanMatcher2D {
   FastCorrelativeScanMatcher2D(
       const Grid2D& grid,
       const proto::FastCorrelativeScanMatcherOptions2D& options);
+  // Same, but the precomputation grids are computed, and full submaps are
+  // matched, concurrently on 'thread_pool' in addition to the calling thread,
+  // which must not be a thread of 'thread_pool'. The results do not depend on
+  // the 'thread_pool'.
+  FastCorrelativeScanMatcher2D(
+      const Grid2D& grid,
+      const proto::FastCorrelativeScanMatcherOptions2D& options,
+      common::ThreadPoolInterface* thread_pool);
   ~FastCorrelativeScanMatcher2D();
 
   FastCorrelativeScanMatcher2D(const FastCorrelativeScanMatcher2D&) = delete;
@@ -127,39 +177,69 @@ class FastCorrelativeScanMatcher2D {
   bool Match(const transform::Rigid2d& initial_pose_estimate,
              const sensor::PointCloud& point_cloud, float min_score,
              float* score, transform::Rigid2d* pose_estimate) const;
+  // Same as above, but the rotated scans of 'point_cloud' are taken from and
+  // added to 'rotated_scan_cache', which must only ever be used with this
+  // 'point_cloud'. The result is the same.
+  bool Match(const transform::Rigid2d& initial_pose_estimate,
+             const sensor::PointCloud& point_cloud, float min_score,
+             RotatedScanCache2D* rotated_scan_cache, float* score,
+             transform::Rigid2d* pose_estimate) const;
 
   // Aligns 'point_cloud' within the full 'grid', i.e., not
   // restricted to the configured search window. If a score above 'min_score'
   // (excluding equality) is possible, true is returned, and 'score' and
-  // 'pose_estimate' are updated with the result.
+  // 'pose_estimate' are updated with the result. Uses the thread pool given on
+  // construction, if any.
   bool MatchFullSubmap(const sensor::PointCloud& point_cloud, float min_score,
                        float* score, transform::Rigid2d* pose_estimate) const;
+  // Same as above, using 'rotated_scan_cache' like Match().
+  bool MatchFullSubmap(const sensor::PointCloud& point_cloud, float min_score,
+                       RotatedScanCache2D* rotated_scan_cache, float* score,
+                       transform::Rigid2d* pose_estimate) const;
 
  private:
   // The actual implementation of the scan matcher, called by Match() and
   // MatchFullSubmap() with appropriate 'initial_pose_estimate' and
-  // 'search_parameters'.
+  // 'search_parameters'. Searches concurrently on 'thread_pool' and uses
+  // 'rotated_scan_cache' if they are not nullptr.
   bool MatchWithSearchParameters(
       SearchParameters search_parameters,
       const transform::Rigid2d& initial_pose_estimate,
-      const sensor::PointCloud& point_cloud, float min_score, float* score,
+      const sensor::PointCloud& point_cloud, float min_score,
+      common::ThreadPoolInterface* thread_pool,
+      RotatedScanCache2D* rotated_scan_cache, float* score,
       transform::Rigid2d* pose_estimate) const;
   std::vector<Candidate2D> ComputeLowestResolutionCandidates(
-      const std::vector<DiscreteScan2D>& discrete_scans,
+      const std::vector<SoaDiscreteScan2D>& discrete_scans,
       const SearchParameters& search_parameters) const;
   std::vector<Candidate2D> GenerateLowestResolutionCandidates(
       const SearchParameters& search_parameters) const;
   void ScoreCandidates(const PrecomputationGrid2D& precomputation_grid,
-                       const std::vector<DiscreteScan2D>& discrete_scans,
+                       const std::vector<SoaDiscreteScan2D>& discrete_scans,
                        const SearchParameters& search_parameters,
                        std::vector<Candidate2D>* const candidates) const;
-  Candidate2D BranchAndBound(const std::vector<DiscreteScan2D>& discrete_scans,
-                             const SearchParameters& search_parameters,
-                             const std::vector<Candidate2D>& candidates,
-                             int candidate_depth, float min_score) const;
+  // Returns the first candidate in depth-first order of those with the best
+  // score above 'min_score', or a candidate with 'min_score' if there is
+  // none. Candidates which score below 'best_score' are pruned, where
+  // 'best_score' is the best score found by this and any concurrent search
+  // and is updated with the result.
+  Candidate2D BranchAndBound(
+      const std::vector<SoaDiscreteScan2D>& discrete_scans,
+      const SearchParameters& search_parameters,
+      const std::vector<Candidate2D>& candidates, int candidate_depth,
+      float min_score, std::atomic<float>* best_score) const;
+  // Same as BranchAndBound() for all 'candidates' of the lowest resolution
+  // with 'best_score' starting at 'min_score', but the candidates are searched
+  // concurrently on 'thread_pool'. Returns the same candidate.
+  Candidate2D ConcurrentBranchAndBound(
+      const std::vector<SoaDiscreteScan2D>& discrete_scans,
+      const SearchParameters& search_parameters,
+      const std::vector<Candidate2D>& candidates, float min_score,
+      common::ThreadPoolInterface* thread_pool) const;
 
   const proto::FastCorrelativeScanMatcherOptions2D options_;
   MapLimits limits_;
+  common::ThreadPoolInterface* const thread_pool_;
   std::unique_ptr<PrecomputationGridStack2D> precomputation_grid_stack_;
 };
 
@@ -23,6 +23,7 @@
 #include <string>
 
 #include "cartographer/common/internal/testing/lua_parameter_dictionary_test_helpers.h"
+#include "cartographer/common/thread_pool.h"
 #include "cartographer/mapping/2d/probability_grid.h"
 #include "cartographer/mapping/2d/probability_grid_range_data_inserter_2d.h"
 #include "cartographer/transform/rigid_transform_test_helpers.h"
@@ -43,10 +44,10 @@ TEST(PrecomputationGridTest, CorrectValues) {
   ProbabilityGrid probability_grid(
       MapLimits(0.05, Eigen::Vector2d(5., 5.), CellLimits(250, 250)),
       &conversion_tables);
-  std::vector<float> reusable_intermediate_grid;
+  std::vector<uint8> reusable_intermediate_grid;
   PrecomputationGrid2D precomputation_grid_dummy(
       probability_grid, probability_grid.limits().cell_limits(), 1,
-      &reusable_intermediate_grid);
+      &reusable_intermediate_grid, nullptr /* thread_pool */);
   for (const Eigen::Array2i& xy_index :
        XYIndexRangeIterator(Eigen::Array2i(50, 50), Eigen::Array2i(249, 249))) {
     probability_grid.SetProbability(
@@ -57,7 +58,7 @@ TEST(PrecomputationGridTest, CorrectValues) {
   for (const int width : {1, 2, 3, 8}) {
     PrecomputationGrid2D precomputation_grid(
         probability_grid, probability_grid.limits().cell_limits(), width,
-        &reusable_intermediate_grid);
+        &reusable_intermediate_grid, nullptr /* thread_pool */);
     for (const Eigen::Array2i& xy_index :
          XYIndexRangeIterator(probability_grid.limits().cell_limits())) {
       float max_score = -std::numeric_limits<float>::infinity();
@@ -83,10 +84,10 @@ TEST(PrecomputationGridTest, TinyProbabilityGrid) {
   ProbabilityGrid probability_grid(
       MapLimits(0.05, Eigen::Vector2d(0.1, 0.1), CellLimits(4, 4)),
       &conversion_tables);
-  std::vector<float> reusable_intermediate_grid;
+  std::vector<uint8> reusable_intermediate_grid;
   PrecomputationGrid2D precomputation_grid_dummy(
       probability_grid, probability_grid.limits().cell_limits(), 1,
-      &reusable_intermediate_grid);
+      &reusable_intermediate_grid, nullptr /* thread_pool */);
   for (const Eigen::Array2i& xy_index :
        XYIndexRangeIterator(probability_grid.limits().cell_limits())) {
     probability_grid.SetProbability(
@@ -97,7 +98,7 @@ TEST(PrecomputationGridTest, TinyProbabilityGrid) {
   for (const int width : {1, 2, 3, 8, 200}) {
     PrecomputationGrid2D precomputation_grid(
         probability_grid, probability_grid.limits().cell_limits(), width,
-        &reusable_intermediate_grid);
+        &reusable_intermediate_grid, nullptr /* thread_pool */);
     for (const Eigen::Array2i& xy_index :
          XYIndexRangeIterator(probability_grid.limits().cell_limits())) {
       float max_score = -std::numeric_limits<float>::infinity();
@@ -116,6 +117,39 @@ TEST(PrecomputationGridTest, TinyProbabilityGrid) {
   }
 }
 
+TEST(PrecomputationGridTest, ConcurrentlyComputedGridsAreEqual) {
+  std::mt19937 prng(42);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  ValueConversionTables conversion_tables;
+  ProbabilityGrid probability_grid(
+      MapLimits(0.05, Eigen::Vector2d(10., 10.), CellLimits(300, 200)),
+      &conversion_tables);
+  std::vector<uint8> reusable_intermediate_grid;
+  PrecomputationGrid2D precomputation_grid_dummy(
+      probability_grid, probability_grid.limits().cell_limits(), 1,
+      &reusable_intermediate_grid, nullptr /* thread_pool */);
+  for (const Eigen::Array2i& xy_index : XYIndexRangeIterator(
+           Eigen::Array2i(20, 30), Eigen::Array2i(279, 189))) {
+    probability_grid.SetProbability(
+        xy_index, precomputation_grid_dummy.ToScore(distribution(prng)));
+  }
+
+  common::ThreadPool thread_pool(3);
+  for (const int width : {1, 2, 3, 8, 64}) {
+    const PrecomputationGrid2D precomputation_grid(
+        probability_grid, probability_grid.limits().cell_limits(), width,
+        &reusable_intermediate_grid, nullptr /* thread_pool */);
+    const PrecomputationGrid2D concurrent_precomputation_grid(
+        probability_grid, probability_grid.limits().cell_limits(), width,
+        &reusable_intermediate_grid, &thread_pool);
+    for (const Eigen::Array2i& xy_index : XYIndexRangeIterator(
+             Eigen::Array2i(-100, -100), Eigen::Array2i(400, 300))) {
+      ASSERT_EQ(precomputation_grid.GetValue(xy_index),
+                concurrent_precomputation_grid.GetValue(xy_index));
+    }
+  }
+}
+
 proto::FastCorrelativeScanMatcherOptions2D
 CreateFastCorrelativeScanMatcherTestOptions2D(
     const int branch_and_bound_depth) {
@@ -245,6 +279,146 @@ TEST(FastCorrelativeScanMatcherTest, FullSubmapMatching) {
   }
 }
 
+TEST(FastCorrelativeScanMatcherTest, ConcurrentFullSubmapMatching) {
+  std::mt19937 prng(42);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  ProbabilityGridRangeDataInserter2D range_data_inserter(
+      CreateRangeDataInserterTestOptions2D());
+  constexpr float kMinScore = 0.1f;
+  const auto options = CreateFastCorrelativeScanMatcherTestOptions2D(6);
+  common::ThreadPool thread_pool(3);
+
+  sensor::PointCloud unperturbed_point_cloud;
+  unperturbed_point_cloud.push_back({Eigen::Vector3f{-2.5f, 0.5f, 0.f}});
+  unperturbed_point_cloud.push_back({Eigen::Vector3f{-2.25f, 0.5f, 0.f}});
+  unperturbed_point_cloud.push_back({Eigen::Vector3f{0.f, 0.5f, 0.f}});
+  unperturbed_point_cloud.push_back({Eigen::Vector3f{0.25f, 1.6f, 0.f}});
+  unperturbed_point_cloud.push_back({Eigen::Vector3f{2.5f, 0.5f, 0.f}});
+  unperturbed_point_cloud.push_back({Eigen::Vector3f{2.f, 1.8f, 0.f}});
+
+  for (int i = 0; i != 20; ++i) {
+    const transform::Rigid2f perturbation(
+        {10. * distribution(prng), 10. * distribution(prng)},
+        1.6 * distribution(prng));
+    const sensor::PointCloud point_cloud = sensor::TransformPointCloud(
+        unperturbed_point_cloud, transform::Embed3D(perturbation));
+    const transform::Rigid2f expected_pose =
+        transform::Rigid2f({2. * distribution(prng), 2. * distribution(prng)},
+                           0.5 * distribution(prng)) *
+        perturbation.inverse();
+
+    ValueConversionTables conversion_tables;
+    ProbabilityGrid probability_grid(
+        MapLimits(0.05, Eigen::Vector2d(5., 5.), CellLimits(200, 200)),
+        &conversion_tables);
+    range_data_inserter.Insert(
+        sensor::RangeData{
+            transform::Embed3D(expected_pose * perturbation).translation(),
+            sensor::TransformPointCloud(point_cloud,
+                                        transform::Embed3D(expected_pose)),
+            {}},
+        &probability_grid);
+    probability_grid.FinishUpdate();
+
+    FastCorrelativeScanMatcher2D fast_correlative_scan_matcher(probability_grid,
+                                                               options);
+    transform::Rigid2d pose_estimate;
+    float score;
+    ASSERT_TRUE(fast_correlative_scan_matcher.MatchFullSubmap(
+        point_cloud, kMinScore, &score, &pose_estimate));
+
+    FastCorrelativeScanMatcher2D concurrent_fast_correlative_scan_matcher(
+        probability_grid, options, &thread_pool);
+    transform::Rigid2d concurrent_pose_estimate;
+    float concurrent_score;
+    ASSERT_TRUE(concurrent_fast_correlative_scan_matcher.MatchFullSubmap(
+        point_cloud, kMinScore, &concurrent_score, &concurrent_pose_estimate));
+    // The result is the same, even when several poses score equally.
+    EXPECT_EQ(score, concurrent_score);
+    EXPECT_EQ(pose_estimate.translation(),
+              concurrent_pose_estimate.translation());
+    EXPECT_EQ(pose_estimate.rotation().angle(),
+              concurrent_pose_estimate.rotation().angle());
+    EXPECT_THAT(expected_pose,
+                transform::IsNearly(concurrent_pose_estimate.cast<float>(),
+                                    0.03f));
+  }
+}
+
+TEST(FastCorrelativeScanMatcherTest, RotatedScanCacheGivesSameResult) {
+  std::mt19937 prng(42);
+  std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+  ProbabilityGridRangeDataInserter2D range_data_inserter(
+      CreateRangeDataInserterTestOptions2D());
+  constexpr float kMinScore = 0.1f;
+  const auto options = CreateFastCorrelativeScanMatcherTestOptions2D(3);
+
+  sensor::PointCloud point_cloud;
+  point_cloud.push_back({Eigen::Vector3f{-2.5f, 0.5f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{-2.f, 0.5f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{0.f, -0.5f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{0.5f, -1.6f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{2.5f, 0.5f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{2.5f, 1.7f, 0.f}});
+
+  // As in constraint search, the same point cloud is matched against several
+  // grids with one cache. The initial rotation differs between grids, as it
+  // does between submaps.
+  RotatedScanCache2D rotated_scan_cache;
+  constexpr int kNumGrids = 10;
+  for (int i = 0; i != kNumGrids; ++i) {
+    const transform::Rigid2f expected_pose(
+        {2. * distribution(prng), 2. * distribution(prng)},
+        0.3 + 0.5 * distribution(prng));
+    const transform::Rigid2d initial_pose_estimate(
+        {0.1, -0.2}, expected_pose.rotation().angle() + 0.1 * (i % 3 - 1));
+
+    ValueConversionTables conversion_tables;
+    ProbabilityGrid probability_grid(
+        MapLimits(0.05, Eigen::Vector2d(5., 5.), CellLimits(200, 200)),
+        &conversion_tables);
+    range_data_inserter.Insert(
+        sensor::RangeData{
+            Eigen::Vector3f(expected_pose.translation().x(),
+                            expected_pose.translation().y(), 0.f),
+            sensor::TransformPointCloud(
+                point_cloud, transform::Embed3D(expected_pose.cast<float>())),
+            {}},
+        &probability_grid);
+    probability_grid.FinishUpdate();
+
+    FastCorrelativeScanMatcher2D fast_correlative_scan_matcher(probability_grid,
+                                                               options);
+    transform::Rigid2d pose_estimate;
+    float score;
+    ASSERT_TRUE(fast_correlative_scan_matcher.Match(
+        initial_pose_estimate, point_cloud, kMinScore, &score,
+        &pose_estimate));
+    transform::Rigid2d cached_pose_estimate;
+    float cached_score;
+    ASSERT_TRUE(fast_correlative_scan_matcher.Match(
+        initial_pose_estimate, point_cloud, kMinScore, &rotated_scan_cache,
+        &cached_score, &cached_pose_estimate));
+    EXPECT_EQ(score, cached_score);
+    EXPECT_EQ(pose_estimate.translation(), cached_pose_estimate.translation());
+    EXPECT_EQ(pose_estimate.rotation().angle(),
+              cached_pose_estimate.rotation().angle());
+
+    ASSERT_TRUE(fast_correlative_scan_matcher.MatchFullSubmap(
+        point_cloud, kMinScore, &score, &pose_estimate));
+    ASSERT_TRUE(fast_correlative_scan_matcher.MatchFullSubmap(
+        point_cloud, kMinScore, &rotated_scan_cache, &cached_score,
+        &cached_pose_estimate));
+    EXPECT_EQ(score, cached_score);
+    EXPECT_EQ(pose_estimate.translation(), cached_pose_estimate.translation());
+    EXPECT_EQ(pose_estimate.rotation().angle(),
+              cached_pose_estimate.rotation().angle());
+  }
+  // The local and the full submap search each rotate the point cloud once.
+  EXPECT_EQ(2, rotated_scan_cache.num_misses());
+  EXPECT_EQ(2 * kNumGrids - 2, rotated_scan_cache.num_hits());
+}
+
 }  // namespace
 }  // namespace scan_matching
 }  // namespace mapping
@@ -25,6 +25,7 @@
 #include "cartographer/common/lua_parameter_dictionary.h"
 #include "cartographer/common/math.h"
 #include "cartographer/mapping/2d/probability_grid.h"
+#include "cartographer/mapping/internal/2d/scan_matching/candidate_scoring_kernels.h"
 #include "cartographer/mapping/internal/2d/tsdf_2d.h"
 #include "cartographer/sensor/point_cloud.h"
 #include "cartographer/transform/transform.h"
@@ -35,43 +36,330 @@ namespace mapping {
 namespace scan_matching {
 namespace {
 
-float ComputeCandidateScore(const TSDF2D& tsdf,
-                            const DiscreteScan2D& discrete_scan,
-                            int x_index_offset, int y_index_offset) {
-  float candidate_score = 0.f;
-  float summed_weight = 0.f;
-  for (const Eigen::Array2i& xy_index : discrete_scan) {
-    const Eigen::Array2i proposed_xy_index(xy_index.x() + x_index_offset,
-                                           xy_index.y() + y_index_offset);
-    const std::pair<float, float> tsd_and_weight =
-        tsdf.GetTSDAndWeight(proposed_xy_index);
-    const float normalized_tsd_score =
-        (tsdf.GetMaxCorrespondenceCost() - std::abs(tsd_and_weight.first)) /
-        tsdf.GetMaxCorrespondenceCost();
-    const float weight = tsd_and_weight.second;
-    candidate_score += normalized_tsd_score * weight;
-    summed_weight += weight;
-  }
-  if (summed_weight == 0.f) return 0.f;
-  candidate_score /= summed_weight;
-  CHECK_GE(candidate_score, 0.f);
-  return candidate_score;
+// Returns the cells of 'grid' which the cells of 'discrete_scans' shifted by
+// any of the 'linear_offsets' of the same scan can hit.
+Eigen::AlignedBox2i ComputeScoredCells(
+    const Grid2D& grid, const std::vector<DiscreteScan2D>& discrete_scans,
+    const std::vector<Eigen::AlignedBox2i>& linear_offsets) {
+  Eigen::AlignedBox2i scored_cells;
+  for (size_t i = 0; i != discrete_scans.size(); ++i) {
+    if (linear_offsets[i].isEmpty()) continue;
+    Eigen::AlignedBox2i scan_cells;
+    for (const Eigen::Array2i& xy_index : discrete_scans[i]) {
+      scan_cells.extend(xy_index.matrix());
+    }
+    if (scan_cells.isEmpty()) continue;
+    scored_cells.extend(scan_cells.min() + linear_offsets[i].min());
+    scored_cells.extend(scan_cells.max() + linear_offsets[i].max());
+  }
+  const CellLimits& cell_limits = grid.limits().cell_limits();
+  return scored_cells.intersection(Eigen::AlignedBox2i(
+      Eigen::Vector2i::Zero(), Eigen::Vector2i(cell_limits.num_x_cells - 1,
+                                               cell_limits.num_y_cells - 1)));
+}
+
+// Values of cells stored densely for 'SumCellValues'. All other cells have
+// 'outside_value'.
+struct DenseCellValues {
+  float GetValue(const Eigen::Array2i& xy_index) const {
+    const Eigen::Array2i local_xy_index = xy_index - offset;
+    if (static_cast<unsigned>(local_xy_index.x()) >=
+            static_cast<unsigned>(num_x_cells) ||
+        static_cast<unsigned>(local_xy_index.y()) >=
+            static_cast<unsigned>(num_y_cells)) {
+      return outside_value;
+    }
+    return values[local_xy_index.x() + local_xy_index.y() * num_x_cells];
+  }
+
+  ScoringGrid2D<float> scoring_grid() const {
+    return {values.data(), offset, num_x_cells, num_y_cells, outside_value};
+  }
+
+  Eigen::Array2i offset;
+  int num_x_cells;
+  int num_y_cells;
+  float outside_value;
+  std::vector<float> values;
+};
+
+// Returns the values 'get_row_values' returns for the 'cells', where
+// 'get_row_values(begin, num_cells, values)' fills in the 'values' of the
+// 'num_cells' cells from 'begin' in the x direction. All other cells have
+// 'outside_value'.
+template <typename GetRowValues>
+DenseCellValues ComputeDenseCellValuesByRow(
+    const Eigen::AlignedBox2i& cells, const float outside_value,
+    const GetRowValues& get_row_values) {
+  DenseCellValues result{Eigen::Array2i::Zero(), 0, 0, outside_value, {}};
+  if (cells.isEmpty()) {
+    return result;
+  }
+  result.offset = cells.min().array();
+  result.num_x_cells = cells.sizes().x() + 1;
+  result.num_y_cells = cells.sizes().y() + 1;
+  result.values.resize(result.num_x_cells * result.num_y_cells);
+  for (int y = 0; y != result.num_y_cells; ++y) {
+    get_row_values(result.offset + Eigen::Array2i(0, y), result.num_x_cells,
+                   &result.values[y * result.num_x_cells]);
+  }
+  return result;
 }
 
-float ComputeCandidateScore(const ProbabilityGrid& probability_grid,
-                            const DiscreteScan2D& discrete_scan,
-                            int x_index_offset, int y_index_offset) {
-  float candidate_score = 0.f;
-  for (const Eigen::Array2i& xy_index : discrete_scan) {
-    const Eigen::Array2i proposed_xy_index(xy_index.x() + x_index_offset,
-                                           xy_index.y() + y_index_offset);
-    const float probability =
-        probability_grid.GetProbability(proposed_xy_index);
-    candidate_score += probability;
-  }
-  candidate_score /= static_cast<float>(discrete_scan.size());
-  CHECK_GT(candidate_score, 0.f);
-  return candidate_score;
+// Returns the values 'get_value' returns for the 'cells'. The value of all
+// other cells is the value of a cell outside of the grid.
+template <typename GetValue>
+DenseCellValues ComputeDenseCellValues(const Eigen::AlignedBox2i& cells,
+                                       const GetValue& get_value) {
+  return ComputeDenseCellValuesByRow(
+      cells, get_value(Eigen::Array2i(-1, -1)),
+      [&get_value](const Eigen::Array2i& begin, const int num_cells,
+                   float* const values) {
+        for (int x = 0; x != num_cells; ++x) {
+          values[x] = get_value(begin + Eigen::Array2i(x, 0));
+        }
+      });
+}
+
+// Returns the values 'combine' computes from 'narrower_values' in width x
+// width areas, where 'narrower_values' are those for half the width. As for
+// the 'PrecomputationGrid2D', the area of the cell (x0, y0) is x0 <= x < x0 +
+// width and y0 <= y < y0 + width.
+template <typename Combine>
+DenseCellValues ComputeWiderCellValues(const DenseCellValues& narrower_values,
+                                       const int narrower_width,
+                                       const Combine& combine) {
+  if (narrower_values.values.empty()) {
+    return narrower_values;
+  }
+  DenseCellValues result{
+      narrower_values.offset - narrower_width,
+      narrower_values.num_x_cells + narrower_width,
+      narrower_values.num_y_cells + narrower_width,
+      narrower_values.outside_value,
+      {}};
+  result.values.resize(result.num_x_cells * result.num_y_cells);
+  for (int y = 0; y != result.num_y_cells; ++y) {
+    for (int x = 0; x != result.num_x_cells; ++x) {
+      const Eigen::Array2i xy_index = result.offset + Eigen::Array2i(x, y);
+      result.values[x + y * result.num_x_cells] = combine(
+          combine(narrower_values.GetValue(xy_index),
+                  narrower_values.GetValue(
+                      xy_index + Eigen::Array2i(narrower_width, 0))),
+          combine(narrower_values.GetValue(
+                      xy_index + Eigen::Array2i(0, narrower_width)),
+                  narrower_values.GetValue(
+                      xy_index + Eigen::Array2i(narrower_width,
+                                                narrower_width))));
+    }
+  }
+  return result;
+}
+
+// Computes the score of a candidate as the sum of the numerators over the sum
+// of the denominators of the cells its discrete scan hits. For probability
+// grids, this is the mean probability, for TSDFs the mean normalized TSD
+// weighted by the TSDF weights.
+//
+// For the search at 'depth' > 0, computes upper bounds of the scores of all
+// candidates with linear offsets in a 2^depth x 2^depth area from the maxima of
+// the numerators and the minima of the denominators in such areas.
+class CandidateScorer {
+ public:
+  // Stores the values of the 'scored_cells' of 'grid' for depths 0 to
+  // 'num_depths' - 1.
+  CandidateScorer(const Grid2D& grid, const Eigen::AlignedBox2i& scored_cells,
+                  const int num_depths) {
+    switch (grid.GetGridType()) {
+      case GridType::PROBABILITY_GRID: {
+        const auto& probability_grid =
+            static_cast<const ProbabilityGrid&>(grid);
+        // Reads whole rows of raw values instead of calling GetProbability()
+        // for each cell, which has to look up the tile of each cell.
+        std::vector<uint16> row;
+        numerators_.push_back(ComputeDenseCellValuesByRow(
+            scored_cells,
+            probability_grid.GetProbability(Eigen::Array2i(-1, -1)),
+            [&probability_grid, &row](const Eigen::Array2i& begin,
+                                      const int num_cells,
+                                      float* const values) {
+              row.resize(num_cells);
+              probability_grid.GetCorrespondenceCostValues(begin, num_cells,
+                                                           row.data());
+              for (int x = 0; x != num_cells; ++x) {
+                values[x] = CorrespondenceCostToProbability(
+                    ValueToCorrespondenceCost(row[x]));
+              }
+            }));
+        break;
+      }
+      case GridType::TSDF: {
+        const auto& tsdf = static_cast<const TSDF2D&>(grid);
+        numerators_.push_back(ComputeDenseCellValues(
+            scored_cells, [&tsdf](const Eigen::Array2i& xy_index) {
+              const std::pair<float, float> tsd_and_weight =
+                  tsdf.GetTSDAndWeight(xy_index);
+              const float normalized_tsd_score =
+                  (tsdf.GetMaxCorrespondenceCost() -
+                   std::abs(tsd_and_weight.first)) /
+                  tsdf.GetMaxCorrespondenceCost();
+              return normalized_tsd_score * tsd_and_weight.second;
+            }));
+        denominators_.push_back(ComputeDenseCellValues(
+            scored_cells, [&tsdf](const Eigen::Array2i& xy_index) {
+              return tsdf.GetTSDAndWeight(xy_index).second;
+            }));
+        break;
+      }
+    }
+    for (int depth = 1; depth < num_depths; ++depth) {
+      const int narrower_width = 1 << (depth - 1);
+      numerators_.push_back(ComputeWiderCellValues(
+          numerators_.back(), narrower_width,
+          [](const float a, const float b) { return std::max(a, b); }));
+      if (!denominators_.empty()) {
+        denominators_.push_back(ComputeWiderCellValues(
+            denominators_.back(), narrower_width,
+            [](const float a, const float b) { return std::min(a, b); }));
+      }
+    }
+  }
+
+  // Returns the score of 'discrete_scan' shifted by 'x_index_offset' and
+  // 'y_index_offset' for 'depth' 0, otherwise an upper bound of the scores for
+  // offsets which are larger by less than 2^depth.
+  float ComputeScore(const SoaDiscreteScan2D& discrete_scan,
+                     const int x_index_offset, const int y_index_offset,
+                     const int depth) const {
+    const float summed_numerator =
+        SumCellValues(numerators_.at(depth).scoring_grid(), discrete_scan,
+                      x_index_offset, y_index_offset);
+    if (denominators_.empty()) {
+      const float score =
+          summed_numerator / static_cast<float>(discrete_scan.x_indices.size());
+      CHECK_GT(score, 0.f);
+      return score;
+    }
+    const float summed_denominator =
+        SumCellValues(denominators_.at(depth).scoring_grid(), discrete_scan,
+                      x_index_offset, y_index_offset);
+    if (summed_denominator == 0.f) {
+      // Without any weight the score is 0. Otherwise it is at most 1, the
+      // largest normalized TSD.
+      return depth == 0 || summed_numerator == 0.f ? 0.f : 1.f;
+    }
+    const float score = summed_numerator / summed_denominator;
+    CHECK_GE(score, 0.f);
+    return depth == 0 ? score : std::min(score, 1.f);
+  }
+
+ private:
+  // Indexed by depth. There are no denominators for probability grids, where
+  // the denominator of every cell is 1.
+  std::vector<DenseCellValues> numerators_;
+  std::vector<DenseCellValues> denominators_;
+};
+
+// Returns the factor applied to the score of a candidate 'distance' away from
+// the initial pose estimate and rotated by 'orientation'.
+double ComputeDeltaCostFactor(
+    const proto::RealTimeCorrelativeScanMatcherOptions& options,
+    const double distance, const double orientation) {
+  return std::exp(-common::Pow2(
+      distance * options.translation_delta_cost_weight() +
+      std::abs(orientation) * options.rotation_delta_cost_weight()));
+}
+
+// Returns the smallest absolute value of the integers in [begin, end].
+int ComputeMinAbs(const int begin, const int end) {
+  if (begin > 0) return begin;
+  if (end < 0) return -end;
+  return 0;
+}
+
+// Scores 'candidates' at 'depth', where each candidate stands for all
+// candidates within the search window with linear offsets larger by less than
+// 2^depth, and sorts them by score. At depth 0, these are the scores 'Match'
+// computes for an exhaustive search.
+void ScoreCandidatesAtDepth(
+    const proto::RealTimeCorrelativeScanMatcherOptions& options,
+    const CandidateScorer& candidate_scorer,
+    const std::vector<SoaDiscreteScan2D>& discrete_scans,
+    const SearchParameters& search_parameters, const int depth,
+    std::vector<Candidate2D>* const candidates) {
+  const int max_linear_offset = (1 << depth) - 1;
+  for (Candidate2D& candidate : *candidates) {
+    const SearchParameters::LinearBounds& linear_bounds =
+        search_parameters.linear_bounds[candidate.scan_index];
+    // The delta cost is the smallest for the candidate closest to the initial
+    // pose estimate.
+    const int min_abs_x_index_offset = ComputeMinAbs(
+        candidate.x_index_offset,
+        std::min(candidate.x_index_offset + max_linear_offset,
+                 linear_bounds.max_x));
+    const int min_abs_y_index_offset = ComputeMinAbs(
+        candidate.y_index_offset,
+        std::min(candidate.y_index_offset + max_linear_offset,
+                 linear_bounds.max_y));
+    candidate.score =
+        candidate_scorer.ComputeScore(discrete_scans[candidate.scan_index],
+                                      candidate.x_index_offset,
+                                      candidate.y_index_offset, depth) *
+        ComputeDeltaCostFactor(
+            options,
+            std::hypot(min_abs_y_index_offset * search_parameters.resolution,
+                       min_abs_x_index_offset * search_parameters.resolution),
+            candidate.orientation);
+  }
+  std::sort(candidates->begin(), candidates->end(),
+            std::greater<Candidate2D>());
+}
+
+// Returns the best candidate of those 'candidates' at 'depth', sorted by
+// score, stand for, or a candidate with 'min_score' if none scores higher.
+Candidate2D BranchAndBound(
+    const proto::RealTimeCorrelativeScanMatcherOptions& options,
+    const CandidateScorer& candidate_scorer,
+    const std::vector<SoaDiscreteScan2D>& discrete_scans,
+    const SearchParameters& search_parameters,
+    const std::vector<Candidate2D>& candidates, const int depth,
+    const float min_score) {
+  if (depth == 0) {
+    return candidates.front();
+  }
+  Candidate2D best_candidate(0, 0, 0, search_parameters);
+  best_candidate.score = min_score;
+  for (const Candidate2D& candidate : candidates) {
+    if (candidate.score <= best_candidate.score) {
+      break;
+    }
+    std::vector<Candidate2D> higher_resolution_candidates;
+    const int half_width = 1 << (depth - 1);
+    for (int x_offset : {0, half_width}) {
+      if (candidate.x_index_offset + x_offset >
+          search_parameters.linear_bounds[candidate.scan_index].max_x) {
+        break;
+      }
+      for (int y_offset : {0, half_width}) {
+        if (candidate.y_index_offset + y_offset >
+            search_parameters.linear_bounds[candidate.scan_index].max_y) {
+          break;
+        }
+        higher_resolution_candidates.emplace_back(
+            candidate.scan_index, candidate.x_index_offset + x_offset,
+            candidate.y_index_offset + y_offset, search_parameters);
+      }
+    }
+    ScoreCandidatesAtDepth(options, candidate_scorer, discrete_scans,
+                           search_parameters, depth - 1,
+                           &higher_resolution_candidates);
+    best_candidate = std::max(
+        best_candidate,
+        BranchAndBound(options, candidate_scorer, discrete_scans,
+                       search_parameters, higher_resolution_candidates,
+                       depth - 1, best_candidate.score));
+  }
+  return best_candidate;
 }
 
 }  // namespace
@@ -135,12 +423,16 @@ double RealTimeCorrelativeScanMatcher2D::Match(
       grid.limits(), rotated_scans,
       Eigen::Translation2f(initial_pose_estimate.translation().x(),
                            initial_pose_estimate.translation().y()));
-  std::vector<Candidate2D> candidates =
-      GenerateExhaustiveSearchCandidates(search_parameters);
-  ScoreCandidates(grid, discrete_scans, search_parameters, &candidates);
-
-  const Candidate2D& best_candidate =
-      *std::max_element(candidates.begin(), candidates.end());
+  Candidate2D best_candidate(0, 0, 0, search_parameters);
+  if (options_.branch_and_bound_depth() > 1) {
+    best_candidate =
+        BranchAndBoundSearch(grid, discrete_scans, search_parameters);
+  } else {
+    std::vector<Candidate2D> candidates =
+        GenerateExhaustiveSearchCandidates(search_parameters);
+    ScoreCandidates(grid, discrete_scans, search_parameters, &candidates);
+    best_candidate = *std::max_element(candidates.begin(), candidates.end());
+  }
   *pose_estimate = transform::Rigid2d(
       {initial_pose_estimate.translation().x() + best_candidate.x,
        initial_pose_estimate.translation().y() + best_candidate.y},
@@ -148,30 +440,71 @@ double RealTimeCorrelativeScanMatcher2D::Match(
   return best_candidate.score;
 }
 
+Candidate2D RealTimeCorrelativeScanMatcher2D::BranchAndBoundSearch(
+    const Grid2D& grid, const std::vector<DiscreteScan2D>& discrete_scans,
+    const SearchParameters& search_parameters) const {
+  const int max_depth = options_.branch_and_bound_depth() - 1;
+  std::vector<Eigen::AlignedBox2i> linear_offsets;
+  for (const SearchParameters::LinearBounds& linear_bounds :
+       search_parameters.linear_bounds) {
+    linear_offsets.emplace_back(
+        Eigen::Vector2i(linear_bounds.min_x, linear_bounds.min_y),
+        Eigen::Vector2i(linear_bounds.max_x, linear_bounds.max_y));
+  }
+  const CandidateScorer candidate_scorer(
+      grid, ComputeScoredCells(grid, discrete_scans, linear_offsets),
+      max_depth + 1);
+  const std::vector<SoaDiscreteScan2D> soa_discrete_scans =
+      ToSoaDiscreteScans(discrete_scans);
+
+  const int linear_step_size = 1 << max_depth;
+  std::vector<Candidate2D> lowest_resolution_candidates;
+  for (int scan_index = 0; scan_index != search_parameters.num_scans;
+       ++scan_index) {
+    const SearchParameters::LinearBounds& linear_bounds =
+        search_parameters.linear_bounds[scan_index];
+    for (int x_index_offset = linear_bounds.min_x;
+         x_index_offset <= linear_bounds.max_x;
+         x_index_offset += linear_step_size) {
+      for (int y_index_offset = linear_bounds.min_y;
+           y_index_offset <= linear_bounds.max_y;
+           y_index_offset += linear_step_size) {
+        lowest_resolution_candidates.emplace_back(
+            scan_index, x_index_offset, y_index_offset, search_parameters);
+      }
+    }
+  }
+  ScoreCandidatesAtDepth(options_, candidate_scorer, soa_discrete_scans,
+                         search_parameters, max_depth,
+                         &lowest_resolution_candidates);
+  return BranchAndBound(options_, candidate_scorer, soa_discrete_scans,
+                        search_parameters, lowest_resolution_candidates,
+                        max_depth, -std::numeric_limits<float>::infinity());
+}
+
 void RealTimeCorrelativeScanMatcher2D::ScoreCandidates(
     const Grid2D& grid, const std::vector<DiscreteScan2D>& discrete_scans,
     const SearchParameters& search_parameters,
     std::vector<Candidate2D>* const candidates) const {
+  // The scored cells of the grid are copied into dense arrays once, so that
+  // the scoring kernels can look up the values of many cells at once.
+  std::vector<Eigen::AlignedBox2i> linear_offsets(discrete_scans.size());
+  for (const Candidate2D& candidate : *candidates) {
+    linear_offsets[candidate.scan_index].extend(
+        Eigen::Vector2i(candidate.x_index_offset, candidate.y_index_offset));
+  }
+  const CandidateScorer candidate_scorer(
+      grid, ComputeScoredCells(grid, discrete_scans, linear_offsets),
+      1 /* num_depths */);
+  const std::vector<SoaDiscreteScan2D> soa_discrete_scans =
+      ToSoaDiscreteScans(discrete_scans);
   for (Candidate2D& candidate : *candidates) {
-    switch (grid.GetGridType()) {
-      case GridType::PROBABILITY_GRID:
-        candidate.score = ComputeCandidateScore(
-            static_cast<const ProbabilityGrid&>(grid),
-            discrete_scans[candidate.scan_index], candidate.x_index_offset,
-            candidate.y_index_offset);
-        break;
-      case GridType::TSDF:
-        candidate.score = ComputeCandidateScore(
-            static_cast<const TSDF2D&>(grid),
-            discrete_scans[candidate.scan_index], candidate.x_index_offset,
-            candidate.y_index_offset);
-        break;
-    }
-    candidate.score *=
-        std::exp(-common::Pow2(std::hypot(candidate.x, candidate.y) *
-                                   options_.translation_delta_cost_weight() +
-                               std::abs(candidate.orientation) *
-                                   options_.rotation_delta_cost_weight()));
+    candidate.score =
+        candidate_scorer.ComputeScore(soa_discrete_scans[candidate.scan_index],
+                                      candidate.x_index_offset,
+                                      candidate.y_index_offset, 0 /* depth */) *
+        ComputeDeltaCostFactor(options_, std::hypot(candidate.x, candidate.y),
+                               candidate.orientation);
   }
 }
 
@@ -80,6 +80,11 @@ class RealTimeCorrelativeScanMatcher2D {
  private:
   std::vector<Candidate2D> GenerateExhaustiveSearchCandidates(
       const SearchParameters& search_parameters) const;
+  // Returns the best candidate of the exhaustive search, but prunes the search
+  // window hierarchically using 'branch_and_bound_depth' resolutions.
+  Candidate2D BranchAndBoundSearch(
+      const Grid2D& grid, const std::vector<DiscreteScan2D>& discrete_scans,
+      const SearchParameters& search_parameters) const;
 
   const proto::RealTimeCorrelativeScanMatcherOptions options_;
 };
@@ -27,9 +27,11 @@
 #include "cartographer/mapping/internal/2d/tsdf_2d.h"
 #include "cartographer/mapping/internal/2d/tsdf_range_data_inserter_2d.h"
 #include "cartographer/mapping/internal/scan_matching/real_time_correlative_scan_matcher.h"
+#include "cartographer/sensor/internal/test_helpers.h"
 #include "cartographer/sensor/point_cloud.h"
+#include "cartographer/transform/rigid_transform_test_helpers.h"
 #include "cartographer/transform/transform.h"
-#include "gtest/gtest.h"
+#include "gmock/gmock.h"
 
 namespace cartographer {
 namespace mapping {
@@ -197,6 +199,78 @@ TEST_F(RealTimeCorrelativeScanMatcherTest,
   EXPECT_GT(1.0, candidates[0].score);
 }
 
+// Grids of a 10 m x 6 m room, as seen by a planar lidar from its center.
+std::vector<std::unique_ptr<Grid2D>> CreateRoomGrids(
+    const sensor::PointCloud& scan, ValueConversionTables* conversion_tables) {
+  const MapLimits limits(0.05, Eigen::Vector2d(6., 6.), CellLimits(240, 240));
+  std::vector<std::unique_ptr<Grid2D>> grids;
+  grids.push_back(
+      absl::make_unique<ProbabilityGrid>(limits, conversion_tables));
+  mapping::proto::ProbabilityGridRangeDataInserterOptions2D
+      probability_grid_options;
+  probability_grid_options.set_hit_probability(0.55);
+  probability_grid_options.set_miss_probability(0.49);
+  probability_grid_options.set_insert_free_space(true);
+  grids.push_back(
+      absl::make_unique<TSDF2D>(limits, 0.3, 10., conversion_tables));
+  mapping::proto::TSDFRangeDataInserterOptions2D tsdf_options;
+  tsdf_options.set_truncation_distance(0.3);
+  tsdf_options.set_maximum_weight(10.);
+  tsdf_options.mutable_normal_estimation_options()->set_num_normal_samples(4);
+  tsdf_options.mutable_normal_estimation_options()->set_sample_radius(0.5);
+  tsdf_options.set_project_sdf_distance_to_scan_normal(true);
+  tsdf_options.set_update_weight_angle_scan_normal_to_ray_kernel_bandwidth(
+      0.5);
+  tsdf_options.set_update_weight_distance_cell_to_hit_kernel_bandwidth(0.5);
+  const sensor::RangeData range_data{Eigen::Vector3f::Zero(), scan, {}};
+  for (int i = 0; i != 5; ++i) {
+    ProbabilityGridRangeDataInserter2D(probability_grid_options)
+        .Insert(range_data, grids[0].get());
+    TSDFRangeDataInserter2D(tsdf_options).Insert(range_data, grids[1].get());
+  }
+  for (const auto& grid : grids) {
+    grid->FinishUpdate();
+  }
+  return grids;
+}
+
+TEST(RealTimeCorrelativeScanMatcher2DBranchAndBoundTest,
+     MatchesExhaustiveSearch) {
+  const sensor::PointCloud scan = sensor::testing::ToPointCloud(
+      sensor::testing::GenerateSyntheticScan2D(360, 5.f, 3.f));
+  ValueConversionTables conversion_tables;
+  const std::vector<std::unique_ptr<Grid2D>> grids =
+      CreateRoomGrids(scan, &conversion_tables);
+  proto::RealTimeCorrelativeScanMatcherOptions options;
+  options.set_linear_search_window(0.3);
+  options.set_angular_search_window(0.2);
+  options.set_translation_delta_cost_weight(0.1);
+  options.set_rotation_delta_cost_weight(0.1);
+  const RealTimeCorrelativeScanMatcher2D exhaustive_scan_matcher(options);
+  for (const auto& grid : grids) {
+    for (const transform::Rigid2d& initial_pose_estimate :
+         {transform::Rigid2d({0.04, -0.03}, 0.02),
+          transform::Rigid2d({-0.21, 0.13}, -0.1),
+          transform::Rigid2d({0.4, 0.3}, 0.3)}) {
+      transform::Rigid2d expected_pose;
+      const double expected_score = exhaustive_scan_matcher.Match(
+          initial_pose_estimate, scan, *grid, &expected_pose);
+      for (const int branch_and_bound_depth : {2, 3, 5}) {
+        options.set_branch_and_bound_depth(branch_and_bound_depth);
+        const RealTimeCorrelativeScanMatcher2D scan_matcher(options);
+        transform::Rigid2d pose_estimate;
+        EXPECT_EQ(expected_score,
+                  scan_matcher.Match(initial_pose_estimate, scan, *grid,
+                                     &pose_estimate));
+        EXPECT_THAT(expected_pose, transform::IsNearly(pose_estimate, 1e-9))
+            << "Actual: " << transform::ToProto(pose_estimate).DebugString()
+            << "\nExpected: "
+            << transform::ToProto(expected_pose).DebugString();
+      }
+    }
+  }
+}
+
 }  // namespace
 }  // namespace scan_matching
 }  // namespace mapping
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/internal/2d/scan_matching/rotated_scan_cache_2d.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+namespace {
+
+// A point cloud is typically searched with two sets of angular search
+// parameters: those of local and those of full submap matching.
+constexpr int kMaxNumEntries = 2;
+
+}  // namespace
+
+std::shared_ptr<const std::vector<sensor::PointCloud>>
+RotatedScanCache2D::FindEntry(const SearchParameters& search_parameters) {
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->angular_perturbation_step_size ==
+            search_parameters.angular_perturbation_step_size &&
+        it->num_scans == search_parameters.num_scans) {
+      entries_.splice(entries_.begin(), entries_, it);
+      return entries_.front().rotated_scans;
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<const std::vector<sensor::PointCloud>> RotatedScanCache2D::Get(
+    const sensor::PointCloud& point_cloud,
+    const SearchParameters& search_parameters) {
+  {
+    absl::MutexLock locker(&mutex_);
+    auto rotated_scans = FindEntry(search_parameters);
+    if (rotated_scans != nullptr) {
+      ++num_hits_;
+      return rotated_scans;
+    }
+    ++num_misses_;
+  }
+
+  // Rotate without holding the lock, so that other threads can look up scans
+  // in the meantime.
+  auto rotated_scans = std::make_shared<const std::vector<sensor::PointCloud>>(
+      GenerateRotatedScans(point_cloud, search_parameters));
+  size_t num_bytes = 0;
+  for (const sensor::PointCloud& rotated_scan : *rotated_scans) {
+    num_bytes += rotated_scan.size() * sizeof(sensor::RangefinderPoint) +
+                 rotated_scan.intensities().size() * sizeof(float);
+  }
+
+  absl::MutexLock locker(&mutex_);
+  auto concurrently_rotated_scans = FindEntry(search_parameters);
+  if (concurrently_rotated_scans != nullptr) {
+    return concurrently_rotated_scans;
+  }
+  entries_.push_front(Entry{search_parameters.angular_perturbation_step_size,
+                            search_parameters.num_scans, num_bytes,
+                            rotated_scans});
+  num_bytes_ += num_bytes;
+  if (static_cast<int>(entries_.size()) > kMaxNumEntries) {
+    num_bytes_ -= entries_.back().num_bytes;
+    entries_.pop_back();
+  }
+  return rotated_scans;
+}
+
+size_t RotatedScanCache2D::num_bytes() const {
+  absl::MutexLock locker(&mutex_);
+  return num_bytes_;
+}
+
+int RotatedScanCache2D::num_hits() const {
+  absl::MutexLock locker(&mutex_);
+  return num_hits_;
+}
+
+int RotatedScanCache2D::num_misses() const {
+  absl::MutexLock locker(&mutex_);
+  return num_misses_;
+}
+
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
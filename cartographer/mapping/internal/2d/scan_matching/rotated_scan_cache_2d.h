@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_ROTATED_SCAN_CACHE_2D_H_
+#define CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_ROTATED_SCAN_CACHE_2D_H_
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "cartographer/mapping/internal/2d/scan_matching/correlative_scan_matcher_2d.h"
+#include "cartographer/sensor/point_cloud.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+
+// Caches the rotated scans of one point cloud, so that matching it against
+// several grids with the same angular search parameters only has to transform
+// and discretize them for each grid. The scans are only rotated by the angular
+// perturbations of the search. The initial rotation, which differs between
+// grids, is applied together with the translation when discretizing. Rotating
+// is the expensive part, since the angular step gets finer with the range of
+// the point cloud.
+//
+// This class is thread-safe.
+class RotatedScanCache2D {
+ public:
+  RotatedScanCache2D() = default;
+
+  RotatedScanCache2D(const RotatedScanCache2D&) = delete;
+  RotatedScanCache2D& operator=(const RotatedScanCache2D&) = delete;
+
+  // Returns 'point_cloud' rotated by the angles of 'search_parameters', as
+  // computed by GenerateRotatedScans(). The result is cached by the angular
+  // step and the number of scans, so 'point_cloud' must be the same in all
+  // calls.
+  std::shared_ptr<const std::vector<sensor::PointCloud>> Get(
+      const sensor::PointCloud& point_cloud,
+      const SearchParameters& search_parameters) LOCKS_EXCLUDED(mutex_);
+
+  // Returns the number of bytes of the cached point clouds.
+  size_t num_bytes() const LOCKS_EXCLUDED(mutex_);
+
+  // Returns how often Get() found the rotated scans in the cache and how
+  // often it had to compute them.
+  int num_hits() const LOCKS_EXCLUDED(mutex_);
+  int num_misses() const LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    double angular_perturbation_step_size;
+    int num_scans;
+    size_t num_bytes;
+    std::shared_ptr<const std::vector<sensor::PointCloud>> rotated_scans;
+  };
+
+  // Returns the cached scans for 'search_parameters' and marks them as most
+  // recently used, or nullptr if there are none.
+  std::shared_ptr<const std::vector<sensor::PointCloud>> FindEntry(
+      const SearchParameters& search_parameters)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  // Most recently used entries first.
+  std::list<Entry> entries_ GUARDED_BY(mutex_);
+  size_t num_bytes_ GUARDED_BY(mutex_) = 0;
+  int num_hits_ GUARDED_BY(mutex_) = 0;
+  int num_misses_ GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_MAPPING_INTERNAL_2D_SCAN_MATCHING_ROTATED_SCAN_CACHE_2D_H_
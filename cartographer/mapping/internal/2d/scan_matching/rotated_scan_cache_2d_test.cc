@@ -0,0 +1,83 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/internal/2d/scan_matching/rotated_scan_cache_2d.h"
+
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+namespace {
+
+sensor::PointCloud CreatePointCloud() {
+  sensor::PointCloud point_cloud;
+  point_cloud.push_back({Eigen::Vector3f{-3.f, 0.5f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{0.f, 2.f, 0.f}});
+  point_cloud.push_back({Eigen::Vector3f{1.5f, -0.25f, 0.f}});
+  return point_cloud;
+}
+
+TEST(RotatedScanCache2DTest, ReturnsGeneratedRotatedScans) {
+  const sensor::PointCloud point_cloud = CreatePointCloud();
+  const SearchParameters search_parameters(0.5, 0.3, point_cloud, 0.05);
+  RotatedScanCache2D cache;
+  const auto rotated_scans = cache.Get(point_cloud, search_parameters);
+
+  const std::vector<sensor::PointCloud> expected_rotated_scans =
+      GenerateRotatedScans(point_cloud, search_parameters);
+  ASSERT_EQ(rotated_scans->size(), expected_rotated_scans.size());
+  size_t expected_num_bytes = 0;
+  for (size_t i = 0; i != expected_rotated_scans.size(); ++i) {
+    EXPECT_EQ((*rotated_scans)[i].points(),
+              expected_rotated_scans[i].points());
+    expected_num_bytes +=
+        expected_rotated_scans[i].size() * sizeof(sensor::RangefinderPoint);
+  }
+  EXPECT_EQ(expected_num_bytes, cache.num_bytes());
+  EXPECT_EQ(0, cache.num_hits());
+  EXPECT_EQ(1, cache.num_misses());
+}
+
+TEST(RotatedScanCache2DTest, ReusesRotatedScans) {
+  const sensor::PointCloud point_cloud = CreatePointCloud();
+  const SearchParameters search_parameters(0.5, 0.3, point_cloud, 0.05);
+  const SearchParameters other_search_parameters(0.5, 0.3, point_cloud, 0.1);
+  RotatedScanCache2D cache;
+  const auto rotated_scans = cache.Get(point_cloud, search_parameters);
+  const size_t num_bytes = cache.num_bytes();
+  // The linear search window does not matter.
+  EXPECT_EQ(
+      cache.Get(point_cloud, SearchParameters(2., 0.3, point_cloud, 0.05)),
+      rotated_scans);
+  EXPECT_EQ(num_bytes, cache.num_bytes());
+  const auto other_rotated_scans =
+      cache.Get(point_cloud, other_search_parameters);
+  EXPECT_NE(other_rotated_scans, rotated_scans);
+  EXPECT_LT(num_bytes, cache.num_bytes());
+  EXPECT_EQ(cache.Get(point_cloud, search_parameters), rotated_scans);
+  // Only the two most recently used rotated scans are kept.
+  cache.Get(point_cloud, SearchParameters(0.5, 0.6, point_cloud, 0.05));
+  EXPECT_NE(cache.Get(point_cloud, other_search_parameters),
+            other_rotated_scans);
+  EXPECT_EQ(2, cache.num_hits());
+  EXPECT_EQ(4, cache.num_misses());
+}
+
+}  // namespace
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
@@ -0,0 +1,205 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "benchmark/benchmark.h"
+#include "cartographer/common/thread_pool.h"
+#include "cartographer/mapping/2d/probability_grid.h"
+#include "cartographer/mapping/2d/probability_grid_range_data_inserter_2d.h"
+#include "cartographer/mapping/internal/2d/scan_matching/ceres_scan_matcher_2d.h"
+#include "cartographer/mapping/internal/2d/scan_matching/fast_correlative_scan_matcher_2d.h"
+#include "cartographer/mapping/internal/2d/scan_matching/real_time_correlative_scan_matcher_2d.h"
+#include "cartographer/mapping/probability_values.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+#include "cartographer/sensor/range_data.h"
+#include "cartographer/transform/rigid_transform.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+namespace {
+
+// A probability grid containing a 20 m x 12 m room, as seen by a planar lidar
+// with 720 beams from a few poses, and a scan of it to be matched.
+class Room2D {
+ public:
+  Room2D()
+      : scan_(sensor::testing::ToPointCloud(
+            sensor::testing::GenerateSyntheticScan2D(720, 10.f, 6.f))),
+        grid_(MapLimits(0.05, Eigen::Vector2d(12., 12.), CellLimits(480, 480)),
+              &conversion_tables_) {
+    mapping::proto::ProbabilityGridRangeDataInserterOptions2D options;
+    options.set_hit_probability(0.55);
+    options.set_miss_probability(0.49);
+    options.set_insert_free_space(true);
+    const ProbabilityGridRangeDataInserter2D range_data_inserter(options);
+    for (int i = 0; i != 10; ++i) {
+      range_data_inserter.Insert(
+          sensor::RangeData{Eigen::Vector3f::Zero(), scan_, {}}, &grid_);
+      grid_.FinishUpdate();
+    }
+  }
+
+  const sensor::PointCloud& scan() const { return scan_; }
+  const Grid2D& grid() const { return grid_; }
+
+ private:
+  const sensor::PointCloud scan_;
+  ValueConversionTables conversion_tables_;
+  ProbabilityGrid grid_;
+};
+
+const Room2D& GetRoom2D() {
+  static const Room2D* const kRoom = new Room2D();
+  return *kRoom;
+}
+
+// Initial pose estimate off by a few centimeters and a degree, a typical error
+// of the pose extrapolator.
+transform::Rigid2d GetInitialPoseEstimate() {
+  return transform::Rigid2d({0.04, -0.03}, 0.02);
+}
+
+void BM_RealTimeCorrelativeScanMatcher2D_Match(benchmark::State& state) {
+  const Room2D& room = GetRoom2D();
+  proto::RealTimeCorrelativeScanMatcherOptions options;
+  options.set_linear_search_window(0.01 * state.range(0));
+  options.set_angular_search_window(0.35);
+  options.set_translation_delta_cost_weight(0.1);
+  options.set_rotation_delta_cost_weight(0.1);
+  options.set_branch_and_bound_depth(state.range(1));
+  const RealTimeCorrelativeScanMatcher2D scan_matcher(options);
+  for (auto _ : state) {
+    transform::Rigid2d pose_estimate;
+    benchmark::DoNotOptimize(scan_matcher.Match(
+        GetInitialPoseEstimate(), room.scan(), room.grid(), &pose_estimate));
+  }
+}
+// Linear search window in centimeters and branch and bound depth.
+BENCHMARK(BM_RealTimeCorrelativeScanMatcher2D_Match)
+    ->Args({10, 1})
+    ->Args({30, 1})
+    ->Args({10, 3})
+    ->Args({30, 3})
+    ->Args({30, 4})
+    ->Unit(benchmark::kMillisecond);
+
+void BM_CeresScanMatcher2D_Match(benchmark::State& state) {
+  const Room2D& room = GetRoom2D();
+  proto::CeresScanMatcherOptions2D options;
+  options.set_occupied_space_weight(1.);
+  options.set_translation_weight(10.);
+  options.set_rotation_weight(40.);
+  options.mutable_ceres_solver_options()->set_use_nonmonotonic_steps(false);
+  options.mutable_ceres_solver_options()->set_max_num_iterations(20);
+  options.mutable_ceres_solver_options()->set_num_threads(1);
+  const CeresScanMatcher2D scan_matcher(options);
+  const transform::Rigid2d initial_pose_estimate = GetInitialPoseEstimate();
+  for (auto _ : state) {
+    transform::Rigid2d pose_estimate;
+    ceres::Solver::Summary summary;
+    scan_matcher.Match(initial_pose_estimate.translation(),
+                       initial_pose_estimate, room.scan(), room.grid(),
+                       &pose_estimate, &summary);
+    benchmark::DoNotOptimize(pose_estimate);
+  }
+}
+BENCHMARK(BM_CeresScanMatcher2D_Match);
+
+// Computes only the finest precomputation grid, i.e. reads all cells.
+void BM_PrecomputationGrid2D(benchmark::State& state) {
+  const Room2D& room = GetRoom2D();
+  std::vector<uint8> reusable_intermediate_grid;
+  for (auto _ : state) {
+    const PrecomputationGrid2D precomputation_grid(
+        room.grid(), room.grid().limits().cell_limits(), 1,
+        &reusable_intermediate_grid, nullptr);
+    benchmark::DoNotOptimize(&precomputation_grid);
+  }
+}
+BENCHMARK(BM_PrecomputationGrid2D)->Unit(benchmark::kMicrosecond);
+
+void BM_PrecomputationGridStack2D(benchmark::State& state) {
+  const Room2D& room = GetRoom2D();
+  proto::FastCorrelativeScanMatcherOptions2D options;
+  options.set_branch_and_bound_depth(7);
+  std::unique_ptr<common::ThreadPool> thread_pool;
+  if (state.range(0) > 0) {
+    thread_pool = absl::make_unique<common::ThreadPool>(state.range(0));
+  }
+  for (auto _ : state) {
+    const PrecomputationGridStack2D precomputation_grid_stack(
+        room.grid(), options, thread_pool.get());
+    benchmark::DoNotOptimize(&precomputation_grid_stack);
+  }
+}
+// Number of additional threads.
+BENCHMARK(BM_PrecomputationGridStack2D)
+    ->Arg(0)
+    ->Arg(3)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_FastCorrelativeScanMatcher2D_Match(benchmark::State& state) {
+  const Room2D& room = GetRoom2D();
+  proto::FastCorrelativeScanMatcherOptions2D options;
+  options.set_linear_search_window(state.range(0));
+  options.set_angular_search_window(0.52);
+  options.set_branch_and_bound_depth(7);
+  const FastCorrelativeScanMatcher2D scan_matcher(room.grid(), options);
+  for (auto _ : state) {
+    float score;
+    transform::Rigid2d pose_estimate;
+    benchmark::DoNotOptimize(scan_matcher.Match(GetInitialPoseEstimate(),
+                                                room.scan(), 0.55f, &score,
+                                                &pose_estimate));
+  }
+}
+// Linear search window in meters.
+BENCHMARK(BM_FastCorrelativeScanMatcher2D_Match)
+    ->Arg(3)
+    ->Arg(7)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_FastCorrelativeScanMatcher2D_MatchFullSubmap(benchmark::State& state) {
+  const Room2D& room = GetRoom2D();
+  proto::FastCorrelativeScanMatcherOptions2D options;
+  options.set_branch_and_bound_depth(7);
+  std::unique_ptr<common::ThreadPool> thread_pool;
+  if (state.range(0) > 0) {
+    thread_pool = absl::make_unique<common::ThreadPool>(state.range(0));
+  }
+  const FastCorrelativeScanMatcher2D scan_matcher(room.grid(), options,
+                                                  thread_pool.get());
+  for (auto _ : state) {
+    float score;
+    transform::Rigid2d pose_estimate;
+    benchmark::DoNotOptimize(scan_matcher.MatchFullSubmap(
+        room.scan(), 0.55f, &score, &pose_estimate));
+  }
+}
+// Number of additional threads.
+BENCHMARK(BM_FastCorrelativeScanMatcher2D_MatchFullSubmap)
+    ->Arg(0)
+    ->Arg(3)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
@@ -22,6 +22,7 @@
 #include "cartographer/common/port.h"
 #include "cartographer/mapping/2d/grid_2d.h"
 #include "cartographer/mapping/2d/map_limits.h"
+#include "cartographer/mapping/2d/tiled_cells.h"
 #include "cartographer/mapping/2d/xy_index.h"
 #include "cartographer/mapping/internal/2d/tsd_value_converter.h"
 
@@ -55,7 +56,7 @@ class TSDF2D : public Grid2D {
  private:
   ValueConversionTables* conversion_tables_;
   std::unique_ptr<TSDValueConverter> value_converter_;
-  std::vector<uint16> weight_cells_;  // Highest bit is update marker.
+  TiledCells weight_cells_;  // Highest bit is update marker.
 };
 
 }  // namespace mapping
@@ -125,6 +125,7 @@ class LocalTrajectoryBuilderTest : public ::testing::Test {
             high_resolution_max_range = 50.,
             low_resolution = 0.5,
             num_range_data = 45000,
+            num_insertion_threads = 0,
             range_data_inserter = {
               hit_probability = 0.7,
               miss_probability = 0.4,
@@ -64,7 +64,7 @@ class PoseGraph3D : public PoseGraph {
   PoseGraph3D(
       const proto::PoseGraphOptions& options,
       std::unique_ptr<optimization::OptimizationProblem3D> optimization_problem,
-      common::ThreadPool* thread_pool);
+      common::ThreadPoolInterface* thread_pool);
   ~PoseGraph3D() override;
 
   PoseGraph3D(const PoseGraph3D&) = delete;
@@ -112,6 +112,8 @@ class PoseGraph3D : public PoseGraph {
       const std::vector<Constraint>& constraints) override;
   void AddTrimmer(std::unique_ptr<PoseGraphTrimmer> trimmer) override;
   void RunFinalOptimization() override;
+  void WaitForAllComputations() LOCKS_EXCLUDED(mutex_)
+      LOCKS_EXCLUDED(work_queue_mutex_) override;
   std::vector<std::vector<int>> GetConnectedTrajectories() const override
       LOCKS_EXCLUDED(mutex_);
   PoseGraph::SubmapData GetSubmapData(const SubmapId& submap_id) const
@@ -157,12 +159,6 @@ class PoseGraph3D : public PoseGraph {
 
   static void RegisterMetrics(metrics::FamilyFactory* family_factory);
 
- protected:
-  // Waits until we caught up (i.e. nothing is waiting to be scheduled), and
-  // all computations have finished.
-  void WaitForAllComputations() LOCKS_EXCLUDED(mutex_)
-      LOCKS_EXCLUDED(work_queue_mutex_);
-
  private:
   MapById<SubmapId, SubmapData> GetSubmapDataUnderLock() const
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -261,7 +257,7 @@ class PoseGraph3D : public PoseGraph {
   constraints::ConstraintBuilder3D constraint_builder_;
 
   // Thread pool used for handling the work queue.
-  common::ThreadPool* const thread_pool_;
+  common::ThreadPoolInterface* const thread_pool_;
 
   // List of all trimmers to consult when optimizations finish.
   std::vector<std::unique_ptr<PoseGraphTrimmer>> trimmers_ GUARDED_BY(mutex_);
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+
+#include "benchmark/benchmark.h"
+#include "cartographer/mapping/3d/hybrid_grid.h"
+#include "cartographer/mapping/3d/range_data_inserter_3d.h"
+#include "cartographer/mapping/internal/3d/scan_matching/ceres_scan_matcher_3d.h"
+#include "cartographer/mapping/internal/3d/scan_matching/fast_correlative_scan_matcher_3d.h"
+#include "cartographer/mapping/internal/3d/scan_matching/rotational_scan_matcher.h"
+#include "cartographer/mapping/trajectory_node.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+#include "cartographer/sensor/internal/voxel_filter.h"
+#include "cartographer/sensor/range_data.h"
+#include "cartographer/transform/rigid_transform.h"
+
+namespace cartographer {
+namespace mapping {
+namespace scan_matching {
+namespace {
+
+constexpr int kHistogramSize = 120;
+
+// High and low resolution hybrid grids of a 24 m x 16 m x 6 m room as seen by
+// a 16-ring lidar, together with node data of a scan of it.
+class Room3D {
+ public:
+  Room3D()
+      : high_resolution_hybrid_grid_(0.10f),
+        low_resolution_hybrid_grid_(0.45f) {
+    const sensor::PointCloud scan =
+        sensor::testing::ToPointCloud(sensor::testing::GenerateSyntheticScan3D(
+            16, 1024, Eigen::Vector3f(12.f, 8.f, 3.f)));
+    mapping::proto::RangeDataInserterOptions3D options;
+    options.set_hit_probability(0.55);
+    options.set_miss_probability(0.49);
+    options.set_num_free_space_voxels(2);
+    options.set_intensity_threshold(40.f);
+    const RangeDataInserter3D range_data_inserter(options);
+    const sensor::RangeData range_data{Eigen::Vector3f::Zero(), scan, {}};
+    for (int i = 0; i != 10; ++i) {
+      range_data_inserter.Insert(range_data, &high_resolution_hybrid_grid_,
+                                 /*intensity_hybrid_grid=*/nullptr);
+      range_data_inserter.Insert(range_data, &low_resolution_hybrid_grid_,
+                                 /*intensity_hybrid_grid=*/nullptr);
+      high_resolution_hybrid_grid_.FinishUpdate();
+      low_resolution_hybrid_grid_.FinishUpdate();
+    }
+    const sensor::PointCloud high_resolution_point_cloud =
+        sensor::VoxelFilter(scan, 0.2f);
+    histogram_ = RotationalScanMatcher::ComputeHistogram(
+        high_resolution_point_cloud, kHistogramSize);
+    node_data_ = TrajectoryNode::Data{common::FromUniversal(0),
+                                      Eigen::Quaterniond::Identity(),
+                                      {},
+                                      high_resolution_point_cloud,
+                                      sensor::VoxelFilter(scan, 0.5f),
+                                      histogram_,
+                                      transform::Rigid3d::Identity()};
+  }
+
+  const HybridGrid& high_resolution_hybrid_grid() const {
+    return high_resolution_hybrid_grid_;
+  }
+  const HybridGrid& low_resolution_hybrid_grid() const {
+    return low_resolution_hybrid_grid_;
+  }
+  const Eigen::VectorXf& histogram() const { return histogram_; }
+  const TrajectoryNode::Data& node_data() const { return node_data_; }
+
+ private:
+  HybridGrid high_resolution_hybrid_grid_;
+  HybridGrid low_resolution_hybrid_grid_;
+  Eigen::VectorXf histogram_;
+  TrajectoryNode::Data node_data_;
+};
+
+const Room3D& GetRoom3D() {
+  static const Room3D* const kRoom = new Room3D();
+  return *kRoom;
+}
+
+// Initial pose estimate off by a few centimeters and a degree, a typical error
+// of the pose extrapolator.
+transform::Rigid3d GetInitialPoseEstimate() {
+  return transform::Rigid3d(
+      Eigen::Vector3d(0.04, -0.03, 0.02),
+      Eigen::Quaterniond(Eigen::AngleAxisd(0.02, Eigen::Vector3d::UnitZ())));
+}
+
+void BM_CeresScanMatcher3D_Match(benchmark::State& state) {
+  const Room3D& room = GetRoom3D();
+  proto::CeresScanMatcherOptions3D options;
+  options.add_occupied_space_weight(1.);
+  options.add_occupied_space_weight(6.);
+  options.set_translation_weight(5.);
+  options.set_rotation_weight(4e2);
+  options.set_only_optimize_yaw(false);
+  options.mutable_ceres_solver_options()->set_use_nonmonotonic_steps(false);
+  options.mutable_ceres_solver_options()->set_max_num_iterations(12);
+  options.mutable_ceres_solver_options()->set_num_threads(1);
+  const CeresScanMatcher3D scan_matcher(options);
+  const transform::Rigid3d initial_pose_estimate = GetInitialPoseEstimate();
+  for (auto _ : state) {
+    transform::Rigid3d pose_estimate;
+    ceres::Solver::Summary summary;
+    scan_matcher.Match(
+        initial_pose_estimate.translation(), initial_pose_estimate,
+        {{&room.node_data().high_resolution_point_cloud,
+          &room.high_resolution_hybrid_grid(),
+          /*intensity_hybrid_grid=*/nullptr},
+         {&room.node_data().low_resolution_point_cloud,
+          &room.low_resolution_hybrid_grid(),
+          /*intensity_hybrid_grid=*/nullptr}},
+        &pose_estimate, &summary);
+    benchmark::DoNotOptimize(pose_estimate);
+  }
+}
+BENCHMARK(BM_CeresScanMatcher3D_Match)->Unit(benchmark::kMillisecond);
+
+void BM_FastCorrelativeScanMatcher3D_Match(benchmark::State& state) {
+  const Room3D& room = GetRoom3D();
+  proto::FastCorrelativeScanMatcherOptions3D options;
+  options.set_branch_and_bound_depth(8);
+  options.set_full_resolution_depth(3);
+  options.set_min_rotational_score(0.77);
+  options.set_min_low_resolution_score(0.55);
+  options.set_linear_xy_search_window(state.range(0));
+  options.set_linear_z_search_window(1.);
+  options.set_angular_search_window(0.26);
+  const FastCorrelativeScanMatcher3D scan_matcher(
+      room.high_resolution_hybrid_grid(), &room.low_resolution_hybrid_grid(),
+      &room.histogram(), options);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        scan_matcher.Match(GetInitialPoseEstimate(),
+                           transform::Rigid3d::Identity(), room.node_data(),
+                           /*min_score=*/0.55f));
+  }
+}
+// Linear xy search window in meters.
+BENCHMARK(BM_FastCorrelativeScanMatcher3D_Match)
+    ->Arg(2)
+    ->Arg(5)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace scan_matching
+}  // namespace mapping
+}  // namespace cartographer
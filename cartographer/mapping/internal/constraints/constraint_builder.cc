@@ -40,6 +40,12 @@ proto::ConstraintBuilderOptions CreateConstraintBuilderOptions(
   options.set_loop_closure_rotation_weight(
       parameter_dictionary->GetDouble("loop_closure_rotation_weight"));
   options.set_log_matches(parameter_dictionary->GetBool("log_matches"));
+  options.set_decompressed_node_cache_size(
+      parameter_dictionary->GetNonNegativeInt("decompressed_node_cache_size"));
+  options.set_rotated_scan_cache_max_bytes(
+      parameter_dictionary->GetNonNegativeInt("rotated_scan_cache_max_bytes"));
+  options.set_num_scan_matcher_threads(
+      parameter_dictionary->GetNonNegativeInt("num_scan_matcher_threads"));
   *options.mutable_fast_correlative_scan_matcher_options() =
       scan_matching::CreateFastCorrelativeScanMatcherOptions2D(
           parameter_dictionary->GetDictionary("fast_correlative_scan_matcher")
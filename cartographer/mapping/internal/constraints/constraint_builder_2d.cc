@@ -20,6 +20,7 @@
 #include <functional>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <memory>
 #include <sstream>
@@ -63,7 +64,14 @@ ConstraintBuilder2D::ConstraintBuilder2D(
       thread_pool_(thread_pool),
       finish_node_task_(absl::make_unique<common::Task>()),
       when_done_task_(absl::make_unique<common::Task>()),
-      ceres_scan_matcher_(options.ceres_scan_matcher_options()) {}
+      node_data_cache_(options.decompressed_node_cache_size()),
+      ceres_scan_matcher_(options.ceres_scan_matcher_options()) {
+  if (options_.num_scan_matcher_threads() > 0) {
+    scan_matcher_thread_pool_ =
+        absl::make_unique<common::ThreadPool>(
+            options_.num_scan_matcher_threads(), "constraint_scan_matcher");
+  }
+}
 
 ConstraintBuilder2D::~ConstraintBuilder2D() {
   absl::MutexLock locker(&mutex_);
@@ -105,6 +113,8 @@ void ConstraintBuilder2D::MaybeAddConstraint(
                       constant_data, initial_relative_pose, *scan_matcher,
                       constraint);
   });
+  constraint_task->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  constraint_task->SetLabel("constraint_2d");
   constraint_task->AddDependency(scan_matcher->creation_task_handle);
   auto constraint_task_handle =
       thread_pool_->Schedule(std::move(constraint_task));
@@ -130,6 +140,11 @@ void ConstraintBuilder2D::MaybeAddGlobalConstraint(
                       constant_data, transform::Rigid2d::Identity(),
                       *scan_matcher, constraint);
   });
+  // Finishing the node and thus the next optimization wait for it, so it keeps
+  // the priority of the other constraint searches. The starvation protection
+  // of the thread pool keeps it from blocking all other work.
+  constraint_task->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  constraint_task->SetLabel("global_constraint_2d");
   constraint_task->AddDependency(scan_matcher->creation_task_handle);
   auto constraint_task_handle =
       thread_pool_->Schedule(std::move(constraint_task));
@@ -143,6 +158,8 @@ void ConstraintBuilder2D::NotifyEndOfNode() {
     absl::MutexLock locker(&mutex_);
     ++num_finished_nodes_;
   });
+  finish_node_task_->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  finish_node_task_->SetLabel("finish_node_2d");
   auto finish_node_task_handle =
       thread_pool_->Schedule(std::move(finish_node_task_));
   finish_node_task_ = absl::make_unique<common::Task>();
@@ -158,6 +175,8 @@ void ConstraintBuilder2D::WhenDone(
   when_done_ = absl::make_unique<std::function<void(const Result&)>>(callback);
   CHECK(when_done_task_ != nullptr);
   when_done_task_->SetWorkItem([this] { RunWhenDoneCallback(); });
+  when_done_task_->SetPriority(common::Task::OPTIMIZATION);
+  when_done_task_->SetLabel("optimization_2d");
   thread_pool_->Schedule(std::move(when_done_task_));
   when_done_task_ = absl::make_unique<common::Task>();
 }
@@ -173,13 +192,18 @@ ConstraintBuilder2D::DispatchScanMatcherConstruction(const SubmapId& submap_id,
   kNumSubmapScanMatchersMetric->Set(submap_scan_matchers_.size());
   submap_scan_matcher.grid = grid;
   auto& scan_matcher_options = options_.fast_correlative_scan_matcher_options();
+  common::ThreadPoolInterface* const scan_matcher_thread_pool =
+      scan_matcher_thread_pool_.get();
   auto scan_matcher_task = absl::make_unique<common::Task>();
-  scan_matcher_task->SetWorkItem(
-      [&submap_scan_matcher, &scan_matcher_options]() {
-        submap_scan_matcher.fast_correlative_scan_matcher =
-            absl::make_unique<scan_matching::FastCorrelativeScanMatcher2D>(
-                *submap_scan_matcher.grid, scan_matcher_options);
-      });
+  scan_matcher_task->SetWorkItem([&submap_scan_matcher, &scan_matcher_options,
+                                  scan_matcher_thread_pool]() {
+    submap_scan_matcher.fast_correlative_scan_matcher =
+        absl::make_unique<scan_matching::FastCorrelativeScanMatcher2D>(
+            *submap_scan_matcher.grid, scan_matcher_options,
+            scan_matcher_thread_pool);
+  });
+  scan_matcher_task->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  scan_matcher_task->SetLabel("scan_matcher_construction_2d");
   submap_scan_matcher.creation_task_handle =
       thread_pool_->Schedule(std::move(scan_matcher_task));
   return &submap_scan_matchers_.at(submap_id);
@@ -193,6 +217,12 @@ void ConstraintBuilder2D::ComputeConstraint(
     const SubmapScanMatcher& submap_scan_matcher,
     std::unique_ptr<ConstraintBuilder2D::Constraint>* constraint) {
   CHECK(submap_scan_matcher.fast_correlative_scan_matcher);
+  // Decompresses the node's point clouds if necessary and keeps them alive
+  // until this search is done.
+  const std::shared_ptr<const TrajectoryNode::Data> node_data =
+      node_data_cache_.Get(node_id, constant_data);
+  const std::shared_ptr<scan_matching::RotatedScanCache2D> rotated_scan_cache =
+      GetRotatedScanCache(node_id);
   const transform::Rigid2d initial_pose =
       ComputeSubmapPose(*submap) * initial_relative_pose;
 
@@ -210,9 +240,13 @@ void ConstraintBuilder2D::ComputeConstraint(
   // 3. Refine.
   if (match_full_submap) {
     kGlobalConstraintsSearchedMetric->Increment();
-    if (submap_scan_matcher.fast_correlative_scan_matcher->MatchFullSubmap(
-            constant_data->filtered_gravity_aligned_point_cloud,
-            options_.global_localization_min_score(), &score, &pose_estimate)) {
+    const bool match_found =
+        submap_scan_matcher.fast_correlative_scan_matcher->MatchFullSubmap(
+            node_data->filtered_gravity_aligned_point_cloud,
+            options_.global_localization_min_score(), rotated_scan_cache.get(),
+            &score, &pose_estimate);
+    UpdateRotatedScanCacheSize(node_id, rotated_scan_cache.get());
+    if (match_found) {
       CHECK_GT(score, options_.global_localization_min_score());
       CHECK_GE(node_id.trajectory_id, 0);
       CHECK_GE(submap_id.trajectory_id, 0);
@@ -223,9 +257,13 @@ void ConstraintBuilder2D::ComputeConstraint(
     }
   } else {
     kConstraintsSearchedMetric->Increment();
-    if (submap_scan_matcher.fast_correlative_scan_matcher->Match(
-            initial_pose, constant_data->filtered_gravity_aligned_point_cloud,
-            options_.min_score(), &score, &pose_estimate)) {
+    const bool match_found =
+        submap_scan_matcher.fast_correlative_scan_matcher->Match(
+            initial_pose, node_data->filtered_gravity_aligned_point_cloud,
+            options_.min_score(), rotated_scan_cache.get(), &score,
+            &pose_estimate);
+    UpdateRotatedScanCacheSize(node_id, rotated_scan_cache.get());
+    if (match_found) {
       // We've reported a successful local match.
       CHECK_GT(score, options_.min_score());
       kConstraintsFoundMetric->Increment();
@@ -244,7 +282,7 @@ void ConstraintBuilder2D::ComputeConstraint(
   // CSM estimate.
   ceres::Solver::Summary unused_summary;
   ceres_scan_matcher_.Match(pose_estimate.translation(), pose_estimate,
-                            constant_data->filtered_gravity_aligned_point_cloud,
+                            node_data->filtered_gravity_aligned_point_cloud,
                             *submap_scan_matcher.grid, &pose_estimate,
                             &unused_summary);
 
@@ -260,7 +298,7 @@ void ConstraintBuilder2D::ComputeConstraint(
   if (options_.log_matches()) {
     std::ostringstream info;
     info << "Node " << node_id << " with "
-         << constant_data->filtered_gravity_aligned_point_cloud.size()
+         << node_data->filtered_gravity_aligned_point_cloud.size()
          << " points on submap " << submap_id << std::fixed;
     if (match_full_submap) {
       info << " matches";
@@ -276,6 +314,50 @@ void ConstraintBuilder2D::ComputeConstraint(
   }
 }
 
+std::shared_ptr<scan_matching::RotatedScanCache2D>
+ConstraintBuilder2D::GetRotatedScanCache(const NodeId& node_id) {
+  absl::MutexLock locker(&mutex_);
+  const auto it = rotated_scan_cache_index_.find(node_id);
+  if (it != rotated_scan_cache_index_.end()) {
+    rotated_scan_caches_.splice(rotated_scan_caches_.begin(),
+                                rotated_scan_caches_, it->second);
+    return it->second->rotated_scan_cache;
+  }
+  auto rotated_scan_cache =
+      std::make_shared<scan_matching::RotatedScanCache2D>();
+  if (options_.rotated_scan_cache_max_bytes() == 0) {
+    return rotated_scan_cache;
+  }
+  rotated_scan_caches_.push_front(
+      RotatedScanCacheEntry{node_id, rotated_scan_cache, 0});
+  rotated_scan_cache_index_.emplace(node_id, rotated_scan_caches_.begin());
+  return rotated_scan_cache;
+}
+
+void ConstraintBuilder2D::UpdateRotatedScanCacheSize(
+    const NodeId& node_id,
+    const scan_matching::RotatedScanCache2D* const rotated_scan_cache) {
+  const size_t num_bytes = rotated_scan_cache->num_bytes();
+  absl::MutexLock locker(&mutex_);
+  const auto it = rotated_scan_cache_index_.find(node_id);
+  if (it == rotated_scan_cache_index_.end() ||
+      it->second->rotated_scan_cache.get() != rotated_scan_cache) {
+    return;
+  }
+  rotated_scan_caches_num_bytes_ += num_bytes;
+  rotated_scan_caches_num_bytes_ -= it->second->num_bytes;
+  it->second->num_bytes = num_bytes;
+  // The least recently used caches are dropped until all of them together fit,
+  // which may drop the cache of 'node_id' itself.
+  while (rotated_scan_caches_num_bytes_ >
+         static_cast<size_t>(options_.rotated_scan_cache_max_bytes())) {
+    const RotatedScanCacheEntry& entry = rotated_scan_caches_.back();
+    rotated_scan_caches_num_bytes_ -= entry.num_bytes;
+    rotated_scan_cache_index_.erase(entry.node_id);
+    rotated_scan_caches_.pop_back();
+  }
+}
+
 void ConstraintBuilder2D::RunWhenDoneCallback() {
   Result result;
   std::unique_ptr<std::function<void(const Result&)>> callback;
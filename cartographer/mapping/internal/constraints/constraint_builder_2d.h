@@ -21,7 +21,10 @@
 #include <deque>
 #include <functional>
 #include <limits>
+#include <list>
 #include <map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include "Eigen/Core"
@@ -35,6 +38,8 @@
 #include "cartographer/mapping/2d/submap_2d.h"
 #include "cartographer/mapping/internal/2d/scan_matching/ceres_scan_matcher_2d.h"
 #include "cartographer/mapping/internal/2d/scan_matching/fast_correlative_scan_matcher_2d.h"
+#include "cartographer/mapping/internal/2d/scan_matching/rotated_scan_cache_2d.h"
+#include "cartographer/mapping/internal/constraints/node_data_cache.h"
 #include "cartographer/mapping/pose_graph_interface.h"
 #include "cartographer/mapping/proto/pose_graph/constraint_builder_options.pb.h"
 #include "cartographer/metrics/family_factory.h"
@@ -131,10 +136,27 @@ class ConstraintBuilder2D {
                          std::unique_ptr<Constraint>* constraint)
       LOCKS_EXCLUDED(mutex_);
 
+  // Returns the rotated scan cache of 'node_id'. The caches of the most
+  // recently matched nodes are kept as long as they take up at most
+  // 'rotated_scan_cache_max_bytes'.
+  std::shared_ptr<scan_matching::RotatedScanCache2D> GetRotatedScanCache(
+      const NodeId& node_id) LOCKS_EXCLUDED(mutex_);
+
+  // Accounts for 'rotated_scan_cache' of 'node_id' having grown during a
+  // search and drops caches until 'rotated_scan_cache_max_bytes' is kept.
+  void UpdateRotatedScanCacheSize(
+      const NodeId& node_id,
+      const scan_matching::RotatedScanCache2D* rotated_scan_cache)
+      LOCKS_EXCLUDED(mutex_);
+
   void RunWhenDoneCallback() LOCKS_EXCLUDED(mutex_);
 
   const constraints::proto::ConstraintBuilderOptions options_;
   common::ThreadPoolInterface* thread_pool_;
+  // Used by the scan matchers together with the 'thread_pool_' thread they run
+  // on to compute their precomputation grids and to match full submaps. Not
+  // used if nullptr.
+  std::unique_ptr<common::ThreadPool> scan_matcher_thread_pool_;
   absl::Mutex mutex_;
 
   // 'callback' set by WhenDone().
@@ -163,6 +185,21 @@ class ConstraintBuilder2D {
       GUARDED_BY(mutex_);
   std::map<SubmapId, common::FixedRatioSampler> per_submap_sampler_;
 
+  // Decompressed point clouds of recently matched nodes.
+  NodeDataCache node_data_cache_;
+
+  // Rotated point clouds of recently matched nodes, most recently used first,
+  // with their size after the last search and an index by node.
+  struct RotatedScanCacheEntry {
+    NodeId node_id;
+    std::shared_ptr<scan_matching::RotatedScanCache2D> rotated_scan_cache;
+    size_t num_bytes;
+  };
+  std::list<RotatedScanCacheEntry> rotated_scan_caches_ GUARDED_BY(mutex_);
+  std::map<NodeId, std::list<RotatedScanCacheEntry>::iterator>
+      rotated_scan_cache_index_ GUARDED_BY(mutex_);
+  size_t rotated_scan_caches_num_bytes_ GUARDED_BY(mutex_) = 0;
+
   scan_matching::CeresScanMatcher2D ceres_scan_matcher_;
 
   // Histogram of scan matcher scores.
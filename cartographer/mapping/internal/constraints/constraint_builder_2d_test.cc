@@ -111,6 +111,40 @@ TEST_F(ConstraintBuilder2DTest, FindsConstraints) {
   }
 }
 
+TEST_F(ConstraintBuilder2DTest, WhenDoneWaitsForGlobalConstraints) {
+  TrajectoryNode::Data node_data;
+  node_data.filtered_gravity_aligned_point_cloud.push_back(
+      {Eigen::Vector3f(0.1, 0.2, 0.3)});
+  node_data.gravity_alignment = Eigen::Quaterniond::Identity();
+  node_data.local_pose = transform::Rigid3d::Identity();
+  SubmapId submap_id{0, 1};
+  MapLimits map_limits(1., Eigen::Vector2d(2., 3.), CellLimits(100, 110));
+  ValueConversionTables conversion_tables;
+  Submap2D submap(
+      Eigen::Vector2f(4.f, 5.f),
+      absl::make_unique<ProbabilityGrid>(map_limits, &conversion_tables),
+      &conversion_tables);
+  constexpr int kNumGlobalConstraintsPerNode = 3;
+  for (int i = 0; i < 3; ++i) {
+    // Every global constraint search is part of the cycle it was added in, so
+    // none of them is left pending or carried over into the next result.
+    for (int j = 0; j < kNumGlobalConstraintsPerNode; ++j) {
+      constraint_builder_->MaybeAddGlobalConstraint(submap_id, &submap,
+                                                    NodeId{0, j}, &node_data);
+    }
+    constraint_builder_->NotifyEndOfNode();
+    EXPECT_CALL(mock_, Run(::testing::SizeIs(kNumGlobalConstraintsPerNode)));
+    constraint_builder_->WhenDone(
+        [this](const constraints::ConstraintBuilder2D::Result& result) {
+          mock_.Run(result);
+        });
+    thread_pool_.WaitUntilIdle();
+    ::testing::Mock::VerifyAndClearExpectations(&mock_);
+    EXPECT_EQ(constraint_builder_->GetNumFinishedNodes(), i + 1);
+    constraint_builder_->DeleteScanMatcher(submap_id);
+  }
+}
+
 }  // namespace
 }  // namespace constraints
 }  // namespace mapping
@@ -65,6 +65,7 @@ ConstraintBuilder3D::ConstraintBuilder3D(
       thread_pool_(thread_pool),
       finish_node_task_(absl::make_unique<common::Task>()),
       when_done_task_(absl::make_unique<common::Task>()),
+      node_data_cache_(options.decompressed_node_cache_size()),
       ceres_scan_matcher_(options.ceres_scan_matcher_options_3d()) {}
 
 ConstraintBuilder3D::~ConstraintBuilder3D() {
@@ -107,6 +108,8 @@ void ConstraintBuilder3D::MaybeAddConstraint(
                       constant_data, global_node_pose, global_submap_pose,
                       *scan_matcher, constraint);
   });
+  constraint_task->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  constraint_task->SetLabel("constraint_3d");
   constraint_task->AddDependency(scan_matcher->creation_task_handle);
   auto constraint_task_handle =
       thread_pool_->Schedule(std::move(constraint_task));
@@ -135,6 +138,11 @@ void ConstraintBuilder3D::MaybeAddGlobalConstraint(
                       transform::Rigid3d::Rotation(global_submap_rotation),
                       *scan_matcher, constraint);
   });
+  // Finishing the node and thus the next optimization wait for it, so it keeps
+  // the priority of the other constraint searches. The starvation protection
+  // of the thread pool keeps it from blocking all other work.
+  constraint_task->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  constraint_task->SetLabel("global_constraint_3d");
   constraint_task->AddDependency(scan_matcher->creation_task_handle);
   auto constraint_task_handle =
       thread_pool_->Schedule(std::move(constraint_task));
@@ -148,6 +156,8 @@ void ConstraintBuilder3D::NotifyEndOfNode() {
     absl::MutexLock locker(&mutex_);
     ++num_finished_nodes_;
   });
+  finish_node_task_->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  finish_node_task_->SetLabel("finish_node_3d");
   auto finish_node_task_handle =
       thread_pool_->Schedule(std::move(finish_node_task_));
   finish_node_task_ = absl::make_unique<common::Task>();
@@ -163,6 +173,8 @@ void ConstraintBuilder3D::WhenDone(
   when_done_ = absl::make_unique<std::function<void(const Result&)>>(callback);
   CHECK(when_done_task_ != nullptr);
   when_done_task_->SetWorkItem([this] { RunWhenDoneCallback(); });
+  when_done_task_->SetPriority(common::Task::OPTIMIZATION);
+  when_done_task_->SetLabel("optimization_3d");
   thread_pool_->Schedule(std::move(when_done_task_));
   when_done_task_ = absl::make_unique<common::Task>();
 }
@@ -192,6 +204,8 @@ ConstraintBuilder3D::DispatchScanMatcherConstruction(const SubmapId& submap_id,
                 submap_scan_matcher.low_resolution_hybrid_grid, histogram,
                 scan_matcher_options);
       });
+  scan_matcher_task->SetPriority(common::Task::CONSTRAINT_SEARCH);
+  scan_matcher_task->SetLabel("scan_matcher_construction_3d");
   submap_scan_matcher.creation_task_handle =
       thread_pool_->Schedule(std::move(scan_matcher_task));
   return &submap_scan_matchers_.at(submap_id);
@@ -205,6 +219,11 @@ void ConstraintBuilder3D::ComputeConstraint(
     const SubmapScanMatcher& submap_scan_matcher,
     std::unique_ptr<Constraint>* constraint) {
   CHECK(submap_scan_matcher.fast_correlative_scan_matcher);
+  // Decompresses the node's point clouds if necessary and keeps them alive
+  // until this search is done.
+  const std::shared_ptr<const TrajectoryNode::Data> node_data =
+      node_data_cache_.Get(node_id, constant_data);
+
   // The 'constraint_transform' (submap i <- node j) is computed from:
   // - a 'high_resolution_point_cloud' in node j and
   // - the initial guess 'initial_pose' (submap i <- node j).
@@ -220,7 +239,7 @@ void ConstraintBuilder3D::ComputeConstraint(
     match_result =
         submap_scan_matcher.fast_correlative_scan_matcher->MatchFullSubmap(
             global_node_pose.rotation(), global_submap_pose.rotation(),
-            *constant_data, options_.global_localization_min_score());
+            *node_data, options_.global_localization_min_score());
     if (match_result != nullptr) {
       CHECK_GT(match_result->score, options_.global_localization_min_score());
       CHECK_GE(node_id.trajectory_id, 0);
@@ -237,7 +256,7 @@ void ConstraintBuilder3D::ComputeConstraint(
   } else {
     kConstraintsSearchedMetric->Increment();
     match_result = submap_scan_matcher.fast_correlative_scan_matcher->Match(
-        global_node_pose, global_submap_pose, *constant_data,
+        global_node_pose, global_submap_pose, *node_data,
         options_.min_score());
     if (match_result != nullptr) {
       // We've reported a successful local match.
@@ -266,10 +285,10 @@ void ConstraintBuilder3D::ComputeConstraint(
   transform::Rigid3d constraint_transform;
   ceres_scan_matcher_.Match(match_result->pose_estimate.translation(),
                             match_result->pose_estimate,
-                            {{&constant_data->high_resolution_point_cloud,
+                            {{&node_data->high_resolution_point_cloud,
                               submap_scan_matcher.high_resolution_hybrid_grid,
                               /*intensity_hybrid_grid=*/nullptr},
-                             {&constant_data->low_resolution_point_cloud,
+                             {&node_data->low_resolution_point_cloud,
                               submap_scan_matcher.low_resolution_hybrid_grid,
                               /*intensity_hybrid_grid=*/nullptr}},
                             &constraint_transform, &unused_summary);
@@ -284,7 +303,7 @@ void ConstraintBuilder3D::ComputeConstraint(
   if (options_.log_matches()) {
     std::ostringstream info;
     info << "Node " << node_id << " with "
-         << constant_data->high_resolution_point_cloud.size()
+         << node_data->high_resolution_point_cloud.size()
          << " points on submap " << submap_id << std::fixed;
     if (match_full_submap) {
       info << " matches";
@@ -114,6 +114,40 @@ TEST_F(ConstraintBuilder3DTest, FindsConstraints) {
   }
 }
 
+TEST_F(ConstraintBuilder3DTest, WhenDoneWaitsForGlobalConstraints) {
+  auto node_data = std::make_shared<TrajectoryNode::Data>();
+  node_data->gravity_alignment = Eigen::Quaterniond::Identity();
+  node_data->high_resolution_point_cloud.push_back(
+      {Eigen::Vector3f(0.1, 0.2, 0.3)});
+  node_data->low_resolution_point_cloud.push_back(
+      {Eigen::Vector3f(0.1, 0.2, 0.3)});
+  node_data->rotational_scan_matcher_histogram = Eigen::VectorXf::Zero(3);
+  node_data->local_pose = transform::Rigid3d::Identity();
+  SubmapId submap_id{0, 1};
+  Submap3D submap(0.1, 0.1, transform::Rigid3d::Identity(),
+                  Eigen::VectorXf::Zero(3));
+  constexpr int kNumGlobalConstraintsPerNode = 3;
+  for (int i = 0; i < 3; ++i) {
+    // Every global constraint search is part of the cycle it was added in, so
+    // none of them is left pending or carried over into the next result.
+    for (int j = 0; j < kNumGlobalConstraintsPerNode; ++j) {
+      constraint_builder_->MaybeAddGlobalConstraint(
+          submap_id, &submap, NodeId{0, j}, node_data.get(),
+          Eigen::Quaterniond::Identity(), Eigen::Quaterniond::Identity());
+    }
+    constraint_builder_->NotifyEndOfNode();
+    EXPECT_CALL(mock_, Run(::testing::SizeIs(kNumGlobalConstraintsPerNode)));
+    constraint_builder_->WhenDone(
+        [this](const constraints::ConstraintBuilder3D::Result& result) {
+          mock_.Run(result);
+        });
+    thread_pool_.WaitUntilIdle();
+    ::testing::Mock::VerifyAndClearExpectations(&mock_);
+    EXPECT_EQ(constraint_builder_->GetNumFinishedNodes(), i + 1);
+    constraint_builder_->DeleteScanMatcher(submap_id);
+  }
+}
+
 }  // namespace
 }  // namespace constraints
 }  // namespace mapping
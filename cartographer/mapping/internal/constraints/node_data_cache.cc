@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/internal/constraints/node_data_cache.h"
+
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace mapping {
+namespace constraints {
+
+NodeDataCache::NodeDataCache(const int max_num_nodes)
+    : max_num_nodes_(max_num_nodes) {
+  CHECK_GE(max_num_nodes_, 0);
+}
+
+std::shared_ptr<const TrajectoryNode::Data> NodeDataCache::Get(
+    const NodeId& node_id, const TrajectoryNode::Data* const constant_data) {
+  if (constant_data->compressed_point_clouds == nullptr) {
+    // Nothing to decompress. The caller keeps 'constant_data' alive.
+    return std::shared_ptr<const TrajectoryNode::Data>(
+        std::shared_ptr<const TrajectoryNode::Data>(), constant_data);
+  }
+  {
+    absl::MutexLock locker(&mutex_);
+    auto it = entry_by_node_id_.find(node_id);
+    if (it != entry_by_node_id_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+  }
+
+  // Decompress without holding the lock, so that other nodes can be looked up
+  // in the meantime.
+  auto decompressed_data = std::make_shared<const TrajectoryNode::Data>(
+      DecompressPointClouds(*constant_data));
+  if (max_num_nodes_ == 0) {
+    return decompressed_data;
+  }
+
+  absl::MutexLock locker(&mutex_);
+  auto it = entry_by_node_id_.find(node_id);
+  if (it != entry_by_node_id_.end()) {
+    // Another thread decompressed the same node concurrently.
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->second;
+  }
+  entries_.emplace_front(node_id, decompressed_data);
+  entry_by_node_id_.emplace(node_id, entries_.begin());
+  if (static_cast<int>(entries_.size()) > max_num_nodes_) {
+    entry_by_node_id_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  return decompressed_data;
+}
+
+int NodeDataCache::num_cached_nodes() const {
+  absl::MutexLock locker(&mutex_);
+  return entries_.size();
+}
+
+}  // namespace constraints
+}  // namespace mapping
+}  // namespace cartographer
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_MAPPING_INTERNAL_CONSTRAINTS_NODE_DATA_CACHE_H_
+#define CARTOGRAPHER_MAPPING_INTERNAL_CONSTRAINTS_NODE_DATA_CACHE_H_
+
+#include <list>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "cartographer/mapping/id.h"
+#include "cartographer/mapping/trajectory_node.h"
+
+namespace cartographer {
+namespace mapping {
+namespace constraints {
+
+// Bounded least-recently-used cache of node data with decompressed point
+// clouds. Constraint search matches each node against many submaps, so this
+// keeps us from decompressing the same node over and over while only holding
+// the point clouds of a few nodes in memory.
+//
+// This class is thread-safe.
+class NodeDataCache {
+ public:
+  // A 'max_num_nodes' of 0 disables caching.
+  explicit NodeDataCache(int max_num_nodes);
+
+  NodeDataCache(const NodeDataCache&) = delete;
+  NodeDataCache& operator=(const NodeDataCache&) = delete;
+
+  // Returns 'constant_data' with decompressed point clouds. If its point
+  // clouds are not compressed, the result simply aliases 'constant_data'.
+  std::shared_ptr<const TrajectoryNode::Data> Get(
+      const NodeId& node_id, const TrajectoryNode::Data* constant_data)
+      LOCKS_EXCLUDED(mutex_);
+
+  int num_cached_nodes() const LOCKS_EXCLUDED(mutex_);
+
+ private:
+  using Entry = std::pair<NodeId, std::shared_ptr<const TrajectoryNode::Data>>;
+
+  const int max_num_nodes_;
+  mutable absl::Mutex mutex_;
+  // Most recently used entries first.
+  std::list<Entry> entries_ GUARDED_BY(mutex_);
+  std::map<NodeId, std::list<Entry>::iterator> entry_by_node_id_
+      GUARDED_BY(mutex_);
+};
+
+}  // namespace constraints
+}  // namespace mapping
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_MAPPING_INTERNAL_CONSTRAINTS_NODE_DATA_CACHE_H_
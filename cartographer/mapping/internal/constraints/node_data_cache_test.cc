@@ -0,0 +1,94 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/mapping/internal/constraints/node_data_cache.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace mapping {
+namespace constraints {
+namespace {
+
+TrajectoryNode::Data CreateCompressedNodeData(const float x) {
+  TrajectoryNode::Data node_data;
+  node_data.gravity_alignment = Eigen::Quaterniond::Identity();
+  node_data.filtered_gravity_aligned_point_cloud.push_back(
+      {Eigen::Vector3f(x, 0.f, 0.f)});
+  node_data.high_resolution_point_cloud.push_back(
+      {Eigen::Vector3f(0.f, x, 0.f)});
+  node_data.low_resolution_point_cloud.push_back(
+      {Eigen::Vector3f(0.f, 0.f, x)});
+  node_data.local_pose = transform::Rigid3d::Identity();
+  return CompressPointClouds(node_data);
+}
+
+TEST(NodeDataCacheTest, ReturnsUncompressedDataUnchanged) {
+  NodeDataCache cache(2);
+  TrajectoryNode::Data node_data;
+  node_data.filtered_gravity_aligned_point_cloud.push_back(
+      {Eigen::Vector3f(1.f, 2.f, 3.f)});
+  EXPECT_EQ(cache.Get(NodeId{0, 0}, &node_data).get(), &node_data);
+  EXPECT_EQ(cache.num_cached_nodes(), 0);
+}
+
+TEST(NodeDataCacheTest, DecompressesPointClouds) {
+  NodeDataCache cache(2);
+  const TrajectoryNode::Data node_data = CreateCompressedNodeData(1.f);
+  const auto decompressed = cache.Get(NodeId{0, 0}, &node_data);
+  EXPECT_EQ(decompressed->compressed_point_clouds, nullptr);
+  ASSERT_EQ(decompressed->filtered_gravity_aligned_point_cloud.size(), 1);
+  EXPECT_TRUE(decompressed->filtered_gravity_aligned_point_cloud[0]
+                  .position.isApprox(Eigen::Vector3f(1.f, 0.f, 0.f)));
+  ASSERT_EQ(decompressed->high_resolution_point_cloud.size(), 1);
+  EXPECT_TRUE(decompressed->high_resolution_point_cloud[0].position.isApprox(
+      Eigen::Vector3f(0.f, 1.f, 0.f)));
+  ASSERT_EQ(decompressed->low_resolution_point_cloud.size(), 1);
+  EXPECT_TRUE(decompressed->low_resolution_point_cloud[0].position.isApprox(
+      Eigen::Vector3f(0.f, 0.f, 1.f)));
+  EXPECT_EQ(cache.Get(NodeId{0, 0}, &node_data), decompressed);
+}
+
+TEST(NodeDataCacheTest, EvictsLeastRecentlyUsedNode) {
+  NodeDataCache cache(2);
+  const TrajectoryNode::Data node_data_0 = CreateCompressedNodeData(0.f);
+  const TrajectoryNode::Data node_data_1 = CreateCompressedNodeData(1.f);
+  const TrajectoryNode::Data node_data_2 = CreateCompressedNodeData(2.f);
+  const auto decompressed_0 = cache.Get(NodeId{0, 0}, &node_data_0);
+  const auto decompressed_1 = cache.Get(NodeId{0, 1}, &node_data_1);
+  // Touch node 0 so that node 1 becomes the least recently used.
+  EXPECT_EQ(cache.Get(NodeId{0, 0}, &node_data_0), decompressed_0);
+  cache.Get(NodeId{0, 2}, &node_data_2);
+  EXPECT_EQ(cache.num_cached_nodes(), 2);
+  EXPECT_EQ(cache.Get(NodeId{0, 0}, &node_data_0), decompressed_0);
+  EXPECT_NE(cache.Get(NodeId{0, 1}, &node_data_1), decompressed_1);
+}
+
+TEST(NodeDataCacheTest, ZeroSizeDisablesCaching) {
+  NodeDataCache cache(0);
+  const TrajectoryNode::Data node_data = CreateCompressedNodeData(1.f);
+  const auto decompressed = cache.Get(NodeId{0, 0}, &node_data);
+  EXPECT_EQ(decompressed->filtered_gravity_aligned_point_cloud.size(), 1);
+  EXPECT_EQ(cache.num_cached_nodes(), 0);
+  EXPECT_NE(cache.Get(NodeId{0, 0}, &node_data), decompressed);
+}
+
+}  // namespace
+}  // namespace constraints
+}  // namespace mapping
+}  // namespace cartographer
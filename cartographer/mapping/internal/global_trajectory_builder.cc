@@ -16,6 +16,7 @@
 
 #include "cartographer/mapping/internal/global_trajectory_builder.h"
 
+#include <chrono>
 #include <memory>
 
 #include "absl/memory/memory.h"
@@ -32,6 +33,7 @@ namespace {
 
 static auto* kLocalSlamMatchingResults = metrics::Counter::Null();
 static auto* kLocalSlamInsertionResults = metrics::Counter::Null();
+static auto* kLocalSlamAddRangeDataLatencyMetric = metrics::Histogram::Null();
 
 template <typename LocalTrajectoryBuilder, typename PoseGraph>
 class GlobalTrajectoryBuilder : public mapping::TrajectoryBuilderInterface {
@@ -58,9 +60,12 @@ class GlobalTrajectoryBuilder : public mapping::TrajectoryBuilderInterface {
       const sensor::TimedPointCloudData& timed_point_cloud_data) override {
     CHECK(local_trajectory_builder_)
         << "Cannot add TimedPointCloudData without a LocalTrajectoryBuilder.";
+    const auto start_time = std::chrono::steady_clock::now();
     std::unique_ptr<typename LocalTrajectoryBuilder::MatchingResult>
         matching_result = local_trajectory_builder_->AddRangeData(
             sensor_id, timed_point_cloud_data);
+    kLocalSlamAddRangeDataLatencyMetric->Observe(
+        common::ToSeconds(std::chrono::steady_clock::now() - start_time));
     if (matching_result == nullptr) {
       // The range data has not been fully accumulated yet.
       return;
@@ -174,6 +179,11 @@ void GlobalTrajectoryBuilderRegisterMetrics(metrics::FamilyFactory* factory) {
       "Local SLAM results");
   kLocalSlamMatchingResults = results->Add({{"type", "MatchingResult"}});
   kLocalSlamInsertionResults = results->Add({{"type", "InsertionResult"}});
+  auto* latency = factory->NewHistogramFamily(
+      "mapping_global_trajectory_builder_add_range_data_latency",
+      "Wall time in seconds spent by local SLAM on each range data message",
+      metrics::Histogram::ScaledPowersOf(2, 1e-4, 10.));
+  kLocalSlamAddRangeDataLatencyMetric = latency->Add({});
 }
 
 }  // namespace mapping
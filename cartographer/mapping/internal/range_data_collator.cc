@@ -16,7 +16,10 @@
 
 #include "cartographer/mapping/internal/range_data_collator.h"
 
+#include <algorithm>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "cartographer/mapping/internal/local_slam_result_data.h"
@@ -27,23 +30,120 @@ namespace mapping {
 
 constexpr float RangeDataCollator::kDefaultIntensityValue;
 
+namespace {
+
+// Overlapping points of one buffered message, i.e. 'data->ranges' from index
+// 'begin' to 'end', and how to convert them into the merged result.
+struct OverlapView {
+  std::shared_ptr<const sensor::TimedPointCloudData> data;
+  size_t begin;
+  size_t end;
+  size_t origin_index;
+  float time_correction;
+};
+
+sensor::TimedPointCloudOriginData::RangeMeasurement ToRangeMeasurement(
+    const OverlapView& view, const size_t index,
+    const float default_intensity) {
+  const std::vector<float>& intensities = view.data->intensities;
+  sensor::TimedPointCloudOriginData::RangeMeasurement point{
+      view.data->ranges[index],
+      index < intensities.size() ? intensities[index] : default_intensity,
+      view.origin_index};
+  // current_end_ + point_time[3]_after == in_timestamp +
+  // point_time[3]_before
+  point.point_time.time += view.time_correction;
+  return point;
+}
+
+bool IsSortedByTime(const OverlapView& view) {
+  for (size_t i = view.begin + 1; i < view.end; ++i) {
+    if (view.data->ranges[i].time < view.data->ranges[i - 1].time) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copies the points of all 'views' into 'ranges' in order of time. Sensors
+// usually deliver points in order of time, in which case the views are merged
+// directly, copying each point once. Otherwise, the points are sorted.
+void MergeByTime(
+    const std::vector<OverlapView>& views, const float default_intensity,
+    std::vector<sensor::TimedPointCloudOriginData::RangeMeasurement>* ranges) {
+  size_t num_points = 0;
+  bool all_sorted = true;
+  for (const OverlapView& view : views) {
+    num_points += view.end - view.begin;
+    all_sorted = all_sorted && IsSortedByTime(view);
+  }
+  ranges->reserve(num_points);
+  if (!all_sorted) {
+    for (const OverlapView& view : views) {
+      for (size_t i = view.begin; i < view.end; ++i) {
+        ranges->push_back(ToRangeMeasurement(view, i, default_intensity));
+      }
+    }
+    std::sort(ranges->begin(), ranges->end(),
+              [](const sensor::TimedPointCloudOriginData::RangeMeasurement& a,
+                 const sensor::TimedPointCloudOriginData::RangeMeasurement& b) {
+                return a.point_time.time < b.point_time.time;
+              });
+    return;
+  }
+  // There are only as many views as range sensors, so a linear search for the
+  // earliest point is cheaper than a heap.
+  std::vector<size_t> next_indices;
+  for (const OverlapView& view : views) {
+    next_indices.push_back(view.begin);
+  }
+  for (size_t n = 0; n < num_points; ++n) {
+    int earliest = -1;
+    float earliest_time = 0.f;
+    for (size_t v = 0; v < views.size(); ++v) {
+      if (next_indices[v] == views[v].end) {
+        continue;
+      }
+      const float time = views[v].data->ranges[next_indices[v]].time +
+                         views[v].time_correction;
+      if (earliest == -1 || time < earliest_time) {
+        earliest = v;
+        earliest_time = time;
+      }
+    }
+    ranges->push_back(ToRangeMeasurement(
+        views[earliest], next_indices[earliest]++, default_intensity));
+  }
+}
+
+}  // namespace
+
 sensor::TimedPointCloudOriginData RangeDataCollator::AddRangeData(
     const std::string& sensor_id,
     sensor::TimedPointCloudData timed_point_cloud_data) {
+  return AddRangeData(sensor_id,
+                      std::make_shared<const sensor::TimedPointCloudData>(
+                          std::move(timed_point_cloud_data)));
+}
+
+sensor::TimedPointCloudOriginData RangeDataCollator::AddRangeData(
+    const std::string& sensor_id,
+    std::shared_ptr<const sensor::TimedPointCloudData> timed_point_cloud_data) {
   CHECK_NE(expected_sensor_ids_.count(sensor_id), 0);
-  timed_point_cloud_data.intensities.resize(
-      timed_point_cloud_data.ranges.size(), kDefaultIntensityValue);
+  CHECK(timed_point_cloud_data != nullptr);
   // TODO(gaschler): These two cases can probably be one.
   if (id_to_pending_data_.count(sensor_id) != 0) {
     current_start_ = current_end_;
     // When we have two messages of the same sensor, move forward the older of
     // the two (do not send out current).
-    current_end_ = id_to_pending_data_.at(sensor_id).time;
+    current_end_ = id_to_pending_data_.at(sensor_id).data->time;
     auto result = CropAndMerge();
-    id_to_pending_data_.emplace(sensor_id, std::move(timed_point_cloud_data));
+    id_to_pending_data_.emplace(
+        sensor_id, PendingData{std::move(timed_point_cloud_data), 0});
     return result;
   }
-  id_to_pending_data_.emplace(sensor_id, std::move(timed_point_cloud_data));
+  id_to_pending_data_.emplace(
+      sensor_id, PendingData{std::move(timed_point_cloud_data), 0});
   if (expected_sensor_ids_.size() != id_to_pending_data_.size()) {
     return {};
   }
@@ -51,7 +151,7 @@ sensor::TimedPointCloudOriginData RangeDataCollator::AddRangeData(
   // We have messages from all sensors, move forward to oldest.
   common::Time oldest_timestamp = common::Time::max();
   for (const auto& pair : id_to_pending_data_) {
-    oldest_timestamp = std::min(oldest_timestamp, pair.second.time);
+    oldest_timestamp = std::min(oldest_timestamp, pair.second.data->time);
   }
   current_end_ = oldest_timestamp;
   return CropAndMerge();
@@ -59,73 +159,50 @@ sensor::TimedPointCloudOriginData RangeDataCollator::AddRangeData(
 
 sensor::TimedPointCloudOriginData RangeDataCollator::CropAndMerge() {
   sensor::TimedPointCloudOriginData result{current_end_, {}, {}};
+  std::vector<OverlapView> overlaps;
   bool warned_for_dropped_points = false;
   for (auto it = id_to_pending_data_.begin();
        it != id_to_pending_data_.end();) {
-    sensor::TimedPointCloudData& data = it->second;
-    const sensor::TimedPointCloud& ranges = it->second.ranges;
-    const std::vector<float>& intensities = it->second.intensities;
+    PendingData& pending = it->second;
+    const sensor::TimedPointCloudData& data = *pending.data;
+    const sensor::TimedPointCloud& ranges = data.ranges;
 
-    auto overlap_begin = ranges.begin();
-    while (overlap_begin < ranges.end() &&
-           data.time + common::FromSeconds((*overlap_begin).time) <
+    size_t overlap_begin = pending.begin;
+    while (overlap_begin < ranges.size() &&
+           data.time + common::FromSeconds(ranges[overlap_begin].time) <
                current_start_) {
       ++overlap_begin;
     }
-    auto overlap_end = overlap_begin;
-    while (overlap_end < ranges.end() &&
-           data.time + common::FromSeconds((*overlap_end).time) <=
+    size_t overlap_end = overlap_begin;
+    while (overlap_end < ranges.size() &&
+           data.time + common::FromSeconds(ranges[overlap_end].time) <=
                current_end_) {
       ++overlap_end;
     }
-    if (ranges.begin() < overlap_begin && !warned_for_dropped_points) {
-      LOG(WARNING) << "Dropped " << std::distance(ranges.begin(), overlap_begin)
+    if (pending.begin < overlap_begin && !warned_for_dropped_points) {
+      LOG(WARNING) << "Dropped " << overlap_begin - pending.begin
                    << " earlier points.";
       warned_for_dropped_points = true;
     }
 
-    // Copy overlapping range.
+    // Reference overlapping range.
     if (overlap_begin < overlap_end) {
-      std::size_t origin_index = result.origins.size();
+      overlaps.push_back(OverlapView{
+          pending.data, overlap_begin, overlap_end, result.origins.size(),
+          static_cast<float>(common::ToSeconds(data.time - current_end_))});
       result.origins.push_back(data.origin);
-      const float time_correction =
-          static_cast<float>(common::ToSeconds(data.time - current_end_));
-      auto intensities_overlap_it =
-          intensities.begin() + (overlap_begin - ranges.begin());
-      result.ranges.reserve(result.ranges.size() +
-                            std::distance(overlap_begin, overlap_end));
-      for (auto overlap_it = overlap_begin; overlap_it != overlap_end;
-           ++overlap_it, ++intensities_overlap_it) {
-        sensor::TimedPointCloudOriginData::RangeMeasurement point{
-            *overlap_it, *intensities_overlap_it, origin_index};
-        // current_end_ + point_time[3]_after == in_timestamp +
-        // point_time[3]_before
-        point.point_time.time += time_correction;
-        result.ranges.push_back(point);
-      }
     }
 
     // Drop buffered points until overlap_end.
-    if (overlap_end == ranges.end()) {
+    if (overlap_end == ranges.size()) {
       it = id_to_pending_data_.erase(it);
-    } else if (overlap_end == ranges.begin()) {
-      ++it;
     } else {
-      const auto intensities_overlap_end =
-          intensities.begin() + (overlap_end - ranges.begin());
-      data = sensor::TimedPointCloudData{
-          data.time, data.origin,
-          sensor::TimedPointCloud(overlap_end, ranges.end()),
-          std::vector<float>(intensities_overlap_end, intensities.end())};
+      pending.begin = overlap_end;
       ++it;
     }
   }
 
-  std::sort(result.ranges.begin(), result.ranges.end(),
-            [](const sensor::TimedPointCloudOriginData::RangeMeasurement& a,
-               const sensor::TimedPointCloudOriginData::RangeMeasurement& b) {
-              return a.point_time.time < b.point_time.time;
-            });
+  MergeByTime(overlaps, kDefaultIntensityValue, &result.ranges);
   return result;
 }
 
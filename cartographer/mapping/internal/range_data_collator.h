@@ -17,7 +17,11 @@
 #ifndef CARTOGRAPHER_MAPPING_INTERNAL_RANGE_DATA_COLLATOR_H_
 #define CARTOGRAPHER_MAPPING_INTERNAL_RANGE_DATA_COLLATOR_H_
 
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "cartographer/sensor/timed_point_cloud_data.h"
@@ -43,12 +47,27 @@ class RangeDataCollator {
       const std::string& sensor_id,
       sensor::TimedPointCloudData timed_point_cloud_data);
 
+  // Same as above, but shares 'timed_point_cloud_data' instead of copying it.
+  // Points which are not returned right away stay in the shared buffer until
+  // a later call returns them.
+  sensor::TimedPointCloudOriginData AddRangeData(
+      const std::string& sensor_id,
+      std::shared_ptr<const sensor::TimedPointCloudData>
+          timed_point_cloud_data);
+
  private:
+  // The points of a buffered message from index 'begin' on, which have not
+  // been returned yet.
+  struct PendingData {
+    std::shared_ptr<const sensor::TimedPointCloudData> data;
+    size_t begin;
+  };
+
   sensor::TimedPointCloudOriginData CropAndMerge();
 
   const std::set<std::string> expected_sensor_ids_;
   // Store at most one message for each sensor.
-  std::map<std::string, sensor::TimedPointCloudData> id_to_pending_data_;
+  std::map<std::string, PendingData> id_to_pending_data_;
   common::Time current_start_ = common::Time::min();
   common::Time current_end_ = common::Time::min();
 
@@ -16,6 +16,9 @@
 
 #include "cartographer/mapping/internal/range_data_collator.h"
 
+#include <algorithm>
+#include <memory>
+
 #include "cartographer/common/time.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -200,6 +203,58 @@ TEST(RangeDataCollatorTest, ThreeSensorsWithIntensities) {
   IntensitiesAreConsistent(output_3);
 }
 
+TEST(RangeDataCollatorTest, ReferencesSharedBuffers) {
+  const std::string sensor_0 = "sensor_0";
+  const std::string sensor_1 = "sensor_1";
+  RangeDataCollator collator({sensor_0, sensor_1});
+  const auto data_0 = std::make_shared<const sensor::TimedPointCloudData>(
+      CreateFakeRangeData(200, 300, true));
+  const auto data_1 = std::make_shared<const sensor::TimedPointCloudData>(
+      CreateFakeRangeData(250, 350, true));
+  EXPECT_EQ(collator.AddRangeData(sensor_0, data_0).ranges.size(), 0);
+  EXPECT_EQ(data_0.use_count(), 2);
+  const auto output_0 = collator.AddRangeData(sensor_1, data_1);
+  EXPECT_EQ(common::ToUniversal(output_0.time), 300);
+  EXPECT_TRUE(ArePointTimestampsSorted(output_0));
+  IntensitiesAreConsistent(output_0);
+  // 'data_0' was returned completely, the later part of 'data_1' is still
+  // referenced by the collator.
+  EXPECT_EQ(data_0.use_count(), 1);
+  EXPECT_EQ(data_1.use_count(), 2);
+  const auto output_1 = collator.AddRangeData(
+      sensor_1, CreateFakeRangeData(350, 450, true));
+  EXPECT_EQ(common::ToUniversal(output_1.time), 350);
+  EXPECT_EQ(output_0.ranges.size() + output_1.ranges.size(), 2 * kNumSamples);
+  EXPECT_TRUE(ArePointTimestampsSorted(output_1));
+  IntensitiesAreConsistent(output_1);
+  EXPECT_EQ(data_1.use_count(), 1);
+}
+
+TEST(RangeDataCollatorTest, SortsUnorderedPoints) {
+  const std::string sensor_id = "single_sensor";
+  RangeDataCollator collator({sensor_id});
+  sensor::TimedPointCloudData data = CreateFakeRangeData(200, 300, true);
+  std::reverse(data.ranges.begin(), data.ranges.end());
+  std::reverse(data.intensities.begin(), data.intensities.end());
+  const auto output = collator.AddRangeData(sensor_id, data);
+  ASSERT_EQ(output.ranges.size(), kNumSamples);
+  EXPECT_TRUE(ArePointTimestampsSorted(output));
+  IntensitiesAreConsistent(output);
+}
+
+TEST(RangeDataCollatorTest, FillsMissingIntensities) {
+  const std::string sensor_id = "single_sensor";
+  RangeDataCollator collator({sensor_id});
+  sensor::TimedPointCloudData data = CreateFakeRangeData(200, 300, true);
+  data.intensities.resize(kNumSamples / 2);
+  const auto output = collator.AddRangeData(sensor_id, data);
+  ASSERT_EQ(output.ranges.size(), kNumSamples);
+  for (int i = 0; i < kNumSamples; ++i) {
+    EXPECT_EQ(output.ranges[i].intensity,
+              i < kNumSamples / 2 ? data.intensities[i] : 0.f);
+  }
+}
+
 }  // namespace
 }  // namespace mapping
 }  // namespace cartographer
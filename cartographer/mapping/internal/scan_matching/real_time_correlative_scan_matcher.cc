@@ -3,6 +3,13 @@
 namespace cartographer {
 namespace mapping {
 namespace scan_matching {
+namespace {
+
+// The search window is pruned in squares of up to 2^(depth - 1) cells, which
+// must not overflow and are already larger than any sensible search window.
+constexpr int kMaxBranchAndBoundDepth = 16;
+
+}  // namespace
 
 proto::RealTimeCorrelativeScanMatcherOptions
 CreateRealTimeCorrelativeScanMatcherOptions(
@@ -16,8 +23,14 @@ CreateRealTimeCorrelativeScanMatcherOptions(
       parameter_dictionary->GetDouble("translation_delta_cost_weight"));
   options.set_rotation_delta_cost_weight(
       parameter_dictionary->GetDouble("rotation_delta_cost_weight"));
+  // Only used in 2D, so 3D configurations do not need to set it.
+  options.set_branch_and_bound_depth(
+      parameter_dictionary->HasKey("branch_and_bound_depth")
+          ? parameter_dictionary->GetNonNegativeInt("branch_and_bound_depth")
+          : 1);
   CHECK_GE(options.translation_delta_cost_weight(), 0.);
   CHECK_GE(options.rotation_delta_cost_weight(), 0.);
+  CHECK_LE(options.branch_and_bound_depth(), kMaxBranchAndBoundDepth);
   return options;
 }
 
@@ -19,6 +19,7 @@
 #include "absl/memory/memory.h"
 #include "absl/types/optional.h"
 #include "cartographer/common/time.h"
+#include "cartographer/common/work_stealing_thread_pool.h"
 #include "cartographer/io/internal/mapping_state_serialization.h"
 #include "cartographer/io/proto_stream.h"
 #include "cartographer/io/proto_stream_deserializer.h"
@@ -31,6 +32,7 @@
 #include "cartographer/mapping/internal/global_trajectory_builder.h"
 #include "cartographer/mapping/internal/motion_filter.h"
 #include "cartographer/sensor/internal/collator.h"
+#include "cartographer/sensor/internal/parallel_trajectory_collator.h"
 #include "cartographer/sensor/internal/trajectory_collator.h"
 #include "cartographer/sensor/internal/voxel_filter.h"
 #include "cartographer/transform/rigid_transform.h"
@@ -72,10 +74,24 @@ void MaybeAddPureLocalizationTrimmer(
   }
 }
 
+std::unique_ptr<common::ThreadPoolInterface> CreateThreadPool(
+    const proto::MapBuilderOptions& options) {
+  switch (options.thread_pool_type()) {
+    case proto::MapBuilderOptions::SHARED_QUEUE_THREAD_POOL:
+      return absl::make_unique<common::ThreadPool>(
+          options.num_background_threads(), "map_builder");
+    case proto::MapBuilderOptions::WORK_STEALING_THREAD_POOL:
+      return absl::make_unique<common::WorkStealingThreadPool>(
+          options.num_background_threads(), "map_builder");
+    default:
+      LOG(FATAL) << "Unknown ThreadPoolType.";
+  }
+}
+
 }  // namespace
 
 MapBuilder::MapBuilder(const proto::MapBuilderOptions& options)
-    : options_(options), thread_pool_(options.num_background_threads()) {
+    : options_(options), thread_pool_(CreateThreadPool(options)) {
   CHECK(options.use_trajectory_builder_2d() ^
         options.use_trajectory_builder_3d());
   if (options.use_trajectory_builder_2d()) {
@@ -83,22 +99,31 @@ MapBuilder::MapBuilder(const proto::MapBuilderOptions& options)
         options_.pose_graph_options(),
         absl::make_unique<optimization::OptimizationProblem2D>(
             options_.pose_graph_options().optimization_problem_options()),
-        &thread_pool_);
+        thread_pool_.get());
   }
   if (options.use_trajectory_builder_3d()) {
     pose_graph_ = absl::make_unique<PoseGraph3D>(
         options_.pose_graph_options(),
         absl::make_unique<optimization::OptimizationProblem3D>(
             options_.pose_graph_options().optimization_problem_options()),
-        &thread_pool_);
+        thread_pool_.get());
   }
-  if (options.collate_by_trajectory()) {
+  if (options.collate_by_trajectory() && options.num_collator_threads() > 0) {
+    sensor_collator_ = absl::make_unique<sensor::ParallelTrajectoryCollator>(
+        options.num_collator_threads());
+  } else if (options.collate_by_trajectory()) {
     sensor_collator_ = absl::make_unique<sensor::TrajectoryCollator>();
   } else {
     sensor_collator_ = absl::make_unique<sensor::Collator>();
   }
 }
 
+MapBuilder::~MapBuilder() {
+  // A 'ParallelTrajectoryCollator' dispatches the data still queued when it
+  // is destroyed, which needs the trajectory builders.
+  sensor_collator_.reset();
+}
+
 int MapBuilder::AddTrajectoryBuilder(
     const std::set<SensorId>& expected_sensor_ids,
     const proto::TrajectoryBuilderOptions& trajectory_options,
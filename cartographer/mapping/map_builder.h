@@ -33,7 +33,7 @@ namespace mapping {
 class MapBuilder : public MapBuilderInterface {
  public:
   explicit MapBuilder(const proto::MapBuilderOptions &options);
-  ~MapBuilder() override {}
+  ~MapBuilder() override;
 
   MapBuilder(const MapBuilder &) = delete;
   MapBuilder &operator=(const MapBuilder &) = delete;
@@ -84,10 +84,12 @@ class MapBuilder : public MapBuilderInterface {
 
  private:
   const proto::MapBuilderOptions options_;
-  common::ThreadPool thread_pool_;
+  std::unique_ptr<common::ThreadPoolInterface> thread_pool_;
 
   std::unique_ptr<PoseGraph> pose_graph_;
 
+  // Dispatches into 'trajectory_builders_', so the destructor destroys it
+  // first.
   std::unique_ptr<sensor::CollatorInterface> sensor_collator_;
   std::vector<std::unique_ptr<mapping::TrajectoryBuilderInterface>>
       trajectory_builders_;
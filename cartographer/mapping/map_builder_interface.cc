@@ -32,6 +32,16 @@ proto::MapBuilderOptions CreateMapBuilderOptions(
       parameter_dictionary->GetNonNegativeInt("num_background_threads"));
   options.set_collate_by_trajectory(
       parameter_dictionary->GetBool("collate_by_trajectory"));
+  options.set_num_collator_threads(
+      parameter_dictionary->GetNonNegativeInt("num_collator_threads"));
+  const std::string thread_pool_type_string =
+      parameter_dictionary->GetString("thread_pool_type");
+  proto::MapBuilderOptions_ThreadPoolType thread_pool_type;
+  CHECK(proto::MapBuilderOptions_ThreadPoolType_Parse(thread_pool_type_string,
+                                                      &thread_pool_type))
+      << "Unknown MapBuilderOptions_ThreadPoolType kind: "
+      << thread_pool_type_string;
+  options.set_thread_pool_type(thread_pool_type);
   *options.mutable_pose_graph_options() = CreatePoseGraphOptions(
       parameter_dictionary->GetDictionary("pose_graph").get());
   CHECK_NE(options.use_trajectory_builder_2d(),
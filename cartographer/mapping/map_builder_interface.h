@@ -55,6 +55,13 @@ class MapBuilderInterface {
   MapBuilderInterface& operator=(const MapBuilderInterface&) = delete;
 
   // Creates a new trajectory builder and returns its index.
+  //
+  // 'local_slam_result_callback' is called from the thread that collates the
+  // sensor data of the trajectory. That is the thread adding the sensor data,
+  // unless 'collate_by_trajectory' is set and 'num_collator_threads' is
+  // positive. Then it is a dispatch thread of the collator, and the callbacks
+  // of trajectories assigned to different dispatch threads run concurrently,
+  // so callbacks shared by several trajectories must be thread-safe.
   virtual int AddTrajectoryBuilder(
       const std::set<SensorId>& expected_sensor_ids,
       const proto::TrajectoryBuilderOptions& trajectory_options,
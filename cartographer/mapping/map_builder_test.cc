@@ -16,6 +16,10 @@
 
 #include "cartographer/mapping/map_builder.h"
 
+#include <map>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
 #include "cartographer/common/config.h"
 #include "cartographer/io/proto_stream.h"
 #include "cartographer/mapping/2d/grid_2d.h"
@@ -253,6 +257,107 @@ TEST_P(MapBuilderTestByGridType, GlobalSlam2D) {
               0.1 * kTravelDistance);
 }
 
+TEST_F(MapBuilderTest, GlobalSlam2DWithWorkStealingThreadPool) {
+  SetOptionsEnableGlobalOptimization();
+  map_builder_options_.set_num_background_threads(4);
+  map_builder_options_.set_thread_pool_type(
+      proto::MapBuilderOptions::WORK_STEALING_THREAD_POOL);
+  BuildMapBuilder();
+  int trajectory_id = map_builder_->AddTrajectoryBuilder(
+      {kRangeSensorId}, trajectory_builder_options_,
+      GetLocalSlamResultCallback());
+  TrajectoryBuilderInterface* trajectory_builder =
+      map_builder_->GetTrajectoryBuilder(trajectory_id);
+  const auto measurements = testing::GenerateFakeRangeMeasurements(
+      kTravelDistance, kDuration, kTimeStep);
+  for (const auto& measurement : measurements) {
+    trajectory_builder->AddSensorData(kRangeSensorId.id, measurement);
+  }
+  map_builder_->FinishTrajectory(trajectory_id);
+  map_builder_->pose_graph()->RunFinalOptimization();
+  EXPECT_EQ(local_slam_result_poses_.size(), measurements.size());
+  EXPECT_GE(map_builder_->pose_graph()->constraints().size(), 50);
+  EXPECT_THAT(map_builder_->pose_graph()->constraints(),
+              ::testing::Contains(::testing::Field(
+                  &PoseGraphInterface::Constraint::tag,
+                  PoseGraphInterface::Constraint::INTER_SUBMAP)));
+  const transform::Rigid3d final_pose =
+      map_builder_->pose_graph()->GetLocalToGlobalTransform(trajectory_id) *
+      local_slam_result_poses_.back();
+  EXPECT_NEAR(kTravelDistance, final_pose.translation().norm(),
+              0.1 * kTravelDistance);
+}
+
+TEST_F(MapBuilderTest, LocalSlam2DWithParallelTrajectoryCollator) {
+  constexpr int kNumTrajectories = 2;
+  map_builder_options_.set_collate_by_trajectory(true);
+  map_builder_options_.set_num_collator_threads(kNumTrajectories);
+  BuildMapBuilder();
+  // Local SLAM of the trajectories runs concurrently on the collator threads.
+  absl::Mutex mutex;
+  std::map<int, std::vector<transform::Rigid3d>> local_slam_result_poses;
+  std::vector<TrajectoryBuilderInterface*> trajectory_builders;
+  for (int i = 0; i != kNumTrajectories; ++i) {
+    const int trajectory_id = map_builder_->AddTrajectoryBuilder(
+        {kRangeSensorId}, trajectory_builder_options_,
+        [&mutex, &local_slam_result_poses](
+            const int trajectory_id, const common::Time,
+            const transform::Rigid3d local_pose, sensor::RangeData,
+            const std::unique_ptr<
+                const TrajectoryBuilderInterface::InsertionResult>) {
+          absl::MutexLock locker(&mutex);
+          local_slam_result_poses[trajectory_id].push_back(local_pose);
+        });
+    EXPECT_EQ(trajectory_id, i);
+    trajectory_builders.push_back(
+        map_builder_->GetTrajectoryBuilder(trajectory_id));
+  }
+  const auto measurements = testing::GenerateFakeRangeMeasurements(
+      kTravelDistance, kDuration, kTimeStep);
+  for (const auto& measurement : measurements) {
+    for (TrajectoryBuilderInterface* trajectory_builder : trajectory_builders) {
+      trajectory_builder->AddSensorData(kRangeSensorId.id, measurement);
+    }
+  }
+  for (int trajectory_id = 0; trajectory_id != kNumTrajectories;
+       ++trajectory_id) {
+    map_builder_->FinishTrajectory(trajectory_id);
+  }
+  map_builder_->pose_graph()->RunFinalOptimization();
+  absl::MutexLock locker(&mutex);
+  ASSERT_EQ(local_slam_result_poses.size(), kNumTrajectories);
+  for (const auto& trajectory_id_and_poses : local_slam_result_poses) {
+    const std::vector<transform::Rigid3d>& poses =
+        trajectory_id_and_poses.second;
+    EXPECT_EQ(poses.size(), measurements.size());
+    EXPECT_NEAR(
+        kTravelDistance,
+        (poses.back().translation() - poses.front().translation()).norm(),
+        0.1 * kTravelDistance);
+  }
+}
+
+TEST_F(MapBuilderTest, DestroyWithPendingDataInParallelTrajectoryCollator) {
+  map_builder_options_.set_collate_by_trajectory(true);
+  map_builder_options_.set_num_collator_threads(2);
+  BuildMapBuilder();
+  int trajectory_id = map_builder_->AddTrajectoryBuilder(
+      {kRangeSensorId}, trajectory_builder_options_,
+      GetLocalSlamResultCallback());
+  TrajectoryBuilderInterface* trajectory_builder =
+      map_builder_->GetTrajectoryBuilder(trajectory_id);
+  const auto measurements = testing::GenerateFakeRangeMeasurements(
+      kTravelDistance, kDuration, kTimeStep);
+  for (const auto& measurement : measurements) {
+    trajectory_builder->AddSensorData(kRangeSensorId.id, measurement);
+  }
+  // Neither finishing the trajectory nor flushing, the collator threads are
+  // most likely still dispatching when the map builder is destroyed, which
+  // still dispatches all data.
+  map_builder_.reset();
+  EXPECT_EQ(local_slam_result_poses_.size(), measurements.size());
+}
+
 TEST_F(MapBuilderTest, GlobalSlam3D) {
   SetOptionsTo3D();
   SetOptionsEnableGlobalOptimization();
@@ -296,6 +401,53 @@ TEST_F(MapBuilderTest, GlobalSlam3D) {
               0.1 * kTravelDistance);
 }
 
+TEST_F(MapBuilderTest, GlobalSlam3DWithCompressedNodePointClouds) {
+  SetOptionsTo3D();
+  SetOptionsEnableGlobalOptimization();
+  auto* const pose_graph_options =
+      map_builder_options_.mutable_pose_graph_options();
+  pose_graph_options->set_compress_node_point_clouds(true);
+  pose_graph_options->mutable_constraint_builder_options()
+      ->set_decompressed_node_cache_size(2);
+  BuildMapBuilder();
+  int trajectory_id = map_builder_->AddTrajectoryBuilder(
+      {kRangeSensorId, kIMUSensorId}, trajectory_builder_options_,
+      GetLocalSlamResultCallback());
+  TrajectoryBuilderInterface* trajectory_builder =
+      map_builder_->GetTrajectoryBuilder(trajectory_id);
+  const auto measurements = testing::GenerateFakeRangeMeasurements(
+      kTravelDistance, kDuration, kTimeStep);
+  for (const auto& measurement : measurements) {
+    trajectory_builder->AddSensorData(kRangeSensorId.id, measurement);
+    trajectory_builder->AddSensorData(
+        kIMUSensorId.id,
+        sensor::ImuData{measurement.time, Eigen::Vector3d(0., 0., 9.8),
+                        Eigen::Vector3d::Zero()});
+  }
+  map_builder_->FinishTrajectory(trajectory_id);
+  map_builder_->pose_graph()->RunFinalOptimization();
+  EXPECT_EQ(local_slam_result_poses_.size(), measurements.size());
+  EXPECT_GE(map_builder_->pose_graph()->constraints().size(), 10);
+  EXPECT_THAT(map_builder_->pose_graph()->constraints(),
+              ::testing::Contains(::testing::Field(
+                  &PoseGraphInterface::Constraint::tag,
+                  PoseGraphInterface::Constraint::INTER_SUBMAP)));
+  const auto trajectory_nodes =
+      map_builder_->pose_graph()->GetTrajectoryNodes();
+  ASSERT_GE(trajectory_nodes.SizeOfTrajectoryOrZero(trajectory_id), 5);
+  for (const auto& node : trajectory_nodes) {
+    ASSERT_NE(node.data.constant_data->compressed_point_clouds, nullptr);
+    EXPECT_TRUE(node.data.constant_data->high_resolution_point_cloud.empty());
+    EXPECT_FALSE(node.data.constant_data->compressed_point_clouds
+                     ->high_resolution_point_cloud.empty());
+  }
+  const transform::Rigid3d final_pose =
+      map_builder_->pose_graph()->GetLocalToGlobalTransform(trajectory_id) *
+      local_slam_result_poses_.back();
+  EXPECT_NEAR(kTravelDistance, final_pose.translation().norm(),
+              0.1 * kTravelDistance);
+}
+
 TEST_P(MapBuilderTestByGridType, DeleteFinishedTrajectory2D) {
   if (GetParam() == GridType::TSDF) SetOptionsToTSDF2D();
   SetOptionsEnableGlobalOptimization();
@@ -78,6 +78,10 @@ class PoseGraph : public PoseGraphInterface {
   // Finishes the given trajectory.
   virtual void FinishTrajectory(int trajectory_id) = 0;
 
+  // Waits until all data added so far has been processed, including its
+  // constraint searches, without running the final optimization.
+  virtual void WaitForAllComputations() = 0;
+
   // Freezes a trajectory. Poses in this trajectory will not be optimized.
   virtual void FreezeTrajectory(int trajectory_id) = 0;
 
@@ -113,7 +113,10 @@ class PoseGraphInterface {
   virtual transform::Rigid3d GetLocalToGlobalTransform(
       int trajectory_id) const = 0;
 
-  // Returns the current optimized trajectories.
+  // Returns the current optimized trajectories. With
+  // 'compress_node_point_clouds', the point clouds of the node data are empty
+  // and kept in 'compressed_point_clouds' instead, see
+  // 'DecompressPointClouds'.
   virtual MapById<NodeId, TrajectoryNode> GetTrajectoryNodes() const = 0;
 
   // Returns the current optimized trajectory poses.
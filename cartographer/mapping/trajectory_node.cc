@@ -29,16 +29,27 @@ proto::TrajectoryNodeData ToProto(const TrajectoryNode::Data& constant_data) {
   proto.set_timestamp(common::ToUniversal(constant_data.time));
   *proto.mutable_gravity_alignment() =
       transform::ToProto(constant_data.gravity_alignment);
-  *proto.mutable_filtered_gravity_aligned_point_cloud() =
-      sensor::CompressedPointCloud(
-          constant_data.filtered_gravity_aligned_point_cloud)
-          .ToProto();
-  *proto.mutable_high_resolution_point_cloud() =
-      sensor::CompressedPointCloud(constant_data.high_resolution_point_cloud)
-          .ToProto();
-  *proto.mutable_low_resolution_point_cloud() =
-      sensor::CompressedPointCloud(constant_data.low_resolution_point_cloud)
-          .ToProto();
+  if (constant_data.compressed_point_clouds != nullptr) {
+    const TrajectoryNode::CompressedPointClouds& compressed_point_clouds =
+        *constant_data.compressed_point_clouds;
+    *proto.mutable_filtered_gravity_aligned_point_cloud() =
+        compressed_point_clouds.filtered_gravity_aligned_point_cloud.ToProto();
+    *proto.mutable_high_resolution_point_cloud() =
+        compressed_point_clouds.high_resolution_point_cloud.ToProto();
+    *proto.mutable_low_resolution_point_cloud() =
+        compressed_point_clouds.low_resolution_point_cloud.ToProto();
+  } else {
+    *proto.mutable_filtered_gravity_aligned_point_cloud() =
+        sensor::CompressedPointCloud(
+            constant_data.filtered_gravity_aligned_point_cloud)
+            .ToProto();
+    *proto.mutable_high_resolution_point_cloud() =
+        sensor::CompressedPointCloud(constant_data.high_resolution_point_cloud)
+            .ToProto();
+    *proto.mutable_low_resolution_point_cloud() =
+        sensor::CompressedPointCloud(constant_data.low_resolution_point_cloud)
+            .ToProto();
+  }
   for (Eigen::VectorXf::Index i = 0;
        i != constant_data.rotational_scan_matcher_histogram.size(); ++i) {
     proto.add_rotational_scan_matcher_histogram(
@@ -48,13 +59,22 @@ proto::TrajectoryNodeData ToProto(const TrajectoryNode::Data& constant_data) {
   return proto;
 }
 
-TrajectoryNode::Data FromProto(const proto::TrajectoryNodeData& proto) {
+namespace {
+
+Eigen::VectorXf RotationalScanMatcherHistogramFromProto(
+    const proto::TrajectoryNodeData& proto) {
   Eigen::VectorXf rotational_scan_matcher_histogram(
       proto.rotational_scan_matcher_histogram_size());
   for (int i = 0; i != proto.rotational_scan_matcher_histogram_size(); ++i) {
     rotational_scan_matcher_histogram(i) =
         proto.rotational_scan_matcher_histogram(i);
   }
+  return rotational_scan_matcher_histogram;
+}
+
+}  // namespace
+
+TrajectoryNode::Data FromProto(const proto::TrajectoryNodeData& proto) {
   return TrajectoryNode::Data{
       common::FromUniversal(proto.timestamp()),
       transform::ToEigen(proto.gravity_alignment()),
@@ -64,9 +84,73 @@ TrajectoryNode::Data FromProto(const proto::TrajectoryNodeData& proto) {
           .Decompress(),
       sensor::CompressedPointCloud(proto.low_resolution_point_cloud())
           .Decompress(),
-      rotational_scan_matcher_histogram,
+      RotationalScanMatcherHistogramFromProto(proto),
       transform::ToRigid3(proto.local_pose())};
 }
 
+TrajectoryNode::Data FromProtoWithCompressedPointClouds(
+    const proto::TrajectoryNodeData& proto) {
+  TrajectoryNode::Data result;
+  result.time = common::FromUniversal(proto.timestamp());
+  result.gravity_alignment = transform::ToEigen(proto.gravity_alignment());
+  result.rotational_scan_matcher_histogram =
+      RotationalScanMatcherHistogramFromProto(proto);
+  result.local_pose = transform::ToRigid3(proto.local_pose());
+  result.compressed_point_clouds =
+      std::make_shared<const TrajectoryNode::CompressedPointClouds>(
+          TrajectoryNode::CompressedPointClouds{
+              sensor::CompressedPointCloud(
+                  proto.filtered_gravity_aligned_point_cloud()),
+              sensor::CompressedPointCloud(proto.high_resolution_point_cloud()),
+              sensor::CompressedPointCloud(
+                  proto.low_resolution_point_cloud())});
+  return result;
+}
+
+TrajectoryNode::Data CompressPointClouds(
+    const TrajectoryNode::Data& constant_data) {
+  if (constant_data.compressed_point_clouds != nullptr) {
+    return constant_data;
+  }
+  TrajectoryNode::Data result;
+  result.time = constant_data.time;
+  result.gravity_alignment = constant_data.gravity_alignment;
+  result.rotational_scan_matcher_histogram =
+      constant_data.rotational_scan_matcher_histogram;
+  result.local_pose = constant_data.local_pose;
+  result.compressed_point_clouds =
+      std::make_shared<const TrajectoryNode::CompressedPointClouds>(
+          TrajectoryNode::CompressedPointClouds{
+              sensor::CompressedPointCloud(
+                  constant_data.filtered_gravity_aligned_point_cloud),
+              sensor::CompressedPointCloud(
+                  constant_data.high_resolution_point_cloud),
+              sensor::CompressedPointCloud(
+                  constant_data.low_resolution_point_cloud)});
+  return result;
+}
+
+TrajectoryNode::Data DecompressPointClouds(
+    const TrajectoryNode::Data& constant_data) {
+  if (constant_data.compressed_point_clouds == nullptr) {
+    return constant_data;
+  }
+  const TrajectoryNode::CompressedPointClouds& compressed_point_clouds =
+      *constant_data.compressed_point_clouds;
+  TrajectoryNode::Data result;
+  result.time = constant_data.time;
+  result.gravity_alignment = constant_data.gravity_alignment;
+  result.filtered_gravity_aligned_point_cloud =
+      compressed_point_clouds.filtered_gravity_aligned_point_cloud.Decompress();
+  result.high_resolution_point_cloud =
+      compressed_point_clouds.high_resolution_point_cloud.Decompress();
+  result.low_resolution_point_cloud =
+      compressed_point_clouds.low_resolution_point_cloud.Decompress();
+  result.rotational_scan_matcher_histogram =
+      constant_data.rotational_scan_matcher_histogram;
+  result.local_pose = constant_data.local_pose;
+  return result;
+}
+
 }  // namespace mapping
 }  // namespace cartographer
@@ -24,6 +24,7 @@
 #include "absl/types/optional.h"
 #include "cartographer/common/time.h"
 #include "cartographer/mapping/proto/trajectory_node_data.pb.h"
+#include "cartographer/sensor/compressed_point_cloud.h"
 #include "cartographer/sensor/range_data.h"
 #include "cartographer/transform/rigid_transform.h"
 
@@ -42,6 +43,13 @@ struct TrajectoryNodePose {
 };
 
 struct TrajectoryNode {
+  // Compressed form of the point clouds in 'Data'.
+  struct CompressedPointClouds {
+    sensor::CompressedPointCloud filtered_gravity_aligned_point_cloud;
+    sensor::CompressedPointCloud high_resolution_point_cloud;
+    sensor::CompressedPointCloud low_resolution_point_cloud;
+  };
+
   struct Data {
     common::Time time;
 
@@ -60,6 +68,10 @@ struct TrajectoryNode {
 
     // The node pose in the local SLAM frame.
     transform::Rigid3d local_pose;
+
+    // If set, the point clouds above are empty and are kept here in compressed
+    // form instead. Use 'DecompressPointClouds' to get them back.
+    std::shared_ptr<const CompressedPointClouds> compressed_point_clouds;
   };
 
   common::Time time() const { return constant_data->time; }
@@ -74,6 +86,21 @@ struct TrajectoryNode {
 
 proto::TrajectoryNodeData ToProto(const TrajectoryNode::Data& constant_data);
 TrajectoryNode::Data FromProto(const proto::TrajectoryNodeData& proto);
+// Like 'FromProto', but keeps the point clouds in their serialized compressed
+// form in 'compressed_point_clouds' instead of decompressing them.
+TrajectoryNode::Data FromProtoWithCompressedPointClouds(
+    const proto::TrajectoryNodeData& proto);
+
+// Returns a copy of 'constant_data' with its point clouds moved into
+// 'compressed_point_clouds'. Compression quantizes points to 1 mm and drops
+// intensities, which is what serialization does anyway.
+TrajectoryNode::Data CompressPointClouds(
+    const TrajectoryNode::Data& constant_data);
+
+// Returns a copy of 'constant_data' with 'compressed_point_clouds' expanded
+// back into the point clouds.
+TrajectoryNode::Data DecompressPointClouds(
+    const TrajectoryNode::Data& constant_data);
 
 }  // namespace mapping
 }  // namespace cartographer
@@ -28,8 +28,8 @@ namespace cartographer {
 namespace mapping {
 namespace {
 
-TEST(TrajectoryNodeTest, ToAndFromProto) {
-  const TrajectoryNode::Data expected{
+TrajectoryNode::Data CreateNodeData() {
+  return TrajectoryNode::Data{
       common::FromUniversal(42),
       Eigen::Quaterniond(1., 2., -3., -4.),
       sensor::CompressedPointCloud(
@@ -45,8 +45,10 @@ TEST(TrajectoryNodeTest, ToAndFromProto) {
       Eigen::VectorXf::Unit(20, 4),
       transform::Rigid3d({1., 2., 3.},
                          Eigen::Quaterniond(4., 5., -6., -7.).normalized())};
-  const proto::TrajectoryNodeData proto = ToProto(expected);
-  const TrajectoryNode::Data actual = FromProto(proto);
+}
+
+void ExpectEqualNodeData(const TrajectoryNode::Data& expected,
+                         const TrajectoryNode::Data& actual) {
   EXPECT_EQ(expected.time, actual.time);
   EXPECT_TRUE(actual.gravity_alignment.isApprox(expected.gravity_alignment));
   EXPECT_EQ(expected.filtered_gravity_aligned_point_cloud.points(),
@@ -61,6 +63,46 @@ TEST(TrajectoryNodeTest, ToAndFromProto) {
               transform::IsNearly(expected.local_pose, 1e-9));
 }
 
+TEST(TrajectoryNodeTest, ToAndFromProto) {
+  const TrajectoryNode::Data expected = CreateNodeData();
+  const proto::TrajectoryNodeData proto = ToProto(expected);
+  ExpectEqualNodeData(expected, FromProto(proto));
+}
+
+TEST(TrajectoryNodeTest, CompressAndDecompressPointClouds) {
+  const TrajectoryNode::Data expected = CreateNodeData();
+  const TrajectoryNode::Data compressed = CompressPointClouds(expected);
+  ASSERT_NE(compressed.compressed_point_clouds, nullptr);
+  EXPECT_TRUE(compressed.filtered_gravity_aligned_point_cloud.empty());
+  EXPECT_TRUE(compressed.high_resolution_point_cloud.empty());
+  EXPECT_TRUE(compressed.low_resolution_point_cloud.empty());
+  const TrajectoryNode::Data decompressed = DecompressPointClouds(compressed);
+  EXPECT_EQ(decompressed.compressed_point_clouds, nullptr);
+  ExpectEqualNodeData(expected, decompressed);
+}
+
+TEST(TrajectoryNodeTest, CompressedToAndFromProto) {
+  const TrajectoryNode::Data expected = CreateNodeData();
+  const proto::TrajectoryNodeData proto =
+      ToProto(CompressPointClouds(expected));
+  EXPECT_EQ(proto.SerializeAsString(), ToProto(expected).SerializeAsString());
+  ExpectEqualNodeData(expected, FromProto(proto));
+}
+
+TEST(TrajectoryNodeTest, FromProtoWithCompressedPointClouds) {
+  const TrajectoryNode::Data expected = CreateNodeData();
+  const proto::TrajectoryNodeData proto = ToProto(expected);
+  const TrajectoryNode::Data compressed =
+      FromProtoWithCompressedPointClouds(proto);
+  ASSERT_NE(compressed.compressed_point_clouds, nullptr);
+  EXPECT_TRUE(compressed.filtered_gravity_aligned_point_cloud.empty());
+  EXPECT_TRUE(compressed.high_resolution_point_cloud.empty());
+  EXPECT_TRUE(compressed.low_resolution_point_cloud.empty());
+  EXPECT_EQ(ToProto(compressed).SerializeAsString(),
+            proto.SerializeAsString());
+  ExpectEqualNodeData(expected, DecompressPointClouds(compressed));
+}
+
 }  // namespace
 }  // namespace mapping
 }  // namespace cartographer
@@ -16,15 +16,16 @@
 
 #include "cartographer/mapping/value_conversion_tables.h"
 
+#include "absl/base/const_init.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "cartographer/mapping/probability_values.h"
 #include "glog/logging.h"
 
 namespace cartographer {
 namespace mapping {
 namespace {
 
-constexpr uint16 kUpdateMarker = 1u << 15;
-
 // 0 is unknown, [1, 32767] maps to [lower_bound, upper_bound].
 float SlowValueToBoundedFloat(const uint16 value, const uint16 unknown_value,
                               const float unknown_result,
@@ -49,17 +50,45 @@ std::unique_ptr<std::vector<float>> PrecomputeValueToBoundedFloat(
   }
   return result;
 }
+
+// Returns the table for 'bounds' if some ValueConversionTables still holds it,
+// otherwise computes it.
+std::shared_ptr<const std::vector<float>> GetSharedConversionTable(
+    const std::tuple<float, float, float>& bounds) {
+  static absl::Mutex mutex(absl::kConstInit);
+  // Never destroyed, tables may be released during static destruction.
+  static auto* const shared_tables PT_GUARDED_BY(mutex) =
+      new std::map<std::tuple<float, float, float>,
+                   std::weak_ptr<const std::vector<float>>>();
+  absl::MutexLock locker(&mutex);
+  std::weak_ptr<const std::vector<float>>& shared_table =
+      (*shared_tables)[bounds];
+  std::shared_ptr<const std::vector<float>> table = shared_table.lock();
+  if (table == nullptr) {
+    table = PrecomputeValueToBoundedFloat(0, std::get<0>(bounds),
+                                          std::get<1>(bounds),
+                                          std::get<2>(bounds));
+    shared_table = table;
+  }
+  return table;
+}
+
 }  // namespace
 
 const std::vector<float>* ValueConversionTables::GetConversionTable(
     float unknown_result, float lower_bound, float upper_bound) {
+  if (unknown_result == kMaxCorrespondenceCost &&
+      lower_bound == kMinCorrespondenceCost &&
+      upper_bound == kMaxCorrespondenceCost) {
+    // The table of probability grids, which is identical.
+    return kValueToCorrespondenceCost;
+  }
   std::tuple<float, float, float> bounds =
       std::make_tuple(unknown_result, lower_bound, upper_bound);
   auto lookup_table_iterator = bounds_to_lookup_table_.find(bounds);
   if (lookup_table_iterator == bounds_to_lookup_table_.end()) {
     auto insertion_result = bounds_to_lookup_table_.emplace(
-        bounds, PrecomputeValueToBoundedFloat(0, unknown_result, lower_bound,
-                                              upper_bound));
+        bounds, GetSharedConversionTable(bounds));
     return insertion_result.first->second.get();
   } else {
     return lookup_table_iterator->second.get();
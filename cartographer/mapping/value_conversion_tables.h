@@ -18,6 +18,8 @@
 #define CARTOGRAPHER_MAPPING_VALUE_CONVERSION_TABLES_H_
 
 #include <map>
+#include <memory>
+#include <tuple>
 #include <vector>
 
 #include "cartographer/common/port.h"
@@ -29,6 +31,10 @@ namespace mapping {
 // Performs lazy computations of lookup tables for mapping from a uint16 value
 // to a float in ['lower_bound', 'upper_bound']. The first element of the table
 // is set to 'unknown_result'.
+//
+// Tables are shared by all instances in the process: the table of probability
+// grids is precomputed at startup, and other tables are computed once and kept
+// as long as some instance uses them. Thread-compatible.
 class ValueConversionTables {
  public:
   const std::vector<float>* GetConversionTable(float unknown_result,
@@ -38,7 +44,7 @@ class ValueConversionTables {
  private:
   std::map<const std::tuple<float /* unknown_result */, float /* lower_bound */,
                             float /* upper_bound */>,
-           std::unique_ptr<const std::vector<float>>>
+           std::shared_ptr<const std::vector<float>>>
       bounds_to_lookup_table_;
 };
 
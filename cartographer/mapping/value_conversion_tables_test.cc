@@ -18,6 +18,7 @@
 
 #include <random>
 
+#include "cartographer/mapping/probability_values.h"
 #include "gtest/gtest.h"
 
 namespace cartographer {
@@ -42,6 +43,24 @@ TEST(ValueConversionTablesTest, InequalTables) {
   EXPECT_FALSE(reference_table == test_table);
 }
 
+TEST(ValueConversionTablesTest, TablesAreSharedBetweenInstances) {
+  ValueConversionTables value_conversion_tables;
+  const std::vector<float>* reference_table =
+      value_conversion_tables.GetConversionTable(0.1f, 0.1f, 0.5f);
+  ValueConversionTables other_value_conversion_tables;
+  const std::vector<float>* test_table =
+      other_value_conversion_tables.GetConversionTable(0.1f, 0.1f, 0.5f);
+  EXPECT_EQ(reference_table, test_table);
+}
+
+TEST(ValueConversionTablesTest, ProbabilityGridTableIsPrecomputed) {
+  ValueConversionTables value_conversion_tables;
+  EXPECT_EQ(kValueToCorrespondenceCost,
+            value_conversion_tables.GetConversionTable(
+                kMaxCorrespondenceCost, kMinCorrespondenceCost,
+                kMaxCorrespondenceCost));
+}
+
 TEST(ValueConversionTablesTest, ValueConversion) {
   ValueConversionTables value_conversion_tables;
   std::mt19937 rng(42);
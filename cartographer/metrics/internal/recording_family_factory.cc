@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/metrics/internal/recording_family_factory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace metrics {
+namespace {
+
+template <typename FamilyMap>
+auto* GetOrCreateFamily(const std::string& name, FamilyMap* families) {
+  auto& family = (*families)[name];
+  if (family == nullptr) {
+    family = absl::make_unique<
+        typename FamilyMap::mapped_type::element_type>();
+  }
+  return family.get();
+}
+
+template <typename FamilyMap>
+auto GetMetric(const std::string& name,
+               const std::map<std::string, std::string>& labels,
+               const FamilyMap& families)
+    -> decltype(families.begin()->second->Get(labels)) {
+  const auto it = families.find(name);
+  if (it == families.end()) {
+    return nullptr;
+  }
+  return it->second->Get(labels);
+}
+
+}  // namespace
+
+void RecordingCounter::Increment(const double by_value) {
+  absl::MutexLock locker(&mutex_);
+  value_ += by_value;
+}
+
+double RecordingCounter::Value() const {
+  absl::MutexLock locker(&mutex_);
+  return value_;
+}
+
+void RecordingGauge::Increment(const double by_value) {
+  absl::MutexLock locker(&mutex_);
+  value_ += by_value;
+}
+
+void RecordingGauge::Set(const double value) {
+  absl::MutexLock locker(&mutex_);
+  value_ = value;
+}
+
+double RecordingGauge::Value() const {
+  absl::MutexLock locker(&mutex_);
+  return value_;
+}
+
+void RecordingHistogram::Observe(const double value) {
+  absl::MutexLock locker(&mutex_);
+  values_.push_back(value);
+}
+
+int RecordingHistogram::Count() const {
+  absl::MutexLock locker(&mutex_);
+  return values_.size();
+}
+
+double RecordingHistogram::Sum() const {
+  absl::MutexLock locker(&mutex_);
+  return std::accumulate(values_.begin(), values_.end(), 0.);
+}
+
+double RecordingHistogram::Percentile(const double percentile) const {
+  CHECK_GE(percentile, 0.);
+  CHECK_LE(percentile, 1.);
+  std::vector<double> values;
+  {
+    absl::MutexLock locker(&mutex_);
+    values = values_;
+  }
+  if (values.empty()) {
+    return 0.;
+  }
+  // Nearest-rank method.
+  const size_t rank = std::max<size_t>(
+      1, static_cast<size_t>(std::ceil(percentile * values.size())));
+  std::nth_element(values.begin(), values.begin() + (rank - 1), values.end());
+  return values[rank - 1];
+}
+
+Family<Counter>* RecordingFamilyFactory::NewCounterFamily(
+    const std::string& name, const std::string& /* description */) {
+  return GetOrCreateFamily(name, &counters_);
+}
+
+Family<Gauge>* RecordingFamilyFactory::NewGaugeFamily(
+    const std::string& name, const std::string& /* description */) {
+  return GetOrCreateFamily(name, &gauges_);
+}
+
+Family<Histogram>* RecordingFamilyFactory::NewHistogramFamily(
+    const std::string& name, const std::string& /* description */,
+    const Histogram::BucketBoundaries& /* boundaries */) {
+  return GetOrCreateFamily(name, &histograms_);
+}
+
+const RecordingCounter* RecordingFamilyFactory::GetCounter(
+    const std::string& name,
+    const std::map<std::string, std::string>& labels) const {
+  return GetMetric(name, labels, counters_);
+}
+
+const RecordingGauge* RecordingFamilyFactory::GetGauge(
+    const std::string& name,
+    const std::map<std::string, std::string>& labels) const {
+  return GetMetric(name, labels, gauges_);
+}
+
+const RecordingHistogram* RecordingFamilyFactory::GetHistogram(
+    const std::string& name,
+    const std::map<std::string, std::string>& labels) const {
+  return GetMetric(name, labels, histograms_);
+}
+
+}  // namespace metrics
+}  // namespace cartographer
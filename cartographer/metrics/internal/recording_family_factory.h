@@ -0,0 +1,143 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_METRICS_INTERNAL_RECORDING_FAMILY_FACTORY_H_
+#define CARTOGRAPHER_METRICS_INTERNAL_RECORDING_FAMILY_FACTORY_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "cartographer/metrics/family_factory.h"
+
+namespace cartographer {
+namespace metrics {
+
+class RecordingCounter : public Counter {
+ public:
+  void Increment() override { Increment(1.); }
+  void Increment(double by_value) override;
+  double Value() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  double value_ GUARDED_BY(mutex_) = 0.;
+};
+
+class RecordingGauge : public Gauge {
+ public:
+  void Increment() override { Increment(1.); }
+  void Increment(double by_value) override;
+  void Decrement() override { Increment(-1.); }
+  void Decrement(double by_value) override { Increment(-by_value); }
+  void Set(double value) override;
+  double Value() const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  double value_ GUARDED_BY(mutex_) = 0.;
+};
+
+// Unlike a bucketed histogram, keeps every observed value, so that exact
+// percentiles can be computed.
+class RecordingHistogram : public Histogram {
+ public:
+  void Observe(double value) override;
+
+  int Count() const;
+  double Sum() const;
+  // Returns the value below which 'percentile' (in [0, 1]) of all observed
+  // values lie, or 0 if nothing has been observed yet.
+  double Percentile(double percentile) const;
+
+ private:
+  mutable absl::Mutex mutex_;
+  std::vector<double> values_ GUARDED_BY(mutex_);
+};
+
+// A FamilyFactory that keeps all metrics in memory, so that they can be
+// inspected in-process. Useful for offline tools that report on a run.
+class RecordingFamilyFactory : public FamilyFactory {
+ public:
+  RecordingFamilyFactory() = default;
+
+  RecordingFamilyFactory(const RecordingFamilyFactory&) = delete;
+  RecordingFamilyFactory& operator=(const RecordingFamilyFactory&) = delete;
+
+  Family<Counter>* NewCounterFamily(const std::string& name,
+                                    const std::string& description) override;
+  Family<Gauge>* NewGaugeFamily(const std::string& name,
+                                const std::string& description) override;
+  Family<Histogram>* NewHistogramFamily(
+      const std::string& name, const std::string& description,
+      const Histogram::BucketBoundaries& boundaries) override;
+
+  // Return the metric of the family 'name' with the given 'labels', or
+  // 'nullptr' if no such metric has been added.
+  const RecordingCounter* GetCounter(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) const;
+  const RecordingGauge* GetGauge(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) const;
+  const RecordingHistogram* GetHistogram(
+      const std::string& name,
+      const std::map<std::string, std::string>& labels) const;
+
+ private:
+  template <typename MetricType, typename RecordingMetricType>
+  class RecordingFamily : public Family<MetricType> {
+   public:
+    MetricType* Add(const std::map<std::string, std::string>& labels) override {
+      absl::MutexLock locker(&mutex_);
+      auto& metric = metrics_[labels];
+      if (metric == nullptr) {
+        metric = absl::make_unique<RecordingMetricType>();
+      }
+      return metric.get();
+    }
+
+    const RecordingMetricType* Get(
+        const std::map<std::string, std::string>& labels) const {
+      absl::MutexLock locker(&mutex_);
+      const auto it = metrics_.find(labels);
+      return it == metrics_.end() ? nullptr : it->second.get();
+    }
+
+   private:
+    mutable absl::Mutex mutex_;
+    std::map<std::map<std::string, std::string>,
+             std::unique_ptr<RecordingMetricType>>
+        metrics_ GUARDED_BY(mutex_);
+  };
+
+  std::map<std::string,
+           std::unique_ptr<RecordingFamily<Counter, RecordingCounter>>>
+      counters_;
+  std::map<std::string, std::unique_ptr<RecordingFamily<Gauge, RecordingGauge>>>
+      gauges_;
+  std::map<std::string,
+           std::unique_ptr<RecordingFamily<Histogram, RecordingHistogram>>>
+      histograms_;
+};
+
+}  // namespace metrics
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_METRICS_INTERNAL_RECORDING_FAMILY_FACTORY_H_
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/metrics/internal/recording_family_factory.h"
+
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace metrics {
+namespace {
+
+TEST(RecordingFamilyFactoryTest, RecordsCountersAndGauges) {
+  RecordingFamilyFactory factory;
+  Counter* counter =
+      factory.NewCounterFamily("counter", "A counter")->Add({{"kind", "a"}});
+  Gauge* gauge = factory.NewGaugeFamily("gauge", "A gauge")->Add({});
+  counter->Increment();
+  counter->Increment(2.);
+  gauge->Set(5.);
+  gauge->Decrement();
+  ASSERT_NE(factory.GetCounter("counter", {{"kind", "a"}}), nullptr);
+  EXPECT_EQ(factory.GetCounter("counter", {{"kind", "a"}})->Value(), 3.);
+  EXPECT_EQ(factory.GetCounter("counter", {{"kind", "b"}}), nullptr);
+  ASSERT_NE(factory.GetGauge("gauge", {}), nullptr);
+  EXPECT_EQ(factory.GetGauge("gauge", {})->Value(), 4.);
+  EXPECT_EQ(factory.GetGauge("counter", {}), nullptr);
+}
+
+TEST(RecordingFamilyFactoryTest, ComputesExactPercentiles) {
+  RecordingFamilyFactory factory;
+  Histogram* histogram =
+      factory
+          .NewHistogramFamily("histogram", "A histogram",
+                              Histogram::FixedWidth(1., 10))
+          ->Add({});
+  const RecordingHistogram* recording_histogram =
+      factory.GetHistogram("histogram", {});
+  ASSERT_NE(recording_histogram, nullptr);
+  EXPECT_EQ(recording_histogram->Percentile(0.5), 0.);
+  for (int i = 100; i > 0; --i) {
+    histogram->Observe(i);
+  }
+  EXPECT_EQ(recording_histogram->Count(), 100);
+  EXPECT_EQ(recording_histogram->Sum(), 5050.);
+  EXPECT_EQ(recording_histogram->Percentile(0.), 1.);
+  EXPECT_EQ(recording_histogram->Percentile(0.5), 50.);
+  EXPECT_EQ(recording_histogram->Percentile(0.99), 99.);
+  EXPECT_EQ(recording_histogram->Percentile(1.), 100.);
+}
+
+}  // namespace
+}  // namespace metrics
+}  // namespace cartographer
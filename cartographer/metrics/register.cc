@@ -16,6 +16,7 @@
 
 #include "cartographer/metrics/register.h"
 
+#include "cartographer/common/thread_pool.h"
 #include "cartographer/mapping/internal/2d/local_trajectory_builder_2d.h"
 #include "cartographer/mapping/internal/2d/pose_graph_2d.h"
 #include "cartographer/mapping/internal/3d/local_trajectory_builder_3d.h"
@@ -29,6 +30,7 @@ namespace cartographer {
 namespace metrics {
 
 void RegisterAllMetrics(FamilyFactory* registry) {
+  common::ThreadPoolInterface::RegisterMetrics(registry);
   mapping::constraints::ConstraintBuilder2D::RegisterMetrics(registry);
   mapping::constraints::ConstraintBuilder3D::RegisterMetrics(registry);
   mapping::GlobalTrajectoryBuilderRegisterMetrics(registry);
@@ -16,24 +16,264 @@
 
 #include "cartographer/sensor/compressed_point_cloud.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "cartographer/common/math.h"
 #include "cartographer/mapping/3d/hybrid_grid.h"
 
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CARTOGRAPHER_SENSOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
 namespace cartographer {
 namespace sensor {
 
 namespace {
 
 // Points are encoded on a fixed grid with a grid spacing of 'kPrecision' with
-// integers. Points are organized in blocks, where each point is encoded
-// relative to the block's origin in an int32 with 'kBitsPerCoordinate' bits per
-// coordinate.
+// integers, and are organized in blocks of grid cells.
+//
+// In the fixed bit rate encoding, blocks are 2^'kBitsPerCoordinate' grid cells
+// wide and each point is encoded relative to the block's origin in an int32
+// with 'kBitsPerCoordinate' bits per coordinate.
+//
+// In the bit-packed encoding, blocks are 2^'kBitPackedBlockBits' grid cells
+// wide, so that sparse point clouds only need few blocks. A block starts with
+// a header of 'kBitPackedBlockHeaderSize' words: the number of points and the
+// bit widths of the coordinates, the block coordinates, and the minimum of
+// each coordinate over the points of the block. The points follow, each
+// encoded as the differences to the minimum using the bit widths, packed back
+// to back with the least significant bit first. Two padding words after the
+// last block allow reading 64 bits at any bit offset inside a block.
 constexpr float kPrecision = 0.001f;  // in meters.
 constexpr int kBitsPerCoordinate = 10;
 constexpr int kCoordinateMask = (1 << kBitsPerCoordinate) - 1;
 constexpr int kMaxBitsPerDirection = 23;
+constexpr int kBitPackedBlockBits = 14;
+constexpr int kBitPackedBlockMask = (1 << kBitPackedBlockBits) - 1;
+constexpr int kBitPackedBlockHeaderSize = 6;
+constexpr int kNumPaddingWords = 2;
+constexpr int kNumPointsBits = 20;
+constexpr int kBitWidthBits = 4;
+constexpr int kMaxPointsPerBitPackedBlock = (1 << kNumPointsBits) - 1;
+
+struct RasterPoint {
+  Eigen::Array3i point;
+  int index;
+};
+
+struct BitPackedBlockHeader {
+  explicit BitPackedBlockHeader(const uint32* const input) {
+    num_points = input[0] & kMaxPointsPerBitPackedBlock;
+    const int min[3] = {static_cast<int>(input[4] & 0xffff),
+                        static_cast<int>(input[4] >> 16),
+                        static_cast<int>(input[5])};
+    bits_per_point = 0;
+    for (int i = 0; i < 3; ++i) {
+      bit_widths[i] = (input[0] >> (kNumPointsBits + i * kBitWidthBits)) &
+                      ((1 << kBitWidthBits) - 1);
+      bits_per_point += bit_widths[i];
+      origin[i] =
+          static_cast<int32>(input[1 + i]) * (1 << kBitPackedBlockBits) +
+          min[i];
+    }
+  }
+
+  // Number of words following the header.
+  int num_data_words() const {
+    return (static_cast<int64>(num_points) * bits_per_point + 31) / 32;
+  }
+
+  int num_points;
+  int bit_widths[3];
+  int bits_per_point;
+  // In units of 'kPrecision'.
+  Eigen::Vector3i origin;
+};
+
+int BitWidth(const int value) {
+  int width = 0;
+  while ((value >> width) != 0) {
+    ++width;
+  }
+  return width;
+}
+
+// Returns the 64 bits starting at 'bit_offset' in 'data'.
+inline uint64 ReadBits(const uint32* const data, const int64 bit_offset) {
+  const uint32* const word = data + (bit_offset >> 5);
+  const int shift = bit_offset & 31;
+  const uint64 low = word[0] | (static_cast<uint64>(word[1]) << 32);
+  // Shifting in two steps avoids shifting by 64 if 'shift' is zero.
+  return (low >> shift) |
+         ((static_cast<uint64>(word[2]) << 31) << (33 - shift));
+}
+
+// Returns the point encoded in the lowest bits of 'code'.
+inline Eigen::Vector3f DecodeBitPackedPoint(const Eigen::Vector3i& origin,
+                                            const int* const bit_widths,
+                                            uint64 code) {
+  Eigen::Vector3f point;
+  for (int i = 0; i < 3; ++i) {
+    const int delta = code & ((uint64{1} << bit_widths[i]) - 1);
+    point[i] = (origin[i] + delta) * kPrecision;
+    code >>= bit_widths[i];
+  }
+  return point;
+}
+
+void AppendBitPackedBlock(const Eigen::Array3i& block_coordinate,
+                          const RasterPoint* const begin,
+                          const RasterPoint* const end,
+                          std::vector<uint32>* const point_data) {
+  Eigen::Array3i min = begin->point;
+  Eigen::Array3i max = begin->point;
+  for (const RasterPoint* it = begin; it != end; ++it) {
+    min = min.min(it->point);
+    max = max.max(it->point);
+  }
+  int bit_widths[3];
+  uint32 header = end - begin;
+  for (int i = 0; i < 3; ++i) {
+    bit_widths[i] = BitWidth(max[i] - min[i]);
+    header |= static_cast<uint32>(bit_widths[i])
+              << (kNumPointsBits + i * kBitWidthBits);
+  }
+  point_data->push_back(header);
+  for (int i = 0; i < 3; ++i) {
+    point_data->push_back(static_cast<uint32>(block_coordinate[i]));
+  }
+  point_data->push_back(min.x() | (min.y() << 16));
+  point_data->push_back(min.z());
+
+  uint64 buffer = 0;
+  int num_buffered_bits = 0;
+  for (const RasterPoint* it = begin; it != end; ++it) {
+    for (int i = 0; i < 3; ++i) {
+      buffer |= static_cast<uint64>(it->point[i] - min[i]) << num_buffered_bits;
+      num_buffered_bits += bit_widths[i];
+      if (num_buffered_bits >= 32) {
+        point_data->push_back(static_cast<uint32>(buffer));
+        buffer >>= 32;
+        num_buffered_bits -= 32;
+      }
+    }
+  }
+  if (num_buffered_bits > 0) {
+    point_data->push_back(static_cast<uint32>(buffer));
+  }
+}
+
+void DecodeBitPackedBlockScalar(const BitPackedBlockHeader& header,
+                                const uint32* const data, const int begin,
+                                RangefinderPoint* const points) {
+  if (header.bits_per_point == 0) {
+    // All points are at the origin, e.g. for blocks holding a single point.
+    const Eigen::Vector3f origin = header.origin.cast<float>() * kPrecision;
+    std::fill(points + begin, points + header.num_points,
+              RangefinderPoint{origin});
+    return;
+  }
+  const uint64 mask_x = (uint64{1} << header.bit_widths[0]) - 1;
+  const uint64 mask_y = (uint64{1} << header.bit_widths[1]) - 1;
+  const uint64 mask_z = (uint64{1} << header.bit_widths[2]) - 1;
+  const int shift_y = header.bit_widths[0];
+  const int shift_z = header.bit_widths[0] + header.bit_widths[1];
+  int64 bit_offset = static_cast<int64>(begin) * header.bits_per_point;
+  for (int i = begin; i < header.num_points; ++i) {
+    const uint64 code = ReadBits(data, bit_offset);
+    bit_offset += header.bits_per_point;
+    points[i].position = Eigen::Vector3f(
+        (header.origin[0] + static_cast<int>(code & mask_x)) * kPrecision,
+        (header.origin[1] + static_cast<int>((code >> shift_y) & mask_y)) *
+            kPrecision,
+        (header.origin[2] + static_cast<int>((code >> shift_z) & mask_z)) *
+            kPrecision);
+  }
+}
+
+#ifdef CARTOGRAPHER_SENSOR_X86_KERNELS
+
+static_assert(sizeof(RangefinderPoint) == 3 * sizeof(float),
+              "RangefinderPoint is expected to be three packed floats.");
+
+// Decodes 4 points per iteration: the words holding each code are gathered,
+// the codes are shifted into place, split into coordinates and converted to
+// floats. Returns the number of decoded points, a multiple of 4.
+__attribute__((target("avx2"))) int DecodeBitPackedBlockAvx2(
+    const BitPackedBlockHeader& header, const uint32* const data,
+    RangefinderPoint* const points) {
+  const long long* const words = reinterpret_cast<const long long*>(data);
+  const int* const third_words = reinterpret_cast<const int*>(data + 2);
+  const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+  const __m128i bits_per_point = _mm_set1_epi32(header.bits_per_point);
+  const __m256i sixty_four = _mm256_set1_epi64x(64);
+  const __m256i even_lanes = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const __m128 precision = _mm_set1_ps(kPrecision);
+  __m256i shifts[3];
+  __m256i masks[3];
+  __m128i origins[3];
+  for (int i = 0, shift = 0; i < 3; shift += header.bit_widths[i++]) {
+    shifts[i] = _mm256_set1_epi64x(shift);
+    masks[i] = _mm256_set1_epi64x((int64{1} << header.bit_widths[i]) - 1);
+    origins[i] = _mm_set1_epi32(header.origin[i]);
+  }
+  const int num_batched = header.num_points - header.num_points % 4;
+  for (int i = 0; i < num_batched; i += 4) {
+    const __m128i bit_offsets = _mm_mullo_epi32(
+        _mm_add_epi32(_mm_set1_epi32(i), lanes), bits_per_point);
+    const __m128i word_indices = _mm_srli_epi32(bit_offsets, 5);
+    const __m256i bit_shifts = _mm256_cvtepu32_epi64(
+        _mm_and_si128(bit_offsets, _mm_set1_epi32(31)));
+    const __m256i low = _mm256_i32gather_epi64(words, word_indices, 4);
+    const __m256i high = _mm256_cvtepu32_epi64(
+        _mm_i32gather_epi32(third_words, word_indices, 4));
+    // A shift by 64 yields zero, which is what we need for aligned codes.
+    const __m256i codes = _mm256_or_si256(
+        _mm256_srlv_epi64(low, bit_shifts),
+        _mm256_sllv_epi64(high, _mm256_sub_epi64(sixty_four, bit_shifts)));
+    __m128 coordinates[4];
+    for (int j = 0; j < 3; ++j) {
+      const __m256i delta =
+          _mm256_and_si256(_mm256_srlv_epi64(codes, shifts[j]), masks[j]);
+      const __m128i delta32 = _mm256_castsi256_si128(
+          _mm256_permutevar8x32_epi32(delta, even_lanes));
+      coordinates[j] = _mm_mul_ps(
+          _mm_cvtepi32_ps(_mm_add_epi32(origins[j], delta32)), precision);
+    }
+    coordinates[3] = _mm_setzero_ps();
+    _MM_TRANSPOSE4_PS(coordinates[0], coordinates[1], coordinates[2],
+                      coordinates[3]);
+    // Each store also writes the x coordinate of the next point, which is
+    // overwritten right after. The last point is stored without it.
+    float* const output = reinterpret_cast<float*>(points + i);
+    _mm_storeu_ps(output, coordinates[0]);
+    _mm_storeu_ps(output + 3, coordinates[1]);
+    _mm_storeu_ps(output + 6, coordinates[2]);
+    _mm_storel_pi(reinterpret_cast<__m64*>(output + 9), coordinates[3]);
+    _mm_store_ss(output + 11, _mm_movehl_ps(coordinates[3], coordinates[3]));
+  }
+  return num_batched;
+}
+
+#endif  // CARTOGRAPHER_SENSOR_X86_KERNELS
+
+void DecodeBitPackedBlock(const BitPackedBlockHeader& header,
+                          const uint32* const data,
+                          RangefinderPoint* const points) {
+  int num_decoded = 0;
+#ifdef CARTOGRAPHER_SENSOR_X86_KERNELS
+  static const bool kAvx2Supported = __builtin_cpu_supports("avx2");
+  // Blocks of sparse point clouds often hold only a few points, these are
+  // decoded without switching to AVX2.
+  if (kAvx2Supported && header.bits_per_point > 0 && header.num_points >= 8) {
+    num_decoded = DecodeBitPackedBlockAvx2(header, data, points);
+  }
+#endif
+  DecodeBitPackedBlockScalar(header, data, num_decoded, points);
+}
 
 }  // namespace
 
@@ -42,6 +282,8 @@ CompressedPointCloud::ConstIterator::ConstIterator(
     : compressed_point_cloud_(compressed_point_cloud),
       remaining_points_(compressed_point_cloud->num_points_),
       remaining_points_in_current_block_(0),
+      current_block_data_(nullptr),
+      current_bit_offset_(0),
       input_(compressed_point_cloud->point_data_.begin()) {
   if (remaining_points_ > 0) {
     ReadNextPoint();
@@ -77,10 +319,20 @@ bool CompressedPointCloud::ConstIterator::operator!=(
 }
 
 void CompressedPointCloud::ConstIterator::ReadNextPoint() {
+  if (compressed_point_cloud_->version_ ==
+      proto::CompressedPointCloud::FIXED_BIT_RATE) {
+    ReadNextFixedBitRatePoint();
+  } else {
+    ReadNextBitPackedPoint();
+  }
+}
+
+void CompressedPointCloud::ConstIterator::ReadNextFixedBitRatePoint() {
   if (remaining_points_in_current_block_ == 0) {
     remaining_points_in_current_block_ = *input_++;
     for (int i = 0; i < 3; ++i) {
-      current_block_coordinates_[i] = *input_++ << kBitsPerCoordinate;
+      current_block_coordinates_[i] = static_cast<int32>(*input_++)
+                                      << kBitsPerCoordinate;
     }
   }
   --remaining_points_in_current_block_;
@@ -96,13 +348,31 @@ void CompressedPointCloud::ConstIterator::ReadNextPoint() {
       kPrecision;
 }
 
+void CompressedPointCloud::ConstIterator::ReadNextBitPackedPoint() {
+  if (remaining_points_in_current_block_ == 0) {
+    const BitPackedBlockHeader header(&*input_);
+    remaining_points_in_current_block_ = header.num_points;
+    current_block_coordinates_ = header.origin;
+    std::copy_n(header.bit_widths, 3, current_bit_widths_);
+    current_block_data_ = &*input_ + kBitPackedBlockHeaderSize;
+    current_bit_offset_ = 0;
+    input_ += kBitPackedBlockHeaderSize + header.num_data_words();
+  }
+  --remaining_points_in_current_block_;
+  const int bits_per_point =
+      current_bit_widths_[0] + current_bit_widths_[1] + current_bit_widths_[2];
+  const uint64 code = bits_per_point == 0
+                          ? 0
+                          : ReadBits(current_block_data_, current_bit_offset_);
+  current_bit_offset_ += bits_per_point;
+  current_point_ = DecodeBitPackedPoint(current_block_coordinates_,
+                                        current_bit_widths_, code);
+}
+
 CompressedPointCloud::CompressedPointCloud(const PointCloud& point_cloud)
-    : num_points_(point_cloud.size()) {
+    : num_points_(point_cloud.size()),
+      version_(proto::CompressedPointCloud::BIT_PACKED_BLOCKS) {
   // Distribute points into blocks.
-  struct RasterPoint {
-    Eigen::Array3i point;
-    int index;
-  };
   using Blocks = mapping::HybridGridBase<std::vector<RasterPoint>>;
   Blocks blocks(kPrecision);
   int num_blocks = 0;
@@ -117,42 +387,48 @@ CompressedPointCloud::CompressedPointCloud(const PointCloud& point_cloud)
     Eigen::Array3i block_coordinate;
     for (int i = 0; i < 3; ++i) {
       raster_point[i] = common::RoundToInt(point.position[i] / kPrecision);
-      block_coordinate[i] = raster_point[i] >> kBitsPerCoordinate;
-      raster_point[i] &= kCoordinateMask;
+      block_coordinate[i] = raster_point[i] >> kBitPackedBlockBits;
+      raster_point[i] &= kBitPackedBlockMask;
     }
     auto* const block = blocks.mutable_value(block_coordinate);
     num_blocks += block->empty();
     block->push_back({raster_point, point_index});
   }
 
-  // Encode blocks.
-  point_data_.reserve(4 * num_blocks + point_cloud.size());
+  // Encode blocks. Blocks with too many points for the header are split.
+  point_data_.reserve(kBitPackedBlockHeaderSize * num_blocks +
+                      2 * point_cloud.size() + kNumPaddingWords);
   for (Blocks::Iterator it(blocks); !it.Done(); it.Next(), --num_blocks) {
     const auto& raster_points = it.GetValue();
-    CHECK_LE(raster_points.size(), std::numeric_limits<int32>::max());
-    point_data_.push_back(raster_points.size());
-    const Eigen::Array3i block_coordinate = it.GetCellIndex();
-    point_data_.push_back(block_coordinate.x());
-    point_data_.push_back(block_coordinate.y());
-    point_data_.push_back(block_coordinate.z());
-    for (const RasterPoint& raster_point : raster_points) {
-      point_data_.push_back((((raster_point.point.z() << kBitsPerCoordinate) +
-                              raster_point.point.y())
-                             << kBitsPerCoordinate) +
-                            raster_point.point.x());
+    for (size_t begin = 0; begin < raster_points.size();
+         begin += kMaxPointsPerBitPackedBlock) {
+      const size_t end = std::min(raster_points.size(),
+                                  begin + kMaxPointsPerBitPackedBlock);
+      AppendBitPackedBlock(it.GetCellIndex(), raster_points.data() + begin,
+                           raster_points.data() + end, &point_data_);
     }
   }
   CHECK_EQ(num_blocks, 0);
+  if (num_points_ > 0) {
+    point_data_.resize(point_data_.size() + kNumPaddingWords, 0);
+  }
 }
 
 CompressedPointCloud::CompressedPointCloud(
     const proto::CompressedPointCloud& proto) {
   num_points_ = proto.num_points();
-  const int data_size = proto.point_data_size();
-  point_data_.reserve(data_size);
+  version_ = proto.version();
   // TODO(wohe): Verify that 'point_data_' does not contain malformed data.
-  for (int i = 0; i != data_size; ++i) {
-    point_data_.emplace_back(proto.point_data(i));
+  if (version_ == proto::CompressedPointCloud::FIXED_BIT_RATE) {
+    const int data_size = proto.point_data_size();
+    point_data_.reserve(data_size);
+    for (int i = 0; i != data_size; ++i) {
+      point_data_.emplace_back(static_cast<uint32>(proto.point_data(i)));
+    }
+  } else {
+    CHECK_EQ(version_, proto::CompressedPointCloud::BIT_PACKED_BLOCKS);
+    point_data_.assign(proto.packed_point_data().begin(),
+                       proto.packed_point_data().end());
   }
 }
 
@@ -169,24 +445,49 @@ CompressedPointCloud::ConstIterator CompressedPointCloud::end() const {
 }
 
 PointCloud CompressedPointCloud::Decompress() const {
-  PointCloud decompressed;
-  for (const RangefinderPoint& point : *this) {
-    decompressed.push_back(point);
+  std::vector<RangefinderPoint> points(num_points_);
+  Decompress(absl::MakeSpan(points));
+  return PointCloud(std::move(points));
+}
+
+void CompressedPointCloud::Decompress(
+    const absl::Span<RangefinderPoint> points) const {
+  CHECK_EQ(points.size(), num_points_);
+  if (version_ == proto::CompressedPointCloud::FIXED_BIT_RATE) {
+    std::copy(begin(), end(), points.begin());
+    return;
+  }
+  const uint32* input = point_data_.data();
+  for (size_t num_decoded = 0; num_decoded < num_points_;) {
+    const BitPackedBlockHeader header(input);
+    input += kBitPackedBlockHeaderSize;
+    CHECK_LE(num_decoded + header.num_points, num_points_);
+    DecodeBitPackedBlock(header, input, points.data() + num_decoded);
+    input += header.num_data_words();
+    num_decoded += header.num_points;
   }
-  return decompressed;
 }
 
 bool CompressedPointCloud::operator==(
     const CompressedPointCloud& right_hand_container) const {
   return point_data_ == right_hand_container.point_data_ &&
-         num_points_ == right_hand_container.num_points_;
+         num_points_ == right_hand_container.num_points_ &&
+         version_ == right_hand_container.version_;
 }
 
 proto::CompressedPointCloud CompressedPointCloud::ToProto() const {
   proto::CompressedPointCloud result;
   result.set_num_points(num_points_);
-  for (const int32 data : point_data_) {
-    result.add_point_data(data);
+  result.set_version(version_);
+  if (version_ == proto::CompressedPointCloud::FIXED_BIT_RATE) {
+    for (const uint32 data : point_data_) {
+      result.add_point_data(static_cast<int32>(data));
+    }
+  } else {
+    result.mutable_packed_point_data()->Reserve(point_data_.size());
+    for (const uint32 data : point_data_) {
+      result.add_packed_point_data(data);
+    }
   }
   return result;
 }
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "benchmark/benchmark.h"
+#include "cartographer/sensor/compressed_point_cloud.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+// Points on the ground and on the walls of a 20 m x 20 m room, similar to a
+// voxel filtered 3D scan.
+PointCloud GenerateScan(const int num_points) {
+  std::mt19937 prng(42);
+  std::uniform_real_distribution<float> distribution(-10.f, 10.f);
+  std::uniform_real_distribution<float> height_distribution(0.f, 3.f);
+  PointCloud point_cloud;
+  for (int i = 0; i < num_points; ++i) {
+    const float u = distribution(prng);
+    const float v = distribution(prng);
+    switch (i % 4) {
+      case 0:
+      case 1:
+        point_cloud.push_back({Eigen::Vector3f(u, v, 0.f)});
+        break;
+      case 2:
+        point_cloud.push_back(
+            {Eigen::Vector3f(u, 10.f, height_distribution(prng))});
+        break;
+      case 3:
+        point_cloud.push_back(
+            {Eigen::Vector3f(-10.f, v, height_distribution(prng))});
+        break;
+    }
+  }
+  return point_cloud;
+}
+
+void BM_Compress(benchmark::State& state) {
+  const PointCloud point_cloud = GenerateScan(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CompressedPointCloud(point_cloud));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_per_point"] =
+      static_cast<double>(
+          CompressedPointCloud(point_cloud).ToProto().ByteSizeLong()) /
+      state.range(0);
+}
+BENCHMARK(BM_Compress)->Arg(1000)->Arg(10000);
+
+void BM_DecompressIterating(benchmark::State& state) {
+  const CompressedPointCloud compressed(GenerateScan(state.range(0)));
+  std::vector<RangefinderPoint> points;
+  for (auto _ : state) {
+    points.clear();
+    for (const RangefinderPoint& point : compressed) {
+      points.push_back(point);
+    }
+    benchmark::DoNotOptimize(points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DecompressIterating)->Arg(1000)->Arg(10000);
+
+void BM_DecompressIntoBuffer(benchmark::State& state) {
+  const CompressedPointCloud compressed(GenerateScan(state.range(0)));
+  std::vector<RangefinderPoint> points(compressed.size());
+  for (auto _ : state) {
+    compressed.Decompress(absl::MakeSpan(points));
+    benchmark::DoNotOptimize(points.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DecompressIntoBuffer)->Arg(1000)->Arg(10000);
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
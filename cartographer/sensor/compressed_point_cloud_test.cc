@@ -16,6 +16,8 @@
 
 #include "cartographer/sensor/compressed_point_cloud.h"
 
+#include <random>
+
 #include "gmock/gmock.h"
 
 namespace Eigen {
@@ -38,6 +40,7 @@ using ::testing::FloatNear;
 using ::testing::PrintToString;
 
 constexpr float kPrecision = 0.001f;
+constexpr int kBitsPerCoordinate = 10;
 
 // Matcher for 3-d vectors w.r.t. to the target precision.
 MATCHER_P(ApproximatelyEquals, expected,
@@ -117,6 +120,71 @@ TEST(CompressPointCloudTest, CompressesNoGaps) {
   }
 }
 
+TEST(CompressPointCloudTest, BulkDecompressionMatchesIteration) {
+  std::mt19937 prng(42);
+  std::uniform_real_distribution<float> distribution(-3.f, 3.f);
+  PointCloud point_cloud;
+  for (int i = 0; i < 1000; ++i) {
+    point_cloud.push_back({Eigen::Vector3f(
+        distribution(prng), distribution(prng), 0.1f * distribution(prng))});
+  }
+  // Points sharing a block with identical coordinates need no bits at all.
+  for (int i = 0; i < 20; ++i) {
+    point_cloud.push_back({Eigen::Vector3f(100.f, 100.f, 100.f)});
+  }
+  const CompressedPointCloud compressed(point_cloud);
+  std::vector<RangefinderPoint> decompressed(compressed.size());
+  compressed.Decompress(absl::MakeSpan(decompressed));
+  std::vector<RangefinderPoint> iterated(compressed.begin(), compressed.end());
+  ASSERT_EQ(point_cloud.size(), iterated.size());
+  EXPECT_EQ(iterated, decompressed);
+  for (const RangefinderPoint& point : point_cloud) {
+    EXPECT_THAT(decompressed, Contains(ApproximatelyEquals(point.position)));
+  }
+}
+
+TEST(CompressPointCloudTest, RoundTripsThroughProto) {
+  PointCloud point_cloud;
+  for (int i = 0; i < 100; ++i) {
+    point_cloud.push_back({Eigen::Vector3f(0.01f * i, -0.02f * i, 0.5f)});
+  }
+  const CompressedPointCloud compressed(point_cloud);
+  const proto::CompressedPointCloud proto = compressed.ToProto();
+  EXPECT_EQ(proto::CompressedPointCloud::BIT_PACKED_BLOCKS, proto.version());
+  EXPECT_EQ(0, proto.point_data_size());
+  // Less than the one word per point of the fixed bit rate encoding.
+  EXPECT_LT(proto.packed_point_data_size(), 100);
+  const CompressedPointCloud loaded(proto);
+  EXPECT_TRUE(loaded == compressed);
+  EXPECT_EQ(compressed.Decompress().points(), loaded.Decompress().points());
+}
+
+TEST(CompressPointCloudTest, LoadsFixedBitRateProto) {
+  // Written before the encoding was versioned: a single block at block
+  // coordinates (0, 0, -1) with two points.
+  proto::CompressedPointCloud proto;
+  proto.set_num_points(2);
+  const auto encode = [](int x, int y, int z) {
+    return (((z << kBitsPerCoordinate) + y) << kBitsPerCoordinate) + x;
+  };
+  for (const int32 data :
+       {2, 0, 0, -1, encode(1, 2, 1021), encode(1023, 0, 1023)}) {
+    proto.add_point_data(data);
+  }
+  const CompressedPointCloud compressed(proto);
+  EXPECT_EQ(2, compressed.size());
+  const PointCloud decompressed = compressed.Decompress();
+  ASSERT_EQ(2, decompressed.size());
+  EXPECT_THAT(decompressed[0],
+              ApproximatelyEquals(Eigen::Vector3f(0.001f, 0.002f, -0.003f)));
+  EXPECT_THAT(decompressed[1],
+              ApproximatelyEquals(Eigen::Vector3f(1.023f, 0.f, -0.001f)));
+  const proto::CompressedPointCloud reserialized = compressed.ToProto();
+  EXPECT_EQ(proto::CompressedPointCloud::FIXED_BIT_RATE,
+            reserialized.version());
+  EXPECT_TRUE(CompressedPointCloud(reserialized) == compressed);
+}
+
 }  // namespace
 }  // namespace sensor
 }  // namespace cartographer
@@ -30,7 +30,7 @@ namespace {
 
 // Number of items that can be queued up before we log which queues are waiting
 // for data.
-const int kMaxQueueSize = 500;
+const size_t kMaxQueueSize = 500;
 
 }  // namespace
 
@@ -48,7 +48,14 @@ OrderedMultiQueue::~OrderedMultiQueue() {
 
 void OrderedMultiQueue::AddQueue(const QueueKey& queue_key, Callback callback) {
   CHECK_EQ(queues_.count(queue_key), 0);
-  queues_[queue_key].callback = std::move(callback);
+  auto it = queues_
+                .emplace(std::piecewise_construct,
+                         std::forward_as_tuple(queue_key),
+                         std::forward_as_tuple())
+                .first;
+  it->second.callback = std::move(callback);
+  it->second.key = &it->first;
+  empty_queues_.insert(queue_key);
 }
 
 void OrderedMultiQueue::MarkQueueAsFinished(const QueueKey& queue_key) {
@@ -57,6 +64,11 @@ void OrderedMultiQueue::MarkQueueAsFinished(const QueueKey& queue_key) {
   auto& queue = it->second;
   CHECK(!queue.finished);
   queue.finished = true;
+  if (queue.heap_index == -1) {
+    // Nothing left to dispatch from this queue.
+    empty_queues_.erase(queue_key);
+    queues_.erase(it);
+  }
   Dispatch();
 }
 
@@ -68,7 +80,17 @@ void OrderedMultiQueue::Add(const QueueKey& queue_key,
         << "Ignored data for queue: '" << queue_key << "'";
     return;
   }
-  it->second.queue.Push(std::move(data));
+  Queue& queue = it->second;
+  const common::Time time = data->GetTime();
+  queue.queue.Push(std::move(data));
+  if (queue.queue.Size() == kMaxQueueSize + 1) {
+    ++num_oversized_queues_;
+  }
+  if (queue.heap_index == -1) {
+    queue.head_time = time;
+    empty_queues_.erase(queue_key);
+    HeapPush(&queue);
+  }
   Dispatch();
 }
 
@@ -91,32 +113,19 @@ QueueKey OrderedMultiQueue::GetBlocker() const {
 
 void OrderedMultiQueue::Dispatch() {
   while (true) {
-    const Data* next_data = nullptr;
-    Queue* next_queue = nullptr;
-    QueueKey next_queue_key;
-    for (auto it = queues_.begin(); it != queues_.end();) {
-      const auto* data = it->second.queue.Peek<Data>();
-      if (data == nullptr) {
-        if (it->second.finished) {
-          queues_.erase(it++);
-          continue;
-        }
-        CannotMakeProgress(it->first);
-        return;
-      }
-      if (next_data == nullptr || data->GetTime() < next_data->GetTime()) {
-        next_data = data;
-        next_queue = &it->second;
-        next_queue_key = it->first;
-      }
-      CHECK_LE(last_dispatched_time_, next_data->GetTime())
-          << "Non-sorted data added to queue: '" << it->first << "'";
-      ++it;
+    if (!empty_queues_.empty()) {
+      CannotMakeProgress(*empty_queues_.begin());
+      return;
     }
-    if (next_data == nullptr) {
+    if (heap_.empty()) {
       CHECK(queues_.empty());
       return;
     }
+    Queue* const next_queue = heap_.front();
+    const QueueKey next_queue_key = *next_queue->key;
+    const Data* next_data = next_queue->queue.Peek<Data>();
+    CHECK_LE(last_dispatched_time_, next_data->GetTime())
+        << "Non-sorted data added to queue: '" << next_queue_key << "'";
 
     // If we haven't dispatched any data for this trajectory yet, fast forward
     // all queues of this trajectory until a common start time has been reached.
@@ -126,7 +135,7 @@ void OrderedMultiQueue::Dispatch() {
     if (next_data->GetTime() >= common_start_time) {
       // Happy case, we are beyond the 'common_start_time' already.
       last_dispatched_time_ = next_data->GetTime();
-      next_queue->callback(next_queue->queue.Pop());
+      next_queue->callback(PopFromQueue(next_queue));
     } else if (next_queue->queue.Size() < 2) {
       if (!next_queue->finished) {
         // We cannot decide whether to drop or dispatch this yet.
@@ -134,27 +143,46 @@ void OrderedMultiQueue::Dispatch() {
         return;
       }
       last_dispatched_time_ = next_data->GetTime();
-      next_queue->callback(next_queue->queue.Pop());
+      next_queue->callback(PopFromQueue(next_queue));
     } else {
       // We take a peek at the time after next data. If it also is not beyond
       // 'common_start_time' we drop 'next_data', otherwise we just found the
       // first packet to dispatch from this queue.
-      std::unique_ptr<Data> next_data_owner = next_queue->queue.Pop();
-      if (next_queue->queue.Peek<Data>()->GetTime() > common_start_time) {
+      std::unique_ptr<Data> next_data_owner = PopFromQueue(next_queue);
+      if (next_queue->head_time > common_start_time) {
         last_dispatched_time_ = next_data->GetTime();
         next_queue->callback(std::move(next_data_owner));
       }
     }
+    if (next_queue->finished && next_queue->heap_index == -1) {
+      queues_.erase(next_queue_key);
+    }
   }
 }
 
+std::unique_ptr<Data> OrderedMultiQueue::PopFromQueue(Queue* const queue) {
+  CHECK_NE(queue->heap_index, -1);
+  if (queue->queue.Size() == kMaxQueueSize + 1) {
+    --num_oversized_queues_;
+  }
+  std::unique_ptr<Data> data = queue->queue.Pop();
+  const Data* const next_data = queue->queue.Peek<Data>();
+  if (next_data != nullptr) {
+    queue->head_time = next_data->GetTime();
+    HeapSiftDown(queue->heap_index);
+    return data;
+  }
+  HeapRemove(queue);
+  if (!queue->finished) {
+    empty_queues_.insert(*queue->key);
+  }
+  return data;
+}
+
 void OrderedMultiQueue::CannotMakeProgress(const QueueKey& queue_key) {
   blocker_ = queue_key;
-  for (auto& entry : queues_) {
-    if (entry.second.queue.Size() > kMaxQueueSize) {
-      LOG_EVERY_N(WARNING, 60) << "Queue waiting for data: " << queue_key;
-      return;
-    }
+  if (num_oversized_queues_ > 0) {
+    LOG_EVERY_N(WARNING, 60) << "Queue waiting for data: " << queue_key;
   }
 }
 
@@ -175,5 +203,71 @@ common::Time OrderedMultiQueue::GetCommonStartTime(const int trajectory_id) {
   return common_start_time;
 }
 
+bool OrderedMultiQueue::HeapLess(const Queue* const a, const Queue* const b) {
+  if (a->head_time != b->head_time) {
+    return a->head_time < b->head_time;
+  }
+  return *a->key < *b->key;
+}
+
+void OrderedMultiQueue::HeapPush(Queue* const queue) {
+  CHECK_EQ(queue->heap_index, -1);
+  heap_.push_back(queue);
+  queue->heap_index = heap_.size() - 1;
+  HeapSiftUp(queue->heap_index);
+}
+
+void OrderedMultiQueue::HeapRemove(Queue* const queue) {
+  const int index = queue->heap_index;
+  CHECK_NE(index, -1);
+  queue->heap_index = -1;
+  Queue* const last = heap_.back();
+  heap_.pop_back();
+  if (last == queue) {
+    return;
+  }
+  HeapSet(index, last);
+  HeapSiftUp(index);
+  HeapSiftDown(last->heap_index);
+}
+
+void OrderedMultiQueue::HeapSiftUp(int index) {
+  Queue* const queue = heap_[index];
+  while (index > 0) {
+    const int parent = (index - 1) / 2;
+    if (!HeapLess(queue, heap_[parent])) {
+      break;
+    }
+    HeapSet(index, heap_[parent]);
+    index = parent;
+  }
+  HeapSet(index, queue);
+}
+
+void OrderedMultiQueue::HeapSiftDown(int index) {
+  Queue* const queue = heap_[index];
+  const int size = heap_.size();
+  while (true) {
+    int child = 2 * index + 1;
+    if (child >= size) {
+      break;
+    }
+    if (child + 1 < size && HeapLess(heap_[child + 1], heap_[child])) {
+      ++child;
+    }
+    if (!HeapLess(heap_[child], queue)) {
+      break;
+    }
+    HeapSet(index, heap_[child]);
+    index = child;
+  }
+  HeapSet(index, queue);
+}
+
+void OrderedMultiQueue::HeapSet(const int index, Queue* const queue) {
+  heap_[index] = queue;
+  queue->heap_index = index;
+}
+
 }  // namespace sensor
 }  // namespace cartographer
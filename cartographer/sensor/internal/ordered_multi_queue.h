@@ -20,8 +20,10 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
+#include <vector>
 
 #include "cartographer/common/internal/blocking_queue.h"
 #include "cartographer/common/port.h"
@@ -45,6 +47,9 @@ struct QueueKey {
 // sorted order. It will wait to see at least one value for each unfinished
 // queue before dispatching the next time ordered value across all queues.
 //
+// Non-empty queues are kept in a binary min-heap keyed by the time of their
+// first value, so dispatching a value costs O(log(number of queues)).
+//
 // This class is thread-compatible.
 class OrderedMultiQueue {
  public:
@@ -81,17 +86,40 @@ class OrderedMultiQueue {
     common::BlockingQueue<std::unique_ptr<Data>> queue;
     Callback callback;
     bool finished = false;
+    // Points to the key of this queue in 'queues_'.
+    const QueueKey* key = nullptr;
+    // Time of the first value in 'queue', only valid if it is not empty.
+    common::Time head_time;
+    // Position in 'heap_', or -1 if 'queue' is empty.
+    int heap_index = -1;
   };
 
   void Dispatch();
+  // Pops the first value of 'queue' and updates the heap. A finished queue
+  // which becomes empty has to be erased by the caller.
+  std::unique_ptr<Data> PopFromQueue(Queue* queue);
   void CannotMakeProgress(const QueueKey& queue_key);
   common::Time GetCommonStartTime(int trajectory_id);
 
+  // Orders queues by the time of their first value, ties are broken by key.
+  static bool HeapLess(const Queue* a, const Queue* b);
+  void HeapPush(Queue* queue);
+  void HeapRemove(Queue* queue);
+  void HeapSiftUp(int index);
+  void HeapSiftDown(int index);
+  void HeapSet(int index, Queue* queue);
+
   // Used to verify that values are dispatched in sorted order.
   common::Time last_dispatched_time_ = common::Time::min();
 
   std::map<int, common::Time> common_start_time_per_trajectory_;
   std::map<QueueKey, Queue> queues_;
+  // Min-heap of all non-empty queues.
+  std::vector<Queue*> heap_;
+  // Keys of all empty, unfinished queues. Dispatching waits for the first.
+  std::set<QueueKey> empty_queues_;
+  // Number of queues holding more than 'kMaxQueueSize' values.
+  int num_oversized_queues_ = 0;
   QueueKey blocker_;
 };
 
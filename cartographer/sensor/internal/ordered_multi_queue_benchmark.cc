@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "cartographer/sensor/imu_data.h"
+#include "cartographer/sensor/internal/ordered_multi_queue.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+constexpr int kNumSensorsPerTrajectory = 5;
+
+// Adds one value to each of 'state.range(0)' queues per round, like a server
+// receiving data from many trajectories with several sensors each.
+void BM_OrderedMultiQueueAdd(benchmark::State& state) {
+  const int num_queues = state.range(0);
+  OrderedMultiQueue queue;
+  std::vector<QueueKey> keys;
+  int64_t num_dispatched = 0;
+  for (int i = 0; i < num_queues; ++i) {
+    keys.push_back(QueueKey{i / kNumSensorsPerTrajectory,
+                            "sensor_" + std::to_string(
+                                            i % kNumSensorsPerTrajectory)});
+    queue.AddQueue(keys.back(), [&num_dispatched](std::unique_ptr<Data>) {
+      ++num_dispatched;
+    });
+  }
+  int64_t time = 0;
+  for (auto _ : state) {
+    for (const QueueKey& key : keys) {
+      queue.Add(key, MakeDispatchable(
+                         "imu", ImuData{common::FromUniversal(++time),
+                                        Eigen::Vector3d::Zero(),
+                                        Eigen::Vector3d::Zero()}));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_queues);
+  queue.Flush();
+  benchmark::DoNotOptimize(num_dispatched);
+}
+BENCHMARK(BM_OrderedMultiQueueAdd)->Arg(8)->Arg(64)->Arg(512)->Arg(1024);
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
@@ -16,6 +16,11 @@
 
 #include "cartographer/sensor/internal/ordered_multi_queue.h"
 
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/memory/memory.h"
@@ -111,6 +116,71 @@ TEST_F(OrderedMultiQueueTest, CommonStartTimePerTrajectory) {
   EXPECT_EQ(values_.size(), 4);
 }
 
+TEST_F(OrderedMultiQueueTest, GetBlocker) {
+  queue_.Add(kFirst, MakeImu(1));
+  EXPECT_EQ(queue_.GetBlocker().sensor_id, kSecond.sensor_id);
+  queue_.Add(kSecond, MakeImu(1));
+  EXPECT_EQ(queue_.GetBlocker().trajectory_id, kThird.trajectory_id);
+  queue_.Add(kThird, MakeImu(2));
+  // Of the two values at time 1, the one of 'kFirst' sorts first.
+  EXPECT_EQ(values_.size(), 1);
+  EXPECT_EQ(queue_.GetBlocker().sensor_id, kFirst.sensor_id);
+  EXPECT_EQ(queue_.GetBlocker().trajectory_id, kFirst.trajectory_id);
+  queue_.Flush();
+  EXPECT_EQ(values_.size(), 3);
+}
+
+TEST(OrderedMultiQueueManyQueuesTest, DispatchesInTimeAndKeyOrder) {
+  constexpr int kNumTrajectories = 20;
+  constexpr int kNumSensors = 30;
+  constexpr int kNumValuesPerQueue = 20;
+  OrderedMultiQueue queue;
+  std::vector<std::pair<common::Time, QueueKey>> dispatched;
+  std::vector<std::pair<QueueKey, int>> values_to_add;
+  std::mt19937 prng(42);
+  std::uniform_int_distribution<int> time_step(0, 3);
+  for (int trajectory_id = 0; trajectory_id < kNumTrajectories;
+       ++trajectory_id) {
+    for (int sensor = 0; sensor < kNumSensors; ++sensor) {
+      const QueueKey key{trajectory_id, "sensor_" + std::to_string(sensor)};
+      queue.AddQueue(key, [&dispatched, key](std::unique_ptr<Data> data) {
+        dispatched.emplace_back(data->GetTime(), key);
+      });
+      int time = 0;
+      for (int i = 0; i < kNumValuesPerQueue; ++i) {
+        values_to_add.emplace_back(key, time);
+        time += time_step(prng);
+      }
+    }
+  }
+  // Interleave the queues randomly, keeping each queue sorted.
+  std::shuffle(values_to_add.begin(), values_to_add.end(), prng);
+  std::map<QueueKey, std::vector<int>> times_per_queue;
+  for (const auto& key_and_time : values_to_add) {
+    times_per_queue[key_and_time.first].push_back(key_and_time.second);
+  }
+  std::map<QueueKey, size_t> next_index;
+  for (auto& entry : times_per_queue) {
+    std::sort(entry.second.begin(), entry.second.end());
+  }
+  for (const auto& key_and_time : values_to_add) {
+    const QueueKey& key = key_and_time.first;
+    const int time = times_per_queue[key][next_index[key]++];
+    queue.Add(key,
+              MakeDispatchable(
+                  "imu", ImuData{common::FromUniversal(time),
+                                 Eigen::Vector3d::Zero(),
+                                 Eigen::Vector3d::Zero()}));
+  }
+  queue.Flush();
+
+  ASSERT_EQ(dispatched.size(),
+            kNumTrajectories * kNumSensors * kNumValuesPerQueue);
+  for (size_t i = 1; i < dispatched.size(); ++i) {
+    EXPECT_FALSE(dispatched[i] < dispatched[i - 1]) << i;
+  }
+}
+
 }  // namespace
 }  // namespace sensor
 }  // namespace cartographer
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/sensor/internal/parallel_trajectory_collator.h"
+
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace sensor {
+
+namespace {
+
+// Maximum number of tasks waiting for a dispatch thread before producers
+// block, bounding memory if collation cannot keep up with the input.
+constexpr size_t kMaxQueuedTasksPerThread = 1000;
+
+}  // namespace
+
+ParallelTrajectoryCollator::ParallelTrajectoryCollator(const int num_threads) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i != num_threads; ++i) {
+    shards_.push_back(absl::make_unique<Shard>(kMaxQueuedTasksPerThread));
+    Shard* const shard = shards_.back().get();
+    shard->thread = std::thread([this, shard]() { Run(shard); });
+  }
+}
+
+ParallelTrajectoryCollator::~ParallelTrajectoryCollator() {
+  for (auto& shard : shards_) {
+    shard->tasks.Push(nullptr);
+  }
+  for (auto& shard : shards_) {
+    shard->thread.join();
+  }
+}
+
+void ParallelTrajectoryCollator::AddTrajectory(
+    const int trajectory_id,
+    const absl::flat_hash_set<std::string>& expected_sensor_ids,
+    const Callback& callback) {
+  GetShard(trajectory_id)
+      ->tasks.Push(absl::make_unique<Task>(Task{
+          trajectory_id, nullptr,
+          [trajectory_id, expected_sensor_ids,
+           callback](TrajectoryCollator* collator) {
+            collator->AddTrajectory(trajectory_id, expected_sensor_ids,
+                                    callback);
+          }}));
+}
+
+void ParallelTrajectoryCollator::FinishTrajectory(const int trajectory_id) {
+  RunAndWait(GetShard(trajectory_id),
+             [trajectory_id](TrajectoryCollator* collator) {
+               collator->FinishTrajectory(trajectory_id);
+             });
+}
+
+void ParallelTrajectoryCollator::AddSensorData(const int trajectory_id,
+                                               std::unique_ptr<Data> data) {
+  GetShard(trajectory_id)
+      ->tasks.Push(absl::make_unique<Task>(
+          Task{trajectory_id, std::move(data), nullptr}));
+}
+
+void ParallelTrajectoryCollator::Flush() {
+  for (auto& shard : shards_) {
+    RunAndWait(shard.get(),
+               [](TrajectoryCollator* collator) { collator->Flush(); });
+  }
+}
+
+absl::optional<int> ParallelTrajectoryCollator::GetBlockingTrajectoryId()
+    const {
+  return absl::optional<int>();
+}
+
+ParallelTrajectoryCollator::Shard* ParallelTrajectoryCollator::GetShard(
+    const int trajectory_id) {
+  CHECK_GE(trajectory_id, 0);
+  return shards_[trajectory_id % shards_.size()].get();
+}
+
+void ParallelTrajectoryCollator::Run(Shard* const shard) {
+  for (;;) {
+    std::unique_ptr<Task> task = shard->tasks.Pop();
+    if (task == nullptr) {
+      shard->collator.Flush();
+      return;
+    }
+    if (task->data != nullptr) {
+      shard->collator.AddSensorData(task->trajectory_id,
+                                    std::move(task->data));
+    } else {
+      task->function(&shard->collator);
+    }
+  }
+}
+
+void ParallelTrajectoryCollator::RunAndWait(
+    Shard* const shard,
+    const std::function<void(TrajectoryCollator*)>& function) {
+  absl::Mutex mutex;
+  bool done = false;
+  shard->tasks.Push(absl::make_unique<Task>(
+      Task{-1, nullptr,
+           [&mutex, &done, &function](TrajectoryCollator* collator) {
+             function(collator);
+             absl::MutexLock lock(&mutex);
+             done = true;
+           }}));
+  absl::MutexLock lock(&mutex);
+  mutex.Await(absl::Condition(&done));
+}
+
+}  // namespace sensor
+}  // namespace cartographer
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_SENSOR_INTERNAL_PARALLEL_TRAJECTORY_COLLATOR_H_
+#define CARTOGRAPHER_SENSOR_INTERNAL_PARALLEL_TRAJECTORY_COLLATOR_H_
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "cartographer/common/internal/blocking_queue.h"
+#include "cartographer/sensor/collator_interface.h"
+#include "cartographer/sensor/internal/trajectory_collator.h"
+
+namespace cartographer {
+namespace sensor {
+
+// Like 'TrajectoryCollator', but collates trajectories on 'num_threads'
+// dispatch threads. Each trajectory is assigned to one dispatch thread which
+// owns its queues, so data of a single trajectory is dispatched in the same
+// order as by 'TrajectoryCollator', while callbacks of trajectories assigned to
+// different threads run concurrently and have to be thread-safe with respect
+// to each other.
+//
+// 'AddTrajectory' and 'AddSensorData' only enqueue work for the dispatch
+// thread and block only if its queue is full. 'FinishTrajectory' and 'Flush'
+// return after all data added before has been dispatched.
+//
+// The destructor dispatches all data added before, as if 'Flush' was called,
+// so no data is dropped even if trajectories are left unfinished.
+class ParallelTrajectoryCollator : public CollatorInterface {
+ public:
+  explicit ParallelTrajectoryCollator(int num_threads);
+  ~ParallelTrajectoryCollator() override;
+
+  ParallelTrajectoryCollator(const ParallelTrajectoryCollator&) = delete;
+  ParallelTrajectoryCollator& operator=(const ParallelTrajectoryCollator&) =
+      delete;
+
+  void AddTrajectory(
+      int trajectory_id,
+      const absl::flat_hash_set<std::string>& expected_sensor_ids,
+      const Callback& callback) override;
+
+  void FinishTrajectory(int trajectory_id) override;
+
+  void AddSensorData(int trajectory_id, std::unique_ptr<Data> data) override;
+
+  void Flush() override;
+
+  absl::optional<int> GetBlockingTrajectoryId() const override;
+
+ private:
+  // Work item for a dispatch thread. Either adds 'data' to the collator of
+  // the thread, or runs 'function' on it. A null task flushes the collator of
+  // the thread and stops it.
+  struct Task {
+    int trajectory_id;
+    std::unique_ptr<Data> data;
+    std::function<void(TrajectoryCollator*)> function;
+  };
+
+  struct Shard {
+    explicit Shard(size_t queue_size) : tasks(queue_size) {}
+
+    common::BlockingQueue<std::unique_ptr<Task>> tasks;
+    // Only accessed from 'thread'.
+    TrajectoryCollator collator;
+    std::thread thread;
+  };
+
+  Shard* GetShard(int trajectory_id);
+  void Run(Shard* shard);
+  // Runs 'function' on the dispatch thread of 'shard' after all previously
+  // enqueued tasks, and waits for it to complete.
+  void RunAndWait(Shard* shard,
+                  const std::function<void(TrajectoryCollator*)>& function);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace sensor
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_SENSOR_INTERNAL_PARALLEL_TRAJECTORY_COLLATOR_H_
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/sensor/internal/parallel_trajectory_collator.h"
+
+#include <array>
+#include <map>
+#include <memory>
+
+#include "absl/synchronization/mutex.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+#include "cartographer/sensor/internal/trajectory_collator.h"
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+using testing::CollatorInput;
+using testing::CollatorOutput;
+
+const std::array<std::string, 2> kSensorId = {{"my_points", "some_imu"}};
+
+std::vector<CollatorInput> CreateInput(const int num_trajectories,
+                                       const int num_timestamps) {
+  std::vector<CollatorInput> input_data;
+  for (int time = 0; time != num_timestamps; ++time) {
+    for (int trajectory_id = 0; trajectory_id != num_trajectories;
+         ++trajectory_id) {
+      input_data.push_back(CollatorInput::CreateTimedPointCloudData(
+          trajectory_id, kSensorId[0], 10 * time));
+      input_data.push_back(CollatorInput::CreateImuData(
+          trajectory_id, kSensorId[1], 10 * time + 5 * (trajectory_id % 2)));
+    }
+  }
+  return input_data;
+}
+
+// Collates 'input_data' and returns the dispatched data by trajectory.
+std::map<int, std::vector<CollatorOutput>> Collate(
+    const int num_trajectories, std::vector<CollatorInput> input_data,
+    CollatorInterface* collator) {
+  absl::Mutex mutex;
+  std::map<int, std::vector<CollatorOutput>> received;
+  for (int trajectory_id = 0; trajectory_id != num_trajectories;
+       ++trajectory_id) {
+    collator->AddTrajectory(
+        trajectory_id,
+        absl::flat_hash_set<std::string>(kSensorId.begin(), kSensorId.end()),
+        [&mutex, &received, trajectory_id](const std::string& sensor_id,
+                                           std::unique_ptr<Data> data) {
+          absl::MutexLock lock(&mutex);
+          received[trajectory_id].push_back(CollatorOutput(
+              trajectory_id, data->GetSensorId(), data->GetTime()));
+        });
+  }
+  for (auto& input : input_data) {
+    input.MoveToCollator(collator);
+  }
+  for (int trajectory_id = 0; trajectory_id != num_trajectories;
+       ++trajectory_id) {
+    collator->FinishTrajectory(trajectory_id);
+  }
+  collator->Flush();
+  absl::MutexLock lock(&mutex);
+  return received;
+}
+
+class ParallelTrajectoryCollatorTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(ParallelTrajectoryCollatorTest, MatchesTrajectoryCollator) {
+  constexpr int kNumTrajectories = 7;
+  constexpr int kNumTimestamps = 50;
+  TrajectoryCollator trajectory_collator;
+  const auto expected =
+      Collate(kNumTrajectories, CreateInput(kNumTrajectories, kNumTimestamps),
+              &trajectory_collator);
+  ParallelTrajectoryCollator parallel_collator(GetParam());
+  const auto received =
+      Collate(kNumTrajectories, CreateInput(kNumTrajectories, kNumTimestamps),
+              &parallel_collator);
+  ASSERT_EQ(expected.size(), kNumTrajectories);
+  for (const auto& entry : expected) {
+    EXPECT_EQ(entry.second.size(), 2 * kNumTimestamps);
+    EXPECT_EQ(entry.second, received.at(entry.first));
+  }
+  EXPECT_FALSE(parallel_collator.GetBlockingTrajectoryId().has_value());
+}
+
+INSTANTIATE_TEST_CASE_P(NumThreads, ParallelTrajectoryCollatorTest,
+                        ::testing::Values(1, 2, 3, 8));
+
+TEST(ParallelTrajectoryCollator, FinishTrajectoryDispatchesRemainingData) {
+  ParallelTrajectoryCollator collator(2);
+  absl::Mutex mutex;
+  std::vector<CollatorOutput> received;
+  collator.AddTrajectory(
+      1, absl::flat_hash_set<std::string>(kSensorId.begin(), kSensorId.end()),
+      [&mutex, &received](const std::string& sensor_id,
+                          std::unique_ptr<Data> data) {
+        absl::MutexLock lock(&mutex);
+        received.push_back(
+            CollatorOutput(1, data->GetSensorId(), data->GetTime()));
+      });
+  // Only one sensor sends data, so nothing is dispatched before the
+  // trajectory is finished.
+  for (int time = 0; time != 5; ++time) {
+    CollatorInput::CreateImuData(1, kSensorId[1], time)
+        .MoveToCollator(&collator);
+  }
+  collator.FinishTrajectory(1);
+  absl::MutexLock lock(&mutex);
+  EXPECT_EQ(received.size(), 5);
+}
+
+TEST(ParallelTrajectoryCollator, DestructionDispatchesAllData) {
+  constexpr int kNumTrajectories = 5;
+  constexpr int kNumTimestamps = 100;
+  absl::Mutex mutex;
+  std::map<int, std::vector<CollatorOutput>> received;
+  {
+    ParallelTrajectoryCollator collator(2);
+    for (int trajectory_id = 0; trajectory_id != kNumTrajectories;
+         ++trajectory_id) {
+      collator.AddTrajectory(
+          trajectory_id,
+          absl::flat_hash_set<std::string>(kSensorId.begin(), kSensorId.end()),
+          [&mutex, &received, trajectory_id](const std::string& sensor_id,
+                                             std::unique_ptr<Data> data) {
+            absl::MutexLock lock(&mutex);
+            received[trajectory_id].push_back(CollatorOutput(
+                trajectory_id, data->GetSensorId(), data->GetTime()));
+          });
+    }
+    // Only the IMU sends data, so all of it is held back waiting for point
+    // clouds until the trajectories are finished or flushed.
+    for (int time = 0; time != kNumTimestamps; ++time) {
+      for (int trajectory_id = 0; trajectory_id != kNumTrajectories;
+           ++trajectory_id) {
+        CollatorInput::CreateImuData(trajectory_id, kSensorId[1], time)
+            .MoveToCollator(&collator);
+      }
+    }
+  }
+  absl::MutexLock lock(&mutex);
+  ASSERT_EQ(received.size(), kNumTrajectories);
+  for (const auto& entry : received) {
+    EXPECT_EQ(entry.second.size(), kNumTimestamps);
+  }
+}
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/sensor/internal/point_transform_kernels.h"
+
+#include <cstddef>
+
+#include "glog/logging.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define CARTOGRAPHER_SENSOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+// The kernels treat point vectors as arrays of floats with 'kStride' floats
+// per point, the position being the first three.
+static_assert(sizeof(RangefinderPoint) == 3 * sizeof(float),
+              "RangefinderPoint is expected to be three packed floats.");
+static_assert(sizeof(TimedRangefinderPoint) == 4 * sizeof(float),
+              "TimedRangefinderPoint is expected to be four packed floats.");
+
+// Row-major rotation matrix followed by the translation.
+struct AffineMatrix {
+  explicit AffineMatrix(const transform::Rigid3f& transform) {
+    const Eigen::Matrix3f rotation = transform.rotation().toRotationMatrix();
+    for (int row = 0; row < 3; ++row) {
+      for (int col = 0; col < 3; ++col) {
+        r[row][col] = rotation(row, col);
+      }
+      t[row] = transform.translation()[row];
+    }
+  }
+
+  float r[3][3];
+  float t[3];
+};
+
+template <int kStride>
+void TransformScalar(const AffineMatrix& m, const size_t begin,
+                     const size_t end, float* const data) {
+  for (size_t i = begin; i < end; ++i) {
+    float* const point = data + kStride * i;
+    const float x = point[0];
+    const float y = point[1];
+    const float z = point[2];
+    point[0] = m.r[0][0] * x + m.r[0][1] * y + m.r[0][2] * z + m.t[0];
+    point[1] = m.r[1][0] * x + m.r[1][1] * y + m.r[1][2] * z + m.t[1];
+    point[2] = m.r[2][0] * x + m.r[2][1] * y + m.r[2][2] * z + m.t[2];
+  }
+}
+
+#ifdef CARTOGRAPHER_SENSOR_X86_KERNELS
+
+// Deinterleaves 4 packed points 'p0', 'p1', 'p2' = (x0 y0 z0 x1), (y1 z1 x2
+// y2), (z2 x3 y3 z3) into 'x', 'y' and 'z', and back. The AVX versions do the
+// same independently in both 128-bit lanes.
+#define CARTOGRAPHER_DEINTERLEAVE(TYPE, SHUFFLE, p0, p1, p2, x, y, z) \
+  const TYPE xy_##x = SHUFFLE(p1, p2, _MM_SHUFFLE(2, 1, 3, 2));      \
+  const TYPE yz_##x = SHUFFLE(p0, p1, _MM_SHUFFLE(1, 0, 2, 1));      \
+  const TYPE x = SHUFFLE(p0, xy_##x, _MM_SHUFFLE(2, 0, 3, 0));       \
+  const TYPE y = SHUFFLE(yz_##x, xy_##x, _MM_SHUFFLE(3, 1, 2, 0));   \
+  const TYPE z = SHUFFLE(yz_##x, p2, _MM_SHUFFLE(3, 0, 3, 1))
+
+#define CARTOGRAPHER_INTERLEAVE(TYPE, SHUFFLE, x, y, z, p0, p1, p2)  \
+  const TYPE rxy_##p0 = SHUFFLE(x, y, _MM_SHUFFLE(2, 0, 2, 0));     \
+  const TYPE ryz_##p0 = SHUFFLE(y, z, _MM_SHUFFLE(3, 1, 3, 1));     \
+  const TYPE rzx_##p0 = SHUFFLE(z, x, _MM_SHUFFLE(3, 1, 2, 0));     \
+  const TYPE p0 = SHUFFLE(rxy_##p0, rzx_##p0, _MM_SHUFFLE(2, 0, 2, 0)); \
+  const TYPE p1 = SHUFFLE(ryz_##p0, rxy_##p0, _MM_SHUFFLE(3, 1, 2, 0)); \
+  const TYPE p2 = SHUFFLE(rzx_##p0, ryz_##p0, _MM_SHUFFLE(3, 1, 3, 1))
+
+__attribute__((target("sse2"))) void TransformPackedSse(
+    const AffineMatrix& m, const size_t num_points, float* const data) {
+  __m128 r[3][3];
+  __m128 t[3];
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      r[row][col] = _mm_set1_ps(m.r[row][col]);
+    }
+    t[row] = _mm_set1_ps(m.t[row]);
+  }
+  const size_t num_batched = num_points - num_points % 4;
+  for (size_t i = 0; i < num_batched; i += 4) {
+    float* const batch = data + 3 * i;
+    const __m128 p0 = _mm_loadu_ps(batch);
+    const __m128 p1 = _mm_loadu_ps(batch + 4);
+    const __m128 p2 = _mm_loadu_ps(batch + 8);
+    CARTOGRAPHER_DEINTERLEAVE(__m128, _mm_shuffle_ps, p0, p1, p2, x, y, z);
+    __m128 result[3];
+    for (int row = 0; row < 3; ++row) {
+      result[row] = _mm_add_ps(
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[row][0], x),
+                                _mm_mul_ps(r[row][1], y)),
+                     _mm_mul_ps(r[row][2], z)),
+          t[row]);
+    }
+    CARTOGRAPHER_INTERLEAVE(__m128, _mm_shuffle_ps, result[0], result[1],
+                            result[2], q0, q1, q2);
+    _mm_storeu_ps(batch, q0);
+    _mm_storeu_ps(batch + 4, q1);
+    _mm_storeu_ps(batch + 8, q2);
+  }
+  TransformScalar<3>(m, num_batched, num_points, data);
+}
+
+__attribute__((target("avx2,fma"))) inline __m256 LoadLanes(
+    const float* const low, const float* const high) {
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(low)),
+                              _mm_loadu_ps(high), 1);
+}
+
+__attribute__((target("avx2,fma"))) inline void StoreLanes(
+    const __m256 value, float* const low, float* const high) {
+  _mm_storeu_ps(low, _mm256_castps256_ps128(value));
+  _mm_storeu_ps(high, _mm256_extractf128_ps(value, 1));
+}
+
+__attribute__((target("avx2,fma"))) void TransformPackedAvx2(
+    const AffineMatrix& m, const size_t num_points, float* const data) {
+  __m256 r[3][3];
+  __m256 t[3];
+  for (int row = 0; row < 3; ++row) {
+    for (int col = 0; col < 3; ++col) {
+      r[row][col] = _mm256_set1_ps(m.r[row][col]);
+    }
+    t[row] = _mm256_set1_ps(m.t[row]);
+  }
+  const size_t num_batched = num_points - num_points % 8;
+  for (size_t i = 0; i < num_batched; i += 8) {
+    float* const batch = data + 3 * i;
+    // Points 0 to 3 go into the low lanes, points 4 to 7 into the high lanes.
+    const __m256 p0 = LoadLanes(batch, batch + 12);
+    const __m256 p1 = LoadLanes(batch + 4, batch + 16);
+    const __m256 p2 = LoadLanes(batch + 8, batch + 20);
+    CARTOGRAPHER_DEINTERLEAVE(__m256, _mm256_shuffle_ps, p0, p1, p2, x, y, z);
+    __m256 result[3];
+    for (int row = 0; row < 3; ++row) {
+      result[row] = _mm256_fmadd_ps(
+          r[row][2], z,
+          _mm256_fmadd_ps(r[row][1], y, _mm256_fmadd_ps(r[row][0], x, t[row])));
+    }
+    CARTOGRAPHER_INTERLEAVE(__m256, _mm256_shuffle_ps, result[0], result[1],
+                            result[2], q0, q1, q2);
+    StoreLanes(q0, batch, batch + 12);
+    StoreLanes(q1, batch + 4, batch + 16);
+    StoreLanes(q2, batch + 8, batch + 20);
+  }
+  TransformScalar<3>(m, num_batched, num_points, data);
+}
+
+#undef CARTOGRAPHER_DEINTERLEAVE
+#undef CARTOGRAPHER_INTERLEAVE
+
+// For timed points every point fills a 128-bit lane, so x, y and z are
+// broadcast within the lane and the time is blended back in afterwards.
+__attribute__((target("sse2"))) void TransformTimedSse(
+    const AffineMatrix& m, const size_t num_points, float* const data) {
+  const __m128 c0 = _mm_setr_ps(m.r[0][0], m.r[1][0], m.r[2][0], 0.f);
+  const __m128 c1 = _mm_setr_ps(m.r[0][1], m.r[1][1], m.r[2][1], 0.f);
+  const __m128 c2 = _mm_setr_ps(m.r[0][2], m.r[1][2], m.r[2][2], 0.f);
+  const __m128 t = _mm_setr_ps(m.t[0], m.t[1], m.t[2], 0.f);
+  const __m128 time_mask = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+  const size_t num_batched = num_points - num_points % 4;
+  for (size_t i = 0; i < num_batched; i += 4) {
+    for (size_t j = 0; j < 4; ++j) {
+      float* const point = data + 4 * (i + j);
+      const __m128 p = _mm_loadu_ps(point);
+      const __m128 x = _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0));
+      const __m128 y = _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1));
+      const __m128 z = _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2));
+      const __m128 position = _mm_add_ps(
+          _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, x), _mm_mul_ps(c1, y)),
+                     _mm_mul_ps(c2, z)),
+          t);
+      _mm_storeu_ps(point, _mm_or_ps(_mm_andnot_ps(time_mask, position),
+                                     _mm_and_ps(time_mask, p)));
+    }
+  }
+  TransformScalar<4>(m, num_batched, num_points, data);
+}
+
+__attribute__((target("avx2,fma"))) void TransformTimedAvx2(
+    const AffineMatrix& m, const size_t num_points, float* const data) {
+  const __m256 c0 = _mm256_setr_ps(m.r[0][0], m.r[1][0], m.r[2][0], 0.f,
+                                   m.r[0][0], m.r[1][0], m.r[2][0], 0.f);
+  const __m256 c1 = _mm256_setr_ps(m.r[0][1], m.r[1][1], m.r[2][1], 0.f,
+                                   m.r[0][1], m.r[1][1], m.r[2][1], 0.f);
+  const __m256 c2 = _mm256_setr_ps(m.r[0][2], m.r[1][2], m.r[2][2], 0.f,
+                                   m.r[0][2], m.r[1][2], m.r[2][2], 0.f);
+  const __m256 t = _mm256_setr_ps(m.t[0], m.t[1], m.t[2], 0.f, m.t[0], m.t[1],
+                                  m.t[2], 0.f);
+  const size_t num_batched = num_points - num_points % 8;
+  for (size_t i = 0; i < num_batched; i += 8) {
+    // Two points per register.
+    for (size_t j = 0; j < 8; j += 2) {
+      float* const points = data + 4 * (i + j);
+      const __m256 p = _mm256_loadu_ps(points);
+      const __m256 x = _mm256_permute_ps(p, _MM_SHUFFLE(0, 0, 0, 0));
+      const __m256 y = _mm256_permute_ps(p, _MM_SHUFFLE(1, 1, 1, 1));
+      const __m256 z = _mm256_permute_ps(p, _MM_SHUFFLE(2, 2, 2, 2));
+      const __m256 positions = _mm256_fmadd_ps(
+          c2, z, _mm256_fmadd_ps(c1, y, _mm256_fmadd_ps(c0, x, t)));
+      _mm256_storeu_ps(points, _mm256_blend_ps(positions, p, 0x88));
+    }
+  }
+  TransformScalar<4>(m, num_batched, num_points, data);
+}
+
+#endif  // CARTOGRAPHER_SENSOR_X86_KERNELS
+
+template <int kStride>
+void TransformPoints(const transform::Rigid3f& transform,
+                     const PointTransformKernel kernel,
+                     const size_t num_points, float* const data) {
+  CHECK(IsPointTransformKernelSupported(kernel));
+  const AffineMatrix m(transform);
+  switch (kernel) {
+#ifdef CARTOGRAPHER_SENSOR_X86_KERNELS
+    case PointTransformKernel::kAvx2:
+      if (kStride == 3) {
+        TransformPackedAvx2(m, num_points, data);
+      } else {
+        TransformTimedAvx2(m, num_points, data);
+      }
+      return;
+    case PointTransformKernel::kSse:
+      if (kStride == 3) {
+        TransformPackedSse(m, num_points, data);
+      } else {
+        TransformTimedSse(m, num_points, data);
+      }
+      return;
+#endif
+    default:
+      TransformScalar<kStride>(m, 0, num_points, data);
+  }
+}
+
+}  // namespace
+
+bool IsPointTransformKernelSupported(const PointTransformKernel kernel) {
+  switch (kernel) {
+    case PointTransformKernel::kScalar:
+      return true;
+#ifdef CARTOGRAPHER_SENSOR_X86_KERNELS
+    case PointTransformKernel::kSse:
+      return __builtin_cpu_supports("sse2");
+    case PointTransformKernel::kAvx2:
+      return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    default:
+      return false;
+  }
+}
+
+PointTransformKernel GetFastestPointTransformKernel() {
+  static const PointTransformKernel kFastestKernel = [] {
+    for (const PointTransformKernel kernel :
+         {PointTransformKernel::kAvx2, PointTransformKernel::kSse}) {
+      if (IsPointTransformKernelSupported(kernel)) {
+        return kernel;
+      }
+    }
+    return PointTransformKernel::kScalar;
+  }();
+  return kFastestKernel;
+}
+
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            const PointTransformKernel kernel,
+                            std::vector<RangefinderPoint>* const points) {
+  TransformPoints<3>(transform, kernel, points->size(),
+                     reinterpret_cast<float*>(points->data()));
+}
+
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            const PointTransformKernel kernel,
+                            std::vector<TimedRangefinderPoint>* const points) {
+  TransformPoints<4>(transform, kernel, points->size(),
+                     reinterpret_cast<float*>(points->data()));
+}
+
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            std::vector<RangefinderPoint>* const points) {
+  TransformPointsInPlace(transform, GetFastestPointTransformKernel(), points);
+}
+
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            std::vector<TimedRangefinderPoint>* const points) {
+  TransformPointsInPlace(transform, GetFastestPointTransformKernel(), points);
+}
+
+}  // namespace sensor
+}  // namespace cartographer
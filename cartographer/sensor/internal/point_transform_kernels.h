@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_SENSOR_INTERNAL_POINT_TRANSFORM_KERNELS_H_
+#define CARTOGRAPHER_SENSOR_INTERNAL_POINT_TRANSFORM_KERNELS_H_
+
+#include <vector>
+
+#include "cartographer/sensor/rangefinder_point.h"
+#include "cartographer/transform/rigid_transform.h"
+
+namespace cartographer {
+namespace sensor {
+
+// Implementations of the batched point transform. The rotation is converted to
+// a 3x3 matrix once per call. 'kAvx2' processes 8 points per iteration using
+// AVX2 and FMA, 'kSse' processes 4 points per iteration using SSE2. Results of
+// all kernels agree within float rounding.
+enum class PointTransformKernel { kScalar, kSse, kAvx2 };
+
+// Returns true if 'kernel' can be used on the CPU we are running on.
+bool IsPointTransformKernelSupported(PointTransformKernel kernel);
+
+// Returns the fastest kernel supported by the CPU we are running on.
+PointTransformKernel GetFastestPointTransformKernel();
+
+// Applies 'transform' to the positions of 'points' in place, using 'kernel'
+// which must be supported. Times are not modified.
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            PointTransformKernel kernel,
+                            std::vector<RangefinderPoint>* points);
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            PointTransformKernel kernel,
+                            std::vector<TimedRangefinderPoint>* points);
+
+// Same as above, using the fastest supported kernel.
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            std::vector<RangefinderPoint>* points);
+void TransformPointsInPlace(const transform::Rigid3f& transform,
+                            std::vector<TimedRangefinderPoint>* points);
+
+}  // namespace sensor
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_SENSOR_INTERNAL_POINT_TRANSFORM_KERNELS_H_
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "cartographer/sensor/internal/point_transform_kernels.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+const transform::Rigid3f kTransform(
+    Eigen::Vector3f(1.f, 2.f, 3.f),
+    Eigen::Quaternionf(Eigen::AngleAxisf(0.5f, Eigen::Vector3f::UnitZ())));
+
+// 'state.range(0)' selects the kernel, 'state.range(1)' is the number of
+// points per ring of a 64-ring lidar scan.
+template <class PointType>
+void BM_TransformPointsInPlace(benchmark::State& state) {
+  const auto kernel = static_cast<PointTransformKernel>(state.range(0));
+  if (!IsPointTransformKernelSupported(kernel)) {
+    state.SkipWithError("Kernel not supported on this CPU.");
+    return;
+  }
+  std::vector<PointType> points;
+  for (const TimedRangefinderPoint& point : testing::GenerateSyntheticScan3D(
+           64, state.range(1), Eigen::Vector3f(12.f, 8.f, 3.f))) {
+    points.push_back(PointType{point.position});
+  }
+  for (auto _ : state) {
+    TransformPointsInPlace(kTransform, kernel, &points);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+
+void KernelArguments(benchmark::internal::Benchmark* benchmark) {
+  for (const PointTransformKernel kernel :
+       {PointTransformKernel::kScalar, PointTransformKernel::kSse,
+        PointTransformKernel::kAvx2}) {
+    benchmark->Args({static_cast<int>(kernel), 512});
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_TransformPointsInPlace, RangefinderPoint)
+    ->Apply(KernelArguments);
+BENCHMARK_TEMPLATE(BM_TransformPointsInPlace, TimedRangefinderPoint)
+    ->Apply(KernelArguments);
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/sensor/internal/point_transform_kernels.h"
+
+#include <random>
+
+#include "gmock/gmock.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+using ::testing::Values;
+
+constexpr float kPrecision = 1e-4f;
+
+transform::Rigid3f CreateTransform() {
+  return transform::Rigid3f(
+      Eigen::Vector3f(12.f, -3.5f, 0.25f),
+      Eigen::Quaternionf(Eigen::AngleAxisf(0.7f, Eigen::Vector3f::UnitZ()) *
+                         Eigen::AngleAxisf(-0.3f, Eigen::Vector3f::UnitY()) *
+                         Eigen::AngleAxisf(0.1f, Eigen::Vector3f::UnitX())));
+}
+
+std::vector<TimedRangefinderPoint> CreatePoints(const int num_points) {
+  std::mt19937 prng(42);
+  std::uniform_real_distribution<float> distribution(-50.f, 50.f);
+  std::vector<TimedRangefinderPoint> points;
+  for (int i = 0; i < num_points; ++i) {
+    points.push_back({Eigen::Vector3f(distribution(prng), distribution(prng),
+                                      distribution(prng)),
+                      -1e-3f * i});
+  }
+  return points;
+}
+
+class PointTransformKernelTest
+    : public ::testing::TestWithParam<PointTransformKernel> {};
+
+TEST_P(PointTransformKernelTest, MatchesEigenForRangefinderPoints) {
+  if (!IsPointTransformKernelSupported(GetParam())) {
+    return;
+  }
+  const transform::Rigid3f transform = CreateTransform();
+  // Sizes that exercise full batches as well as the scalar remainder.
+  for (const int num_points : {0, 1, 3, 4, 7, 8, 9, 17, 1000}) {
+    std::vector<RangefinderPoint> points;
+    for (const TimedRangefinderPoint& point : CreatePoints(num_points)) {
+      points.push_back({point.position});
+    }
+    std::vector<RangefinderPoint> actual = points;
+    TransformPointsInPlace(transform, GetParam(), &actual);
+    ASSERT_EQ(actual.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      const Eigen::Vector3f expected = transform * points[i].position;
+      EXPECT_TRUE(actual[i].position.isApprox(expected, kPrecision))
+          << num_points << " points, index " << i;
+    }
+  }
+}
+
+TEST_P(PointTransformKernelTest, MatchesEigenAndKeepsTimes) {
+  if (!IsPointTransformKernelSupported(GetParam())) {
+    return;
+  }
+  const transform::Rigid3f transform = CreateTransform();
+  for (const int num_points : {0, 1, 3, 4, 7, 8, 9, 17, 1000}) {
+    const std::vector<TimedRangefinderPoint> points = CreatePoints(num_points);
+    std::vector<TimedRangefinderPoint> actual = points;
+    TransformPointsInPlace(transform, GetParam(), &actual);
+    ASSERT_EQ(actual.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+      const Eigen::Vector3f expected = transform * points[i].position;
+      EXPECT_TRUE(actual[i].position.isApprox(expected, kPrecision))
+          << num_points << " points, index " << i;
+      EXPECT_EQ(actual[i].time, points[i].time);
+    }
+  }
+}
+
+INSTANTIATE_TEST_CASE_P(AllKernels, PointTransformKernelTest,
+                        Values(PointTransformKernel::kScalar,
+                               PointTransformKernel::kSse,
+                               PointTransformKernel::kAvx2));
+
+TEST(PointTransformKernelsTest, FastestKernelIsSupported) {
+  EXPECT_TRUE(
+      IsPointTransformKernelSupported(GetFastestPointTransformKernel()));
+}
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
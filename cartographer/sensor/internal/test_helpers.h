@@ -17,6 +17,10 @@
 #ifndef CARTOGRAPHER_SENSOR_INTERNAL_TEST_HELPERS_H_
 #define CARTOGRAPHER_SENSOR_INTERNAL_TEST_HELPERS_H_
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
 #include <string>
 #include <tuple>
 
@@ -26,6 +30,7 @@
 #include "cartographer/sensor/imu_data.h"
 #include "cartographer/sensor/internal/dispatchable.h"
 #include "cartographer/sensor/odometry_data.h"
+#include "cartographer/sensor/point_cloud.h"
 #include "cartographer/sensor/timed_point_cloud_data.h"
 #include "gmock/gmock.h"
 
@@ -80,6 +85,85 @@ struct CollatorInput {
   const CollatorOutput expected_output;
 };
 
+// Returns the distance from the origin along the unit vector 'direction' to
+// the walls of an axis-aligned box centered at the origin.
+inline float DistanceToBoxWalls(const Eigen::Vector3f& direction,
+                                const Eigen::Vector3f& half_extents) {
+  float distance = std::numeric_limits<float>::infinity();
+  for (int i = 0; i != 3; ++i) {
+    if (std::abs(direction[i]) > 1e-6f) {
+      distance = std::min(distance, half_extents[i] / std::abs(direction[i]));
+    }
+  }
+  return distance;
+}
+
+// Generates a scan of a planar rangefinder with 'num_beams' evenly spaced
+// beams spinning once around the origin of a rectangular room. Ranges carry a
+// few centimeters of noise from a fixed seed, so that the result is
+// reproducible. Times are relative to the last point of a 100 ms sweep.
+inline TimedPointCloud GenerateSyntheticScan2D(const int num_beams,
+                                               const float half_extent_x,
+                                               const float half_extent_y) {
+  std::mt19937 prng(42);
+  std::normal_distribution<float> noise(0.f, 0.02f);
+  TimedPointCloud scan;
+  scan.reserve(num_beams);
+  for (int i = 0; i != num_beams; ++i) {
+    const float angle = 2.f * static_cast<float>(M_PI) * i / num_beams;
+    const Eigen::Vector3f direction(std::cos(angle), std::sin(angle), 0.f);
+    const float range =
+        DistanceToBoxWalls(direction, Eigen::Vector3f(half_extent_x,
+                                                      half_extent_y, 1.f)) +
+        noise(prng);
+    scan.push_back({range * direction, -0.1f * (num_beams - 1 - i) /
+                                           static_cast<float>(num_beams)});
+  }
+  return scan;
+}
+
+// Generates a scan of a spinning multi-beam lidar with 'num_rings' rings
+// spread over +/-15 degrees of elevation and 'points_per_ring' points per ring,
+// placed at the origin of a box room whose walls, floor and ceiling are at
+// 'half_extents'. Like GenerateSyntheticScan2D(), the result is reproducible.
+inline TimedPointCloud GenerateSyntheticScan3D(
+    const int num_rings, const int points_per_ring,
+    const Eigen::Vector3f& half_extents) {
+  std::mt19937 prng(42);
+  std::normal_distribution<float> noise(0.f, 0.02f);
+  const float max_elevation = 15.f * static_cast<float>(M_PI) / 180.f;
+  TimedPointCloud scan;
+  scan.reserve(num_rings * points_per_ring);
+  for (int j = 0; j != points_per_ring; ++j) {
+    const float azimuth = 2.f * static_cast<float>(M_PI) * j / points_per_ring;
+    const float time =
+        -0.1f * (points_per_ring - 1 - j) / static_cast<float>(points_per_ring);
+    for (int i = 0; i != num_rings; ++i) {
+      const float elevation =
+          num_rings == 1
+              ? 0.f
+              : max_elevation * (2.f * i / (num_rings - 1) - 1.f);
+      const Eigen::Vector3f direction(std::cos(elevation) * std::cos(azimuth),
+                                      std::cos(elevation) * std::sin(azimuth),
+                                      std::sin(elevation));
+      const float range =
+          DistanceToBoxWalls(direction, half_extents) + noise(prng);
+      scan.push_back({range * direction, time});
+    }
+  }
+  return scan;
+}
+
+// Drops the per-point times of 'timed_point_cloud'.
+inline PointCloud ToPointCloud(const TimedPointCloud& timed_point_cloud) {
+  std::vector<RangefinderPoint> points;
+  points.reserve(timed_point_cloud.size());
+  for (const TimedRangefinderPoint& point : timed_point_cloud) {
+    points.push_back(ToRangefinderPoint(point));
+  }
+  return PointCloud(std::move(points));
+}
+
 }  // namespace testing
 }  // namespace sensor
 }  // namespace cartographer
@@ -17,7 +17,10 @@
 #include "cartographer/sensor/internal/voxel_filter.h"
 
 #include <cmath>
+#include <array>
+#include <limits>
 #include <random>
+#include <string>
 #include <utility>
 
 #include "absl/container/flat_hash_map.h"
@@ -35,14 +38,28 @@ PointCloud FilterByMaxRange(const PointCloud& point_cloud,
   });
 }
 
-PointCloud AdaptivelyVoxelFiltered(
+SoaPointCloud FilterByMaxRange(const SoaPointCloudView point_cloud,
+                               const float max_range) {
+  std::vector<bool> points_used(point_cloud.size());
+  const float* const x = point_cloud.x();
+  const float* const y = point_cloud.y();
+  const float* const z = point_cloud.z();
+  for (size_t i = 0; i < point_cloud.size(); ++i) {
+    points_used[i] =
+        std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]) <= max_range;
+  }
+  return SelectPoints(point_cloud, points_used);
+}
+
+template <class PointCloudType>
+PointCloudType AdaptivelyVoxelFilteredByHashing(
     const proto::AdaptiveVoxelFilterOptions& options,
-    const PointCloud& point_cloud) {
+    const PointCloudType& point_cloud) {
   if (point_cloud.size() <= options.min_num_points()) {
     // 'point_cloud' is already sparse enough.
     return point_cloud;
   }
-  PointCloud result = VoxelFilter(point_cloud, options.max_length());
+  PointCloudType result = VoxelFilter(point_cloud, options.max_length());
   if (result.size() >= options.min_num_points()) {
     // Filtering with 'max_length' resulted in a sufficiently dense point cloud.
     return result;
@@ -60,10 +77,10 @@ PointCloud AdaptivelyVoxelFiltered(
       // edge length is at most 10% off.
       while ((high_length - low_length) / low_length > 1e-1f) {
         const float mid_length = (low_length + high_length) / 2.f;
-        const PointCloud candidate = VoxelFilter(point_cloud, mid_length);
+        PointCloudType candidate = VoxelFilter(point_cloud, mid_length);
         if (candidate.size() >= options.min_num_points()) {
           low_length = mid_length;
-          result = candidate;
+          result = std::move(candidate);
         } else {
           high_length = mid_length;
         }
@@ -85,17 +102,18 @@ VoxelKeyType GetVoxelCellIndex(const Eigen::Vector3f& point,
   return (x << 42) + (y << 21) + z;
 }
 
-template <class T, class PointFunction>
+// 'position_function' returns the position of the point with the given index.
+template <class PositionFunction>
 std::vector<bool> RandomizedVoxelFilterIndices(
-    const std::vector<T>& point_cloud, const float resolution,
-    PointFunction&& point_function) {
+    const size_t num_points, const float resolution,
+    PositionFunction&& position_function) {
   // According to https://en.wikipedia.org/wiki/Reservoir_sampling
   std::minstd_rand0 generator;
   absl::flat_hash_map<VoxelKeyType, std::pair<int, int>>
       voxel_count_and_point_index;
-  for (size_t i = 0; i < point_cloud.size(); i++) {
+  for (size_t i = 0; i < num_points; i++) {
     auto& voxel = voxel_count_and_point_index[GetVoxelCellIndex(
-        point_function(point_cloud[i]), resolution)];
+        position_function(i), resolution)];
     voxel.first++;
     if (voxel.first == 1) {
       voxel.second = i;
@@ -106,13 +124,24 @@ std::vector<bool> RandomizedVoxelFilterIndices(
       }
     }
   }
-  std::vector<bool> points_used(point_cloud.size(), false);
+  std::vector<bool> points_used(num_points, false);
   for (const auto& voxel_and_index : voxel_count_and_point_index) {
     points_used[voxel_and_index.second.second] = true;
   }
   return points_used;
 }
 
+template <class T, class PointFunction>
+std::vector<bool> RandomizedVoxelFilterIndices(
+    const std::vector<T>& point_cloud, const float resolution,
+    PointFunction&& point_function) {
+  return RandomizedVoxelFilterIndices(
+      point_cloud.size(), resolution,
+      [&point_cloud, &point_function](const size_t index) {
+        return point_function(point_cloud[index]);
+      });
+}
+
 template <class T, class PointFunction>
 std::vector<T> RandomizedVoxelFilter(const std::vector<T>& point_cloud,
                                      const float resolution,
@@ -129,20 +158,17 @@ std::vector<T> RandomizedVoxelFilter(const std::vector<T>& point_cloud,
   return results;
 }
 
-}  // namespace
-
-std::vector<RangefinderPoint> VoxelFilter(
-    const std::vector<RangefinderPoint>& points, const float resolution) {
-  return RandomizedVoxelFilter(
-      points, resolution,
-      [](const RangefinderPoint& point) { return point.position; });
+Eigen::Vector3f Position(const PointCloud& point_cloud, const size_t index) {
+  return point_cloud[index].position;
 }
 
-PointCloud VoxelFilter(const PointCloud& point_cloud, const float resolution) {
-  const std::vector<bool> points_used = RandomizedVoxelFilterIndices(
-      point_cloud.points(), resolution,
-      [](const RangefinderPoint& point) { return point.position; });
+Eigen::Vector3f Position(const SoaPointCloudView& point_cloud,
+                         const size_t index) {
+  return point_cloud.position(index);
+}
 
+PointCloud SelectPoints(const PointCloud& point_cloud,
+                        const std::vector<bool>& points_used) {
   std::vector<RangefinderPoint> filtered_points;
   for (size_t i = 0; i < point_cloud.size(); i++) {
     if (points_used[i]) {
@@ -160,6 +186,212 @@ PointCloud VoxelFilter(const PointCloud& point_cloud, const float resolution) {
                     std::move(filtered_intensities));
 }
 
+// Same as 'common::RoundToInt', which calls std::lround, but inlined. Adding
+// 0.5 in double precision is exact for all floats that fit into an int.
+int RoundHalfAwayFromZero(const float x) {
+  return static_cast<int>(static_cast<double>(x) + std::copysign(0.5, x));
+}
+
+struct KeyAndIndex {
+  VoxelKeyType key;
+  uint32_t index;
+};
+
+// Returns the number of bits needed to represent the non-negative 'value'.
+int BitWidth(uint32_t value) {
+  int width = 0;
+  for (; value != 0; value >>= 1) {
+    ++width;
+  }
+  return width;
+}
+
+// Stable least significant digit radix sort of 'values' by the lowest
+// 'num_key_bytes' bytes of their keys, using 'scratch' as the second buffer.
+// Passes over bytes in which all keys agree are skipped.
+void RadixSortByKey(const int num_key_bytes, std::vector<KeyAndIndex>* values,
+                    std::vector<KeyAndIndex>* scratch) {
+  constexpr int kMaxNumKeyBytes = sizeof(VoxelKeyType);
+  CHECK_LE(num_key_bytes, kMaxNumKeyBytes);
+  std::array<std::array<size_t, 256>, kMaxNumKeyBytes> histograms{};
+  for (const KeyAndIndex& value : *values) {
+    for (int byte = 0; byte < num_key_bytes; ++byte) {
+      ++histograms[byte][(value.key >> (8 * byte)) & 0xff];
+    }
+  }
+  scratch->resize(values->size());
+  for (int byte = 0; byte < num_key_bytes; ++byte) {
+    std::array<size_t, 256>& histogram = histograms[byte];
+    const size_t first_digit = ((*values)[0].key >> (8 * byte)) & 0xff;
+    if (histogram[first_digit] == values->size()) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t& count : histogram) {
+      const size_t digit_count = count;
+      count = offset;
+      offset += digit_count;
+    }
+    for (const KeyAndIndex& value : *values) {
+      (*scratch)[histogram[(value.key >> (8 * byte)) & 0xff]++] = value;
+    }
+    values->swap(*scratch);
+  }
+}
+
+// Assigns the points of a point cloud to voxels by sorting voxel keys, keeping
+// the first point of each voxel. Keys are packed relative to the bounding box
+// of the occupied voxels, so only as many radix passes as needed for its
+// extent are made. Sorted keys are kept for the resolution last passed to
+// 'KeepSortedKeys', so that an adaptive search over resolutions only selects
+// points once, and buffers are reused across resolutions.
+template <class PointCloudType>
+class SortingVoxelSelector {
+ public:
+  explicit SortingVoxelSelector(const PointCloudType& point_cloud)
+      : point_cloud_(point_cloud) {
+    CHECK_LE(point_cloud.size(), std::numeric_limits<uint32_t>::max());
+  }
+
+  // Sorts the voxel keys for 'resolution' and returns the number of occupied
+  // voxels.
+  size_t SortAndCountVoxels(const float resolution) {
+    if (point_cloud_.size() == 0) {
+      sorted_.clear();
+      return 0;
+    }
+    cells_.resize(point_cloud_.size());
+    Eigen::Array3i min_cell =
+        Eigen::Array3i::Constant(std::numeric_limits<int>::max());
+    Eigen::Array3i max_cell =
+        Eigen::Array3i::Constant(std::numeric_limits<int>::min());
+    for (size_t i = 0; i < point_cloud_.size(); ++i) {
+      const Eigen::Array3f index =
+          Position(point_cloud_, i).array() / resolution;
+      cells_[i] = Eigen::Array3i(RoundHalfAwayFromZero(index.x()),
+                                 RoundHalfAwayFromZero(index.y()),
+                                 RoundHalfAwayFromZero(index.z()));
+      min_cell = min_cell.min(cells_[i]);
+      max_cell = max_cell.max(cells_[i]);
+    }
+    const Eigen::Array3i extent = max_cell - min_cell;
+    const int y_shift = BitWidth(extent.z());
+    const int x_shift = y_shift + BitWidth(extent.y());
+    const int num_key_bits = x_shift + BitWidth(extent.x());
+    CHECK_LE(num_key_bits, 64) << "Point cloud too large for voxel size.";
+    sorted_.resize(point_cloud_.size());
+    for (size_t i = 0; i < point_cloud_.size(); ++i) {
+      const Eigen::Array3i offset = cells_[i] - min_cell;
+      sorted_[i] = {(static_cast<VoxelKeyType>(offset.x()) << x_shift) |
+                        (static_cast<VoxelKeyType>(offset.y()) << y_shift) |
+                        static_cast<VoxelKeyType>(offset.z()),
+                    static_cast<uint32_t>(i)};
+    }
+    RadixSortByKey((num_key_bits + 7) / 8, &sorted_, &scratch_);
+    size_t num_voxels = 1;
+    for (size_t i = 1; i < sorted_.size(); ++i) {
+      if (sorted_[i].key != sorted_[i - 1].key) {
+        ++num_voxels;
+      }
+    }
+    return num_voxels;
+  }
+
+  // Keeps the keys of the last call to 'SortAndCountVoxels' for 'Select'.
+  void KeepSortedKeys() { kept_.swap(sorted_); }
+
+  // Returns one point per voxel of the kept keys, in their original order.
+  PointCloudType Select() const {
+    std::vector<bool> points_used(point_cloud_.size(), false);
+    for (size_t i = 0; i < kept_.size(); ++i) {
+      // The sort is stable, so the first point of each voxel has the lowest
+      // index.
+      if (i == 0 || kept_[i].key != kept_[i - 1].key) {
+        points_used[kept_[i].index] = true;
+      }
+    }
+    return SelectPoints(point_cloud_, points_used);
+  }
+
+ private:
+  const PointCloudType& point_cloud_;
+  std::vector<Eigen::Array3i> cells_;
+  std::vector<KeyAndIndex> sorted_;
+  std::vector<KeyAndIndex> kept_;
+  std::vector<KeyAndIndex> scratch_;
+};
+
+// Same search over voxel edge lengths as 'AdaptivelyVoxelFilteredByHashing',
+// but only the number of voxels is computed for each candidate length and
+// points are selected once, from the kept sorted keys.
+template <class PointCloudType>
+PointCloudType AdaptivelyVoxelFilteredBySorting(
+    const proto::AdaptiveVoxelFilterOptions& options,
+    const PointCloudType& point_cloud) {
+  if (point_cloud.size() <= options.min_num_points()) {
+    // 'point_cloud' is already sparse enough.
+    return point_cloud;
+  }
+  SortingVoxelSelector<PointCloudType> selector(point_cloud);
+  size_t result_size = selector.SortAndCountVoxels(options.max_length());
+  selector.KeepSortedKeys();
+  if (result_size >= options.min_num_points()) {
+    return selector.Select();
+  }
+  for (float high_length = options.max_length();
+       high_length > 1e-2f * options.max_length(); high_length /= 2.f) {
+    float low_length = high_length / 2.f;
+    result_size = selector.SortAndCountVoxels(low_length);
+    selector.KeepSortedKeys();
+    if (result_size >= options.min_num_points()) {
+      while ((high_length - low_length) / low_length > 1e-1f) {
+        const float mid_length = (low_length + high_length) / 2.f;
+        if (selector.SortAndCountVoxels(mid_length) >=
+            options.min_num_points()) {
+          low_length = mid_length;
+          selector.KeepSortedKeys();
+        } else {
+          high_length = mid_length;
+        }
+      }
+      return selector.Select();
+    }
+  }
+  return selector.Select();
+}
+
+template <class PointCloudType>
+PointCloudType AdaptivelyVoxelFiltered(
+    const proto::AdaptiveVoxelFilterOptions& options,
+    const PointCloudType& point_cloud) {
+  switch (options.algorithm()) {
+    case proto::AdaptiveVoxelFilterOptions::HASH_MAP:
+      return AdaptivelyVoxelFilteredByHashing(options, point_cloud);
+    case proto::AdaptiveVoxelFilterOptions::RADIX_SORT:
+      return AdaptivelyVoxelFilteredBySorting(options, point_cloud);
+    default:
+      LOG(FATAL) << "Unknown AdaptiveVoxelFilterOptions::Algorithm: "
+                 << options.algorithm();
+  }
+}
+
+}  // namespace
+
+std::vector<RangefinderPoint> VoxelFilter(
+    const std::vector<RangefinderPoint>& points, const float resolution) {
+  return RandomizedVoxelFilter(
+      points, resolution,
+      [](const RangefinderPoint& point) { return point.position; });
+}
+
+PointCloud VoxelFilter(const PointCloud& point_cloud, const float resolution) {
+  return SelectPoints(
+      point_cloud,
+      RandomizedVoxelFilterIndices(
+          point_cloud.points(), resolution,
+          [](const RangefinderPoint& point) { return point.position; }));
+}
+
 TimedPointCloud VoxelFilter(const TimedPointCloud& timed_point_cloud,
                             const float resolution) {
   return RandomizedVoxelFilter(
@@ -179,6 +411,17 @@ std::vector<sensor::TimedPointCloudOriginData::RangeMeasurement> VoxelFilter(
       });
 }
 
+SoaPointCloud VoxelFilter(const SoaPointCloudView point_cloud,
+                          const float resolution) {
+  return SelectPoints(
+      point_cloud,
+      RandomizedVoxelFilterIndices(
+          point_cloud.size(), resolution,
+          [&point_cloud](const size_t index) {
+            return point_cloud.position(index);
+          }));
+}
+
 proto::AdaptiveVoxelFilterOptions CreateAdaptiveVoxelFilterOptions(
     common::LuaParameterDictionary* const parameter_dictionary) {
   proto::AdaptiveVoxelFilterOptions options;
@@ -186,6 +429,16 @@ proto::AdaptiveVoxelFilterOptions CreateAdaptiveVoxelFilterOptions(
   options.set_min_num_points(
       parameter_dictionary->GetNonNegativeInt("min_num_points"));
   options.set_max_range(parameter_dictionary->GetDouble("max_range"));
+  if (parameter_dictionary->HasKey("algorithm")) {
+    const std::string algorithm_string =
+        parameter_dictionary->GetString("algorithm");
+    proto::AdaptiveVoxelFilterOptions::Algorithm algorithm;
+    CHECK(proto::AdaptiveVoxelFilterOptions::Algorithm_Parse(algorithm_string,
+                                                             &algorithm))
+        << "Unknown AdaptiveVoxelFilterOptions::Algorithm kind: "
+        << algorithm_string;
+    options.set_algorithm(algorithm);
+  }
   return options;
 }
 
@@ -196,5 +449,12 @@ PointCloud AdaptiveVoxelFilter(
       options, FilterByMaxRange(point_cloud, options.max_range()));
 }
 
+SoaPointCloud AdaptiveVoxelFilter(
+    const SoaPointCloudView point_cloud,
+    const proto::AdaptiveVoxelFilterOptions& options) {
+  return AdaptivelyVoxelFiltered(
+      options, FilterByMaxRange(point_cloud, options.max_range()));
+}
+
 }  // namespace sensor
 }  // namespace cartographer
@@ -22,6 +22,7 @@
 #include "cartographer/common/lua_parameter_dictionary.h"
 #include "cartographer/sensor/point_cloud.h"
 #include "cartographer/sensor/proto/adaptive_voxel_filter_options.pb.h"
+#include "cartographer/sensor/soa_point_cloud.h"
 #include "cartographer/sensor/timed_point_cloud_data.h"
 
 namespace cartographer {
@@ -36,6 +37,9 @@ std::vector<sensor::TimedPointCloudOriginData::RangeMeasurement> VoxelFilter(
     const std::vector<sensor::TimedPointCloudOriginData::RangeMeasurement>&
         range_measurements,
     const float resolution);
+// Keeps the same points as the 'PointCloud' overload, with all channels.
+SoaPointCloud VoxelFilter(SoaPointCloudView point_cloud,
+                          const float resolution);
 
 proto::AdaptiveVoxelFilterOptions CreateAdaptiveVoxelFilterOptions(
     common::LuaParameterDictionary* const parameter_dictionary);
@@ -43,6 +47,9 @@ proto::AdaptiveVoxelFilterOptions CreateAdaptiveVoxelFilterOptions(
 PointCloud AdaptiveVoxelFilter(
     const PointCloud& point_cloud,
     const proto::AdaptiveVoxelFilterOptions& options);
+SoaPointCloud AdaptiveVoxelFilter(
+    SoaPointCloudView point_cloud,
+    const proto::AdaptiveVoxelFilterOptions& options);
 
 }  // namespace sensor
 }  // namespace cartographer
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "cartographer/sensor/internal/test_helpers.h"
+#include "cartographer/sensor/internal/voxel_filter.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+// Scan of a 64-ring lidar with 'state.range(0)' points per ring.
+PointCloud CreateScan(const benchmark::State& state) {
+  return testing::ToPointCloud(testing::GenerateSyntheticScan3D(
+      64, state.range(0), Eigen::Vector3f(12.f, 8.f, 3.f)));
+}
+
+void BM_VoxelFilter(benchmark::State& state) {
+  const PointCloud point_cloud = CreateScan(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(VoxelFilter(point_cloud, 0.025f));
+  }
+  state.SetItemsProcessed(state.iterations() * point_cloud.size());
+}
+BENCHMARK(BM_VoxelFilter)->Arg(512)->Arg(2048);
+
+// 'state.range(1)' is the 'AdaptiveVoxelFilterOptions::Algorithm'.
+void BM_AdaptiveVoxelFilter(benchmark::State& state) {
+  const PointCloud point_cloud = CreateScan(state);
+  proto::AdaptiveVoxelFilterOptions options;
+  options.set_max_length(2.f);
+  options.set_min_num_points(150);
+  options.set_max_range(15.f);
+  options.set_algorithm(
+      static_cast<proto::AdaptiveVoxelFilterOptions::Algorithm>(
+          state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(AdaptiveVoxelFilter(point_cloud, options));
+  }
+  state.SetItemsProcessed(state.iterations() * point_cloud.size());
+}
+BENCHMARK(BM_AdaptiveVoxelFilter)
+    ->Args({512, proto::AdaptiveVoxelFilterOptions::HASH_MAP})
+    ->Args({2048, proto::AdaptiveVoxelFilterOptions::HASH_MAP})
+    ->Args({512, proto::AdaptiveVoxelFilterOptions::RADIX_SORT})
+    ->Args({2048, proto::AdaptiveVoxelFilterOptions::RADIX_SORT});
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
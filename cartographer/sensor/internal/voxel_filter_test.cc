@@ -18,6 +18,7 @@
 
 #include <cmath>
 
+#include "cartographer/sensor/soa_point_cloud.h"
 #include "gmock/gmock.h"
 
 namespace cartographer {
@@ -81,6 +82,97 @@ TEST(VoxelFilterTest, IgnoresTime) {
   EXPECT_THAT(timed_point_cloud, Contains(result[0]));
 }
 
+PointCloud CreateGridPointCloud() {
+  std::vector<RangefinderPoint> points;
+  std::vector<float> intensities;
+  for (int i = 0; i < 1000; ++i) {
+    points.push_back({Eigen::Vector3f(0.013f * (i % 97), 0.021f * (i % 31),
+                                      0.007f * (i % 13))});
+    intensities.push_back(1.f * i);
+  }
+  return PointCloud(points, intensities);
+}
+
+TEST(VoxelFilterTest, SoaPointCloudSelectsSamePoints) {
+  const PointCloud point_cloud = CreateGridPointCloud();
+  const PointCloud expected = VoxelFilter(point_cloud, 0.05f);
+  const PointCloud actual =
+      VoxelFilter(SoaPointCloud::FromPointCloud(point_cloud), 0.05f)
+          .ToPointCloud();
+  EXPECT_EQ(actual.points(), expected.points());
+  EXPECT_EQ(actual.intensities(), expected.intensities());
+}
+
+TEST(VoxelFilterTest, AdaptiveSoaPointCloudSelectsSamePoints) {
+  proto::AdaptiveVoxelFilterOptions options;
+  options.set_max_length(0.5f);
+  options.set_min_num_points(200);
+  options.set_max_range(1.5f);
+  const PointCloud point_cloud = CreateGridPointCloud();
+  const PointCloud expected = AdaptiveVoxelFilter(point_cloud, options);
+  const PointCloud actual =
+      AdaptiveVoxelFilter(SoaPointCloud::FromPointCloud(point_cloud), options)
+          .ToPointCloud();
+  EXPECT_GE(expected.size(), 200);
+  EXPECT_EQ(actual.points(), expected.points());
+  EXPECT_EQ(actual.intensities(), expected.intensities());
+}
+
+proto::AdaptiveVoxelFilterOptions CreateRadixSortOptions(
+    const int min_num_points) {
+  proto::AdaptiveVoxelFilterOptions options;
+  options.set_max_length(0.5f);
+  options.set_min_num_points(min_num_points);
+  options.set_max_range(1.5f);
+  options.set_algorithm(proto::AdaptiveVoxelFilterOptions::RADIX_SORT);
+  return options;
+}
+
+TEST(VoxelFilterTest, RadixSortKeepsSameNumberOfPointsAsHashMap) {
+  const PointCloud point_cloud = CreateGridPointCloud();
+  for (const int min_num_points : {10, 100, 200, 500}) {
+    proto::AdaptiveVoxelFilterOptions options =
+        CreateRadixSortOptions(min_num_points);
+    const PointCloud sorted = AdaptiveVoxelFilter(point_cloud, options);
+    options.set_algorithm(proto::AdaptiveVoxelFilterOptions::HASH_MAP);
+    const PointCloud hashed = AdaptiveVoxelFilter(point_cloud, options);
+    EXPECT_EQ(sorted.size(), hashed.size());
+    EXPECT_EQ(sorted.intensities().size(), sorted.size());
+  }
+}
+
+TEST(VoxelFilterTest, RadixSortKeepsFirstPointOfEachVoxel) {
+  std::vector<RangefinderPoint> points;
+  std::vector<float> intensities;
+  for (int i = 0; i < 300; ++i) {
+    const Eigen::Vector3f position(0.1f * (i % 10), 0.1f * (i / 10), 0.f);
+    points.push_back({position});
+    intensities.push_back(2.f * i);
+    points.push_back({position});
+    intensities.push_back(2.f * i + 1.f);
+  }
+  proto::AdaptiveVoxelFilterOptions options = CreateRadixSortOptions(300);
+  options.set_max_range(10.f);
+  const PointCloud result =
+      AdaptiveVoxelFilter(PointCloud(points, intensities), options);
+  ASSERT_EQ(result.size(), 300);
+  for (int i = 0; i < 300; ++i) {
+    EXPECT_EQ(result[i], points[2 * i]);
+    EXPECT_EQ(result.intensities()[i], 2.f * i);
+  }
+}
+
+TEST(VoxelFilterTest, RadixSortSoaPointCloudSelectsSamePoints) {
+  const proto::AdaptiveVoxelFilterOptions options = CreateRadixSortOptions(200);
+  const PointCloud point_cloud = CreateGridPointCloud();
+  const PointCloud expected = AdaptiveVoxelFilter(point_cloud, options);
+  const PointCloud actual =
+      AdaptiveVoxelFilter(SoaPointCloud::FromPointCloud(point_cloud), options)
+          .ToPointCloud();
+  EXPECT_EQ(actual.points(), expected.points());
+  EXPECT_EQ(actual.intensities(), expected.intensities());
+}
+
 }  // namespace
 }  // namespace sensor
 }  // namespace cartographer
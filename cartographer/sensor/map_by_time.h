@@ -18,6 +18,7 @@
 #define CARTOGRAPHER_SENSOR_MAP_BY_TIME_H_
 
 #include <algorithm>
+#include <deque>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -32,17 +33,71 @@ namespace cartographer {
 namespace sensor {
 
 // 'DataType' must contain a 'time' member of type common::Time.
+//
+// Data of each trajectory is stored in time order in a deque of contiguous
+// chunks of at most 'kChunkSize' elements. Appending is amortized O(1), lookups
+// by time are binary searches, and trimming a range of data only touches the
+// chunks at its ends, so that long sessions with high rate data (e.g. IMU)
+// stay cheap to trim and query.
 template <typename DataType>
 class MapByTime {
+ public:
+  static constexpr size_t kChunkSize = 1024;
+
+ private:
+  // Contiguous data of which a prefix may have been erased.
+  class Chunk {
+   public:
+    Chunk() { data_.reserve(kChunkSize); }
+
+    size_t size() const { return data_.size() - begin_; }
+    bool full() const { return data_.size() >= kChunkSize; }
+    const DataType& operator[](const size_t index) const {
+      return data_[begin_ + index];
+    }
+    const DataType& back() const { return data_.back(); }
+    typename std::vector<DataType>::const_iterator begin() const {
+      return data_.begin() + begin_;
+    }
+    typename std::vector<DataType>::const_iterator end() const {
+      return data_.end();
+    }
+
+    void push_back(const DataType& data) { data_.push_back(data); }
+
+    // Erases the data in ['first', 'last'), moving whichever of the remaining
+    // prefix or suffix is shorter. Erasing a prefix is O(1).
+    void Erase(const size_t first, const size_t last) {
+      const auto data_first = data_.begin() + begin_ + first;
+      const auto data_last = data_.begin() + begin_ + last;
+      if (first < size() - last) {
+        std::move_backward(data_.begin() + begin_, data_first, data_last);
+        begin_ += last - first;
+      } else {
+        data_.erase(data_first, data_last);
+      }
+    }
+
+   private:
+    std::vector<DataType> data_;
+    size_t begin_ = 0;
+  };
+
+  // Chunks are never empty.
+  using Chunks = std::deque<Chunk>;
+
  public:
   // Appends data to a 'trajectory_id', creating trajectories as needed.
   void Append(const int trajectory_id, const DataType& data) {
     CHECK_GE(trajectory_id, 0);
-    auto& trajectory = data_[trajectory_id];
-    if (!trajectory.empty()) {
-      CHECK_GT(data.time, std::prev(trajectory.end())->first);
+    auto& chunks = data_[trajectory_id];
+    if (!chunks.empty()) {
+      CHECK_GT(data.time, chunks.back().back().time);
+    }
+    if (chunks.empty() || chunks.back().full()) {
+      chunks.emplace_back();
     }
-    trajectory.emplace(data.time, data);
+    chunks.back().push_back(data);
   }
 
   // Removes data no longer needed once 'node_id' gets removed from 'nodes'.
@@ -71,9 +126,8 @@ class MapByTime {
                                      : common::Time::max();
     CHECK_LT(gap_start, gap_end);
 
-    auto& trajectory = data_.at(trajectory_id);
-    auto data_it = trajectory.lower_bound(gap_start);
-    auto data_end = trajectory.upper_bound(gap_end);
+    auto data_it = lower_bound(trajectory_id, gap_start);
+    auto data_end = upper_bound(trajectory_id, gap_end);
     if (data_it == data_end) {
       return;
     }
@@ -87,13 +141,11 @@ class MapByTime {
     if (gap_start != common::Time::min()) {
       // Retain the first data inside the gap.
       data_it = std::next(data_it);
+      if (data_it == data_end) {
+        return;
+      }
     }
-    while (data_it != data_end) {
-      data_it = trajectory.erase(data_it);
-    }
-    if (trajectory.empty()) {
-      data_.erase(trajectory_id);
-    }
+    Erase(trajectory_id, data_it, data_end);
   }
 
   bool HasTrajectory(const int trajectory_id) const {
@@ -108,32 +160,46 @@ class MapByTime {
     using pointer = const DataType*;
     using reference = const DataType&;
 
-    explicit ConstIterator(
-        typename std::map<common::Time, DataType>::const_iterator iterator)
-        : iterator_(iterator) {}
+    ConstIterator(const Chunks* chunks, const size_t chunk_index,
+                  const size_t index)
+        : chunks_(chunks), chunk_index_(chunk_index), index_(index) {}
 
-    const DataType& operator*() const { return iterator_->second; }
+    const DataType& operator*() const {
+      return (*chunks_)[chunk_index_][index_];
+    }
 
-    const DataType* operator->() const { return &iterator_->second; }
+    const DataType* operator->() const { return &operator*(); }
 
     ConstIterator& operator++() {
-      ++iterator_;
+      if (++index_ == (*chunks_)[chunk_index_].size()) {
+        ++chunk_index_;
+        index_ = 0;
+      }
       return *this;
     }
 
     ConstIterator& operator--() {
-      --iterator_;
+      if (index_ == 0) {
+        --chunk_index_;
+        index_ = (*chunks_)[chunk_index_].size();
+      }
+      --index_;
       return *this;
     }
 
     bool operator==(const ConstIterator& it) const {
-      return iterator_ == it.iterator_;
+      return chunks_ == it.chunks_ && chunk_index_ == it.chunk_index_ &&
+             index_ == it.index_;
     }
 
     bool operator!=(const ConstIterator& it) const { return !operator==(it); }
 
    private:
-    typename std::map<common::Time, DataType>::const_iterator iterator_;
+    friend class MapByTime;
+
+    const Chunks* chunks_;
+    size_t chunk_index_;
+    size_t index_;
   };
 
   class ConstTrajectoryIterator {
@@ -145,8 +211,7 @@ class MapByTime {
     using reference = const int&;
 
     explicit ConstTrajectoryIterator(
-        typename std::map<int, std::map<common::Time, DataType>>::const_iterator
-            current_trajectory)
+        typename std::map<int, Chunks>::const_iterator current_trajectory)
         : current_trajectory_(current_trajectory) {}
 
     int operator*() const { return current_trajectory_->first; }
@@ -170,16 +235,16 @@ class MapByTime {
     }
 
    private:
-    typename std::map<int, std::map<common::Time, DataType>>::const_iterator
-        current_trajectory_;
+    typename std::map<int, Chunks>::const_iterator current_trajectory_;
   };
 
   ConstIterator BeginOfTrajectory(const int trajectory_id) const {
-    return ConstIterator(data_.at(trajectory_id).begin());
+    return ConstIterator(&data_.at(trajectory_id), 0, 0);
   }
 
   ConstIterator EndOfTrajectory(const int trajectory_id) const {
-    return ConstIterator(data_.at(trajectory_id).end());
+    const Chunks& chunks = data_.at(trajectory_id);
+    return ConstIterator(&chunks, chunks.size(), 0);
   }
 
   // Returns Range object for range-based loops over the trajectory IDs.
@@ -200,11 +265,69 @@ class MapByTime {
   // before 'time'. 'trajectory_id' must refer to an existing trajectory.
   ConstIterator lower_bound(const int trajectory_id,
                             const common::Time time) const {
-    return ConstIterator(data_.at(trajectory_id).lower_bound(time));
+    return Bound(trajectory_id,
+                 [time](const DataType& data) { return data.time < time; });
+  }
+
+  // Like 'lower_bound', but returns the first element whose time goes after
+  // 'time'.
+  ConstIterator upper_bound(const int trajectory_id,
+                            const common::Time time) const {
+    return Bound(trajectory_id,
+                 [time](const DataType& data) { return data.time <= time; });
   }
 
  private:
-  std::map<int, std::map<common::Time, DataType>> data_;
+  // Returns the first element of 'trajectory_id' for which 'goes_before' is
+  // false. 'goes_before' must partition the data.
+  template <typename Predicate>
+  ConstIterator Bound(const int trajectory_id,
+                      const Predicate& goes_before) const {
+    const Chunks& chunks = data_.at(trajectory_id);
+    const auto chunk_it = std::partition_point(
+        chunks.begin(), chunks.end(), [&goes_before](const Chunk& chunk) {
+          return goes_before(chunk.back());
+        });
+    if (chunk_it == chunks.end()) {
+      return EndOfTrajectory(trajectory_id);
+    }
+    return ConstIterator(
+        &chunks, chunk_it - chunks.begin(),
+        std::partition_point(chunk_it->begin(), chunk_it->end(), goes_before) -
+            chunk_it->begin());
+  }
+
+  // Erases the data in ['begin', 'end') of 'trajectory_id'. Only the chunks
+  // containing 'begin' and 'end' are modified in place, the chunks in between
+  // are dropped as a whole. Does nothing if the range is empty.
+  void Erase(const int trajectory_id, const ConstIterator& begin,
+             const ConstIterator& end) {
+    if (begin == end) {
+      return;
+    }
+    Chunks& chunks = data_.at(trajectory_id);
+    Chunk& front_chunk = chunks[begin.chunk_index_];
+    if (begin.chunk_index_ == end.chunk_index_) {
+      // 'end' is dereferenceable, so the chunk cannot become empty.
+      front_chunk.Erase(begin.index_, end.index_);
+      return;
+    }
+    size_t first_dropped_chunk = begin.chunk_index_;
+    if (begin.index_ != 0) {
+      front_chunk.Erase(begin.index_, front_chunk.size());
+      ++first_dropped_chunk;
+    }
+    if (end.chunk_index_ != chunks.size()) {
+      chunks[end.chunk_index_].Erase(0, end.index_);
+    }
+    chunks.erase(chunks.begin() + first_dropped_chunk,
+                 chunks.begin() + end.chunk_index_);
+    if (chunks.empty()) {
+      data_.erase(trajectory_id);
+    }
+  }
+
+  std::map<int, Chunks> data_;
 };
 
 }  // namespace sensor
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark/benchmark.h"
+#include "cartographer/common/time.h"
+#include "cartographer/mapping/id.h"
+#include "cartographer/sensor/imu_data.h"
+#include "cartographer/sensor/map_by_time.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+constexpr int kImuRate = 200;  // Hz.
+constexpr int kNodeRate = 10;  // Hz.
+
+common::Time ImuTime(const int index) {
+  return common::FromUniversal(index * (10000000 / kImuRate));
+}
+
+struct NodeData {
+  common::Time time;
+};
+
+// Returns 'state.range(0)' seconds of IMU data.
+MapByTime<ImuData> GenerateImuData(const benchmark::State& state) {
+  MapByTime<ImuData> map_by_time;
+  for (int i = 0; i < state.range(0) * kImuRate; ++i) {
+    map_by_time.Append(0, ImuData{ImuTime(i), Eigen::Vector3d::UnitZ(),
+                                  Eigen::Vector3d::Zero()});
+  }
+  return map_by_time;
+}
+
+void BM_Append(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(GenerateImuData(state));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * kImuRate);
+}
+BENCHMARK(BM_Append)->Arg(600)->Arg(3600);
+
+// Looks up the data between each pair of consecutive nodes.
+void BM_LowerBound(benchmark::State& state) {
+  const MapByTime<ImuData> map_by_time = GenerateImuData(state);
+  const int num_nodes = state.range(0) * kNodeRate;
+  for (auto _ : state) {
+    for (int i = 0; i < num_nodes; ++i) {
+      benchmark::DoNotOptimize(
+          map_by_time.lower_bound(0, ImuTime(i * (kImuRate / kNodeRate))));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+BENCHMARK(BM_LowerBound)->Arg(600)->Arg(3600);
+
+// Trims the oldest nodes one by one, as the pure localization trimmer does.
+void BM_TrimOldestNodes(benchmark::State& state) {
+  const int num_nodes = state.range(0) * kNodeRate;
+  for (auto _ : state) {
+    state.PauseTiming();
+    MapByTime<ImuData> map_by_time = GenerateImuData(state);
+    mapping::MapById<mapping::NodeId, NodeData> nodes;
+    for (int i = 0; i < num_nodes; ++i) {
+      nodes.Append(0, NodeData{ImuTime(i * (kImuRate / kNodeRate))});
+    }
+    state.ResumeTiming();
+    for (int i = 0; i + 1 < num_nodes; ++i) {
+      map_by_time.Trim(nodes, mapping::NodeId{0, i});
+      nodes.Trim(mapping::NodeId{0, i});
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+BENCHMARK(BM_TrimOldestNodes)->Arg(600)->Arg(3600);
+
+// Trims every other node, which leaves gaps in the middle of the data.
+void BM_TrimEveryOtherNode(benchmark::State& state) {
+  const int num_nodes = state.range(0) * kNodeRate;
+  for (auto _ : state) {
+    state.PauseTiming();
+    MapByTime<ImuData> map_by_time = GenerateImuData(state);
+    mapping::MapById<mapping::NodeId, NodeData> nodes;
+    for (int i = 0; i < num_nodes; ++i) {
+      nodes.Append(0, NodeData{ImuTime(i * (kImuRate / kNodeRate))});
+    }
+    state.ResumeTiming();
+    for (int i = 1; i + 1 < num_nodes; i += 2) {
+      map_by_time.Trim(nodes, mapping::NodeId{0, i});
+      nodes.Trim(mapping::NodeId{0, i});
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes / 2);
+}
+BENCHMARK(BM_TrimEveryOtherNode)->Arg(600)->Arg(3600);
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
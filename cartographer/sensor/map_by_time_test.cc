@@ -16,7 +16,9 @@
 
 #include "cartographer/sensor/map_by_time.h"
 
+#include <algorithm>
 #include <deque>
+#include <vector>
 
 #include "cartographer/common/time.h"
 #include "gtest/gtest.h"
@@ -97,6 +99,113 @@ TEST(MapByTimeTest, TrimmingDoesNotCreateTrajectory) {
   EXPECT_FALSE(map_by_time.HasTrajectory(42));
 }
 
+TEST(MapByTimeTest, TrimmingLastNodeWithOneDataAfterPreviousNode) {
+  MapByTime<Data> map_by_time;
+  map_by_time.Append(42, Data{CreateTime(5)});
+  map_by_time.Append(42, Data{CreateTime(15)});
+  mapping::MapById<mapping::NodeId, NodeData> map_by_id;
+  map_by_id.Append(42, NodeData{CreateTime(10)});
+  map_by_id.Append(42, NodeData{CreateTime(20)});
+  // The only data after the previous node is retained, so nothing is erased.
+  map_by_time.Trim(map_by_id, mapping::NodeId{42, 1});
+  map_by_id.Trim(mapping::NodeId{42, 1});
+  std::deque<Data> expected_data = {Data{CreateTime(5)}, Data{CreateTime(15)}};
+  for (const Data& data : map_by_time.trajectory(42)) {
+    ASSERT_FALSE(expected_data.empty());
+    EXPECT_EQ(expected_data.front().time, data.time);
+    expected_data.pop_front();
+  }
+  EXPECT_TRUE(expected_data.empty());
+}
+
+TEST(MapByTimeTest, LowerAndUpperBoundAcrossChunks) {
+  constexpr int kNumData = 3 * MapByTime<Data>::kChunkSize + 5;
+  MapByTime<Data> map_by_time;
+  for (int i = 0; i < kNumData; ++i) {
+    map_by_time.Append(0, Data{CreateTime(2 * i)});
+  }
+  for (int i = -1; i < 2 * kNumData + 1; ++i) {
+    const auto lower = map_by_time.lower_bound(0, CreateTime(i));
+    const auto upper = map_by_time.upper_bound(0, CreateTime(i));
+    const int expected_lower = i < 0 ? 0 : (i + 1) / 2;
+    const int expected_upper = i < 0 ? 0 : i / 2 + 1;
+    if (expected_lower >= kNumData) {
+      EXPECT_TRUE(lower == map_by_time.EndOfTrajectory(0));
+    } else {
+      EXPECT_EQ(lower->time, CreateTime(2 * expected_lower));
+    }
+    if (expected_upper >= kNumData) {
+      EXPECT_TRUE(upper == map_by_time.EndOfTrajectory(0));
+    } else {
+      EXPECT_EQ(upper->time, CreateTime(2 * expected_upper));
+    }
+  }
+  // Iterating backwards visits all data across chunk boundaries.
+  int expected_index = kNumData;
+  for (auto it = map_by_time.EndOfTrajectory(0);
+       it != map_by_time.BeginOfTrajectory(0);) {
+    --it;
+    --expected_index;
+    EXPECT_EQ(it->time, CreateTime(2 * expected_index));
+  }
+  EXPECT_EQ(expected_index, 0);
+}
+
+TEST(MapByTimeTest, TrimmingAcrossChunks) {
+  constexpr int kNumData = 5 * MapByTime<Data>::kChunkSize;
+  MapByTime<Data> map_by_time;
+  for (int i = 0; i < kNumData; ++i) {
+    map_by_time.Append(42, Data{CreateTime(i)});
+  }
+  mapping::MapById<mapping::NodeId, NodeData> map_by_id;
+  map_by_id.Append(42, NodeData{CreateTime(100)});
+  map_by_id.Append(42, NodeData{CreateTime(1500)});
+  map_by_id.Append(42, NodeData{CreateTime(3500)});
+  map_by_id.Append(42, NodeData{CreateTime(3600)});
+  map_by_id.Append(42, NodeData{CreateTime(4000)});
+  std::vector<int> expected_times;
+  for (int i = 0; i < kNumData; ++i) {
+    expected_times.push_back(i);
+  }
+  const auto expect_data = [&map_by_time, &expected_times]() {
+    auto it = expected_times.begin();
+    for (const Data& data : map_by_time.trajectory(42)) {
+      ASSERT_TRUE(it != expected_times.end());
+      EXPECT_EQ(data.time, CreateTime(*it));
+      ++it;
+    }
+    EXPECT_TRUE(it == expected_times.end());
+  };
+  const auto erase_times = [&expected_times](int begin, int end) {
+    expected_times.erase(
+        std::lower_bound(expected_times.begin(), expected_times.end(), begin),
+        std::lower_bound(expected_times.begin(), expected_times.end(), end));
+  };
+
+  // Trimming a node in the middle retains the data at the adjacent nodes.
+  map_by_time.Trim(map_by_id, mapping::NodeId{42, 1});
+  map_by_id.Trim(mapping::NodeId{42, 1});
+  erase_times(101, 3500);
+  expect_data();
+
+  // Trimming the first node drops all data up to the next node.
+  map_by_time.Trim(map_by_id, mapping::NodeId{42, 0});
+  map_by_id.Trim(mapping::NodeId{42, 0});
+  erase_times(0, 3500);
+  expect_data();
+  EXPECT_EQ(map_by_time.lower_bound(42, CreateTime(0))->time,
+            CreateTime(3500));
+
+  // Trimming the last node drops all data after the previous node.
+  map_by_time.Trim(map_by_id, mapping::NodeId{42, 4});
+  map_by_id.Trim(mapping::NodeId{42, 4});
+  erase_times(3601, kNumData);
+  expect_data();
+  map_by_time.Append(42, Data{CreateTime(kNumData)});
+  expected_times.push_back(kNumData);
+  expect_data();
+}
+
 }  // namespace
 }  // namespace sensor
 }  // namespace cartographer
@@ -16,6 +16,9 @@
 
 #include "cartographer/sensor/point_cloud.h"
 
+#include <utility>
+
+#include "cartographer/sensor/internal/point_transform_kernels.h"
 #include "cartographer/sensor/proto/sensor.pb.h"
 #include "cartographer/transform/transform.h"
 
@@ -55,21 +58,15 @@ void PointCloud::push_back(PointCloud::PointType value) {
 
 PointCloud TransformPointCloud(const PointCloud& point_cloud,
                                const transform::Rigid3f& transform) {
-  std::vector<RangefinderPoint> points;
-  points.reserve(point_cloud.size());
-  for (const RangefinderPoint& point : point_cloud.points()) {
-    points.emplace_back(transform * point);
-  }
-  return PointCloud(points, point_cloud.intensities());
+  std::vector<RangefinderPoint> points = point_cloud.points();
+  TransformPointsInPlace(transform, &points);
+  return PointCloud(std::move(points), point_cloud.intensities());
 }
 
 TimedPointCloud TransformTimedPointCloud(const TimedPointCloud& point_cloud,
                                          const transform::Rigid3f& transform) {
-  TimedPointCloud result;
-  result.reserve(point_cloud.size());
-  for (const TimedRangefinderPoint& point : point_cloud) {
-    result.push_back(transform * point);
-  }
+  TimedPointCloud result = point_cloud;
+  TransformPointsInPlace(transform, &result);
   return result;
 }
 
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/sensor/soa_point_cloud.h"
+
+#include <algorithm>
+
+namespace cartographer {
+namespace sensor {
+
+SoaPointCloud::SoaPointCloud(const bool has_time, const bool has_intensity)
+    : has_time_(has_time), has_intensity_(has_intensity) {}
+
+SoaPointCloud SoaPointCloud::FromPointCloud(const PointCloud& point_cloud) {
+  const bool has_intensity = !point_cloud.intensities().empty();
+  SoaPointCloud result(false /* has_time */, has_intensity);
+  result.resize(point_cloud.size());
+  for (size_t i = 0; i < point_cloud.size(); ++i) {
+    const Eigen::Vector3f& position = point_cloud[i].position;
+    result.x_[i] = position.x();
+    result.y_[i] = position.y();
+    result.z_[i] = position.z();
+  }
+  if (has_intensity) {
+    std::copy(point_cloud.intensities().begin(),
+              point_cloud.intensities().end(), result.intensity_.begin());
+  }
+  return result;
+}
+
+SoaPointCloud SoaPointCloud::FromTimedPointCloud(
+    const TimedPointCloud& timed_point_cloud) {
+  SoaPointCloud result(true /* has_time */, false /* has_intensity */);
+  result.resize(timed_point_cloud.size());
+  for (size_t i = 0; i < timed_point_cloud.size(); ++i) {
+    const TimedRangefinderPoint& point = timed_point_cloud[i];
+    result.x_[i] = point.position.x();
+    result.y_[i] = point.position.y();
+    result.z_[i] = point.position.z();
+    result.time_[i] = point.time;
+  }
+  return result;
+}
+
+PointCloud SoaPointCloud::ToPointCloud() const {
+  std::vector<RangefinderPoint> points;
+  points.reserve(size());
+  for (size_t i = 0; i < size(); ++i) {
+    points.push_back({position(i)});
+  }
+  return PointCloud(std::move(points), intensity_);
+}
+
+TimedPointCloud SoaPointCloud::ToTimedPointCloud() const {
+  TimedPointCloud result;
+  result.reserve(size());
+  for (size_t i = 0; i < size(); ++i) {
+    result.push_back({position(i), has_time_ ? time_[i] : 0.f});
+  }
+  return result;
+}
+
+void SoaPointCloud::reserve(const size_t size) {
+  x_.reserve(size);
+  y_.reserve(size);
+  z_.reserve(size);
+  if (has_time_) time_.reserve(size);
+  if (has_intensity_) intensity_.reserve(size);
+}
+
+void SoaPointCloud::resize(const size_t size) {
+  x_.resize(size);
+  y_.resize(size);
+  z_.resize(size);
+  if (has_time_) time_.resize(size);
+  if (has_intensity_) intensity_.resize(size);
+}
+
+void SoaPointCloud::push_back(const Eigen::Vector3f& position,
+                              const float time, const float intensity) {
+  x_.push_back(position.x());
+  y_.push_back(position.y());
+  z_.push_back(position.z());
+  if (has_time_) time_.push_back(time);
+  if (has_intensity_) intensity_.push_back(intensity);
+}
+
+SoaPointCloudView::SoaPointCloudView(const SoaPointCloud& point_cloud)
+    : x_(point_cloud.x()),
+      y_(point_cloud.y()),
+      z_(point_cloud.z()),
+      time_(point_cloud.time()),
+      intensity_(point_cloud.intensity()),
+      size_(point_cloud.size()),
+      has_time_(point_cloud.has_time()),
+      has_intensity_(point_cloud.has_intensity()) {}
+
+SoaPointCloudView::SoaPointCloudView(const float* const x,
+                                     const float* const y,
+                                     const float* const z,
+                                     const float* const time,
+                                     const float* const intensity,
+                                     const size_t size)
+    : x_(x),
+      y_(y),
+      z_(z),
+      time_(time),
+      intensity_(intensity),
+      size_(size),
+      has_time_(time != nullptr),
+      has_intensity_(intensity != nullptr) {}
+
+SoaPointCloudView SoaPointCloudView::subview(const size_t begin,
+                                             const size_t count) const {
+  CHECK_LE(begin + count, size_);
+  SoaPointCloudView result = *this;
+  result.x_ += begin;
+  result.y_ += begin;
+  result.z_ += begin;
+  if (has_time_) result.time_ += begin;
+  if (has_intensity_) result.intensity_ += begin;
+  result.size_ = count;
+  return result;
+}
+
+SoaPointCloud CopyPointCloud(const SoaPointCloudView point_cloud) {
+  const size_t size = point_cloud.size();
+  SoaPointCloud result(point_cloud.has_time(), point_cloud.has_intensity());
+  result.resize(size);
+  std::copy(point_cloud.x(), point_cloud.x() + size, result.mutable_x());
+  std::copy(point_cloud.y(), point_cloud.y() + size, result.mutable_y());
+  std::copy(point_cloud.z(), point_cloud.z() + size, result.mutable_z());
+  if (point_cloud.has_time()) {
+    std::copy(point_cloud.time(), point_cloud.time() + size,
+              result.mutable_time());
+  }
+  if (point_cloud.has_intensity()) {
+    std::copy(point_cloud.intensity(), point_cloud.intensity() + size,
+              result.mutable_intensity());
+  }
+  return result;
+}
+
+SoaPointCloud TransformPointCloud(const SoaPointCloudView point_cloud,
+                                  const transform::Rigid3f& transform) {
+  const size_t size = point_cloud.size();
+  // Only the time and intensity channels are copied, the coordinates are
+  // written once, transformed.
+  SoaPointCloud result(point_cloud.has_time(), point_cloud.has_intensity());
+  result.resize(size);
+  if (point_cloud.has_time()) {
+    std::copy(point_cloud.time(), point_cloud.time() + size,
+              result.mutable_time());
+  }
+  if (point_cloud.has_intensity()) {
+    std::copy(point_cloud.intensity(), point_cloud.intensity() + size,
+              result.mutable_intensity());
+  }
+  // Rotating by a matrix instead of the quaternion, with one independent
+  // loop iteration per point, lets the compiler vectorize the loop.
+  const Eigen::Matrix3f rotation = transform.rotation().toRotationMatrix();
+  const Eigen::Vector3f& translation = transform.translation();
+  const float* const x = point_cloud.x();
+  const float* const y = point_cloud.y();
+  const float* const z = point_cloud.z();
+  float* const result_x = result.mutable_x();
+  float* const result_y = result.mutable_y();
+  float* const result_z = result.mutable_z();
+  for (size_t i = 0; i < size; ++i) {
+    const float point_x = x[i];
+    const float point_y = y[i];
+    const float point_z = z[i];
+    result_x[i] = rotation(0, 0) * point_x + rotation(0, 1) * point_y +
+                  rotation(0, 2) * point_z + translation.x();
+    result_y[i] = rotation(1, 0) * point_x + rotation(1, 1) * point_y +
+                  rotation(1, 2) * point_z + translation.y();
+    result_z[i] = rotation(2, 0) * point_x + rotation(2, 1) * point_y +
+                  rotation(2, 2) * point_z + translation.z();
+  }
+  return result;
+}
+
+SoaPointCloud CropPointCloud(const SoaPointCloudView point_cloud,
+                             const float min_z, const float max_z) {
+  std::vector<bool> points_used(point_cloud.size());
+  const float* const z = point_cloud.z();
+  for (size_t i = 0; i < point_cloud.size(); ++i) {
+    points_used[i] = min_z <= z[i] && z[i] <= max_z;
+  }
+  return SelectPoints(point_cloud, points_used);
+}
+
+SoaPointCloud SelectPoints(const SoaPointCloudView point_cloud,
+                           const std::vector<bool>& points_used) {
+  CHECK_EQ(points_used.size(), point_cloud.size());
+  SoaPointCloud result(point_cloud.has_time(), point_cloud.has_intensity());
+  for (size_t i = 0; i < point_cloud.size(); ++i) {
+    if (points_used[i]) {
+      result.push_back(
+          point_cloud.position(i),
+          point_cloud.has_time() ? point_cloud.time()[i] : 0.f,
+          point_cloud.has_intensity() ? point_cloud.intensity()[i] : 0.f);
+    }
+  }
+  return result;
+}
+
+}  // namespace sensor
+}  // namespace cartographer
@@ -0,0 +1,161 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef CARTOGRAPHER_SENSOR_SOA_POINT_CLOUD_H_
+#define CARTOGRAPHER_SENSOR_SOA_POINT_CLOUD_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "Eigen/Core"
+#include "cartographer/sensor/point_cloud.h"
+#include "cartographer/transform/rigid_transform.h"
+#include "glog/logging.h"
+
+namespace cartographer {
+namespace sensor {
+
+class SoaPointCloudView;
+
+// Stores a point cloud as a structure of arrays: one contiguous array for each
+// of the x, y and z coordinates and for each of the optional time and
+// intensity channels. Unlike 'PointCloud' and 'TimedPointCloud', loops over a
+// single coordinate access memory with unit stride, which allows the compiler
+// to vectorize them. Time and intensity have the same meaning as in
+// 'TimedPointCloud' and 'PointCloud'.
+class SoaPointCloud {
+ public:
+  SoaPointCloud() : SoaPointCloud(false, false) {}
+  SoaPointCloud(bool has_time, bool has_intensity);
+
+  // Copies intensities if 'point_cloud' has them.
+  static SoaPointCloud FromPointCloud(const PointCloud& point_cloud);
+  static SoaPointCloud FromTimedPointCloud(
+      const TimedPointCloud& timed_point_cloud);
+
+  PointCloud ToPointCloud() const;
+  // Points get a time of 0.f if there is no time channel.
+  TimedPointCloud ToTimedPointCloud() const;
+
+  size_t size() const { return x_.size(); }
+  bool empty() const { return x_.empty(); }
+  bool has_time() const { return has_time_; }
+  bool has_intensity() const { return has_intensity_; }
+
+  void reserve(size_t size);
+  void resize(size_t size);
+
+  // 'time' and 'intensity' are ignored if the respective channel is absent.
+  void push_back(const Eigen::Vector3f& position, float time = 0.f,
+                 float intensity = 0.f);
+
+  Eigen::Vector3f position(size_t index) const {
+    return Eigen::Vector3f(x_[index], y_[index], z_[index]);
+  }
+
+  // The time and intensity accessors return nullptr for absent channels. Like
+  // 'std::vector::data()', all accessors may also return nullptr if the point
+  // cloud is empty, so 'has_time()' and 'has_intensity()' tell whether a
+  // channel is present.
+  const float* x() const { return x_.data(); }
+  const float* y() const { return y_.data(); }
+  const float* z() const { return z_.data(); }
+  const float* time() const { return time_.data(); }
+  const float* intensity() const { return intensity_.data(); }
+  float* mutable_x() { return x_.data(); }
+  float* mutable_y() { return y_.data(); }
+  float* mutable_z() { return z_.data(); }
+  float* mutable_time() { return time_.data(); }
+  float* mutable_intensity() { return intensity_.data(); }
+
+ private:
+  bool has_time_;
+  bool has_intensity_;
+  std::vector<float> x_;
+  std::vector<float> y_;
+  std::vector<float> z_;
+  // Empty unless 'has_time_'.
+  std::vector<float> time_;
+  // Empty unless 'has_intensity_'.
+  std::vector<float> intensity_;
+};
+
+// Non-owning view of a contiguous range of points with the same layout as
+// 'SoaPointCloud'. The viewed arrays must outlive the view.
+class SoaPointCloudView {
+ public:
+  SoaPointCloudView(const SoaPointCloud& point_cloud);  // NOLINT
+  // 'time' and 'intensity' are nullptr for absent channels.
+  SoaPointCloudView(const float* x, const float* y, const float* z,
+                    const float* time, const float* intensity, size_t size);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  bool has_time() const { return has_time_; }
+  bool has_intensity() const { return has_intensity_; }
+
+  Eigen::Vector3f position(size_t index) const {
+    return Eigen::Vector3f(x_[index], y_[index], z_[index]);
+  }
+
+  const float* x() const { return x_; }
+  const float* y() const { return y_; }
+  const float* z() const { return z_; }
+  const float* time() const { return time_; }
+  const float* intensity() const { return intensity_; }
+
+  // Returns a view of 'count' points starting at 'begin', without copying.
+  SoaPointCloudView subview(size_t begin, size_t count) const;
+
+ private:
+  const float* x_;
+  const float* y_;
+  const float* z_;
+  const float* time_;
+  const float* intensity_;
+  size_t size_;
+  // Kept apart from the pointers, which may be nullptr for an empty view.
+  bool has_time_;
+  bool has_intensity_;
+};
+
+// Like 'RangeData', but with 'SoaPointCloud's.
+struct SoaRangeData {
+  Eigen::Vector3f origin;
+  SoaPointCloud returns;
+  SoaPointCloud misses;
+};
+
+// Copies the points viewed by 'point_cloud' into an owning 'SoaPointCloud'.
+SoaPointCloud CopyPointCloud(SoaPointCloudView point_cloud);
+
+// Transforms 'point_cloud' according to 'transform'.
+SoaPointCloud TransformPointCloud(SoaPointCloudView point_cloud,
+                                  const transform::Rigid3f& transform);
+
+// Returns a new point cloud without points that fall outside the region defined
+// by 'min_z' and 'max_z'.
+SoaPointCloud CropPointCloud(SoaPointCloudView point_cloud, float min_z,
+                             float max_z);
+
+// Returns the points for which 'points_used' is true, with all channels.
+SoaPointCloud SelectPoints(SoaPointCloudView point_cloud,
+                           const std::vector<bool>& points_used);
+
+}  // namespace sensor
+}  // namespace cartographer
+
+#endif  // CARTOGRAPHER_SENSOR_SOA_POINT_CLOUD_H_
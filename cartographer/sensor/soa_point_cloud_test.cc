@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 The Cartographer Authors
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cartographer/sensor/soa_point_cloud.h"
+
+#include <cmath>
+
+#include "cartographer/transform/transform.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace cartographer {
+namespace sensor {
+namespace {
+
+TimedPointCloud CreateTimedPointCloud() {
+  TimedPointCloud point_cloud;
+  for (int i = 0; i < 17; ++i) {
+    point_cloud.push_back(
+        {Eigen::Vector3f(0.5f * i, 1.f - 0.25f * i, 0.1f * i), -0.01f * i});
+  }
+  return point_cloud;
+}
+
+TEST(SoaPointCloudTest, RoundTripsTimedPointCloud) {
+  const TimedPointCloud timed_point_cloud = CreateTimedPointCloud();
+  const SoaPointCloud soa_point_cloud =
+      SoaPointCloud::FromTimedPointCloud(timed_point_cloud);
+  EXPECT_TRUE(soa_point_cloud.has_time());
+  EXPECT_FALSE(soa_point_cloud.has_intensity());
+  EXPECT_EQ(soa_point_cloud.intensity(), nullptr);
+  EXPECT_EQ(soa_point_cloud.ToTimedPointCloud(), timed_point_cloud);
+}
+
+TEST(SoaPointCloudTest, RoundTripsPointCloudWithIntensities) {
+  const PointCloud point_cloud(
+      {{{0.f, 1.f, 2.f}}, {{3.f, 4.f, 5.f}}, {{6.f, 7.f, 8.f}}},
+      {10.f, 20.f, 30.f});
+  const SoaPointCloud soa_point_cloud =
+      SoaPointCloud::FromPointCloud(point_cloud);
+  EXPECT_FALSE(soa_point_cloud.has_time());
+  ASSERT_TRUE(soa_point_cloud.has_intensity());
+  EXPECT_EQ(soa_point_cloud.intensity()[2], 30.f);
+  const PointCloud round_tripped = soa_point_cloud.ToPointCloud();
+  EXPECT_EQ(round_tripped.points(), point_cloud.points());
+  EXPECT_EQ(round_tripped.intensities(), point_cloud.intensities());
+}
+
+TEST(SoaPointCloudTest, EmptyPointCloudKeepsChannels) {
+  const SoaPointCloud point_cloud(true /* has_time */,
+                                  false /* has_intensity */);
+  const SoaPointCloudView view(point_cloud);
+  EXPECT_TRUE(view.empty());
+  EXPECT_TRUE(view.has_time());
+  EXPECT_FALSE(view.has_intensity());
+  EXPECT_TRUE(view.subview(0, 0).has_time());
+  EXPECT_TRUE(CopyPointCloud(view).has_time());
+  EXPECT_TRUE(TransformPointCloud(view, transform::Rigid3f::Identity())
+                  .has_time());
+}
+
+TEST(SoaPointCloudTest, SubviewDoesNotCopy) {
+  const SoaPointCloud soa_point_cloud =
+      SoaPointCloud::FromTimedPointCloud(CreateTimedPointCloud());
+  const SoaPointCloudView view =
+      SoaPointCloudView(soa_point_cloud).subview(3, 5);
+  EXPECT_EQ(view.size(), 5);
+  EXPECT_EQ(view.x(), soa_point_cloud.x() + 3);
+  EXPECT_EQ(view.y(), soa_point_cloud.y() + 3);
+  EXPECT_EQ(view.z(), soa_point_cloud.z() + 3);
+  EXPECT_EQ(view.time(), soa_point_cloud.time() + 3);
+  EXPECT_EQ(view.intensity(), nullptr);
+  EXPECT_TRUE(view.position(0).isApprox(soa_point_cloud.position(3)));
+  EXPECT_EQ(CopyPointCloud(view).size(), 5);
+}
+
+TEST(SoaPointCloudTest, TransformPointCloudMatchesTimedPointCloud) {
+  const TimedPointCloud timed_point_cloud = CreateTimedPointCloud();
+  const transform::Rigid3f transform(
+      Eigen::Vector3f(1.f, -2.f, 0.5f),
+      Eigen::Quaternionf(Eigen::AngleAxisf(0.3f, Eigen::Vector3f::UnitZ()) *
+                         Eigen::AngleAxisf(-0.2f, Eigen::Vector3f::UnitX())));
+  const TimedPointCloud expected =
+      TransformTimedPointCloud(timed_point_cloud, transform);
+  const SoaPointCloud actual = TransformPointCloud(
+      SoaPointCloud::FromTimedPointCloud(timed_point_cloud), transform);
+  ASSERT_EQ(actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_TRUE(actual.position(i).isApprox(expected[i].position, 1e-6f));
+    EXPECT_EQ(actual.time()[i], expected[i].time);
+  }
+}
+
+TEST(SoaPointCloudTest, CropPointCloud) {
+  SoaPointCloud point_cloud(false /* has_time */, true /* has_intensity */);
+  point_cloud.push_back({0.f, 0.f, 0.5f}, 0.f, 1.f);
+  point_cloud.push_back({0.f, 0.f, 1.5f}, 0.f, 2.f);
+  point_cloud.push_back({0.f, 0.f, 1.f}, 0.f, 3.f);
+  point_cloud.push_back({0.f, 0.f, 2.5f}, 0.f, 4.f);
+  const SoaPointCloud cropped = CropPointCloud(point_cloud, 1.f, 2.f);
+  ASSERT_EQ(cropped.size(), 2);
+  EXPECT_EQ(cropped.z()[0], 1.5f);
+  EXPECT_EQ(cropped.intensity()[0], 2.f);
+  EXPECT_EQ(cropped.z()[1], 1.f);
+  EXPECT_EQ(cropped.intensity()[1], 3.f);
+}
+
+}  // namespace
+}  // namespace sensor
+}  // namespace cartographer
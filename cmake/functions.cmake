@@ -44,6 +44,13 @@ function(google_test NAME ARG_SRC)
   add_test(${NAME} ${NAME})
 endfunction()
 
+function(google_benchmark NAME)
+  add_executable(${NAME} ${ARGN})
+  _common_compile_stuff()
+
+  target_link_libraries("${NAME}" PUBLIC benchmark::benchmark_main)
+endfunction()
+
 function(google_binary NAME)
   _parse_arguments("${ARGN}")
 
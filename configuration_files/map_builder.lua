@@ -18,6 +18,8 @@ MAP_BUILDER = {
   use_trajectory_builder_2d = false,
   use_trajectory_builder_3d = false,
   num_background_threads = 4,
+  thread_pool_type = "SHARED_QUEUE_THREAD_POOL",
   pose_graph = POSE_GRAPH,
   collate_by_trajectory = false,
+  num_collator_threads = 0,
 }
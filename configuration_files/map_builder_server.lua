@@ -23,6 +23,8 @@ MAP_BUILDER_SERVER = {
   upload_batch_size = 100,
   enable_ssl_encryption = false,
   enable_google_auth = false,
+  incoming_data_queue_size = 0,
+  upload_queue_size = 0,
 }
 
 MAP_BUILDER.collate_by_trajectory = true
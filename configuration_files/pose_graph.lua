@@ -22,6 +22,9 @@ POSE_GRAPH = {
     loop_closure_translation_weight = 1.1e4,
     loop_closure_rotation_weight = 1e5,
     log_matches = true,
+    decompressed_node_cache_size = 100,
+    rotated_scan_cache_max_bytes = 64 * 1024 * 1024,
+    num_scan_matcher_threads = 0,
     fast_correlative_scan_matcher = {
       linear_search_window = 7.,
       angular_search_window = math.rad(30.),
@@ -87,6 +90,7 @@ POSE_GRAPH = {
   global_sampling_ratio = 0.003,
   log_residual_histograms = true,
   global_constraint_search_after_n_seconds = 10.,
+  compress_node_point_clouds = false,
   --  overlapping_submaps_trimmer_2d = {
   --    fresh_submaps_count = 1,
   --    min_covered_area = 2,
@@ -26,12 +26,14 @@ TRAJECTORY_BUILDER_2D = {
     max_length = 0.5,
     min_num_points = 200,
     max_range = 50.,
+    algorithm = "HASH_MAP",
   },
 
   loop_closure_adaptive_voxel_filter = {
     max_length = 0.9,
     min_num_points = 100,
     max_range = 50.,
+    algorithm = "HASH_MAP",
   },
 
   use_online_correlative_scan_matching = false,
@@ -40,6 +42,7 @@ TRAJECTORY_BUILDER_2D = {
     angular_search_window = math.rad(20.),
     translation_delta_cost_weight = 1e-1,
     rotation_delta_cost_weight = 1e-1,
+    branch_and_bound_depth = 1,
   },
 
   ceres_scan_matcher = {
@@ -86,6 +89,7 @@ TRAJECTORY_BUILDER_2D = {
 
   submaps = {
     num_range_data = 90,
+    num_insertion_threads = 0,
     grid_options_2d = {
       grid_type = "PROBABILITY_GRID",
       resolution = 0.05,
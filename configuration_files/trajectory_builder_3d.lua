@@ -25,12 +25,14 @@ TRAJECTORY_BUILDER_3D = {
     max_length = 2.,
     min_num_points = 150,
     max_range = 15.,
+    algorithm = "HASH_MAP",
   },
 
   low_resolution_adaptive_voxel_filter = {
     max_length = 4.,
     min_num_points = 200,
     max_range = MAX_3D_RANGE,
+    algorithm = "HASH_MAP",
   },
 
   use_online_correlative_scan_matching = false,
@@ -98,6 +100,7 @@ TRAJECTORY_BUILDER_3D = {
     high_resolution_max_range = 20.,
     low_resolution = 0.45,
     num_range_data = 160,
+    num_insertion_threads = 0,
     range_data_inserter = {
       hit_probability = 0.55,
       miss_probability = 0.49,